@@ -0,0 +1,141 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+
+#include "ll_async_logger.hpp"
+#include "ll_latency_histogram.hpp"
+
+/*
+ * Benchmark: asynchronous binary logger vs synchronous formatted logger
+ *
+ * Synchronous baseline mirrors an spdlog basic_file_sink in sync mode:
+ * lock a mutex, format the line (snprintf), fwrite into a buffered FILE*.
+ *
+ * Per-call latency is measured around every call with steady_clock,
+ * so every number includes the timer overhead printed first.
+ */
+
+static constexpr std::size_t N_MSGS = 1000000; // 1 million
+static constexpr std::size_t N_OVERFLOW = 200000;
+
+using clk = std::chrono::steady_clock;
+
+static std::uint64_t elapsed_ns(clk::time_point a, clk::time_point b)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count();
+}
+
+// Synchronous baseline
+
+class sync_file_logger
+{
+    std::FILE* f_;
+    std::mutex m_;
+    char line_[256];
+
+public:
+    explicit sync_file_logger(const char* path) : f_(std::fopen(path, "w")) {}
+    ~sync_file_logger() { std::fclose(f_); }
+
+    void fill(std::uint64_t id, double px, std::int32_t qty, char side)
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        const auto ts = std::chrono::system_clock::now().time_since_epoch().count();
+        const int n = std::snprintf(line_, sizeof(line_), "%lld fill id=%llu px=%g qty=%d side=%c\n",
+                                    static_cast<long long>(ts), static_cast<unsigned long long>(id), px, qty, side);
+        std::fwrite(line_, 1, static_cast<std::size_t>(n), f_);
+    }
+};
+
+void bench_timer_overhead()
+{
+    ll_latency_histogram h;
+    for (std::size_t i = 0; i < N_MSGS; ++i)
+    {
+        auto a = clk::now();
+        auto b = clk::now();
+        h.record(elapsed_ns(a, b));
+    }
+    h.print(std::cout, "timer overhead (ns)     ");
+}
+
+void bench_sync()
+{
+    sync_file_logger log("/tmp/ll_bench_sync.log");
+    ll_latency_histogram h;
+    auto t0 = clk::now();
+    for (std::size_t i = 0; i < N_MSGS; ++i)
+    {
+        auto a = clk::now();
+        log.fill(i, 100.25 + static_cast<double>(i % 100) * 0.01, static_cast<std::int32_t>(i % 500), 'B');
+        auto b = clk::now();
+        h.record(elapsed_ns(a, b));
+    }
+    auto t1 = clk::now();
+    h.print(std::cout, "sync snprintf+fwrite (ns)");
+    std::cout << "  total: " << elapsed_ns(t0, t1) / 1000000 << " ms\n";
+}
+
+void bench_async()
+{
+    ll_async_logger::config cfg;
+    cfg.ring_bytes = std::size_t{64} << 20; // holds the whole run: measures the pure hot path
+    cfg.policy = ll_overflow_policy::block;
+    ll_async_logger log("/tmp/ll_bench_async.log", cfg);
+
+    LL_LOG(log, "warmup thread={}", 0); // registers this thread's ring
+
+    ll_latency_histogram h;
+    auto t0 = clk::now();
+    for (std::size_t i = 0; i < N_MSGS; ++i)
+    {
+        auto a = clk::now();
+        LL_LOG(log, "fill id={} px={} qty={} side={}",
+               static_cast<std::uint64_t>(i), 100.25 + static_cast<double>(i % 100) * 0.01,
+               static_cast<std::int32_t>(i % 500), 'B');
+        auto b = clk::now();
+        h.record(elapsed_ns(a, b));
+    }
+    auto t1 = clk::now();
+    log.flush();
+    auto t2 = clk::now();
+    h.print(std::cout, "async binary log (ns)    ");
+    std::cout << "  producer total: " << elapsed_ns(t0, t1) / 1000000 << " ms"
+              << ", until flushed: " << elapsed_ns(t0, t2) / 1000000 << " ms\n";
+}
+
+// small ring, no consumer headroom: shows what each policy does under a burst
+void bench_overflow(ll_overflow_policy policy, const char* name)
+{
+    ll_async_logger::config cfg;
+    cfg.ring_bytes = std::size_t{64} << 10;
+    cfg.policy = policy;
+    ll_async_logger log("/tmp/ll_bench_async_overflow.log", cfg);
+
+    ll_latency_histogram h;
+    for (std::size_t i = 0; i < N_OVERFLOW; ++i)
+    {
+        auto a = clk::now();
+        LL_LOG(log, "burst id={} name={}", static_cast<std::uint64_t>(i), std::string_view("AAPL"));
+        auto b = clk::now();
+        h.record(elapsed_ns(a, b));
+    }
+    log.flush();
+    h.print(std::cout, name);
+    std::cout << "  dropped: " << log.dropped() << " / " << N_OVERFLOW << "\n";
+}
+
+int main()
+{
+    std::cout << "\n=== Per-call latency: " << N_MSGS << " messages ===\n";
+    bench_timer_overhead();
+    bench_sync();
+    bench_async();
+
+    std::cout << "\n=== Overflow policies: 64 KiB ring, " << N_OVERFLOW << " message burst ===\n";
+    bench_overflow(ll_overflow_policy::drop, "policy drop  (ns)        ");
+    bench_overflow(ll_overflow_policy::count, "policy count (ns)        ");
+    bench_overflow(ll_overflow_policy::block, "policy block (ns)        ");
+}
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ll_bar_aggregator.hpp"
+
+/*
+ * Benchmark: OHLCV bars from trades across a large universe
+ *
+ * TICKS trades over SECONDS seconds on SYMBOLS symbols (popularity ~ 1/rank,
+ * Poisson arrivals, per-symbol random-walk prices in ticks). Tickers are
+ * 6-character strings; the dense-id path resolves them once per trade via
+ * ll_symbol_index.
+ *
+ * - ll_bar 1s (ids)      : ll_bar_aggregator fed dense ids
+ * - ll_bar 1s (tickers)  : + ll_symbol_index lookup per trade
+ * - ll_bar 1m            : direct 1m aggregation
+ * - ll_bar 1s -> 1m      : 1s aggregator, its batches resampled into 1m
+ * - hash map AoS 1s      : std::unordered_map<ticker, bar> per interval,
+ *                          rows copied out and transposed into the same
+ *                          columns, map cleared (nodes freed) per interval
+ *
+ * Then finalize alone: cost of closing one interval with 1% / 10% / 100%
+ * of the universe active. Results are cross-checked against the map.
+ */
+
+static constexpr std::uint32_t SYMBOLS = 10'000;
+static constexpr std::size_t TICKS = 10'000'000;
+static constexpr double SECONDS = 1800.0;
+static constexpr std::uint64_t SEC = 1'000'000'000ull;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+struct trade
+{
+    std::uint64_t ts;
+    std::uint32_t sym;
+    std::uint32_t qty;
+    std::int64_t price;
+};
+
+struct bar
+{
+    std::int64_t open, high, low, close, volume;
+    double notional;
+    std::uint32_t trades;
+};
+
+// checksum over emitted rows, to compare methods
+struct digest
+{
+    std::uint64_t rows = 0, volume = 0, mix = 0;
+    void add(const ll_bar_batch& b)
+    {
+        for (std::size_t r = 0; r < b.rows; ++r)
+        {
+            rows++;
+            volume += static_cast<std::uint64_t>(b.volume[r]);
+            mix += ll_hash_combine(ll_hash_combine(b.ts, b.symbol[r]),
+                                   static_cast<std::uint64_t>(b.open[r] ^ (b.high[r] << 1) ^ (b.low[r] << 2) ^
+                                                              (b.close[r] << 3)) + b.trades[r]);
+        }
+    }
+    bool operator==(const digest&) const = default;
+};
+
+static void line(const char* what, std::uint64_t ns, const digest& d)
+{
+    std::printf("%-22s %8.2f ns/tick %8.1f M ticks/s   %9llu bars\n", what, static_cast<double>(ns) / TICKS,
+                TICKS / (static_cast<double>(ns) / 1e3), static_cast<unsigned long long>(d.rows));
+}
+
+int main()
+{
+    std::mt19937_64 rng(5);
+    std::vector<double> cdf(SYMBOLS);
+    double acc = 0.0;
+    for (std::uint32_t i = 0; i < SYMBOLS; ++i) cdf[i] = acc += 1.0 / (i + 1);
+    std::uniform_real_distribution<double> u(0.0, acc);
+    std::exponential_distribution<double> gap(TICKS / SECONDS);
+    std::vector<std::int64_t> px(SYMBOLS);
+    for (auto& p : px) p = 10'000 + static_cast<std::int64_t>(rng() % 90'000);
+
+    std::vector<trade> ticks(TICKS);
+    double t = 0.0;
+    const std::uint64_t t0 = 1'700'000'000ull * SEC;
+    for (auto& k : ticks)
+    {
+        t += gap(rng);
+        k.ts = t0 + static_cast<std::uint64_t>(t * 1e9);
+        k.sym = static_cast<std::uint32_t>(std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin());
+        px[k.sym] = std::max<std::int64_t>(1, px[k.sym] + static_cast<std::int64_t>(rng() % 5) - 2);
+        k.price = px[k.sym];
+        k.qty = 1 + static_cast<std::uint32_t>(rng() % 500);
+    }
+    std::vector<std::uint64_t> key(SYMBOLS);
+    for (std::uint32_t i = 0; i < SYMBOLS; ++i)
+    {
+        char name[8];
+        std::snprintf(name, sizeof name, "S%05u", i);
+        key[i] = ll_symbol_key(name);
+    }
+
+    std::printf("\n=== Bars: %zu trades, %u symbols, %.0f s ===\n", TICKS, SYMBOLS, SECONDS);
+
+    // dense ids
+    digest d1;
+    {
+        ll_bar_aggregator agg(SYMBOLS, SEC);
+        const std::uint64_t ns = time_ns([&] {
+            for (const trade& k : ticks)
+                if (agg.on_trade(k.sym, k.ts, k.price, k.qty)) d1.add(agg.bars());
+            agg.flush();
+            d1.add(agg.bars());
+        });
+        line("ll_bar 1s (ids)", ns, d1);
+    }
+
+    // tickers through the dense index
+    digest d2;
+    {
+        ll_symbol_index index(SYMBOLS);
+        for (std::uint32_t i = 0; i < SYMBOLS; ++i) index.id(key[i]); // ids in the same order
+        ll_bar_aggregator agg(SYMBOLS, SEC);
+        const std::uint64_t ns = time_ns([&] {
+            for (const trade& k : ticks)
+                if (agg.on_trade(index.find(key[k.sym]), k.ts, k.price, k.qty)) d2.add(agg.bars());
+            agg.flush();
+            d2.add(agg.bars());
+        });
+        line("ll_bar 1s (tickers)", ns, d2);
+    }
+
+    // 1m direct vs resampled from 1s
+    digest d3, d4;
+    {
+        ll_bar_aggregator agg(SYMBOLS, 60 * SEC);
+        const std::uint64_t ns = time_ns([&] {
+            for (const trade& k : ticks)
+                if (agg.on_trade(k.sym, k.ts, k.price, k.qty)) d3.add(agg.bars());
+            agg.flush();
+            d3.add(agg.bars());
+        });
+        line("ll_bar 1m", ns, d3);
+    }
+    {
+        ll_bar_aggregator s1(SYMBOLS, SEC), m1(SYMBOLS, 60 * SEC);
+        const std::uint64_t ns = time_ns([&] {
+            for (const trade& k : ticks)
+                if (s1.on_trade(k.sym, k.ts, k.price, k.qty) && m1.on_bars(s1.bars())) d4.add(m1.bars());
+            s1.flush();
+            if (m1.on_bars(s1.bars())) d4.add(m1.bars());
+            m1.flush();
+            d4.add(m1.bars());
+        });
+        line("ll_bar 1s -> 1m", ns, d4);
+    }
+
+    // baseline: per-interval hash map of AoS bars keyed by ticker
+    digest d5;
+    {
+        std::unordered_map<std::uint64_t, std::uint32_t> id_of; // ticker -> id for the output column
+        for (std::uint32_t i = 0; i < SYMBOLS; ++i) id_of[key[i]] = i;
+        std::unordered_map<std::uint64_t, bar> open;
+        std::vector<std::pair<std::uint32_t, bar>> rows;
+        ll_bar_batch out;
+        out.reserve(SYMBOLS);
+        std::uint64_t start = 0;
+        bool any = false;
+        auto close_interval = [&] {
+            rows.clear();
+            for (const auto& [k, b] : open) rows.emplace_back(id_of[k], b);
+            std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            out.ts = start;
+            out.rows = rows.size();
+            for (std::size_t r = 0; r < rows.size(); ++r)
+            {
+                const bar& b = rows[r].second;
+                out.symbol[r] = rows[r].first;
+                out.open[r] = b.open;
+                out.high[r] = b.high;
+                out.low[r] = b.low;
+                out.close[r] = b.close;
+                out.volume[r] = b.volume;
+                out.vwap[r] = b.notional / static_cast<double>(b.volume);
+                out.trades[r] = b.trades;
+            }
+            d5.add(out);
+            open.clear();
+        };
+        const std::uint64_t ns = time_ns([&] {
+            for (const trade& k : ticks)
+            {
+                if (!any)
+                {
+                    start = k.ts - k.ts % SEC;
+                    any = true;
+                }
+                else if (k.ts - start >= SEC)
+                {
+                    close_interval();
+                    start = k.ts - k.ts % SEC;
+                }
+                auto [it, fresh] = open.try_emplace(key[k.sym]);
+                bar& b = it->second;
+                if (fresh) b = {k.price, k.price, k.price, k.price, 0, 0.0, 0};
+                b.high = std::max(b.high, k.price);
+                b.low = std::min(b.low, k.price);
+                b.close = k.price;
+                b.volume += k.qty;
+                b.notional += static_cast<double>(k.price) * k.qty;
+                ++b.trades;
+            }
+            close_interval();
+        });
+        line("hash map AoS 1s", ns, d5);
+    }
+    std::printf("outputs match: %s (1s), %s (1m direct vs resampled)\n", d1 == d2 && d1 == d5 ? "yes" : "NO",
+                d3 == d4 ? "yes" : "NO");
+
+    // finalize cost alone
+    std::printf("\nfinalize one interval (%u symbols):\n", SYMBOLS);
+    for (double frac : {0.01, 0.1, 1.0})
+    {
+        ll_bar_aggregator agg(SYMBOLS, SEC);
+        const auto active = static_cast<std::uint32_t>(SYMBOLS * frac);
+        std::uint64_t total = 0;
+        constexpr int REPS = 200;
+        for (int r = 0; r < REPS; ++r)
+        {
+            for (std::uint32_t s = 0; s < active; ++s)
+                agg.on_trade(static_cast<std::uint32_t>((s * 7919ull) % SYMBOLS), t0 + r * SEC, 100 + s, 1);
+            total += time_ns([&] { agg.flush(); });
+        }
+        std::printf("  %5.0f%% active: %8.2f us  (%zu rows)\n", frac * 100, static_cast<double>(total) / REPS / 1e3,
+                    agg.bars().rows);
+    }
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "ll_covariance.hpp"
+
+/*
+ * Benchmark: covariance / correlation of many return series
+ *
+ * SERIES daily return series (one market factor + idiosyncratic noise),
+ * WINDOW observations.
+ *
+ * - naive triple loop  : for i, for j >= i, for t over the row-major
+ *                        (time x series) returns, means subtracted inline
+ * - naive, transposed  : same after transposing to series-major, so the
+ *                        inner loop is a contiguous dot product
+ * - ll_covariance_matrix / ll_correlation_matrix (1 thread, all threads)
+ * The naive loops run on the first NAIVE_SERIES series (pairs scale as
+ * n^2, the full-size time is extrapolated) and are checked against the
+ * same sub-block of the blocked result.
+ *
+ * Rolling: ll_rolling_covariance over the same window, then PUSHED more
+ * rows pushed one at a time and in batches; compared with recomputing
+ * from scratch, and checked against a fresh one-shot on the final window.
+ */
+
+static constexpr std::size_t SERIES = 5000;
+static constexpr std::size_t WINDOW = 1000;
+static constexpr std::size_t PUSHED = 512;
+static constexpr std::size_t NAIVE_SERIES = 1000;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+static void naive_rowmajor(const double* x, std::size_t rows, std::size_t ld, std::size_t n, double* out)
+{
+    std::vector<double> mean(n, 0.0);
+    for (std::size_t t = 0; t < rows; ++t)
+        for (std::size_t j = 0; j < n; ++j) mean[j] += x[t * ld + j];
+    for (double& m : mean) m /= static_cast<double>(rows);
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = i; j < n; ++j)
+        {
+            double s = 0.0;
+            for (std::size_t t = 0; t < rows; ++t) s += (x[t * ld + i] - mean[i]) * (x[t * ld + j] - mean[j]);
+            out[i * n + j] = out[j * n + i] = s / static_cast<double>(rows - 1);
+        }
+}
+
+static void naive_transposed(const double* x, std::size_t rows, std::size_t ld, std::size_t n, double* out)
+{
+    std::vector<double> xt(n * rows);
+    for (std::size_t t = 0; t < rows; ++t)
+        for (std::size_t j = 0; j < n; ++j) xt[j * rows + t] = x[t * ld + j];
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        double m = 0.0;
+        for (std::size_t t = 0; t < rows; ++t) m += xt[j * rows + t];
+        m /= static_cast<double>(rows);
+        for (std::size_t t = 0; t < rows; ++t) xt[j * rows + t] -= m;
+    }
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = i; j < n; ++j)
+        {
+            const double* a = &xt[i * rows];
+            const double* b = &xt[j * rows];
+            double s = 0.0;
+            for (std::size_t t = 0; t < rows; ++t) s += a[t] * b[t];
+            out[i * n + j] = out[j * n + i] = s / static_cast<double>(rows - 1);
+        }
+}
+
+// max |a - b| over the leading m x m block of two matrices with strides la, lb
+static double max_diff(const double* a, std::size_t la, const double* b, std::size_t lb, std::size_t m)
+{
+    double d = 0.0;
+    for (std::size_t i = 0; i < m; ++i)
+        for (std::size_t j = 0; j < m; ++j) d = std::max(d, std::fabs(a[i * la + j] - b[i * lb + j]));
+    return d;
+}
+
+int main()
+{
+    const std::size_t total = WINDOW + PUSHED;
+    std::vector<double> x(total * SERIES);
+    {
+        std::mt19937_64 rng(3);
+        std::normal_distribution<double> nd(0.0, 1.0);
+        std::vector<double> beta(SERIES), vol(SERIES);
+        for (std::size_t j = 0; j < SERIES; ++j)
+        {
+            beta[j] = 0.5 + nd(rng) * 0.3;
+            vol[j] = 0.01 + 0.02 * std::fabs(nd(rng));
+        }
+        for (std::size_t t = 0; t < total; ++t)
+        {
+            const double f = 0.0004 + 0.01 * nd(rng);
+            for (std::size_t j = 0; j < SERIES; ++j) x[t * SERIES + j] = beta[j] * f + vol[j] * nd(rng);
+        }
+    }
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const double pairs = SERIES * (SERIES + 1) / 2.0;
+    const double flops = 2.0 * pairs * WINDOW;
+
+    std::printf("\n=== Covariance: %zu series x %zu observations (%u hardware threads) ===\n", SERIES, WINDOW, hw);
+    std::printf("%-34s %10s %9s\n", "method", "seconds", "GFLOP/s");
+    const auto row = [&](const char* name, double sec) {
+        std::printf("%-34s %10.3f %9.2f\n", name, sec, flops / sec / 1e9);
+    };
+
+    std::vector<double> cov(SERIES * SERIES), corr(SERIES * SERIES);
+    std::vector<double> naive(NAIVE_SERIES * NAIVE_SERIES), naive_t(NAIVE_SERIES * NAIVE_SERIES);
+    const double scale = static_cast<double>(SERIES) * SERIES / (static_cast<double>(NAIVE_SERIES) * NAIVE_SERIES);
+
+    const double t_naive = time_ns([&] { naive_rowmajor(x.data(), WINDOW, SERIES, NAIVE_SERIES, naive.data()); }) / 1e9;
+    const double t_naive_t = time_ns([&] { naive_transposed(x.data(), WINDOW, SERIES, NAIVE_SERIES, naive_t.data()); }) / 1e9;
+    char name[80];
+    std::snprintf(name, sizeof name, "naive triple loop (x%.0f of %zu)", scale, NAIVE_SERIES);
+    row(name, t_naive * scale);
+    std::snprintf(name, sizeof name, "naive, transposed (x%.0f of %zu)", scale, NAIVE_SERIES);
+    row(name, t_naive_t * scale);
+    // best of 2: the first call also pays the page faults of the output
+    const auto best = [](auto&& f) { return std::min(time_ns(f), time_ns(f)) / 1e9; };
+    const double t1 = best([&] { ll_covariance_matrix(x.data(), WINDOW, SERIES, cov.data(), 1); });
+    row("ll_covariance_matrix, 1 thread", t1);
+    std::snprintf(name, sizeof name, "ll_covariance_matrix, %u thread%s", hw, hw == 1 ? "" : "s");
+    row(name, best([&] { ll_covariance_matrix(x.data(), WINDOW, SERIES, cov.data(), hw); }));
+    row("ll_correlation_matrix", best([&] { ll_correlation_matrix(x.data(), WINDOW, SERIES, corr.data()); }));
+
+    double cmax = 0.0;
+    for (std::size_t i = 0; i < NAIVE_SERIES * NAIVE_SERIES; ++i) cmax = std::max(cmax, std::fabs(naive[i]));
+    std::printf("max |blocked - naive| %.1e (max |cov| %.1e), naive vs transposed %.1e\n",
+                max_diff(cov.data(), SERIES, naive.data(), NAIVE_SERIES, NAIVE_SERIES), cmax,
+                max_diff(naive.data(), NAIVE_SERIES, naive_t.data(), NAIVE_SERIES, NAIVE_SERIES));
+    double off = 0.0;
+    for (std::size_t i = 0; i < SERIES; ++i)
+        for (std::size_t j = 0; j < SERIES; ++j)
+            if (i != j) off += corr[i * SERIES + j];
+    std::printf("mean off-diagonal correlation %.3f, corr[0][0] = %.15f\n", off / (SERIES * (SERIES - 1.0)), corr[0]);
+
+    // rolling window
+    std::printf("\n=== Rolling window %zu, %zu series: %zu further rows ===\n", WINDOW, SERIES, PUSHED);
+    std::printf("%-34s %12s %12s\n", "update", "ms / row", "vs rebuild");
+    ll_rolling_covariance roll(SERIES, WINDOW);
+    const double t_fill = time_ns([&] { roll.push(x.data(), WINDOW); }) / 1e9;
+    std::printf("%-34s %12.3f %12s   (fill: %.3f s)\n", "rebuild (one-shot)", t1 * 1e3, "1x", t_fill);
+    std::size_t next = WINDOW;
+    for (auto [k, reps] : {std::pair<std::size_t, std::size_t>{1, 16}, {16, 4}, {64, 2}, {256, 1}}) // 464 rows
+    {
+        const double sec = time_ns([&] {
+            for (std::size_t r = 0; r < reps; ++r, next += k) roll.push(&x[next * SERIES], k);
+        }) / 1e9;
+        const double per_row = sec / static_cast<double>(reps * k);
+        std::snprintf(name, sizeof name, "push, %zu row%s per call", k, k == 1 ? "" : "s");
+        std::printf("%-34s %12.3f %11.0fx\n", name, per_row * 1e3, t1 / per_row);
+    }
+    ll_covariance_matrix(&x[(next - WINDOW) * SERIES], WINDOW, SERIES, cov.data());
+    roll.covariance(corr.data());
+    cmax = 0.0;
+    for (double v : cov) cmax = std::max(cmax, std::fabs(v));
+    std::printf("after %zu rows: max |rolling - one-shot| %.1e (max |cov| %.1e)", next - WINDOW,
+                max_diff(corr.data(), SERIES, cov.data(), SERIES, SERIES), cmax);
+    const double t_resync = time_ns([&] { roll.resync(); }) / 1e9;
+    roll.covariance(corr.data());
+    std::printf(", after resync (%.3f s) %.1e\n", t_resync, max_diff(corr.data(), SERIES, cov.data(), SERIES, SERIES));
+}
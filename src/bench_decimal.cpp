@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "ll_decimal.hpp"
+#include "ll_fast_parse.hpp"
+#include "ll_random.hpp"
+
+/*
+ * Benchmark: fixed-point decimal prices against double and __int128
+ *
+ * usage: bench_decimal [ops = 8388608]
+ *
+ * Prices are random at 4 decimal places in [1, 10000). Each timed loop
+ * runs over a 64k-element array (cache resident) until ops are done; ns
+ * per value, best of REPS.
+ * 1. Round to tick (ticks 0.0001, 0.0005, 0.0050, 0.0025 chosen at run
+ *    time), nearest, half away from zero:
+ *    - double  : std::round(p / tick) * tick
+ *    - double  : std::round(p * (1 / tick)) * tick
+ *    - int64   : (|p| + t/2) / t * t, hardware division
+ *    - __int128: the same in 128-bit (__divti3)
+ *    - ll_tick_size::round (multiply-shift magic)
+ *    plus how many double results differ from the exact answer.
+ * 2. Rescaled product at 8 places (price * fx rate): double multiply,
+ *    __int128 product / 10^8, ll_decimal64 * ll_decimal64 (precomputed
+ *    reciprocal, overflow-checked). Checked vs plain adds.
+ * 3. Text: parse "1234.5678" style prices with ll_parse_decimal,
+ *    ll_parse_double + from_double, std::from_chars + std::llround;
+ *    format with ll_format_decimal, std::to_chars(fixed, 4), snprintf.
+ */
+
+static constexpr unsigned REPS = 5;
+static constexpr std::size_t N = 1 << 16;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// f() does one pass over the N-element arrays. Passes repeat identical
+// work: the fence keeps the compiler from folding them into one
+template <class F>
+static double per_value(std::size_t ops, F&& f)
+{
+    const std::size_t passes = std::max<std::size_t>(1, ops / N);
+    std::uint64_t best = ~0ull;
+    for (unsigned r = 0; r < REPS; ++r)
+        best = std::min(best, time_ns([&] {
+                            for (std::size_t p = 0; p < passes; ++p)
+                            {
+                                f();
+                                std::atomic_signal_fence(std::memory_order_seq_cst);
+                            }
+                        }));
+    return static_cast<double>(best) / (passes * N);
+}
+
+using d4 = ll_decimal64<4>;
+using d8 = ll_decimal64<8>;
+using ll_decimal_detail::i128;
+using ll_decimal_detail::u128;
+
+static std::int64_t round_int64(std::int64_t p, std::int64_t t) noexcept
+{
+    const std::int64_t q = ((p < 0 ? -p : p) + t / 2) / t;
+    return (p < 0 ? -q : q) * t;
+}
+
+static std::int64_t round_i128(std::int64_t p, std::int64_t t) noexcept
+{
+    const i128 a = p < 0 ? -static_cast<i128>(p) : static_cast<i128>(p);
+    const i128 q = (a + t / 2) / t;
+    return static_cast<std::int64_t>((p < 0 ? -q : q) * t);
+}
+
+static void round_to_tick(std::size_t ops, const std::vector<std::int64_t>& raw, std::int64_t t)
+{
+    std::vector<double> pd(N), outd(N);
+    std::vector<std::int64_t> outi(N);
+    std::vector<d4> pdec(N), outdec(N);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        pd[i] = d4::from_raw(raw[i]).to_double();
+        pdec[i] = d4::from_raw(raw[i]);
+    }
+    const double tick = d4::from_raw(t).to_double();
+    const double inv = 1.0 / tick;
+    const ll_tick_size<4> ts(d4::from_raw(t));
+
+    const double ns_div = per_value(ops, [&] {
+        for (std::size_t i = 0; i < N; ++i) outd[i] = std::round(pd[i] / tick) * tick;
+    });
+    std::size_t bad_div = 0;
+    for (std::size_t i = 0; i < N; ++i) bad_div += d4::from_double(outd[i]) != ts.round(pdec[i]);
+    const double ns_mul = per_value(ops, [&] {
+        for (std::size_t i = 0; i < N; ++i) outd[i] = std::round(pd[i] * inv) * tick;
+    });
+    std::size_t bad_mul = 0;
+    for (std::size_t i = 0; i < N; ++i) bad_mul += d4::from_double(outd[i]) != ts.round(pdec[i]);
+    const double ns_i64 = per_value(ops, [&] {
+        for (std::size_t i = 0; i < N; ++i) outi[i] = round_int64(raw[i], t);
+    });
+    const double ns_i128 = per_value(ops, [&] {
+        for (std::size_t i = 0; i < N; ++i) outi[i] = round_i128(raw[i], t);
+    });
+    const double ns_ll = per_value(ops, [&] {
+        for (std::size_t i = 0; i < N; ++i) outdec[i] = ts.round(pdec[i]);
+    });
+    std::size_t bad_ll = 0;
+    for (std::size_t i = 0; i < N; ++i) bad_ll += outdec[i].raw() != round_int64(raw[i], t);
+
+    std::printf("%-8.4f %10.2f %6zu %10.2f %6zu %10.2f %10.2f %10.2f %6zu\n", tick, ns_div, bad_div, ns_mul, bad_mul, ns_i64,
+                ns_i128, ns_ll, bad_ll);
+}
+
+static void products(std::size_t ops)
+{
+    ll_xoshiro256pp g(8);
+    std::vector<d8> a(N), b(N), out(N);
+    std::vector<double> ad(N), bd(N), outd(N);
+    std::vector<std::int64_t> outi(N);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        a[i] = d8::from_raw(static_cast<std::int64_t>(ll_uniform_below(g, 1'000'000'000'000ull))); // [0, 10000)
+        b[i] = d8::from_raw(50'000'000 + static_cast<std::int64_t>(ll_uniform_below(g, 150'000'000))); // [0.5, 2)
+        ad[i] = a[i].to_double();
+        bd[i] = b[i].to_double();
+    }
+
+    std::printf("\n=== Product rescaled to 8 places (price * rate), ns per value, best of %u ===\n", REPS);
+    std::printf("%-44s %8s\n", "method", "ns");
+    std::printf("%-44s %8.2f\n", "double a * b", per_value(ops, [&] {
+                    for (std::size_t i = 0; i < N; ++i) outd[i] = ad[i] * bd[i];
+                }));
+    std::printf("%-44s %8.2f\n", "__int128 (a * b + 10^8 / 2) / 10^8", per_value(ops, [&] {
+                    for (std::size_t i = 0; i < N; ++i)
+                    {
+                        const i128 p = static_cast<i128>(a[i].raw()) * b[i].raw();
+                        const u128 m = p < 0 ? -static_cast<u128>(p) : static_cast<u128>(p);
+                        const std::int64_t q = static_cast<std::int64_t>((m + d8::unit / 2) / d8::unit);
+                        outi[i] = p < 0 ? -q : q;
+                    }
+                }));
+    std::printf("%-44s %8.2f\n", "ll_decimal64<8> * ll_decimal64<8> (checked)", per_value(ops, [&] {
+                    for (std::size_t i = 0; i < N; ++i) out[i] = a[i] * b[i];
+                }));
+    std::size_t bad = 0, off = 0;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        bad += out[i].raw() != outi[i];
+        off += d8::from_double(ad[i] * bd[i]) != out[i];
+    }
+    std::printf("ll_decimal64 vs __int128 mismatches: %zu; double products off by >= 1e-8 after rounding: %zu of %zu\n", bad,
+                off, N);
+
+    std::int64_t si = 0;
+    d8 sd;
+    double sf = 0.0;
+    std::printf("%-44s %8.2f\n", "int64 += (unchecked)", per_value(ops, [&] {
+                    std::int64_t x = 0;
+                    for (std::size_t i = 0; i < N; ++i) x += a[i].raw();
+                    si = x;
+                }));
+    std::printf("%-44s %8.2f\n", "ll_decimal64 += (checked)", per_value(ops, [&] {
+                    d8 x;
+                    for (std::size_t i = 0; i < N; ++i) x += a[i];
+                    sd = x;
+                }));
+    std::printf("%-44s %8.2f\n", "double +=", per_value(ops, [&] {
+                    double x = 0.0;
+                    for (std::size_t i = 0; i < N; ++i) x += ad[i];
+                    sf = x;
+                }));
+    std::printf("sums: %lld %lld %.1f\n", static_cast<long long>(si), static_cast<long long>(sd.raw()), sf);
+}
+
+static void text(std::size_t ops, const std::vector<std::int64_t>& raw)
+{
+    // "1234.5678", "12.5", "7.25": 1 to 4 decimals as a feed would print them
+    std::string buf;
+    std::vector<std::uint32_t> at(N + 1);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        at[i] = static_cast<std::uint32_t>(buf.size());
+        char tmp[32];
+        const int decimals = 1 + static_cast<int>(i % 4);
+        const std::int64_t cut = raw[i] - raw[i] % static_cast<std::int64_t>(ll_decimal_detail::pow10(4 - decimals));
+        char* e = ll_format_decimal(tmp, tmp + sizeof(tmp), d4::from_raw(cut)).ptr;
+        buf.append(tmp, static_cast<std::size_t>(e - tmp - (4 - decimals)));
+        buf.push_back(',');
+    }
+    at[N] = static_cast<std::uint32_t>(buf.size());
+    const char* s = buf.data();
+    std::vector<d4> out(N);
+    std::vector<d4> ref(N);
+    for (std::size_t i = 0; i < N; ++i) ll_parse_decimal(s + at[i], s + at[i + 1] - 1, ref[i]);
+
+    std::printf("\n=== Text: %zu prices like \"%.*s\", ns per value, best of %u ===\n", N,
+                static_cast<int>(at[1] - at[0] - 1), s, REPS);
+    std::printf("%-44s %8s %10s\n", "method", "ns", "mismatch");
+    auto parse_row = [&](const char* name, auto&& one) {
+        const double ns = per_value(ops, [&] {
+            for (std::size_t i = 0; i < N; ++i) out[i] = one(s + at[i], s + at[i + 1] - 1);
+        });
+        std::size_t bad = 0;
+        for (std::size_t i = 0; i < N; ++i) bad += out[i] != ref[i];
+        std::printf("%-44s %8.2f %10zu\n", name, ns, bad);
+    };
+    parse_row("ll_parse_decimal", [](const char* b, const char* e) {
+        d4 v;
+        ll_parse_decimal(b, e, v);
+        return v;
+    });
+    parse_row("ll_parse_double + from_double", [](const char* b, const char* e) {
+        double v = 0;
+        ll_parse_double(b, e, v);
+        return d4::from_double(v);
+    });
+    parse_row("std::from_chars(double) + std::llround", [](const char* b, const char* e) {
+        double v = 0;
+        std::from_chars(b, e, v);
+        return d4::from_raw(std::llround(v * 1e4));
+    });
+
+    char o[32];
+    std::uint64_t len = 0;
+    std::printf("%-44s %8.2f\n", "ll_format_decimal", per_value(ops / 4, [&] {
+                    for (std::size_t i = 0; i < N; ++i) len += ll_format_decimal(o, o + sizeof(o), ref[i]).ptr - o;
+                }));
+    std::vector<double> refd(N);
+    for (std::size_t i = 0; i < N; ++i) refd[i] = ref[i].to_double();
+    std::printf("%-44s %8.2f\n", "std::to_chars(double, fixed, 4)", per_value(ops / 4, [&] {
+                    for (std::size_t i = 0; i < N; ++i)
+                        len += std::to_chars(o, o + sizeof(o), refd[i], std::chars_format::fixed, 4).ptr - o;
+                }));
+    std::printf("%-44s %8.2f\n", "snprintf(\"%.4f\")", per_value(ops / 4, [&] {
+                    for (std::size_t i = 0; i < N; ++i) len += std::snprintf(o, sizeof(o), "%.4f", refd[i]);
+                }));
+    std::printf("(%llu bytes formatted)\n", static_cast<unsigned long long>(len));
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1u << 23);
+
+    ll_xoshiro256pp g(125);
+    std::vector<std::int64_t> raw(N);
+    for (auto& r : raw) r = 10'000 + static_cast<std::int64_t>(ll_uniform_below(g, 99'990'000)); // [1, 10000) at 4 places
+
+    std::printf("\n=== Round to tick, nearest (half away from zero): ns per value, best of %u; 'off' = results that differ from exact ===\n",
+                REPS);
+    std::printf("%-8s %10s %6s %10s %6s %10s %10s %10s %6s\n", "tick", "dbl /tick", "off", "dbl *inv", "off", "int64 /",
+                "int128 /", "ll_tick", "off");
+    volatile std::int64_t ticks[] = {1, 5, 50, 25};
+    for (std::int64_t t : ticks) round_to_tick(ops, raw, t);
+
+    products(ops);
+    text(ops, raw);
+    return 0;
+}
@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "ll_graph.hpp"
+
+/*
+ * Benchmark: CSR graph vs std::vector adjacency lists
+ *
+ * usage: bench_graph [scale = 21] [edge factor = 8] [threads = 4]
+ *
+ * Graph: R-MAT (Graph500 parameters a = 0.57, b = c = 0.19), 2^scale
+ * vertices, edge factor x 2^scale undirected edges, vertex ids randomly
+ * permuted so hubs are spread over the id space. Power-law degrees, one
+ * giant component plus many isolated vertices.
+ *
+ * - build      : std::vector<std::vector<uint32_t>> (push_back both
+ *                directions, then sort + unique each list) vs ll_csr_graph
+ *                with 1 and THREADS threads (results must be identical);
+ *                BUILD_REPS rounds, first (cold memory) and best reported
+ * - BFS        : SOURCES random non-isolated sources; top-down on the
+ *                adjacency lists, top-down on CSR, direction-optimizing on
+ *                CSR. Every CSR parent tree is checked against the baseline
+ *                depths (same reach, parent one level up and adjacent).
+ *                TEPS = undirected edges in the reached component / time
+ * - components : BFS labelling on the adjacency lists vs union-find on CSR
+ *                (sequential, and lock-free with THREADS threads)
+ */
+
+static constexpr unsigned SOURCES = 16;
+static constexpr unsigned BUILD_REPS = 3;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+static std::uint64_t splitmix(std::uint64_t& s)
+{
+    std::uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static std::vector<ll_edge> rmat(unsigned scale, std::size_t m, std::uint64_t seed)
+{
+    // 16-bit thresholds for quadrants a | b | c | d
+    constexpr std::uint32_t qa = 37355, qb = qa + 12452, qc = qb + 12452;
+    std::vector<ll_edge> e(m);
+    std::uint64_t s = seed;
+    for (ll_edge& x : e)
+    {
+        ll_vertex u = 0, v = 0;
+        std::uint64_t bits = 0;
+        for (unsigned l = 0; l < scale; ++l)
+        {
+            if (l % 4 == 0) bits = splitmix(s);
+            const std::uint32_t r = static_cast<std::uint32_t>(bits & 0xFFFF);
+            bits >>= 16;
+            u = u << 1 | (r >= qb);
+            v = v << 1 | ((r >= qa && r < qb) || r >= qc);
+        }
+        x = {u, v};
+    }
+    std::vector<ll_vertex> perm(std::size_t{1} << scale);
+    std::iota(perm.begin(), perm.end(), ll_vertex{0});
+    std::shuffle(perm.begin(), perm.end(), std::mt19937_64(seed));
+    for (ll_edge& x : e) x = {perm[x.from], perm[x.to]};
+    return e;
+}
+
+using adjacency = std::vector<std::vector<ll_vertex>>;
+
+static adjacency build_lists(std::size_t n, const std::vector<ll_edge>& edges)
+{
+    adjacency a(n);
+    for (const ll_edge& e : edges)
+    {
+        a[e.from].push_back(e.to);
+        a[e.to].push_back(e.from);
+    }
+    for (std::size_t v = 0; v < n; ++v)
+    {
+        auto& l = a[v];
+        std::sort(l.begin(), l.end());
+        l.erase(std::unique(l.begin(), l.end()), l.end());
+        l.erase(std::remove(l.begin(), l.end(), static_cast<ll_vertex>(v)), l.end());
+    }
+    return a;
+}
+
+// top-down BFS over adjacency lists; depth, -1 = unreached
+static std::vector<std::int32_t> bfs_lists(const adjacency& a, ll_vertex src)
+{
+    std::vector<std::int32_t> depth(a.size(), -1);
+    std::vector<ll_vertex> q{src};
+    depth[src] = 0;
+    for (std::size_t h = 0; h < q.size(); ++h)
+    {
+        const ll_vertex u = q[h];
+        for (ll_vertex v : a[u])
+            if (depth[v] < 0)
+            {
+                depth[v] = depth[u] + 1;
+                q.push_back(v);
+            }
+    }
+    return depth;
+}
+
+static std::size_t components_lists(const adjacency& a, std::vector<ll_vertex>& label)
+{
+    label.assign(a.size(), ll_no_vertex);
+    std::vector<ll_vertex> q;
+    std::size_t count = 0;
+    for (std::size_t s = 0; s < a.size(); ++s)
+    {
+        if (label[s] != ll_no_vertex) continue;
+        ++count;
+        q.assign(1, static_cast<ll_vertex>(s));
+        label[s] = static_cast<ll_vertex>(s);
+        for (std::size_t h = 0; h < q.size(); ++h)
+            for (ll_vertex v : a[q[h]])
+                if (label[v] == ll_no_vertex)
+                {
+                    label[v] = static_cast<ll_vertex>(s);
+                    q.push_back(v);
+                }
+    }
+    return count;
+}
+
+static bool check_tree(const ll_csr_graph& g, const ll_bfs_result& r, const std::vector<std::int32_t>& depth, ll_vertex src)
+{
+    std::size_t reached = 0;
+    for (std::size_t v = 0; v < g.vertices(); ++v)
+    {
+        const ll_vertex p = r.parent[v];
+        if ((p == ll_no_vertex) != (depth[v] < 0)) return false;
+        if (p == ll_no_vertex) continue;
+        ++reached;
+        if (v == src) continue;
+        const auto nb = g.neighbours(static_cast<ll_vertex>(v));
+        if (depth[p] != depth[v] - 1 || !std::binary_search(nb.begin(), nb.end(), p)) return false;
+    }
+    return reached == r.visited && r.parent[src] == src;
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned scale = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)) : 21;
+    const std::size_t factor = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8;
+    const unsigned threads = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 4;
+    const std::size_t n = std::size_t{1} << scale;
+
+    std::vector<ll_edge> edges;
+    const std::uint64_t tgen = time_ns([&] { edges = rmat(scale, factor * n, 42); });
+    std::printf("\n=== R-MAT scale %u: %zu vertices, %zu input edges (generated in %.2f s) ===\n", scale, n,
+                edges.size(), tgen / 1e9);
+
+    // freed blocks stay in the process: on this VM fresh pages cost up to
+    // ~10 s/GB to fault in and would otherwise dominate every build
+    mallopt(M_MMAP_THRESHOLD, 1 << 30);
+    mallopt(M_TRIM_THRESHOLD, -1);
+
+    adjacency lists;
+    ll_csr_graph g1, gt;
+    std::uint64_t cold[3] = {}, best[3] = {~0ull, ~0ull, ~0ull};
+    for (unsigned rep = 0; rep < BUILD_REPS; ++rep)
+    {
+        const std::uint64_t ns[3] = {
+            time_ns([&] { lists = build_lists(n, edges); }),
+            time_ns([&] { g1 = ll_csr_graph(n, edges, {true, true, 1}); }),
+            time_ns([&] { gt = ll_csr_graph(n, edges, {true, true, threads}); })};
+        for (int k = 0; k < 3; ++k)
+        {
+            if (rep == 0) cold[k] = ns[k];
+            best[k] = std::min(best[k], ns[k]);
+        }
+        if (rep + 1 < BUILD_REPS)
+        {
+            lists = {};
+            g1 = {};
+            gt = {};
+        }
+    }
+    const bool same = g1.edges() == gt.edges() &&
+                      std::equal(g1.offsets(), g1.offsets() + n + 1, gt.offsets()) &&
+                      std::equal(g1.targets(), g1.targets() + g1.edges(), gt.targets());
+    edges = {};
+    gt = {};
+
+    std::size_t list_bytes = n * sizeof(std::vector<ll_vertex>), isolated = 0, max_deg = 0;
+    for (const auto& l : lists)
+    {
+        list_bytes += l.capacity() * sizeof(ll_vertex);
+        isolated += l.empty();
+        max_deg = std::max(max_deg, l.size());
+    }
+    std::printf("after dedupe: %zu directed edges, max degree %zu, %zu isolated vertices\n", g1.edges(), max_deg,
+                isolated);
+    std::printf("\n%-34s %10s %10s %12s\n", "build (seconds)", "first run", "best", "memory");
+    std::printf("%-34s %10.3f %10.3f %9.0f MB\n", "vector<vector<uint32_t>>", cold[0] / 1e9, best[0] / 1e9,
+                list_bytes / 1048576.0);
+    std::printf("%-34s %10.3f %10.3f %9.0f MB\n", "ll_csr_graph, 1 thread", cold[1] / 1e9, best[1] / 1e9,
+                g1.memory_bytes() / 1048576.0);
+    char name[40];
+    std::snprintf(name, sizeof name, "ll_csr_graph, %u threads", threads);
+    std::printf("%-34s %10.3f %10.3f   identical: %s\n", name, cold[2] / 1e9, best[2] / 1e9, same ? "yes" : "NO");
+
+    // BFS
+    std::vector<ll_vertex> sources;
+    std::mt19937_64 rng(7);
+    while (sources.size() < SOURCES)
+    {
+        const ll_vertex s = static_cast<ll_vertex>(rng() % n);
+        if (g1.degree(s)) sources.push_back(s);
+    }
+    struct row
+    {
+        char name[40];
+        std::uint64_t ns = 0;
+        std::uint64_t examined = 0;
+        unsigned bu = 0, levels = 0;
+    };
+    row rows[4] = {{"vector<vector>, top-down"}, {"CSR top-down, 1 thread"}, {"CSR direction-opt, 1 thread"}, {}};
+    std::snprintf(rows[3].name, sizeof rows[3].name, "CSR direction-opt, %u threads", threads);
+    std::uint64_t teps_edges = 0;
+    bool ok = true;
+    for (ll_vertex s : sources)
+    {
+        std::vector<std::int32_t> depth;
+        rows[0].ns += time_ns([&] { depth = bfs_lists(lists, s); });
+        std::uint64_t deg = 0;
+        for (std::size_t v = 0; v < n; ++v)
+            if (depth[v] >= 0) deg += g1.degree(static_cast<ll_vertex>(v));
+        teps_edges += deg / 2;
+        rows[0].examined += deg;
+
+        const ll_bfs_options opts[3] = {{1, false}, {1, true}, {threads, true}};
+        for (int k = 0; k < 3; ++k)
+        {
+            ll_bfs_result r;
+            rows[k + 1].ns += time_ns([&] { r = ll_bfs(g1, s, opts[k]); });
+            rows[k + 1].examined += r.edges_examined;
+            rows[k + 1].bu += r.bottom_up_levels;
+            rows[k + 1].levels += r.levels;
+            ok &= check_tree(g1, r, depth, s);
+        }
+    }
+    std::printf("\n=== BFS, %u sources, mean per search (%.1f M edges reached) ===\n", SOURCES,
+                teps_edges / 1e6 / SOURCES);
+    std::printf("%-34s %10s %10s %12s %14s\n", "method", "ms", "MTEPS", "edges seen", "bottom-up lvl");
+    for (const row& r : rows)
+    {
+        std::printf("%-34s %10.2f %10.1f %10.1f M", r.name, r.ns / 1e6 / SOURCES,
+                    teps_edges * 1e3 / static_cast<double>(r.ns), r.examined / 1e6 / SOURCES);
+        if (r.levels)
+            std::printf(" %8.1f / %.1f", static_cast<double>(r.bu) / SOURCES, static_cast<double>(r.levels) / SOURCES);
+        std::printf("\n");
+    }
+    std::printf("parent trees valid: %s\n", ok ? "yes" : "NO");
+
+    // connected components
+    std::vector<ll_vertex> label;
+    std::size_t cl = 0;
+    ll_components cc;
+    const std::uint64_t tcl = time_ns([&] { cl = components_lists(lists, label); });
+    ll_components ccp;
+    const std::uint64_t tcc = time_ns([&] { cc = ll_connected_components(g1); });
+    const std::uint64_t tcp = time_ns([&] { ccp = ll_connected_components(g1, threads); });
+    // same partition: representatives map one-to-one
+    auto agrees = [&](const ll_components& c)
+    {
+        std::vector<ll_vertex> map(n, ll_no_vertex);
+        if (c.count != cl) return false;
+        for (std::size_t v = 0; v < n; ++v)
+        {
+            ll_vertex& m = map[label[v]];
+            if (m == ll_no_vertex) m = c.label[v];
+            if (m != c.label[v]) return false;
+        }
+        return true;
+    };
+    const bool agree = agrees(cc) && agrees(ccp);
+    std::printf("\n=== Connected components ===\n");
+    std::printf("%-34s %10s %12s\n", "method", "ms", "components");
+    std::printf("%-34s %10.1f %12zu\n", "BFS labelling, vector<vector>", tcl / 1e6, cl);
+    std::printf("%-34s %10.1f %12zu\n", "union-find on CSR, 1 thread", tcc / 1e6, cc.count);
+    std::snprintf(name, sizeof name, "lock-free union-find, %u threads", threads);
+    std::printf("%-34s %10.1f %12zu\n", name, tcp / 1e6, ccp.count);
+    std::printf("same partition: %s\n", agree ? "yes" : "NO");
+    return ok && same && agree ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "ll_json.hpp"
+
+/*
+ * Benchmark: on-demand SIMD JSON vs a conventional DOM parser
+ *
+ * Input: generated reference-data snapshot — an array of instrument objects
+ * (symbol, isin, venue, currency, tick size, lot size, price, flags, tags,
+ * free-text description with escapes). Same records again as NDJSON.
+ *
+ * Query: sum of "price" and count of "active" instruments.
+ * - stage 1 only  : structural index
+ * - on-demand     : index + lazy walk touching two fields per record
+ * - DOM           : recursive descent building std::vector / std::string nodes,
+ *                   then the same query over the tree
+ * - NDJSON        : parse_many() over 1 MiB windows
+ *
+ * Usage: bench_json_ondemand [megabytes]   (default 64)
+ */
+
+using clk = std::chrono::steady_clock;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = clk::now();
+    f();
+    auto end = clk::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Data generation
+
+struct lcg
+{
+    std::uint64_t s;
+    std::uint64_t next()
+    {
+        s = s * 6364136223846793005ull + 1442695040888963407ull;
+        return s >> 33;
+    }
+};
+
+static void append_record(std::string& out, std::uint64_t i, lcg& r)
+{
+    static const char* venues[] = {"XNAS", "XNYS", "ARCX", "BATS", "XLON", "XETR"};
+    static const char* ccys[] = {"USD", "EUR", "GBP", "JPY"};
+    char buf[512];
+    const int n = std::snprintf(
+        buf, sizeof(buf),
+        "{\"symbol\":\"SYM%06llu\",\"isin\":\"US%010llu\",\"venue\":\"%s\",\"currency\":\"%s\","
+        "\"tick_size\":%s,\"lot_size\":%llu,\"price\":%llu.%02llu,\"active\":%s,"
+        "\"tags\":[\"equity\",\"tier%llu\"],\"meta\":{\"sector\":%llu,\"adv\":%llu},"
+        "\"description\":\"Instrument %llu \\\"common\\\" share class\\n\"}",
+        static_cast<unsigned long long>(i), static_cast<unsigned long long>(r.next() % 10000000000ull),
+        venues[r.next() % 6], ccys[r.next() % 4], (r.next() & 1) ? "0.01" : "0.0001",
+        static_cast<unsigned long long>(1 + r.next() % 1000), static_cast<unsigned long long>(r.next() % 5000),
+        static_cast<unsigned long long>(r.next() % 100), (r.next() % 10) ? "true" : "false",
+        static_cast<unsigned long long>(r.next() % 3), static_cast<unsigned long long>(r.next() % 11),
+        static_cast<unsigned long long>(r.next() % 100000000), static_cast<unsigned long long>(i));
+    out.append(buf, static_cast<std::size_t>(n));
+}
+
+// Conventional DOM baseline
+
+struct dom_node
+{
+    using object = std::vector<std::pair<std::string, dom_node>>;
+    using array = std::vector<dom_node>;
+    std::variant<std::nullptr_t, bool, double, std::string, array, object> v;
+
+    const dom_node* find(std::string_view key) const
+    {
+        for (const auto& [k, n] : std::get<object>(v))
+            if (k == key) return &n;
+        return nullptr;
+    }
+};
+
+class dom_parser
+{
+    const char* p_;
+    const char* end_;
+
+    void ws()
+    {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+    }
+    std::string str()
+    {
+        std::string s;
+        ++p_;
+        while (*p_ != '"')
+        {
+            if (*p_ == '\\')
+            {
+                ++p_;
+                switch (*p_)
+                {
+                case 'n': s.push_back('\n'); break;
+                case 't': s.push_back('\t'); break;
+                case 'r': s.push_back('\r'); break;
+                case 'b': s.push_back('\b'); break;
+                case 'f': s.push_back('\f'); break;
+                default: s.push_back(*p_); break; // \" \\ \/ (\u not needed here)
+                }
+                ++p_;
+            }
+            else
+            {
+                s.push_back(*p_++);
+            }
+        }
+        ++p_;
+        return s;
+    }
+
+public:
+    dom_parser(const char* p, std::size_t n) : p_(p), end_(p + n) {}
+
+    dom_node value()
+    {
+        ws();
+        dom_node n;
+        switch (*p_)
+        {
+        case '{':
+        {
+            dom_node::object o;
+            ++p_;
+            ws();
+            if (*p_ == '}') ++p_;
+            else
+                for (;;)
+                {
+                    ws();
+                    std::string k = str();
+                    ws();
+                    ++p_; // ':'
+                    o.emplace_back(std::move(k), value());
+                    ws();
+                    if (*p_++ == '}') break;
+                }
+            n.v = std::move(o);
+            break;
+        }
+        case '[':
+        {
+            dom_node::array a;
+            ++p_;
+            ws();
+            if (*p_ == ']') ++p_;
+            else
+                for (;;)
+                {
+                    a.push_back(value());
+                    ws();
+                    if (*p_++ == ']') break;
+                }
+            n.v = std::move(a);
+            break;
+        }
+        case '"': n.v = str(); break;
+        case 't': n.v = true; p_ += 4; break;
+        case 'f': n.v = false; p_ += 5; break;
+        case 'n': n.v = nullptr; p_ += 4; break;
+        default:
+        {
+            double d;
+            p_ = std::from_chars(p_, end_, d).ptr;
+            n.v = d;
+        }
+        }
+        return n;
+    }
+};
+
+static void report(const char* name, uint64_t ns, std::size_t bytes)
+{
+    std::cout << name << static_cast<double>(ns) / 1e6 << " ms, "
+              << static_cast<double>(bytes) / static_cast<double>(ns) << " GB/s\n";
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t target = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64) << 20;
+
+    std::string json, ndjson;
+    json.reserve(target + 4096);
+    ndjson.reserve(target + 4096);
+    lcg r{42};
+    std::size_t records = 0;
+    json.push_back('[');
+    while (json.size() < target)
+    {
+        if (records) json.push_back(',');
+        json.push_back('\n');
+        const std::size_t start = json.size();
+        append_record(json, records, r);
+        ndjson.append(json, start, json.size() - start);
+        ndjson.push_back('\n');
+        ++records;
+    }
+    json.append("\n]");
+
+    std::cout << "\n=== Reference data: " << records << " records, " << (json.size() >> 20) << " MiB ===\n";
+
+    ll_json_parser parser;
+    double sum = 0;
+    std::size_t active = 0;
+
+    parser.index_only(json); // warm: sizes the index buffers once
+    std::size_t structurals = 0;
+    uint64_t t = time_ns([&] { structurals = parser.index_only(json); });
+    report("stage 1 index   : ", t, json.size());
+    std::cout << "  structurals: " << structurals << "\n";
+
+    t = time_ns([&]
+    {
+        ll_json_value root = parser.parse(json);
+        for (ll_json_value inst : root.get_array())
+        {
+            sum += inst["price"].get_double();
+            active += inst["active"].get_bool();
+        }
+    });
+    report("on-demand query : ", t, json.size());
+    std::cout << "  sum(price)=" << static_cast<std::uint64_t>(sum) << " active=" << active << "\n";
+
+    double dsum = 0;
+    std::size_t dactive = 0;
+    t = time_ns([&]
+    {
+        dom_parser dp(json.data(), json.size());
+        dom_node root = dp.value();
+        for (const dom_node& inst : std::get<dom_node::array>(root.v))
+        {
+            dsum += std::get<double>(inst.find("price")->v);
+            dactive += std::get<bool>(inst.find("active")->v);
+        }
+    });
+    report("DOM parse+query : ", t, json.size());
+    std::cout << "  sum(price)=" << static_cast<std::uint64_t>(dsum) << " active=" << dactive << "\n";
+
+    std::cout << "\n=== NDJSON: " << records << " lines, " << (ndjson.size() >> 20) << " MiB ===\n";
+    sum = 0;
+    active = 0;
+    std::size_t docs = 0;
+    t = time_ns([&]
+    {
+        docs = parser.parse_many(ndjson, [&](ll_json_value inst)
+        {
+            sum += inst["price"].get_double();
+            active += inst["active"].get_bool();
+        });
+    });
+    report("parse_many query: ", t, ndjson.size());
+    std::cout << "  docs=" << docs << " sum(price)=" << static_cast<std::uint64_t>(sum) << " active=" << active << "\n";
+
+    std::cout << "\n=== Lazy access sample ===\n";
+    {
+        ll_json_value root = parser.parse(json);
+        ll_json_value first = *root.get_array().begin();
+        std::string scratch;
+        std::cout << "symbol=" << first["symbol"].get_raw_string()
+                  << " lot_size=" << first["lot_size"].get_uint64()
+                  << " tags=" << first["tags"].get_array().size()
+                  << " meta=" << first["meta"].raw_json() << "\n"
+                  << "description=" << first["description"].get_string(scratch);
+    }
+}
@@ -0,0 +1,378 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "ll_l2_book.hpp"
+#include "ll_latency_histogram.hpp"
+
+/*
+ * Benchmark: incremental L2 aggregation + delta publication vs recomputation
+ *
+ * Event stream: adds around a mid that wanders by a tick (distance from the
+ * touch is geometric, mean 16 levels, so a good part of the book lies
+ * outside the published window), cancels of
+ * random live orders, partial executions and quantity modifies, with the
+ * live order count held around LIVE_ORDERS.
+ *
+ * - full recompute : order map updated, then the top 10 of each side rebuilt
+ *                    from every live order (what we do today)
+ * - level map      : std::map<price, level> per side kept incrementally, top
+ *                    10 copied out and published through the same seqlock
+ *                    after every event (no dirty tracking, no deltas)
+ * - ll_l2_book     : incremental levels, dirty window tracking, O(depth)
+ *                    delta diff, seqlock publication when the window changed
+ *
+ * Every method produces a top-10 snapshot after every event; they are
+ * cross-checked at intervals.
+ *
+ * Usage: bench_l2_book [events]   (default 2000000)
+ */
+
+static constexpr std::size_t DEPTH = 10;
+static constexpr std::size_t LIVE_ORDERS = 20000;
+static constexpr std::size_t RECOMPUTE_EVENTS = 5000; // the baseline is too slow for the full stream
+
+using clk = std::chrono::steady_clock;
+using book_t = ll_l2_book<DEPTH>;
+using snap_t = book_t::snapshot;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = clk::now();
+    f();
+    auto end = clk::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Event stream
+// Adds are placed relative to a mid that moves by at most a tick, so the book
+// never crosses (the stream has no matching engine).
+
+struct event
+{
+    char type; // 'A' add, 'X' cancel, 'E' execute (reduce), 'M' modify qty
+    ll_side side;
+    std::uint64_t id;
+    std::int64_t price;
+    std::uint64_t qty;
+};
+
+static std::vector<event> make_events(std::size_t n)
+{
+    std::vector<event> ev;
+    ev.reserve(n);
+    struct live
+    {
+        std::uint64_t id;
+        ll_side side;
+        std::int64_t price;
+        std::uint64_t qty;
+    };
+    std::vector<live> orders;
+    std::uint64_t s = 0x9E3779B97F4A7C15ull, next_id = 1;
+    auto rnd = [&s] {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return s;
+    };
+    std::int64_t mid = 100000;
+
+    while (ev.size() < n)
+    {
+        const std::uint64_t r = rnd();
+        if (r % 256 == 0) mid = 100000 + static_cast<std::int64_t>((r >> 8) % 3) - 1; // touch moves, book does not cross
+        const unsigned kind = static_cast<unsigned>((r >> 16) % 100);
+
+        if (orders.size() < LIVE_ORDERS / 2 || (kind < 50 && orders.size() < LIVE_ORDERS))
+        {
+            const ll_side side = (r >> 24) & 1 ? ll_side::bid : ll_side::ask;
+            std::int64_t dist = 1;
+            while (dist < 200 && (rnd() & 15) != 0) ++dist; // geometric, mean ~16 levels
+            const std::int64_t price = side == ll_side::bid ? mid - 1 - dist : mid + 1 + dist;
+            const std::uint64_t qty = 100 * (1 + (r >> 32) % 10);
+            orders.push_back({next_id, side, price, qty});
+            ev.push_back({'A', side, next_id++, price, qty});
+            continue;
+        }
+        const std::size_t k = static_cast<std::size_t>(rnd() % orders.size());
+        live& o = orders[k];
+        if (kind < 85)
+        {
+            ev.push_back({'X', o.side, o.id, o.price, 0});
+            o = orders.back();
+            orders.pop_back();
+        }
+        else if (kind < 95)
+        {
+            const std::uint64_t q = o.qty > 100 ? 100 : o.qty;
+            ev.push_back({'E', o.side, o.id, o.price, q});
+            o.qty -= q;
+            if (o.qty == 0)
+            {
+                o = orders.back();
+                orders.pop_back();
+            }
+        }
+        else
+        {
+            o.qty = 100 * (1 + rnd() % 10);
+            ev.push_back({'M', o.side, o.id, o.price, o.qty});
+        }
+    }
+    return ev;
+}
+
+// Baselines
+
+struct order_rec
+{
+    std::int64_t price;
+    std::uint64_t qty;
+    ll_side side;
+};
+
+static void apply_orders(std::unordered_map<std::uint64_t, order_rec>& m, const event& e)
+{
+    switch (e.type)
+    {
+    case 'A': m.emplace(e.id, order_rec{e.price, e.qty, e.side}); break;
+    case 'X': m.erase(e.id); break;
+    case 'E':
+    {
+        auto it = m.find(e.id);
+        if ((it->second.qty -= e.qty) == 0) m.erase(it);
+        break;
+    }
+    case 'M': m[e.id].qty = e.qty; break;
+    }
+}
+
+static void recompute(const std::unordered_map<std::uint64_t, order_rec>& orders, snap_t& out)
+{
+    std::map<std::int64_t, ll_l2_level, std::greater<>> bids;
+    std::map<std::int64_t, ll_l2_level> asks;
+    for (const auto& [id, o] : orders)
+    {
+        ll_l2_level& l = o.side == ll_side::bid ? bids[o.price] : asks[o.price];
+        l.price = o.price;
+        l.qty += o.qty;
+        ++l.orders;
+    }
+    out = snap_t{};
+    for (const auto& [p, l] : bids)
+        if (out.bid_levels < DEPTH) out.bids[out.bid_levels++] = l;
+    for (const auto& [p, l] : asks)
+        if (out.ask_levels < DEPTH) out.asks[out.ask_levels++] = l;
+}
+
+struct level_map_book
+{
+    std::unordered_map<std::uint64_t, order_rec> orders;
+    std::map<std::int64_t, ll_l2_level, std::greater<>> bids;
+    std::map<std::int64_t, ll_l2_level> asks;
+
+    template <typename M>
+    static void sub(M& m, std::int64_t price, std::uint64_t qty, bool gone)
+    {
+        auto it = m.find(price);
+        it->second.qty -= qty;
+        it->second.orders -= gone;
+        if (it->second.orders == 0) m.erase(it);
+    }
+
+    void apply(const event& e)
+    {
+        auto level_sub = [&](const order_rec& o, std::uint64_t qty, bool gone)
+        {
+            if (o.side == ll_side::bid) sub(bids, o.price, qty, gone);
+            else sub(asks, o.price, qty, gone);
+        };
+        switch (e.type)
+        {
+        case 'A':
+        {
+            orders.emplace(e.id, order_rec{e.price, e.qty, e.side});
+            ll_l2_level& l = e.side == ll_side::bid ? bids[e.price] : asks[e.price];
+            l.price = e.price;
+            l.qty += e.qty;
+            ++l.orders;
+            break;
+        }
+        case 'X':
+        {
+            auto it = orders.find(e.id);
+            level_sub(it->second, it->second.qty, true);
+            orders.erase(it);
+            break;
+        }
+        case 'E':
+        {
+            auto it = orders.find(e.id);
+            it->second.qty -= e.qty;
+            level_sub(it->second, e.qty, it->second.qty == 0);
+            if (it->second.qty == 0) orders.erase(it);
+            break;
+        }
+        case 'M':
+        {
+            order_rec& o = orders[e.id];
+            ll_l2_level& l = o.side == ll_side::bid ? bids[o.price] : asks[o.price];
+            l.qty = l.qty - o.qty + e.qty;
+            o.qty = e.qty;
+            break;
+        }
+        }
+    }
+
+    void top(snap_t& out) const
+    {
+        out.bid_levels = out.ask_levels = 0;
+        for (auto it = bids.begin(); it != bids.end() && out.bid_levels < DEPTH; ++it) out.bids[out.bid_levels++] = it->second;
+        for (auto it = asks.begin(); it != asks.end() && out.ask_levels < DEPTH; ++it) out.asks[out.ask_levels++] = it->second;
+    }
+};
+
+static void apply_book(book_t& b, const event& e)
+{
+    switch (e.type)
+    {
+    case 'A': b.add(e.id, e.side, e.price, e.qty); break;
+    case 'X': b.remove(e.id); break;
+    case 'E': b.reduce(e.id, e.qty); break;
+    case 'M': b.modify(e.id, e.price, e.qty); break;
+    }
+}
+
+static bool same_top(const snap_t& a, const snap_t& b)
+{
+    if (a.bid_levels != b.bid_levels || a.ask_levels != b.ask_levels) return false;
+    for (std::uint32_t i = 0; i < a.bid_levels; ++i)
+        if (a.bids[i].price != b.bids[i].price || a.bids[i].qty != b.bids[i].qty || a.bids[i].orders != b.bids[i].orders) return false;
+    for (std::uint32_t i = 0; i < a.ask_levels; ++i)
+        if (a.asks[i].price != b.asks[i].price || a.asks[i].qty != b.asks[i].qty || a.asks[i].orders != b.asks[i].orders) return false;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::vector<event> ev = make_events(n);
+    std::cout << "\n=== L2 book: " << n << " order events, ~" << LIVE_ORDERS << " live orders, top " << DEPTH
+              << " published ===\n";
+
+    // 1. full recompute on every event (short prefix of the stream)
+    {
+        std::unordered_map<std::uint64_t, order_rec> orders;
+        snap_t s{};
+        const std::size_t m = std::min(n, RECOMPUTE_EVENTS + LIVE_ORDERS);
+        for (std::size_t i = 0; i < LIVE_ORDERS && i < m; ++i) apply_orders(orders, ev[i]); // warm the book first
+        const std::uint64_t t = time_ns([&] {
+            for (std::size_t i = LIVE_ORDERS; i < m; ++i)
+            {
+                apply_orders(orders, ev[i]);
+                recompute(orders, s);
+            }
+        });
+        std::printf("full recompute : %10.1f ns/event  (%zu events)\n",
+                    static_cast<double>(t) / static_cast<double>(m - LIVE_ORDERS), m - LIVE_ORDERS);
+    }
+
+    // 2. incremental level map, top copied every event
+    level_map_book lm;
+    snap_t lm_top{};
+    ll_seqlock<snap_t> lm_pub;
+    std::uint64_t t_lm = time_ns([&] {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            lm.apply(ev[i]);
+            lm.top(lm_top);
+            lm_top.seq = i;
+            lm_pub.store(lm_top);
+        }
+    });
+    std::printf("level map      : %10.1f ns/event\n", static_cast<double>(t_lm) / static_cast<double>(n));
+
+    // 3. ll_l2_book: update + publish; throughput, then per-event latency
+    {
+        book_t warm(LIVE_ORDERS * 2);
+        const std::uint64_t t = time_ns([&] {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                apply_book(warm, ev[i]);
+                warm.publish(i);
+            }
+        });
+        std::printf("ll_l2_book     : %10.1f ns/event\n", static_cast<double>(t) / static_cast<double>(n));
+    }
+    book_t book(LIVE_ORDERS * 2);
+    ll_latency_histogram upd;
+    std::uint64_t published = 0, deltas = 0;
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const auto a = clk::now();
+            apply_book(book, ev[i]);
+            if (book.publish(i))
+            {
+                ++published;
+                deltas += book.deltas().size();
+            }
+            upd.record(static_cast<std::uint64_t>((clk::now() - a).count()));
+        }
+    }
+    upd.print(std::cout, "ll_l2_book update+publish (ns, incl. clock reads)");
+    std::printf("published on %.1f%% of events, %.2f deltas per publication (vs %zu levels in a full snapshot)\n",
+                100.0 * static_cast<double>(published) / static_cast<double>(n),
+                static_cast<double>(deltas) / static_cast<double>(published ? published : 1), 2 * DEPTH);
+    std::printf("book at end: %zu orders, %zu bid / %zu ask levels\n", book.orders(), book.levels(ll_side::bid),
+                book.levels(ll_side::ask));
+
+    // reader side: snapshot load cost (uncontended)
+    snap_t rs{};
+    std::uint64_t sum = 0;
+    const std::size_t loads = 1000000;
+    const std::uint64_t t_rd = time_ns([&] {
+        for (std::size_t i = 0; i < loads; ++i)
+        {
+            rs = book.snapshots().load();
+            sum += rs.seq;
+        }
+    });
+    std::printf("snapshot load  : %10.1f ns (%zu bytes, seqlock)\n", static_cast<double>(t_rd) / static_cast<double>(loads),
+                sizeof(snap_t));
+
+    // correctness: replay again, compare against the level map and a recompute at checkpoints
+    {
+        book_t b2(LIVE_ORDERS * 2);
+        level_map_book ref;
+        std::unordered_map<std::uint64_t, order_rec> orders;
+        snap_t a{}, c{};
+        bool ok = true;
+        for (std::size_t i = 0; i < n && ok; ++i)
+        {
+            apply_book(b2, ev[i]);
+            b2.publish(i);
+            ref.apply(ev[i]);
+            apply_orders(orders, ev[i]);
+            if (i % 997 == 0 || i + 1 == n)
+            {
+                ref.top(a);
+                ok = same_top(b2.snapshots().load(), a);
+                if (i % (997 * 50) == 0)
+                {
+                    recompute(orders, c);
+                    ok = ok && same_top(a, c);
+                }
+            }
+        }
+        std::cout << "ll_l2_book vs level map vs recompute: " << (ok ? "match" : "MISMATCH") << " (checksum " << (sum & 0xFF)
+                  << ")\n";
+    }
+}
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <random>
+#include <vector>
+
+#include "ll_list_pool.hpp"
+
+/*
+ * Benchmark: ll_list_pool snapshot (slab copy + link rebase) vs rebuild
+ *
+ * usage: bench_list_snapshot [max orders = 1000000]
+ *
+ * Source: a pool of N orders (24 B, 40 B nodes) at 80% of capacity, after
+ * N rounds of churn (cancel a random order, add a new one, requeue a
+ * random order), so list order and slab order are unrelated, as in a
+ * live book. N = 10k, 100k, ... up to the maximum.
+ * - rebuild        : new pool, emplace_back of every element in list order
+ * - rebuild reuse  : clear() + emplace_back into an existing pool
+ * - snapshot()     : new pool, slab copy + rebase
+ * - snapshot_to()  : slab copy + rebase into an existing pool
+ * Reported: first run and best of REPS (ms), and ns per live element.
+ * Each copy is checked against the source (same sequence, counterpart()
+ * maps handles, mutating the copy leaves the source alone).
+ */
+
+static constexpr unsigned REPS = 7;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+struct order
+{
+    std::uint64_t id;
+    std::int64_t price;
+    std::int32_t qty;
+    std::uint32_t flags;
+};
+
+using pool = ll_list_pool<order>;
+
+static std::vector<std::uint64_t> ids_of(pool& p)
+{
+    std::vector<std::uint64_t> ids;
+    ids.reserve(p.size());
+    for (auto it = p.begin(); it != p.end(); ++it) ids.push_back(it->id);
+    return ids;
+}
+
+static bool check_copy(pool& src, pool& copy, const std::vector<pool::iterator>& handles, bool positions)
+{
+    if (ids_of(copy) != ids_of(src)) return false;
+    if (positions)
+        for (std::size_t k = 0; k < handles.size(); k += 997)
+            if (copy.counterpart(src, handles[k])->id != handles[k]->id) return false;
+    // mutate the copy: the source must not see it
+    const std::size_t n = src.size();
+    const std::uint64_t front = src.begin()->id;
+    copy.erase(copy.begin());
+    copy.emplace_back(order{~0ull, 0, 0, 0});
+    auto back = src.end();
+    --back;
+    return src.size() == n && src.begin()->id == front && back->id != ~0ull;
+}
+
+static void run(std::size_t n)
+{
+    const std::size_t cap = n + n / 4;
+    std::mt19937_64 rng(n);
+    pool src(cap);
+    std::vector<pool::iterator> h;
+    h.reserve(n);
+    std::uint64_t next_id = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        h.push_back(src.emplace_back(order{next_id++, static_cast<std::int64_t>(rng() % 5000), 100, 0}));
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const std::size_t a = rng() % n;
+        src.erase(h[a]);
+        h[a] = src.emplace_back(order{next_id++, static_cast<std::int64_t>(rng() % 5000), 100, 0});
+        src.splice(src.end(), h[rng() % n]);
+    }
+
+    pool reuse(cap);
+    std::uint64_t first[4] = {}, best[4] = {~0ull, ~0ull, ~0ull, ~0ull};
+    bool ok = true;
+    for (unsigned rep = 0; rep < REPS; ++rep)
+    {
+        pool* fresh = nullptr;
+        std::uint64_t t[4];
+        t[0] = time_ns([&] {
+            fresh = new pool(cap);
+            for (auto it = src.begin(); it != src.end(); ++it) fresh->emplace_back(*it);
+        });
+        if (rep == 0) ok &= check_copy(src, *fresh, h, false);
+        delete fresh;
+
+        t[1] = time_ns([&] {
+            reuse.clear();
+            for (auto it = src.begin(); it != src.end(); ++it) reuse.emplace_back(*it);
+        });
+        if (rep == 0) ok &= check_copy(src, reuse, h, false);
+
+        t[2] = time_ns([&] { fresh = new pool(src.snapshot()); });
+        if (rep == 0) ok &= check_copy(src, *fresh, h, true);
+        delete fresh;
+
+        t[3] = time_ns([&] { src.snapshot_to(reuse); });
+        if (rep == 0) ok &= check_copy(src, reuse, h, true);
+
+        for (int k = 0; k < 4; ++k)
+        {
+            if (rep == 0) first[k] = t[k];
+            best[k] = std::min(best[k], t[k]);
+        }
+    }
+
+    static const char* names[4] = {"rebuild (new pool)", "rebuild (clear + reuse)", "snapshot()", "snapshot_to(reuse)"};
+    std::printf("\n=== %zu orders, capacity %zu (slab %.1f MB) ===\n", n, cap, cap * 40 / 1048576.0);
+    std::printf("%-26s %12s %12s %14s\n", "method", "first ms", "best ms", "best ns/order");
+    for (int k = 0; k < 4; ++k)
+        std::printf("%-26s %12.3f %12.3f %14.2f\n", names[k], first[k] / 1e6, best[k] / 1e6,
+                    static_cast<double>(best[k]) / n);
+    std::printf("copies identical, handles map, source untouched: %s\n", ok ? "yes" : "NO");
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t max_n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    // freed slabs stay in the process: "best" is the copy itself, "first"
+    // includes faulting fresh pages in (up to ~10 s/GB on this VM)
+    mallopt(M_MMAP_THRESHOLD, 1 << 30);
+    mallopt(M_TRIM_THRESHOLD, -1);
+
+    for (std::size_t n = 10'000; n <= max_n; n *= 10) run(n);
+    return 0;
+}
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <malloc.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "ll_intrusive_list.hpp"
+#include "ll_list_pool.hpp"
+
+/*
+ * Benchmark: in-place list sort / merge / unique by relinking
+ *
+ * usage: bench_list_sort [n = 1000000]
+ *
+ * n orders (24 B) with random prices from 5000 ticks (many ties, so
+ * stability matters), sorted by price. Two memory layouts of the same
+ * sequence:
+ * - in order : node k of the list is the k-th node allocated
+ * - churned  : nodes sit at random slab / heap positions, as after a
+ *              day of adds and cancels
+ * Methods:
+ * - ll_list_pool::sort               : bottom-up merge sort, relinking
+ * - copy + std::stable_sort + rebuild : values to a vector, sort, clear,
+ *                                       emplace_back (the old way)
+ * - iterators + std::stable_sort + splice : sort handles, relink in order
+ * - std::list::sort
+ * - intrusive_list::sort
+ * Best of REPS; every run restores the original order first (untimed) and
+ * is checked: sorted by price, ties in original order.
+ * Then merge of two sorted halves and unique by price, once each.
+ */
+
+static constexpr unsigned REPS = 3;
+static constexpr std::int64_t TICKS = 5000;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+struct order
+{
+    std::uint64_t id;
+    std::int64_t price;
+    std::int32_t qty;
+    std::uint32_t seq; // position before sorting: ties must keep this order
+};
+
+struct intrusive_order
+{
+    intrusive_hook hook;
+    order o;
+};
+
+static const order& of(const intrusive_hook* h)
+{
+    return reinterpret_cast<const intrusive_order*>(reinterpret_cast<const char*>(h) -
+                                                    offsetof(intrusive_order, hook))->o;
+}
+
+static constexpr auto by_price = [](const order& a, const order& b) { return a.price < b.price; };
+
+template <typename It>
+static bool sorted_stable(It first, It last, std::size_t n)
+{
+    std::size_t k = 0;
+    const order* prev = nullptr;
+    for (; first != last; ++first, ++k)
+    {
+        const order& o = *first;
+        if (prev && (o.price < prev->price || (o.price == prev->price && o.seq < prev->seq))) return false;
+        prev = &o;
+    }
+    return k == n;
+}
+
+// the same value sequence in each container; slot[k] = memory position of
+// element k (identity = in order, a permutation = churned)
+struct containers
+{
+    ll_list_pool<order> pool;
+    std::vector<ll_list_pool<order>::iterator> pool_its;
+    std::list<order> lst;
+    std::vector<std::list<order>::iterator> lst_its;
+    std::vector<intrusive_order> objs;
+    intrusive_list ilist;
+
+    containers(const std::vector<order>& vals, const std::vector<std::uint32_t>& slot)
+        : pool(vals.size())
+        , pool_its(vals.size())
+        , lst_its(vals.size())
+        , objs(vals.size())
+    {
+        const std::size_t n = vals.size();
+        std::vector<std::uint32_t> elem_at(n);
+        for (std::size_t k = 0; k < n; ++k) elem_at[slot[k]] = static_cast<std::uint32_t>(k);
+        // allocate in memory order, then link in sequence order
+        for (std::size_t s = 0; s < n; ++s)
+        {
+            pool_its[elem_at[s]] = pool.emplace_back(vals[elem_at[s]]);
+            lst_its[elem_at[s]] = lst.insert(lst.end(), vals[elem_at[s]]);
+            objs[s].o = vals[elem_at[s]];
+        }
+        restore(slot);
+    }
+
+    // relink everything in the original sequence (untimed)
+    void restore(const std::vector<std::uint32_t>& slot)
+    {
+        for (auto it : pool_its) pool.splice(pool.end(), it);
+        for (auto it : lst_its) lst.splice(lst.end(), lst, it);
+        ilist.clear();
+        for (std::uint32_t s : slot) ilist.push_back(&objs[s].hook);
+    }
+};
+
+static void sort_layout(const std::vector<order>& vals, const std::vector<std::uint32_t>& slot,
+                        std::uint64_t (&best)[5], bool (&ok)[5])
+{
+    const std::size_t n = vals.size();
+    containers c(vals, slot);
+    for (unsigned rep = 0; rep < REPS; ++rep)
+    {
+        std::uint64_t t[5];
+        bool good[5];
+
+        c.restore(slot);
+        t[0] = time_ns([&] { c.pool.sort(by_price); });
+        good[0] = sorted_stable(c.pool.begin(), c.pool.end(), n);
+
+        // rebuild destroys nodes: work on a copy of the pool with the same layout
+        {
+            c.restore(slot);
+            ll_list_pool<order> work = c.pool.snapshot();
+            t[1] = time_ns([&] {
+                std::vector<order> v;
+                v.reserve(n);
+                for (auto it = work.begin(); it != work.end(); ++it) v.push_back(*it);
+                std::stable_sort(v.begin(), v.end(), by_price);
+                work.clear();
+                for (const order& o : v) work.emplace_back(o);
+            });
+            good[1] = sorted_stable(work.begin(), work.end(), n);
+        }
+
+        c.restore(slot);
+        t[2] = time_ns([&] {
+            std::vector<ll_list_pool<order>::iterator> its;
+            its.reserve(n);
+            for (auto it = c.pool.begin(); it != c.pool.end(); ++it) its.push_back(it);
+            std::stable_sort(its.begin(), its.end(), [](auto a, auto b) { return a->price < b->price; });
+            for (auto it : its) c.pool.splice(c.pool.end(), it);
+        });
+        good[2] = sorted_stable(c.pool.begin(), c.pool.end(), n);
+
+        c.restore(slot);
+        t[3] = time_ns([&] { c.lst.sort(by_price); });
+        good[3] = sorted_stable(c.lst.begin(), c.lst.end(), n);
+
+        c.restore(slot);
+        t[4] = time_ns([&] { c.ilist.sort([](const intrusive_hook* a, const intrusive_hook* b) {
+            return of(a).price < of(b).price;
+        }); });
+        {
+            std::vector<order> seqv;
+            seqv.reserve(n);
+            for (intrusive_hook* h = c.ilist.front(); h != c.ilist.end(); h = h->next) seqv.push_back(of(h));
+            good[4] = sorted_stable(seqv.begin(), seqv.end(), n);
+        }
+
+        for (int k = 0; k < 5; ++k)
+        {
+            best[k] = std::min(best[k], t[k]);
+            ok[k] = ok[k] && good[k];
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    // freed memory stays in the process (fresh pages are slow on this VM)
+    mallopt(M_MMAP_THRESHOLD, 1 << 30);
+    mallopt(M_TRIM_THRESHOLD, -1);
+
+    std::mt19937_64 rng(121);
+    std::vector<order> vals(n);
+    for (std::size_t k = 0; k < n; ++k)
+        vals[k] = {k, static_cast<std::int64_t>(rng() % TICKS), 100, static_cast<std::uint32_t>(k)};
+    std::vector<std::uint32_t> in_order(n), churned(n);
+    std::iota(in_order.begin(), in_order.end(), 0u);
+    std::iota(churned.begin(), churned.end(), 0u);
+    std::shuffle(churned.begin(), churned.end(), rng);
+
+    std::uint64_t best[2][5];
+    bool ok[2][5];
+    for (int l = 0; l < 2; ++l)
+    {
+        std::fill(std::begin(best[l]), std::end(best[l]), ~0ull);
+        std::fill(std::begin(ok[l]), std::end(ok[l]), true);
+        sort_layout(vals, l ? churned : in_order, best[l], ok[l]);
+    }
+
+    static const char* names[5] = {"ll_list_pool::sort", "copy + stable_sort + rebuild",
+                                   "iterators + stable_sort + splice", "std::list::sort", "intrusive_list::sort"};
+    std::printf("\n=== Sort %zu orders by price (%lld ticks), best of %u ===\n", n, static_cast<long long>(TICKS), REPS);
+    std::printf("%-34s %16s %16s %8s\n", "method", "in order ms", "churned ms", "stable");
+    for (int k = 0; k < 5; ++k)
+        std::printf("%-34s %16.1f %16.1f %8s\n", names[k], best[0][k] / 1e6, best[1][k] / 1e6,
+                    ok[0][k] && ok[1][k] ? "ok" : "FAIL");
+
+    // merge two sorted halves (churned layout), then unique by price
+    const std::size_t h = n / 2;
+    std::vector<order> lo(vals.begin(), vals.begin() + h), hi(vals.begin() + h, vals.end());
+    std::vector<std::uint32_t> slot_lo(h), slot_hi(n - h);
+    std::iota(slot_lo.begin(), slot_lo.end(), 0u);
+    std::iota(slot_hi.begin(), slot_hi.end(), 0u);
+    std::shuffle(slot_lo.begin(), slot_lo.end(), rng);
+    std::shuffle(slot_hi.begin(), slot_hi.end(), rng);
+    containers a(lo, slot_lo), b(hi, slot_hi);
+    a.pool.sort(by_price);
+    b.pool.sort(by_price);
+    a.lst.sort(by_price);
+    b.lst.sort(by_price);
+    auto icmp = [](const intrusive_hook* x, const intrusive_hook* y) { return of(x).price < of(y).price; };
+    a.ilist.sort(icmp);
+    b.ilist.sort(icmp);
+
+    // the pool's merge moves values across slabs: give it room for both halves
+    ll_list_pool<order> merged(n);
+    for (auto it = a.pool.begin(); it != a.pool.end(); ++it) merged.emplace_back(*it);
+    const std::uint64_t m0 = time_ns([&] { merged.merge(b.pool, by_price); });
+    const std::uint64_t m1 = time_ns([&] { a.lst.merge(b.lst, by_price); });
+    const std::uint64_t m2 = time_ns([&] { a.ilist.merge(b.ilist, icmp); });
+    std::vector<order> iseq;
+    for (intrusive_hook* x = a.ilist.front(); x != a.ilist.end(); x = x->next) iseq.push_back(of(x));
+    const bool mok = sorted_stable(merged.begin(), merged.end(), n) && sorted_stable(a.lst.begin(), a.lst.end(), n) &&
+                     sorted_stable(iseq.begin(), iseq.end(), n);
+
+    auto same_price = [](const order& x, const order& y) { return x.price == y.price; };
+    std::size_t r0 = 0, r2 = 0;
+    const std::size_t before = a.lst.size();
+    const std::uint64_t u0 = time_ns([&] { r0 = merged.unique(same_price); });
+    const std::uint64_t u1 = time_ns([&] { a.lst.unique(same_price); });
+    const std::uint64_t u2 = time_ns([&] {
+        r2 = a.ilist.unique([](const intrusive_hook* x, const intrusive_hook* y) { return of(x).price == of(y).price; });
+    });
+    const bool uok = r0 == before - a.lst.size() && r2 == r0 && merged.size() == a.lst.size();
+
+    std::printf("\n=== merge two sorted halves of %zu (churned), then unique by price ===\n", h);
+    std::printf("%-34s %16s %16s\n", "method", "merge ms", "unique ms");
+    std::printf("%-34s %16.1f %16.1f\n", "ll_list_pool (moves other's values)", m0 / 1e6, u0 / 1e6);
+    std::printf("%-34s %16.1f %16.1f\n", "std::list", m1 / 1e6, u1 / 1e6);
+    std::printf("%-34s %16.1f %16.1f\n", "intrusive_list", m2 / 1e6, u2 / 1e6);
+    std::printf("merged sorted and stable: %s; unique left %zu prices, counts agree: %s\n", mok ? "ok" : "FAIL",
+                merged.size(), uok ? "ok" : "FAIL");
+    return 0;
+}
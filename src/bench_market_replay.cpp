@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "ll_feed_generator.hpp"
+#include "ll_replay.hpp"
+
+/*
+ * Benchmark: market data replay at original pacing, Nx speed and flat out
+ *
+ * Input: a bursty Hawkes feed (ll_feed_generator) written to
+ * /tmp/ll_feed.replay, then replayed from the mmap'd file.
+ *
+ * Handler: decodes the ll_md_update in place and maintains per-symbol last
+ * price / volume. Every HICCUP_EVERY messages it stalls for HICCUP_NS
+ * (a page fault, a GC-like pause, a cache-cold path) to show the
+ * difference between the two histograms:
+ * - latency : completion - intended send time (coordinated-omission correct)
+ * - service : completion - dispatch (the naive number; hides the backlog
+ *             that builds up behind a stall)
+ *
+ * Usage: bench_market_replay [seconds of feed]   (default 2)
+ */
+
+static constexpr std::uint64_t HICCUP_EVERY = 50000;
+static constexpr std::uint64_t HICCUP_NS = 200000; // 200 us
+
+static const char* PATH = "/tmp/ll_feed.replay";
+
+using clk = std::chrono::steady_clock;
+
+struct symbol_state
+{
+    std::int64_t last_price = 0;
+    std::uint64_t volume = 0;
+    std::uint64_t updates = 0;
+};
+
+static void spin_for(std::uint64_t ns)
+{
+    const auto until = clk::now() + std::chrono::nanoseconds(ns);
+    while (clk::now() < until) {}
+}
+
+static void report(const char* mode, const ll_replay_stats& st, double feed_s)
+{
+    const double wall_s = static_cast<double>(st.wall_ns) / 1e9;
+    std::printf("\n--- %s: %llu msgs in %.3f s (feed %.3f s, x%.1f), %.2f M msg/s, max lag %.1f us\n", mode,
+                static_cast<unsigned long long>(st.messages), wall_s, feed_s, feed_s / wall_s,
+                static_cast<double>(st.messages) / wall_s / 1e6, static_cast<double>(st.max_lag_ns) / 1e3);
+    st.latency.print(std::cout, "latency vs intended (ns)");
+    st.service.print(std::cout, "service time        (ns)");
+}
+
+int main(int argc, char** argv)
+{
+    ll_feed_config cfg;
+    cfg.duration_s = argc > 1 ? std::strtod(argv[1], nullptr) : 2.0;
+
+    const std::uint64_t n = ll_feed_generator(cfg).write(PATH);
+    ll_replay_file file(PATH);
+
+    // burstiness of the generated feed: variance / mean of message counts per
+    // 1 ms bucket (1 for a Poisson feed, larger when arrivals cluster)
+    std::vector<std::uint32_t> per_ms(static_cast<std::size_t>(cfg.duration_s * 1000) + 1);
+    file.for_each([&](const ll_replay_record& r) { ++per_ms[(r.ts_ns - cfg.start_ns) / 1000000]; });
+    double mean = 0.0, var = 0.0;
+    std::uint32_t peak = 0;
+    for (std::uint32_t c : per_ms)
+    {
+        mean += c;
+        peak = c > peak ? c : peak;
+    }
+    mean /= static_cast<double>(per_ms.size());
+    for (std::uint32_t c : per_ms) var += (c - mean) * (c - mean);
+    var /= static_cast<double>(per_ms.size());
+    std::cout << "\n=== Market data replay: " << n << " messages, " << (file.bytes() >> 10) << " KiB, "
+              << cfg.duration_s << " s of feed ===\n"
+              << "per 1 ms: mean " << mean << " msgs, peak " << peak << ", index of dispersion " << var / mean
+              << " (Poisson = 1)\n";
+
+    std::vector<symbol_state> book(cfg.symbols);
+    std::uint64_t handled = 0;
+    auto handler = [&](const ll_replay_record& r)
+    {
+        const ll_md_update::view m(r.payload.data(), r.payload.size());
+        symbol_state& s = book[m.get<ll_md_symbol>()];
+        if (m.get<ll_md_type>() == 'E')
+        {
+            s.last_price = m.get<ll_md_price>();
+            s.volume += m.get<ll_md_qty>();
+        }
+        ++s.updates;
+        if (++handled % HICCUP_EVERY == 0) spin_for(HICCUP_NS);
+    };
+
+    struct mode
+    {
+        const char* name;
+        double speed;
+    };
+    for (const mode& m : {mode{"original pacing (1x)", 1.0}, mode{"10x", 10.0}, mode{"100x", 100.0},
+                          mode{"as fast as possible", 0.0}})
+    {
+        ll_replay_options opt;
+        opt.speed = m.speed;
+        report(m.name, ll_replay_engine::run(file, handler, opt), cfg.duration_s);
+    }
+
+    std::uint64_t volume = 0;
+    for (const symbol_state& s : book) volume += s.volume;
+    std::cout << "\n(handled " << handled << " messages, executed volume " << volume << ")\n";
+}
@@ -0,0 +1,580 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <malloc.h>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "ll_intrusive_list.hpp"
+#include "ll_latency_histogram.hpp"
+#include "ll_list_pool.hpp"
+#include "mini_list.hpp"
+
+/*
+ * Benchmark: order-queue churn replayed against five containers
+ *
+ * usage: bench_order_churn [ops = 2000000] [live = 10000] [add% cancel% execute% move%]
+ *
+ * One price level's queue of orders (24 B) starts with LIVE orders and
+ * replays a script of OPS operations drawn from the mix (default
+ * 45 / 35 / 10 / 10, where adds balance removals so the queue stays near
+ * LIVE):
+ * - add     : new order at the back
+ * - cancel  : a random live order, from anywhere in the queue
+ * - execute : the order at the front
+ * - move    : a random order loses priority and goes to the back
+ * The script is generated once and replayed on each container: same
+ * operations, same victims, same sizes.
+ * - ll_list_pool, intrusive_list (objects in a fixed slab), std::list,
+ *   mini_list, std::vector (cancel / move find the order by id)
+ * Reported:
+ * - ops/s for the whole script, with no per-op timing
+ * - per-op latency percentiles from a second replay timing every op
+ *   (steady_clock, ~20 ns of it is the clock), overall and per kind
+ * - memory over time: live heap bytes of the container at eighths of the
+ *   script (global operator new / delete are counted in this binary)
+ * Every replay must end with the same queue (ids in order).
+ */
+
+// Heap accounting
+    // every allocation in the process goes through here; live bytes are
+    // usable sizes, so allocator rounding counts, headers do not
+
+static std::size_t g_heap_live = 0;
+
+static void* counted(void* p)
+{
+    if (!p) throw std::bad_alloc();
+    g_heap_live += malloc_usable_size(p);
+    return p;
+}
+
+static void uncounted(void* p) noexcept
+{
+    if (!p) return;
+    g_heap_live -= malloc_usable_size(p);
+    std::free(p);
+}
+
+void* operator new(std::size_t n)
+{
+    return counted(std::malloc(n ? n : 1));
+}
+void* operator new[](std::size_t n)
+{
+    return counted(std::malloc(n ? n : 1));
+}
+void* operator new(std::size_t n, std::align_val_t a)
+{
+    const std::size_t al = static_cast<std::size_t>(a);
+    return counted(std::aligned_alloc(al, (n + al - 1) / al * al));
+}
+void* operator new[](std::size_t n, std::align_val_t a)
+{
+    return operator new(n, a);
+}
+void operator delete(void* p) noexcept
+{
+    uncounted(p);
+}
+void operator delete[](void* p) noexcept
+{
+    uncounted(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    uncounted(p);
+}
+void operator delete[](void* p, std::size_t) noexcept
+{
+    uncounted(p);
+}
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    uncounted(p);
+}
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    uncounted(p);
+}
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    uncounted(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    uncounted(p);
+}
+
+struct order
+{
+    std::uint64_t id;
+    std::int64_t price;
+    std::int32_t qty;
+    std::uint32_t flags;
+};
+
+enum op_kind : std::uint8_t
+{
+    op_add,
+    op_cancel,
+    op_execute,
+    op_move,
+    op_kinds
+};
+
+static const char* kind_names[op_kinds] = {"add", "cancel", "execute", "move"};
+
+struct script_op
+{
+    op_kind kind;
+    std::uint32_t pick; // cancel / move: index into the live set, mod its size
+};
+
+struct script
+{
+    std::size_t live = 0;
+    std::size_t peak = 0;     // largest queue size during the replay
+    std::uint64_t ids = 0;    // orders created (prefill + adds)
+    std::vector<script_op> ops;
+};
+
+static script make_script(std::size_t n_ops, std::size_t live, const unsigned (&mix)[op_kinds])
+{
+    script s;
+    s.live = live;
+    s.ops.reserve(n_ops);
+    const unsigned total = mix[0] + mix[1] + mix[2] + mix[3];
+    std::mt19937_64 rng(123);
+    std::size_t size = live;
+    s.peak = size;
+    s.ids = live;
+    for (std::size_t i = 0; i < n_ops; ++i)
+    {
+        unsigned r = static_cast<unsigned>(rng() % total);
+        op_kind k = op_add;
+        for (unsigned j = 0; j < op_kinds; ++j)
+        {
+            if (r < mix[j])
+            {
+                k = static_cast<op_kind>(j);
+                break;
+            }
+            r -= mix[j];
+        }
+        if (size == 0) k = op_add; // nothing to remove
+        s.ops.push_back({k, static_cast<std::uint32_t>(rng())});
+        if (k == op_add)
+        {
+            ++s.ids;
+            s.peak = std::max(s.peak, ++size);
+        }
+        else if (k != op_move)
+            --size;
+    }
+    return s;
+}
+
+// Containers
+    // each adapter: handle add(order), cancel(id, handle), front_id(),
+    // pop_front(), move_back(id, handle), ids(out)
+
+struct pool_queue
+{
+    using handle = ll_list_pool<order>::iterator;
+    ll_list_pool<order> q;
+    explicit pool_queue(std::size_t cap) : q(cap) {}
+    handle add(const order& o)
+    {
+        return q.emplace_back(o);
+    }
+    void cancel(std::uint64_t, handle h)
+    {
+        q.erase(h);
+    }
+    std::uint64_t front_id()
+    {
+        return q.begin()->id;
+    }
+    void pop_front()
+    {
+        q.erase(q.begin());
+    }
+    void move_back(std::uint64_t, handle h)
+    {
+        q.splice(q.end(), h);
+    }
+    void ids(std::vector<std::uint64_t>& out)
+    {
+        for (auto& o : q) out.push_back(o.id);
+    }
+};
+
+struct intrusive_order
+{
+    intrusive_hook hook;
+    order o;
+};
+
+static intrusive_order* owner(intrusive_hook* h)
+{
+    return reinterpret_cast<intrusive_order*>(reinterpret_cast<char*>(h) - offsetof(intrusive_order, hook));
+}
+
+struct intrusive_queue
+{
+    using handle = intrusive_order*;
+    std::vector<intrusive_order> slab; // objects live here, the list links them
+    std::vector<std::uint32_t> free_slots;
+    intrusive_list q;
+    explicit intrusive_queue(std::size_t cap) : slab(cap)
+    {
+        free_slots.reserve(cap);
+        for (std::size_t i = cap; i-- > 0;) free_slots.push_back(static_cast<std::uint32_t>(i));
+    }
+    handle add(const order& o)
+    {
+        intrusive_order* x = &slab[free_slots.back()];
+        free_slots.pop_back();
+        x->o = o;
+        q.push_back(&x->hook);
+        return x;
+    }
+    void release(intrusive_order* x)
+    {
+        q.remove(&x->hook);
+        free_slots.push_back(static_cast<std::uint32_t>(x - slab.data()));
+    }
+    void cancel(std::uint64_t, handle h)
+    {
+        release(h);
+    }
+    std::uint64_t front_id()
+    {
+        return owner(q.front())->o.id;
+    }
+    void pop_front()
+    {
+        release(owner(q.front()));
+    }
+    void move_back(std::uint64_t, handle h)
+    {
+        q.splice(q.end(), &h->hook);
+    }
+    void ids(std::vector<std::uint64_t>& out)
+    {
+        for (intrusive_hook* h = q.front(); h != q.end(); h = h->next) out.push_back(owner(h)->o.id);
+    }
+};
+
+struct std_list_queue
+{
+    using handle = std::list<order>::iterator;
+    std::list<order> q;
+    explicit std_list_queue(std::size_t) {}
+    handle add(const order& o)
+    {
+        return q.insert(q.end(), o);
+    }
+    void cancel(std::uint64_t, handle h)
+    {
+        q.erase(h);
+    }
+    std::uint64_t front_id()
+    {
+        return q.front().id;
+    }
+    void pop_front()
+    {
+        q.pop_front();
+    }
+    void move_back(std::uint64_t, handle h)
+    {
+        q.splice(q.end(), q, h);
+    }
+    void ids(std::vector<std::uint64_t>& out)
+    {
+        for (auto& o : q) out.push_back(o.id);
+    }
+};
+
+struct mini_list_queue
+{
+    using handle = mini_list<order>::iterator;
+    mini_list<order> q;
+    explicit mini_list_queue(std::size_t) {}
+    handle add(const order& o)
+    {
+        return q.insert(q.end(), o);
+    }
+    void cancel(std::uint64_t, handle h)
+    {
+        q.erase(h);
+    }
+    std::uint64_t front_id()
+    {
+        return q.begin()->id;
+    }
+    void pop_front()
+    {
+        q.erase(q.begin());
+    }
+    void move_back(std::uint64_t, handle h)
+    {
+        q.splice(q.end(), h);
+    }
+    void ids(std::vector<std::uint64_t>& out)
+    {
+        for (auto& o : q) out.push_back(o.id);
+    }
+};
+
+// no stable handles: cancel and move search by id, erase shifts the tail
+struct vector_queue
+{
+    using handle = std::uint32_t; // unused
+    std::vector<order> q;
+    explicit vector_queue(std::size_t) {}
+    handle add(const order& o)
+    {
+        q.push_back(o);
+        return 0;
+    }
+    std::vector<order>::iterator find(std::uint64_t id)
+    {
+        return std::find_if(q.begin(), q.end(), [id](const order& o) { return o.id == id; });
+    }
+    void cancel(std::uint64_t id, handle)
+    {
+        q.erase(find(id));
+    }
+    std::uint64_t front_id()
+    {
+        return q.front().id;
+    }
+    void pop_front()
+    {
+        q.erase(q.begin());
+    }
+    void move_back(std::uint64_t id, handle)
+    {
+        auto it = find(id);
+        std::rotate(it, it + 1, q.end());
+    }
+    void ids(std::vector<std::uint64_t>& out)
+    {
+        for (auto& o : q) out.push_back(o.id);
+    }
+};
+
+// Driver
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+static std::uint64_t now_ns()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static constexpr int MEM_SAMPLES = 9; // start, each eighth
+
+struct result
+{
+    const char* name;
+    std::uint64_t wall_ns = 0;
+    ll_latency_histogram all;
+    ll_latency_histogram by_kind[op_kinds];
+    std::size_t mem[MEM_SAMPLES] = {};
+    std::size_t mem_peak = 0;
+    std::vector<std::uint64_t> final_ids;
+};
+
+enum class replay_mode
+{
+    wall,    // one clock around the whole script: ops/s, final queue
+    latency, // a clock around every operation
+    memory   // heap use after every operation
+};
+
+template <class Queue, replay_mode Mode>
+static void replay(const script& s, result& r)
+{
+    // bookkeeping sized up front, outside the heap baseline
+    std::vector<typename Queue::handle> handle_of(s.ids);
+    std::vector<std::uint64_t> live_ids;  // dense set of live ids, for random picks
+    std::vector<std::uint32_t> pos_of(s.ids); // id -> index in live_ids
+    live_ids.reserve(s.peak);
+    if (Mode == replay_mode::wall) r.final_ids.reserve(s.peak);
+
+    const std::size_t base = g_heap_live;
+    Queue q(s.peak);
+    std::uint64_t next_id = 0;
+    auto add = [&] {
+        const std::uint64_t id = next_id++;
+        handle_of[id] = q.add(order{id, 10000 + static_cast<std::int64_t>(id % 7), 100, 0});
+        pos_of[id] = static_cast<std::uint32_t>(live_ids.size());
+        live_ids.push_back(id);
+    };
+    auto forget = [&](std::uint64_t id) {
+        const std::uint32_t k = pos_of[id];
+        live_ids[k] = live_ids.back();
+        pos_of[live_ids[k]] = k;
+        live_ids.pop_back();
+    };
+    for (std::size_t i = 0; i < s.live; ++i) add();
+
+    const std::size_t n = s.ops.size();
+    const std::size_t eighth = std::max<std::size_t>(n / 8, 1);
+    int sample = 0;
+    if (Mode == replay_mode::memory)
+    {
+        r.mem[sample++] = g_heap_live - base;
+        r.mem_peak = r.mem[0];
+    }
+
+    auto run = [&] {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const script_op op = s.ops[i];
+            const std::uint64_t t0 = Mode == replay_mode::latency ? now_ns() : 0;
+            switch (op.kind)
+            {
+            case op_add:
+                add();
+                break;
+            case op_cancel:
+            {
+                const std::uint64_t id = live_ids[op.pick % live_ids.size()];
+                q.cancel(id, handle_of[id]);
+                forget(id);
+                break;
+            }
+            case op_execute:
+            {
+                const std::uint64_t id = q.front_id();
+                q.pop_front();
+                forget(id);
+                break;
+            }
+            case op_move:
+            {
+                const std::uint64_t id = live_ids[op.pick % live_ids.size()];
+                q.move_back(id, handle_of[id]);
+                break;
+            }
+            default:
+                break;
+            }
+            if constexpr (Mode == replay_mode::latency)
+            {
+                const std::uint64_t dt = now_ns() - t0;
+                r.all.record(dt);
+                r.by_kind[op.kind].record(dt);
+            }
+            else if constexpr (Mode == replay_mode::memory)
+            {
+                const std::size_t live_bytes = g_heap_live - base;
+                r.mem_peak = std::max(r.mem_peak, live_bytes);
+                if ((i + 1) % eighth == 0 && sample < MEM_SAMPLES) r.mem[sample++] = live_bytes;
+            }
+        }
+    };
+    if constexpr (Mode == replay_mode::wall)
+    {
+        r.wall_ns = time_ns(run);
+        q.ids(r.final_ids);
+    }
+    else
+        run();
+}
+
+template <class Queue>
+static void measure(const script& s, result& r)
+{
+    replay<Queue, replay_mode::wall>(s, r);
+    replay<Queue, replay_mode::latency>(s, r);
+    replay<Queue, replay_mode::memory>(s, r);
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n_ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const std::size_t live = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10'000;
+    unsigned mix[op_kinds] = {45, 35, 10, 10};
+    if (argc > 6)
+        for (int j = 0; j < op_kinds; ++j) mix[j] = static_cast<unsigned>(std::strtoul(argv[3 + j], nullptr, 10));
+    if (mix[0] + mix[1] + mix[2] + mix[3] == 0)
+    {
+        std::fprintf(stderr, "bench_order_churn: empty mix\n");
+        return 1;
+    }
+
+    // freed memory stays in the process (fresh pages are slow on this VM)
+    mallopt(M_MMAP_THRESHOLD, 1 << 30);
+    mallopt(M_TRIM_THRESHOLD, -1);
+
+    const script s = make_script(n_ops, live, mix);
+    result res[5];
+    res[0].name = "ll_list_pool";
+    res[1].name = "intrusive_list";
+    res[2].name = "std::list";
+    res[3].name = "mini_list";
+    res[4].name = "std::vector";
+    measure<pool_queue>(s, res[0]);
+    measure<intrusive_queue>(s, res[1]);
+    measure<std_list_queue>(s, res[2]);
+    measure<mini_list_queue>(s, res[3]);
+    measure<vector_queue>(s, res[4]);
+
+    bool same = true;
+    for (const result& r : res) same = same && r.final_ids == res[0].final_ids;
+
+    std::printf("\n=== Order churn: %zu ops (add %u%%, cancel %u%%, execute %u%%, move %u%%), %zu live at start, peak %zu ===\n",
+                n_ops, mix[0], mix[1], mix[2], mix[3], live, s.peak);
+    std::printf("%-16s %10s %8s %8s %8s %8s %10s %10s\n", "container", "Mops/s", "p50 ns", "p99", "p99.9", "p99.99",
+                "max", "peak KB");
+    for (const result& r : res)
+        std::printf("%-16s %10.2f %8llu %8llu %8llu %8llu %10llu %10zu\n", r.name, n_ops * 1e3 / r.wall_ns,
+                    static_cast<unsigned long long>(r.all.percentile(50)),
+                    static_cast<unsigned long long>(r.all.percentile(99)),
+                    static_cast<unsigned long long>(r.all.percentile(99.9)),
+                    static_cast<unsigned long long>(r.all.percentile(99.99)),
+                    static_cast<unsigned long long>(r.all.max()), r.mem_peak / 1024);
+
+    std::printf("\nper-op latency, p50 / p99 ns\n%-16s", "container");
+    for (const char* k : kind_names) std::printf(" %15s", k);
+    std::printf("\n");
+    for (const result& r : res)
+    {
+        std::printf("%-16s", r.name);
+        for (const auto& h : r.by_kind)
+            std::printf(" %7llu / %5llu", static_cast<unsigned long long>(h.percentile(50)),
+                        static_cast<unsigned long long>(h.percentile(99)));
+        std::printf("\n");
+    }
+
+    std::printf("\ncontainer heap KB over the script (start, then each eighth)\n%-16s", "container");
+    for (int k = 0; k < MEM_SAMPLES; ++k) std::printf(" %7d/8", k);
+    std::printf("\n");
+    for (const result& r : res)
+    {
+        std::printf("%-16s", r.name);
+        for (std::size_t m : r.mem) std::printf(" %9zu", m / 1024);
+        std::printf("\n");
+    }
+    std::printf("final queues identical: %s (%zu orders)\n", same ? "yes" : "NO", res[0].final_ids.size());
+    return 0;
+}
@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "ll_feed_generator.hpp"
+#include "ll_pcap.hpp"
+
+/*
+ * Benchmark: offline multicast feed decoding from pcap / pcapng
+ *
+ * Input: a bursty ll_feed_generator feed packed into MoldUDP64 packets on
+ * four multicast groups 233.54.12.1-4:26401-26404 (group 4 VLAN tagged),
+ * mixed with 5% unrelated UDP traffic and 2% ARP, written twice:
+ *   /tmp/ll_feed.pcap    (nanosecond pcap)
+ *   /tmp/ll_feed.pcapng  (EPB blocks, if_tsresol = 10^-9)
+ *
+ * - frames     : walk every record (file format overhead only)
+ * - filter     : Ethernet/IP/UDP parse + one (group, port) filter
+ * - decode     : all feed groups -> MoldUDP64 -> ll_md_update fields
+ * - ifstream   : the usual approach - read header + copy each packet into a
+ *                vector, then the same parse and decode
+ *
+ * Usage: bench_pcap_decode [seconds of feed]   (default 10)
+ */
+
+using clk = std::chrono::steady_clock;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = clk::now();
+    f();
+    auto end = clk::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+static const char* PCAP_PATH = "/tmp/ll_feed.pcap";
+static const char* PCAPNG_PATH = "/tmp/ll_feed.pcapng";
+static const char* GROUPS[] = {"233.54.12.1", "233.54.12.2", "233.54.12.3", "233.54.12.4"};
+static constexpr std::uint16_t BASE_PORT = 26401;
+
+// Capture generation
+
+struct frame_builder
+{
+    std::vector<std::uint8_t> b;
+
+    void u8(unsigned v) { b.push_back(static_cast<std::uint8_t>(v)); }
+    void be16(unsigned v) { u8(v >> 8); u8(v); }
+    void be32(std::uint32_t v) { be16(v >> 16); be16(v & 0xFFFF); }
+    void be64(std::uint64_t v) { be32(static_cast<std::uint32_t>(v >> 32)); be32(static_cast<std::uint32_t>(v)); }
+    void bytes(const void* p, std::size_t n)
+    {
+        const auto* c = static_cast<const std::uint8_t*>(p);
+        b.insert(b.end(), c, c + n);
+    }
+
+    void ethernet(std::uint32_t dst_group, int vlan, unsigned ethertype)
+    {
+        // multicast MAC 01:00:5e + low 23 bits of the group
+        const std::uint8_t mac[6] = {0x01, 0x00, 0x5e, static_cast<std::uint8_t>((dst_group >> 16) & 0x7F),
+                                     static_cast<std::uint8_t>(dst_group >> 8), static_cast<std::uint8_t>(dst_group)};
+        const std::uint8_t src[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+        bytes(mac, 6);
+        bytes(src, 6);
+        if (vlan >= 0)
+        {
+            be16(0x8100);
+            be16(static_cast<unsigned>(vlan));
+        }
+        be16(ethertype);
+    }
+
+    void ipv4_udp(std::uint32_t src, std::uint32_t dst, std::uint16_t sport, std::uint16_t dport, std::size_t payload)
+    {
+        const std::size_t ip = b.size();
+        u8(0x45);
+        u8(0);
+        be16(static_cast<unsigned>(20 + 8 + payload));
+        be16(0);
+        be16(0x4000); // DF
+        u8(32);
+        u8(17);
+        be16(0); // checksum, filled below
+        be32(src);
+        be32(dst);
+        std::uint32_t sum = 0;
+        for (std::size_t i = 0; i < 20; i += 2) sum += (b[ip + i] << 8) | b[ip + i + 1];
+        while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+        b[ip + 10] = static_cast<std::uint8_t>(~sum >> 8);
+        b[ip + 11] = static_cast<std::uint8_t>(~sum);
+        be16(sport);
+        be16(dport);
+        be16(static_cast<unsigned>(8 + payload));
+        be16(0); // UDP checksum optional over IPv4
+    }
+};
+
+struct capture_writer
+{
+    std::FILE* pcap;
+    std::FILE* ng;
+
+    capture_writer()
+        : pcap(std::fopen(PCAP_PATH, "wb"))
+        , ng(std::fopen(PCAPNG_PATH, "wb"))
+    {
+        const std::uint32_t hdr[6] = {0xA1B23C4D, 2 | (4u << 16), 0, 0, 65535, 1};
+        std::fwrite(hdr, sizeof(hdr), 1, pcap);
+
+        const std::uint32_t shb[7] = {0x0A0D0D0A, 28, 0x1A2B3C4D, 1, 0xFFFFFFFF, 0xFFFFFFFF, 28};
+        std::fwrite(shb, sizeof(shb), 1, ng);
+        // IDB: Ethernet, snaplen, if_tsresol = 9, end of options
+        const std::uint32_t idb[8] = {1, 32, 1, 65535, 9 | (1u << 16), 9, 0, 32};
+        std::fwrite(idb, sizeof(idb), 1, ng);
+    }
+
+    ~capture_writer()
+    {
+        std::fclose(pcap);
+        std::fclose(ng);
+    }
+
+    void write(std::uint64_t ts_ns, const std::vector<std::uint8_t>& f)
+    {
+        const auto len = static_cast<std::uint32_t>(f.size());
+        const std::uint32_t rec[4] = {static_cast<std::uint32_t>(ts_ns / 1000000000u),
+                                      static_cast<std::uint32_t>(ts_ns % 1000000000u), len, len};
+        std::fwrite(rec, sizeof(rec), 1, pcap);
+        std::fwrite(f.data(), 1, f.size(), pcap);
+
+        const std::uint32_t padded = (len + 3) & ~3u;
+        const std::uint32_t total = 32 + padded;
+        const std::uint32_t epb[7] = {6, total, 0, static_cast<std::uint32_t>(ts_ns >> 32),
+                                      static_cast<std::uint32_t>(ts_ns), len, len};
+        static const std::uint8_t zeros[4] = {};
+        std::fwrite(epb, sizeof(epb), 1, ng);
+        std::fwrite(f.data(), 1, f.size(), ng);
+        std::fwrite(zeros, 1, padded - len, ng);
+        std::fwrite(&total, sizeof(total), 1, ng);
+    }
+};
+
+// one MoldUDP64 packet per channel, flushed when the next message is more
+// than 2 us later or the packet holds 8 messages
+static std::uint64_t generate(double seconds, std::uint64_t& messages)
+{
+    ll_feed_config cfg;
+    cfg.duration_s = seconds;
+    cfg.channels = 4;
+
+    capture_writer out;
+    frame_builder fb;
+    struct pending
+    {
+        std::vector<std::uint8_t> msgs;
+        std::uint16_t count = 0;
+        std::uint64_t first_ts = 0, last_ts = 0, seq = 1;
+    };
+    pending ch[4];
+    std::uint64_t packets = 0, noise = 0, last_written = 0;
+    const std::uint32_t src = ll_ipv4("10.1.1.1");
+
+    auto flush = [&](std::uint32_t c)
+    {
+        pending& p = ch[c];
+        if (!p.count) return;
+        const std::uint64_t ts = std::max(p.last_ts, last_written); // keep the capture in time order
+        last_written = ts;
+        const std::uint32_t group = ll_ipv4(GROUPS[c]);
+        fb.b.clear();
+        fb.ethernet(group, c == 3 ? 100 : -1, 0x0800);
+        fb.ipv4_udp(src, group, 40000, static_cast<std::uint16_t>(BASE_PORT + c), 20 + p.msgs.size());
+        fb.bytes("SESSION001", 10);
+        fb.be64(p.seq);
+        fb.be16(p.count);
+        fb.bytes(p.msgs.data(), p.msgs.size());
+        out.write(ts, fb.b);
+        p.seq += p.count;
+        p.count = 0;
+        p.msgs.clear();
+        ++packets;
+
+        // unrelated traffic: other UDP every 20th packet, ARP every 50th
+        if (packets % 20 == 0)
+        {
+            fb.b.clear();
+            fb.ethernet(ll_ipv4("239.1.1.1"), -1, 0x0800);
+            fb.ipv4_udp(src, ll_ipv4("239.1.1.1"), 5000, 5000, 64);
+            fb.b.resize(fb.b.size() + 64, 0xAB);
+            out.write(ts, fb.b);
+            ++noise;
+        }
+        if (packets % 50 == 0)
+        {
+            fb.b.clear();
+            fb.ethernet(0xFFFFFF, -1, 0x0806);
+            fb.b.resize(fb.b.size() + 28, 0);
+            out.write(ts, fb.b);
+            ++noise;
+        }
+    };
+
+    messages = ll_feed_generator(cfg).generate([&](std::uint64_t ts, std::uint32_t c, std::span<const std::byte> m)
+    {
+        for (std::uint32_t k = 0; k < 4; ++k)
+            if (ch[k].count && (ts - ch[k].first_ts > 2000 || ch[k].count == 8)) flush(k);
+        pending& p = ch[c];
+        if (!p.count) p.first_ts = ts;
+        p.last_ts = ts;
+        p.msgs.push_back(static_cast<std::uint8_t>(m.size() >> 8));
+        p.msgs.push_back(static_cast<std::uint8_t>(m.size()));
+        p.msgs.insert(p.msgs.end(), reinterpret_cast<const std::uint8_t*>(m.data()),
+                      reinterpret_cast<const std::uint8_t*>(m.data()) + m.size());
+        ++p.count;
+    });
+    for (std::uint32_t k = 0; k < 4; ++k) flush(k);
+    return packets + noise;
+}
+
+// Decoding
+
+struct decode_sink
+{
+    std::uint64_t msgs = 0, volume = 0, gaps = 0;
+    std::int64_t price_sum = 0;
+    std::uint64_t next_seq[4] = {1, 1, 1, 1};
+
+    void packet(const ll_udp_packet& p)
+    {
+        const unsigned c = p.dst_port - BASE_PORT;
+        if (c >= 4) return;
+        ll_moldudp64_header h;
+        ll_moldudp64_for_each(p.payload, [&](std::uint64_t, std::span<const std::byte> m)
+        {
+            const ll_md_update::view v(m.data(), m.size());
+            price_sum += v.get<ll_md_price>();
+            if (v.get<ll_md_type>() == 'E') volume += v.get<ll_md_qty>();
+            ++msgs;
+        }, &h);
+        gaps += h.seq != next_seq[c];
+        next_seq[c] = h.seq + h.count;
+    }
+};
+
+// Baseline: stream + copy per packet (classic pcap only)
+static void decode_ifstream(decode_sink& sink, const ll_pcap_filter& filter)
+{
+    std::ifstream in(PCAP_PATH, std::ios::binary);
+    char hdr[24];
+    in.read(hdr, sizeof(hdr));
+    std::uint32_t rec[4];
+    std::vector<std::byte> buf;
+    ll_udp_packet pkt;
+    while (in.read(reinterpret_cast<char*>(rec), sizeof(rec)))
+    {
+        buf.resize(rec[2]);
+        in.read(reinterpret_cast<char*>(buf.data()), rec[2]);
+        const ll_pcap_frame f{std::uint64_t{rec[0]} * 1000000000u + rec[1], 1, rec[3], buf};
+        if (ll_pcap_detail::parse_udp(f, pkt) == ll_pcap_detail::udp_result::ok && filter.match(pkt.dst_ip, pkt.dst_port))
+            sink.packet(pkt);
+    }
+}
+
+static void line(const char* what, std::uint64_t ns, std::uint64_t packets, std::uint64_t msgs, std::size_t bytes)
+{
+    const double s = static_cast<double>(ns) / 1e9;
+    std::printf("%-22s: %7.1f ms  %6.2f M pkt/s  %6.2f M msg/s  %5.2f GB/s\n", what, static_cast<double>(ns) / 1e6,
+                static_cast<double>(packets) / s / 1e6, static_cast<double>(msgs) / s / 1e6,
+                static_cast<double>(bytes) / s / 1e9);
+}
+
+int main(int argc, char** argv)
+{
+    const double seconds = argc > 1 ? std::strtod(argv[1], nullptr) : 10.0;
+    std::uint64_t messages = 0;
+    const std::uint64_t frames = generate(seconds, messages);
+
+    ll_pcap_filter feed;
+    for (unsigned c = 0; c < 4; ++c) feed.add(ll_ipv4(GROUPS[c]), static_cast<std::uint16_t>(BASE_PORT + c));
+    ll_pcap_filter one;
+    one.add(ll_ipv4(GROUPS[0]), BASE_PORT);
+
+    for (const char* path : {PCAP_PATH, PCAPNG_PATH})
+    {
+        ll_pcap_reader reader(path);
+        std::cout << "\n=== " << (reader.format() == ll_pcap_format::pcap ? "pcap" : "pcapng") << ": " << frames
+                  << " frames, " << messages << " messages, " << (reader.bytes() >> 20) << " MiB ===\n";
+
+        // page cache warm-up so every run measures parsing
+        volatile std::uint64_t wire = 0;
+        reader.for_each_frame([&](const ll_pcap_frame& f) { wire = wire + f.orig_len; });
+
+        std::uint64_t t = time_ns([&] { reader.for_each_frame([&](const ll_pcap_frame& f) { wire = wire + f.orig_len; }); });
+        line("frames", t, frames, 0, reader.bytes());
+
+        ll_pcap_stats st;
+        std::uint64_t payload = 0;
+        t = time_ns([&] { st = reader.for_each_udp([&](const ll_udp_packet& p) { payload += p.payload.size(); }, one); });
+        line("filter one group", t, st.frames, 0, reader.bytes());
+
+        decode_sink sink;
+        t = time_ns([&] { st = reader.for_each_udp([&](const ll_udp_packet& p) { sink.packet(p); }, feed); });
+        line("decode all groups", t, st.frames, sink.msgs, reader.bytes());
+        std::printf("  frames=%llu udp=%llu matched=%llu non_udp=%llu truncated=%d msgs=%llu gaps=%llu\n",
+                    static_cast<unsigned long long>(st.frames), static_cast<unsigned long long>(st.udp),
+                    static_cast<unsigned long long>(st.matched), static_cast<unsigned long long>(st.non_udp),
+                    st.truncated, static_cast<unsigned long long>(sink.msgs), static_cast<unsigned long long>(sink.gaps));
+
+        if (reader.format() == ll_pcap_format::pcap)
+        {
+            decode_sink base;
+            t = time_ns([&] { decode_ifstream(base, feed); });
+            line("ifstream + copy", t, frames, base.msgs, reader.bytes());
+            std::cout << "  ll_pcap vs ifstream: "
+                      << (base.msgs == sink.msgs && base.price_sum == sink.price_sum && base.volume == sink.volume ? "match" : "MISMATCH")
+                      << "\n";
+        }
+    }
+}
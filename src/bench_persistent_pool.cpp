@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ll_list_pool.hpp"
+#include "ll_mmap_file.hpp"
+#include "ll_persistent_list_pool.hpp"
+
+/*
+ * Benchmark: restart of a list of open orders
+ *
+ * usage: bench_persistent_pool [events = 20000000] [live orders = 1000000] [dir = /tmp]
+ *
+ * A synthetic day: adds (emplace_back), cancels (erase) and modifies
+ * (update + splice to the back, i.e. loss of queue priority), with about
+ * LIVE orders open at any time. The events are journalled to
+ * dir/ll_orders.log as fixed 24-byte records.
+ * - live day   : the same events on ll_list_pool (heap slab) and on
+ *                ll_persistent_list_pool (slab in dir/ll_orders.pool)
+ * - checkpoint : msync cost after the day, and after small batches
+ * - restart, to the state at 90% of the day:
+ *     full replay of the journal into a fresh ll_list_pool (what a
+ *     restart costs today), warm and with the journal evicted from the
+ *     page cache
+ *     reopen of the clean pool file + rebuilding the id -> handle table by
+ *     one walk of the list, warm and evicted
+ * - crash: a child process reopens the pool, applies the rest of the day
+ *   and SIGKILLs itself with no checkpoint; the parent reopens the dirty
+ *   file (recovery pass) and compares the list with the reference
+ * Every restart path must reproduce the reference order sequence exactly.
+ */
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+struct order
+{
+    std::uint64_t id;
+    std::int64_t price;
+    std::int32_t qty;
+    std::uint32_t side;
+};
+
+enum : std::uint32_t
+{
+    ADD,
+    CANCEL,
+    MODIFY
+};
+
+struct event
+{
+    std::uint32_t type;
+    std::int32_t qty;
+    std::uint64_t id;
+    std::int64_t price;
+};
+
+static std::vector<event> make_day(std::size_t n, std::size_t live_target, std::uint64_t& ids)
+{
+    std::mt19937_64 rng(2024);
+    std::vector<event> ev(n);
+    std::vector<std::uint64_t> live;
+    live.reserve(live_target * 2);
+    ids = 0;
+    for (event& e : ev)
+    {
+        const unsigned r = static_cast<unsigned>(rng() % 10);
+        const std::int32_t qty = static_cast<std::int32_t>(1 + rng() % 1000);
+        if (live.size() < live_target || r < 4 || live.empty())
+        {
+            e = {ADD, qty, ids, 100'000 + static_cast<std::int64_t>(rng() % 2000)};
+            live.push_back(ids++);
+            continue;
+        }
+        const std::size_t k = rng() % live.size();
+        if (r < 8)
+        {
+            e = {CANCEL, 0, live[k], 0};
+            live[k] = live.back();
+            live.pop_back();
+        }
+        else
+            e = {MODIFY, qty, live[k], 0};
+    }
+    return ev;
+}
+
+template <typename Pool>
+static void apply(Pool& pool, std::vector<typename Pool::iterator>& h, const event* ev, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const event& e = ev[i];
+        switch (e.type)
+        {
+        case ADD:
+            h[e.id] = pool.emplace_back(order{e.id, e.price, e.qty, 0});
+            break;
+        case CANCEL:
+            pool.erase(h[e.id]);
+            break;
+        default:
+            h[e.id]->qty = e.qty;
+            pool.splice(pool.end(), h[e.id]);
+            break;
+        }
+    }
+}
+
+template <typename Pool>
+static std::vector<std::uint64_t> ids_of(Pool& pool)
+{
+    std::vector<std::uint64_t> ids;
+    ids.reserve(pool.size());
+    for (auto it = pool.begin(); it != pool.end(); ++it) ids.push_back(it->id);
+    return ids;
+}
+
+// reopen + one walk to rebuild the id -> handle table
+using ppool = ll_persistent_list_pool<order>;
+static void rebuild(ppool& pool, std::vector<ppool::iterator>& h)
+{
+    for (auto it = pool.begin(); it != pool.end(); ++it) h[it->id] = it;
+}
+
+// drop the file's (clean) pages from the page cache: the next read comes from disk
+static void evict(const char* path)
+{
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20'000'000;
+    const std::size_t live = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000'000;
+    const std::string dir = argc > 3 ? argv[3] : "/tmp";
+    const std::string log_path = dir + "/ll_orders.log", pool_path = dir + "/ll_orders.pool";
+    const std::size_t capacity = live * 2;
+    const std::size_t cut = n / 10 * 9;
+    constexpr std::size_t small = 1000, large = 100'000;
+
+    std::uint64_t ids = 0;
+    const std::vector<event> day = make_day(n, live, ids);
+    {
+        ll_mmap_file log(log_path.c_str(), ll_mmap_mode::create, n * sizeof(event));
+        std::memcpy(log.data(), day.data(), n * sizeof(event));
+        log.sync();
+    }
+
+    // reference and heap baseline
+    std::vector<std::uint64_t> ref_cut, ref_final;
+    std::uint64_t t_heap = 0;
+    {
+        ll_list_pool<order> pool(capacity);
+        std::vector<ll_list_pool<order>::iterator> h(ids);
+        t_heap = time_ns([&] { apply(pool, h, day.data(), cut); });
+        ref_cut = ids_of(pool);
+        apply(pool, h, day.data() + cut, n - cut);
+        ref_final = ids_of(pool);
+    }
+
+    std::printf("\n=== Order list restart: %zu events, ~%zu live orders, capacity %zu (%.0f MB pool file, %.0f MB journal) ===\n",
+                n, live, capacity, (4096 + (capacity + 1) * 32) / 1048576.0, n * sizeof(event) / 1048576.0);
+    std::printf("%zu orders live at 90%% of the day, %zu at the close\n\n", ref_cut.size(), ref_final.size());
+
+    // live day on the mapped pool
+    std::uint64_t t_mapped = 0, t_ckpt = 0;
+    {
+        ppool pool(pool_path.c_str(), ll_mmap_mode::create, capacity);
+        std::vector<ppool::iterator> h(ids);
+        t_mapped = time_ns([&] { apply(pool, h, day.data(), cut); });
+        t_ckpt = time_ns([&] { pool.checkpoint(); });
+    }
+    std::printf("%-48s %12s\n", "live day (first 90%)", "ns / event");
+    std::printf("%-48s %12.1f\n", "ll_list_pool (heap)", static_cast<double>(t_heap) / cut);
+    std::printf("%-48s %12.1f\n", "ll_persistent_list_pool (mapped file)", static_cast<double>(t_mapped) / cut);
+
+    // restart paths; each one is timed from the files to a usable id -> handle table
+    auto replay_once = [&](bool& ok)
+    {
+        std::uint64_t t = 0;
+        std::vector<ll_list_pool<order>::iterator> h;
+        ll_list_pool<order>* pool = nullptr;
+        t = time_ns([&]
+        {
+            ll_mmap_file log(log_path.c_str());
+            pool = new ll_list_pool<order>(capacity);
+            h.assign(ids, {});
+            apply(*pool, h, reinterpret_cast<const event*>(log.data()), cut);
+        });
+        ok = ids_of(*pool) == ref_cut;
+        delete pool;
+        return t;
+    };
+    auto reopen_once = [&](bool& ok, std::uint64_t& open_ns)
+    {
+        std::uint64_t t = 0;
+        std::vector<ppool::iterator> h;
+        ppool* pool = nullptr;
+        t = time_ns([&]
+        {
+            open_ns = time_ns([&] { pool = new ppool(pool_path.c_str(), ll_mmap_mode::read_write); });
+            h.assign(ids, {});
+            rebuild(*pool, h);
+        });
+        ok = ids_of(*pool) == ref_cut && pool->open_info().was_clean;
+        delete pool;
+        return t;
+    };
+
+    bool ok[4];
+    std::uint64_t open_ns[2];
+    const std::uint64_t t_replay_warm = replay_once(ok[0]);
+    evict(log_path.c_str());
+    const std::uint64_t t_replay_cold = replay_once(ok[1]);
+    const std::uint64_t t_open_warm = reopen_once(ok[2], open_ns[0]);
+    evict(pool_path.c_str());
+    const std::uint64_t t_open_cold = reopen_once(ok[3], open_ns[1]);
+
+    // incremental checkpoints, then the rest of the day in a process that dies
+    std::uint64_t t_small = 0, t_large = 0;
+    {
+        ppool pool(pool_path.c_str(), ll_mmap_mode::read_write);
+        std::vector<ppool::iterator> h(ids);
+        rebuild(pool, h);
+        apply(pool, h, day.data() + cut, small);
+        t_small = time_ns([&] { pool.checkpoint(); });
+        apply(pool, h, day.data() + cut + small, large);
+        t_large = time_ns([&] { pool.checkpoint(); });
+    }
+    const pid_t child = ::fork();
+    if (child == 0)
+    {
+        ppool pool(pool_path.c_str(), ll_mmap_mode::read_write);
+        std::vector<ppool::iterator> h(ids);
+        rebuild(pool, h);
+        apply(pool, h, day.data() + cut + small + large, n - cut - small - large);
+        std::raise(SIGKILL); // no checkpoint, no destructor
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    const bool killed = WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+
+    std::vector<ppool::iterator> hr;
+    ppool* rp = nullptr;
+    std::uint64_t t_recover_open = 0;
+    const std::uint64_t t_recover = time_ns([&]
+    {
+        t_recover_open = time_ns([&] { rp = new ppool(pool_path.c_str(), ll_mmap_mode::read_write); });
+        hr.assign(ids, {});
+        rebuild(*rp, hr);
+    });
+    const ll_persistent_open_info info = rp->open_info();
+    const bool ok_recover = killed && !info.was_clean && ids_of(*rp) == ref_final;
+    delete rp;
+
+    std::printf("%-48s %12s\n", "checkpoint (msync)", "ms");
+    std::printf("%-48s %12.2f\n", "after the day's first 90%", t_ckpt / 1e6);
+    std::printf("after %-42zu %12.2f\n", small, t_small / 1e6);
+    std::printf("after %-42zu %12.2f\n", large, t_large / 1e6);
+
+    std::printf("\n%-48s %12s %10s %8s\n", "restart to the state at 90% of the day", "ms", "open", "check");
+    std::printf("%-48s %12.1f %10s %8s\n", "replay journal into ll_list_pool, warm cache", t_replay_warm / 1e6, "-",
+                ok[0] ? "ok" : "FAIL");
+    std::printf("%-48s %12.1f %10s %8s\n", "replay journal, journal evicted", t_replay_cold / 1e6, "-",
+                ok[1] ? "ok" : "FAIL");
+    std::printf("%-48s %12.1f %7.0f us %8s\n", "reopen clean pool + rebuild handles, warm", t_open_warm / 1e6,
+                open_ns[0] / 1e3, ok[2] ? "ok" : "FAIL");
+    std::printf("%-48s %12.1f %7.0f us %8s\n", "reopen clean pool + rebuild handles, evicted", t_open_cold / 1e6,
+                open_ns[1] / 1e3, ok[3] ? "ok" : "FAIL");
+    std::printf("\nafter kill -9 at the close (%zu events since the last checkpoint):\n", n - cut - small - large);
+    std::printf("%-48s %12.1f %7.1f ms %8s\n", "reopen dirty pool (recovery) + rebuild handles", t_recover / 1e6,
+                t_recover_open / 1e6, ok_recover ? "ok" : "FAIL");
+    std::printf("recovered %zu orders, %zu orphans, truncated: %s\n", ref_final.size(), info.orphans,
+                info.truncated ? "yes" : "no");
+
+    std::remove(log_path.c_str());
+    std::remove(pool_path.c_str());
+    return ok[0] && ok[1] && ok[2] && ok[3] && ok_recover ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "ll_list_pool.hpp"
+
+/*
+ * Benchmark: ll_list_pool exhaustion handling
+ *
+ * usage: bench_pool_backpressure [ops = 4000000]
+ *
+ * 1. Hot path cost. Churn at 80% occupancy of a 100k pool: erase a random
+ *    order, add one in its place. ns per erase + add, best of REPS:
+ *    - emplace_back, no watermarks
+ *    - emplace_back, watermarks set but never reached
+ *    - try_emplace_back, watermarks set but never reached
+ *    - emplace_back, watermarks at the churn level: every add turns
+ *      pressure on, every erase turns it off (worst case, callback + flag)
+ * 2. A burst. 60% occupancy with one add and one cancel per step, then
+ *    a burst of 4 adds per cancel that needs 2.5x the capacity:
+ *    - emplace_back         : the first refused add throws (the old outcome)
+ *    - try_emplace_back     : refused adds are counted, the process lives
+ *    - watermarks 80% / 60% : the gateway reads the flag and sheds normal
+ *                             adds while it is set; priority adds (1 in
+ *                             64, e.g. hedges) always go through
+ *    Reported: peak, adds refused by the pool, priority adds refused,
+ *    adds shed upstream, pressure events, final size.
+ */
+
+static constexpr unsigned REPS = 5;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+struct order
+{
+    std::uint64_t id;
+    std::int64_t price;
+    std::int32_t qty;
+    std::uint32_t flags;
+};
+
+using pool = ll_list_pool<order>;
+
+static void count_call(void* ctx, std::size_t)
+{
+    ++*static_cast<std::uint64_t*>(ctx);
+}
+
+enum class mode
+{
+    plain,
+    armed,
+    try_armed,
+    flapping
+};
+
+static void hot_path(std::size_t ops)
+{
+    const std::size_t cap = 100'000, live = cap * 8 / 10;
+    std::mt19937_64 rng(122);
+    std::vector<std::uint32_t> victim(ops);
+    for (auto& v : victim) v = static_cast<std::uint32_t>(rng() % live);
+
+    static const char* names[4] = {"emplace_back, no watermarks", "emplace_back, watermarks armed",
+                                   "try_emplace_back, armed", "emplace_back, flapping at the mark"};
+    std::printf("\n=== Hot path: churn at %zu / %zu live, %zu erase + add pairs, best of %u ===\n", live, cap, ops, REPS);
+    std::printf("%-38s %10s %12s %12s\n", "mode", "ns/pair", "callbacks", "peak");
+    for (mode m : {mode::plain, mode::armed, mode::try_armed, mode::flapping})
+    {
+        pool p(cap);
+        std::vector<pool::iterator> h(live);
+        std::uint64_t next_id = 0;
+        for (auto& it : h) it = p.emplace_back(order{next_id++, 100, 1, 0});
+        std::uint64_t calls = 0;
+        std::atomic<bool> flag{false};
+        if (m == mode::armed || m == mode::try_armed)
+            p.set_watermarks({cap * 9 / 10, cap * 7 / 10, count_call, count_call, &calls, &flag});
+        if (m == mode::flapping) p.set_watermarks({live, live - 1, count_call, count_call, &calls, &flag});
+
+        std::uint64_t best = ~0ull;
+        bool ok = true;
+        for (unsigned rep = 0; rep < REPS; ++rep)
+        {
+            calls = 0; // report one run's callbacks
+            const std::uint64_t t = time_ns([&] {
+                for (std::size_t i = 0; i < ops; ++i)
+                {
+                    auto& slot = h[victim[i]];
+                    p.erase(slot);
+                    if (m == mode::try_armed)
+                    {
+                        auto r = p.try_emplace_back(order{next_id++, 100, 1, 0});
+                        if (!r) [[unlikely]] std::abort();
+                        slot = *r;
+                    }
+                    else
+                        slot = p.emplace_back(order{next_id++, 100, 1, 0});
+                }
+            });
+            best = std::min(best, t);
+            ok = ok && p.size() == live;
+        }
+        const ll_pool_stats st = p.stats();
+        std::printf("%-38s %10.2f %12llu %12zu%s\n", names[static_cast<int>(m)], static_cast<double>(best) / ops,
+                    static_cast<unsigned long long>(calls), st.peak, ok ? "" : "  SIZE MISMATCH");
+    }
+}
+
+struct burst_result
+{
+    std::size_t steps_run;
+    bool threw;
+    std::uint64_t shed;             // normal adds the gateway turned away under pressure
+    std::uint64_t priority_refused; // priority adds the pool could not take
+    ll_pool_stats st;
+};
+
+enum class policy
+{
+    throwing,
+    try_only,
+    throttled
+};
+
+static burst_result burst(policy pol)
+{
+    const std::size_t cap = 100'000, start = cap * 6 / 10;
+    const std::size_t calm = 50'000, burst_steps = 50'000, after = 150'000;
+    std::mt19937_64 rng(7);
+    pool p(cap);
+    std::vector<pool::iterator> live;
+    live.reserve(cap);
+    std::uint64_t next_id = 0;
+    for (std::size_t i = 0; i < start; ++i) live.push_back(p.emplace_back(order{next_id++, 100, 1, 0}));
+
+    std::atomic<bool> pressure{false};
+    if (pol == policy::throttled) p.set_watermarks({cap * 8 / 10, cap * 6 / 10, nullptr, nullptr, nullptr, &pressure});
+    p.reset_stats();
+
+    burst_result r{0, false, 0, 0, {}};
+    const std::size_t steps = calm + burst_steps + after;
+    for (std::size_t s = 0; s < steps && !r.threw; ++s)
+    {
+        // one cancel per step
+        if (!live.empty())
+        {
+            const std::size_t k = rng() % live.size();
+            p.erase(live[k]);
+            live[k] = live.back();
+            live.pop_back();
+        }
+        const unsigned adds = (s >= calm && s < calm + burst_steps) ? 4 : 1;
+        for (unsigned a = 0; a < adds; ++a)
+        {
+            const order o{next_id++, 100, 1, 0};
+            const bool priority = (rng() & 63) == 0; // e.g. hedges, must get in
+            // the gateway reads the flag and sheds normal flow under pressure
+            if (!priority && pressure.load(std::memory_order_relaxed))
+            {
+                ++r.shed;
+                continue;
+            }
+            if (pol == policy::throwing)
+            {
+                try
+                {
+                    live.push_back(p.emplace_back(o));
+                }
+                catch (const std::bad_alloc&)
+                {
+                    r.threw = true;
+                    break;
+                }
+            }
+            else if (auto it = p.try_emplace_back(o))
+                live.push_back(*it);
+            else if (priority)
+                ++r.priority_refused;
+        }
+        r.steps_run = s + 1;
+    }
+    r.st = p.stats();
+    return r;
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t ops = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+    hot_path(ops);
+
+    std::printf("\n=== Burst: capacity 100000, 60%% full; 50k calm steps (1 add, 1 cancel), 50k burst steps (4 adds, 1 cancel), 150k calm ===\n");
+    std::printf("%-26s %8s %9s %8s %8s %10s %9s %9s %8s\n", "policy", "steps", "outcome", "peak", "refused",
+                "prio refd", "shed", "pressure", "end");
+    for (policy pol : {policy::throwing, policy::try_only, policy::throttled})
+    {
+        static const char* names[3] = {"emplace_back (throws)", "try_emplace_back", "watermarks 80/60% + flag"};
+        const burst_result r = burst(pol);
+        std::printf("%-26s %8zu %9s %8zu %8llu %10llu %9llu %9llu %8zu\n", names[static_cast<int>(pol)], r.steps_run,
+                    r.threw ? "THREW" : "survived", r.st.peak, static_cast<unsigned long long>(r.st.exhausted),
+                    static_cast<unsigned long long>(r.priority_refused), static_cast<unsigned long long>(r.shed),
+                    static_cast<unsigned long long>(r.st.pressure_events), r.st.size);
+    }
+    return 0;
+}
@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ll_bloom_filter.hpp"
+#include "ll_count_min.hpp"
+#include "ll_hash.hpp"
+#include "ll_hyperloglog.hpp"
+
+/*
+ * Benchmark: probabilistic membership, cardinality and frequency
+ *
+ * 1. Membership: ll_blocked_bloom at 8 / 12 / 16 bits per key vs a classic
+ *    Bloom filter (k independent bit probes) and std::unordered_set.
+ *    Insert and probe cost (single and bulk), false positive rate on keys
+ *    never inserted, memory. Then A/B feed arbitration: two copies of a
+ *    sequenced feed, B jittered against A, deduplicated on the sequence
+ *    number.
+ * 2. Cardinality: ll_hyperloglog relative error from 10 to 10M distinct
+ *    keys (p = 12, 14), insert cost, and the "distinct order ids per
+ *    client" case: 10k clients with Zipf-sized id sets vs one
+ *    unordered_set per client.
+ * 3. Frequency: ll_count_min on a Zipf(1.1) stream over 1M keys,
+ *    plain vs conservative update, vs std::unordered_map counting.
+ *
+ * Hash-set memory is estimated as 32 bytes per node (16-byte node plus
+ * allocator header, rounded) plus 8 bytes per bucket.
+ */
+
+static constexpr std::size_t N_KEYS = 4'000'000;
+static constexpr std::size_t N_STREAM = 10'000'000;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+static double per(std::uint64_t ns, std::size_t n)
+{
+    return static_cast<double>(ns) / static_cast<double>(n);
+}
+
+template <class S>
+static std::size_t set_bytes(const S& s)
+{
+    return s.size() * 32 + s.bucket_count() * 8;
+}
+
+// textbook Bloom filter: k probes anywhere in one bit array
+class classic_bloom
+{
+    std::vector<std::uint64_t> bits_;
+    std::uint64_t nbits_;
+    unsigned k_;
+
+public:
+    classic_bloom(std::size_t n, double bits_per_key)
+        : bits_(static_cast<std::size_t>(static_cast<double>(n) * bits_per_key / 64) + 1)
+        , nbits_(bits_.size() * 64)
+        , k_(static_cast<unsigned>(std::lround(bits_per_key * 0.693)))
+    {
+    }
+    void insert(std::uint64_t key)
+    {
+        const std::uint64_t h = ll_mix64(key), h2 = (h >> 32) | 1;
+        for (unsigned i = 0; i < k_; ++i)
+        {
+            const std::uint64_t b = (h + i * h2) % nbits_;
+            bits_[b >> 6] |= std::uint64_t{1} << (b & 63);
+        }
+    }
+    bool contains(std::uint64_t key) const
+    {
+        const std::uint64_t h = ll_mix64(key), h2 = (h >> 32) | 1;
+        for (unsigned i = 0; i < k_; ++i)
+        {
+            const std::uint64_t b = (h + i * h2) % nbits_;
+            if (!(bits_[b >> 6] >> (b & 63) & 1)) return false;
+        }
+        return true;
+    }
+    std::size_t memory_bytes() const
+    {
+        return bits_.size() * 8;
+    }
+};
+
+// ---------------------------------------------------------------------------
+
+static void membership(std::mt19937_64& rng)
+{
+    std::cout << "\n=== Membership: " << N_KEYS << " keys inserted, " << N_KEYS << " absent keys probed ===\n";
+    std::vector<std::uint64_t> keys(N_KEYS), absent(N_KEYS);
+    for (auto& k : keys) k = rng();
+    for (auto& k : absent) k = rng();
+    std::unique_ptr<bool[]> out(new bool[N_KEYS]);
+
+    std::printf("%-22s %9s %9s %9s %9s %10s %11s\n", "structure", "ins ns", "bulk ins", "probe ns", "bulk prb",
+                "false pos", "bytes");
+    for (double bpk : {8.0, 12.0, 16.0})
+    {
+        ll_blocked_bloom single(N_KEYS, bpk), bulk(N_KEYS, bpk);
+        const std::uint64_t t_ins = time_ns([&] {
+            for (std::uint64_t k : keys) single.insert(k);
+        });
+        const std::uint64_t t_bulk = time_ns([&] { bulk.insert(keys); });
+        std::size_t fp = 0;
+        const std::uint64_t t_probe = time_ns([&] {
+            for (std::uint64_t k : absent) fp += single.contains(k);
+        });
+        std::size_t fp_bulk = 0;
+        const std::uint64_t t_bprobe = time_ns([&] { fp_bulk = bulk.contains(absent, out.get()); });
+        std::size_t hits = bulk.contains(keys, out.get());
+        char label[48];
+        std::snprintf(label, sizeof label, "blocked bloom %2.0f b/key", bpk);
+        std::printf("%-22s %9.1f %9.1f %9.1f %9.1f %9.3f%% %11zu%s\n", label, per(t_ins, N_KEYS), per(t_bulk, N_KEYS),
+                    per(t_probe, N_KEYS), per(t_bprobe, N_KEYS), 100.0 * static_cast<double>(fp) / N_KEYS,
+                    bulk.memory_bytes(), hits == N_KEYS && fp == fp_bulk ? "" : "  MISMATCH");
+    }
+    {
+        classic_bloom b(N_KEYS, 12.0);
+        const std::uint64_t t_ins = time_ns([&] {
+            for (std::uint64_t k : keys) b.insert(k);
+        });
+        std::size_t fp = 0;
+        const std::uint64_t t_probe = time_ns([&] {
+            for (std::uint64_t k : absent) fp += b.contains(k);
+        });
+        std::printf("%-22s %9.1f %9s %9.1f %9s %9.3f%% %11zu\n", "classic bloom 12 b/key", per(t_ins, N_KEYS), "-",
+                    per(t_probe, N_KEYS), "-", 100.0 * static_cast<double>(fp) / N_KEYS, b.memory_bytes());
+    }
+    {
+        std::unordered_set<std::uint64_t> s;
+        const std::uint64_t t_ins = time_ns([&] {
+            for (std::uint64_t k : keys) s.insert(k);
+        });
+        std::size_t fp = 0;
+        const std::uint64_t t_probe = time_ns([&] {
+            for (std::uint64_t k : absent) fp += s.count(k);
+        });
+        std::printf("%-22s %9.1f %9s %9.1f %9s %9.3f%% %11zu\n", "std::unordered_set", per(t_ins, N_KEYS), "-",
+                    per(t_probe, N_KEYS), "-", 100.0 * static_cast<double>(fp) / N_KEYS, set_bytes(s));
+    }
+
+    // A/B arbitration: every sequence number arrives on both feeds, B
+    // displaced by up to 64 messages; forward the first copy only
+    std::vector<std::uint64_t> b(N_KEYS);
+    for (std::uint64_t s = 1; s <= N_KEYS; ++s) b[s - 1] = s;
+    for (std::size_t i = 0; i + 1 < b.size(); ++i) std::swap(b[i], b[std::min(b.size() - 1, i + rng() % 64)]);
+    std::vector<std::uint64_t> merged; // arrival order of sequence numbers
+    merged.reserve(2 * N_KEYS);
+    for (std::size_t i = 0; i < N_KEYS; ++i)
+    {
+        merged.push_back(i + 1);
+        merged.push_back(b[i]);
+    }
+    ll_blocked_bloom seen(N_KEYS, 12.0);
+    std::size_t forwarded = 0;
+    const std::uint64_t t = time_ns([&] {
+        for (std::uint64_t seq : merged) forwarded += !seen.test_and_insert_hash(ll_mix64(seq));
+    });
+    std::printf("A/B dedup (12 b/key): %.1f ns/message, forwarded %zu of %zu unique (%zu lost to false positives)\n",
+                per(t, merged.size()), forwarded, N_KEYS, N_KEYS - forwarded);
+}
+
+// ---------------------------------------------------------------------------
+
+static void cardinality(std::mt19937_64& rng)
+{
+    std::cout << "\n=== Cardinality: ll_hyperloglog ===\n";
+    std::printf("%10s  %-4s %8s %8s %7s %9s\n", "distinct", "p", "bias", "rms err", "mode", "bytes");
+    for (unsigned p : {12u, 14u})
+        for (std::size_t n : {10ul, 100ul, 1000ul, 10'000ul, 100'000ul, 1'000'000ul, 10'000'000ul})
+        {
+            const unsigned trials = n <= 100'000 ? 20 : n <= 1'000'000 ? 5 : 1;
+            double bias = 0.0, sq = 0.0;
+            std::size_t bytes = 0;
+            bool dense = false;
+            std::vector<std::uint64_t> ks(n);
+            for (unsigned t = 0; t < trials; ++t)
+            {
+                for (auto& k : ks) k = rng();
+                ll_hyperloglog h(p);
+                h.add(ks);
+                const double e = (h.estimate() - static_cast<double>(n)) / static_cast<double>(n);
+                bias += e;
+                sq += e * e;
+                bytes = h.memory_bytes();
+                dense = h.is_dense();
+            }
+            std::printf("%10zu  %-4u %+7.3f%% %7.3f%% %7s %9zu\n", n, p, 100.0 * bias / trials,
+                        100.0 * std::sqrt(sq / trials), dense ? "dense" : "sparse", bytes);
+        }
+
+    // insert cost, 10M distinct keys
+    std::vector<std::uint64_t> ks(N_STREAM);
+    for (auto& k : ks) k = rng();
+    ll_hyperloglog single(14), bulk(14);
+    const std::uint64_t t1 = time_ns([&] {
+        for (std::uint64_t k : ks) single.add(k);
+    });
+    const std::uint64_t t2 = time_ns([&] { bulk.add(ks); });
+    std::unordered_set<std::uint64_t> exact;
+    const std::size_t n_exact = N_STREAM / 4;
+    const std::uint64_t t3 = time_ns([&] {
+        for (std::size_t i = 0; i < n_exact; ++i) exact.insert(ks[i]);
+    });
+    std::printf("insert p=14: single %.1f ns, bulk %.1f ns, unordered_set %.1f ns/key (%zu keys, %zu bytes)\n",
+                per(t1, N_STREAM), per(t2, N_STREAM), per(t3, n_exact), n_exact, set_bytes(exact));
+
+    // distinct order ids per client, Zipf-sized: client i sends ~ 2M / (i + 1) ids
+    constexpr std::size_t CLIENTS = 10'000;
+    std::vector<ll_hyperloglog> hll(CLIENTS, ll_hyperloglog(12));
+    std::vector<std::unordered_set<std::uint64_t>> sets(CLIENTS);
+    std::size_t ids = 0, hll_bytes = 0, set_total = 0;
+    std::uint64_t t_hll = 0, t_set = 0;
+    double err_sum = 0.0, err_max = 0.0;
+    for (std::size_t c = 0; c < CLIENTS; ++c)
+    {
+        const std::size_t n = std::max<std::size_t>(1, 2'000'000 / (c + 1));
+        ks.resize(n);
+        for (auto& k : ks) k = rng();
+        ids += n;
+        t_hll += time_ns([&] { hll[c].add(ks); });
+        t_set += time_ns([&] {
+            for (std::uint64_t k : ks) sets[c].insert(k);
+        });
+        const double e = std::abs(hll[c].estimate() - static_cast<double>(n)) / static_cast<double>(n);
+        err_sum += e;
+        err_max = std::max(err_max, e);
+        hll_bytes += hll[c].memory_bytes();
+        set_total += set_bytes(sets[c]);
+        std::unordered_set<std::uint64_t>().swap(sets[c]); // keep the sandbox within memory
+    }
+    std::printf("%zu clients, %zu order ids: HLL p=12 %.1f ns/id, %.2f MB, mean err %.2f%%, max %.2f%%\n", CLIENTS, ids,
+                per(t_hll, ids), static_cast<double>(hll_bytes) / 1e6, 100.0 * err_sum / CLIENTS, 100.0 * err_max);
+    std::printf("%*s unordered_set per client %.1f ns/id, %.2f MB\n", 40, "", per(t_set, ids),
+                static_cast<double>(set_total) / 1e6);
+}
+
+// ---------------------------------------------------------------------------
+
+static void frequency(std::mt19937_64& rng)
+{
+    constexpr std::size_t UNIVERSE = 1'000'000;
+    std::cout << "\n=== Frequency: Zipf(1.1) over " << UNIVERSE << " keys, " << N_STREAM << " events ===\n";
+    std::vector<double> cdf(UNIVERSE);
+    double acc = 0.0;
+    for (std::size_t i = 0; i < UNIVERSE; ++i) cdf[i] = acc += 1.0 / std::pow(static_cast<double>(i + 1), 1.1);
+    std::uniform_real_distribution<double> u(0.0, acc);
+    std::vector<std::uint64_t> stream(N_STREAM);
+    for (auto& k : stream)
+        k = ll_mix64(static_cast<std::uint64_t>(std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin()));
+
+    std::unordered_map<std::uint64_t, std::uint32_t> exact;
+    const std::uint64_t t_map = time_ns([&] {
+        for (std::uint64_t k : stream) ++exact[k];
+    });
+    std::printf("%-26s %8s %8s %12s %12s %10s\n", "structure", "add ns", "bulk ns", "top-100 err", "mean abs err",
+                "bytes");
+    std::printf("%-26s %8.1f %8s %12s %12s %10zu\n", "std::unordered_map", per(t_map, N_STREAM), "-", "exact", "exact",
+                exact.size() * 32 + exact.bucket_count() * 8);
+
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> top;
+    for (const auto& [k, c] : exact) top.emplace_back(c, k);
+    std::partial_sort(top.begin(), top.begin() + 100, top.end(), std::greater<>());
+
+    for (std::size_t width : {std::size_t{1} << 14, std::size_t{1} << 16})
+        for (bool cons : {false, true})
+        {
+            ll_count_min single(width, 4, cons), bulk(width, 4, cons);
+            const std::uint64_t t1 = time_ns([&] {
+                for (std::uint64_t k : stream) single.add(k);
+            });
+            const std::uint64_t t2 = time_ns([&] { bulk.add(stream); });
+            double top_err = 0.0, abs_err = 0.0;
+            bool under = false;
+            for (std::size_t i = 0; i < 100; ++i)
+                top_err += static_cast<double>(bulk.estimate(top[i].second) - top[i].first) / top[i].first;
+            for (const auto& [k, c] : exact)
+            {
+                const std::uint64_t e = bulk.estimate(k);
+                under = under || e < c || e != single.estimate(k);
+                abs_err += static_cast<double>(e - c);
+            }
+            char label[48];
+            std::snprintf(label, sizeof label, "count-min 4x%zu%s", width, cons ? " conserv." : "");
+            std::printf("%-26s %8.1f %8.1f %11.3f%% %12.2f %10zu%s\n", label, per(t1, N_STREAM), per(t2, N_STREAM),
+                        100.0 * top_err / 100, abs_err / static_cast<double>(exact.size()), bulk.memory_bytes(),
+                        under ? "  MISMATCH" : "");
+        }
+    std::printf("(e / width * N: %.0f for 2^14, %.0f for 2^16)\n", std::exp(1.0) / 16384 * N_STREAM,
+                std::exp(1.0) / 65536 * N_STREAM);
+}
+
+int main()
+{
+    std::mt19937_64 rng(2024);
+    membership(rng);
+    cardinality(rng);
+    frequency(rng);
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ll_latency_histogram.hpp"
+#include "ll_quantile_sketch.hpp"
+
+/*
+ * Benchmark: streaming quantile sketches vs keeping every sample
+ *
+ * N samples of two distributions:
+ * - latency : lognormal body (median ~2 us) with a 0.5% slow tail ~50x
+ * - price   : normal around 100.00 with 0.01 ticks
+ *
+ * For each method: insert cost, bytes held, and error at p50 .. p99.99
+ * against the exact (sorted) answer. Error is reported as
+ * - rank error : |F(estimate) - q| where F is the exact empirical CDF
+ * - value error: |estimate - exact| / exact
+ *
+ * - exact sort        : keep every sample, sort once at the end
+ * - ll_kll_sketch     : k = 100, 200, 400; k = 200 with a 1024-wide buffer
+ * - ll_tdigest        : delta = 50, 100, 200, 500
+ * - ll_latency_histogram (integers, 7 sub-bits) for reference on latency
+ *
+ * Finally THREADS threads each sketch a slice and the sketches are merged,
+ * to check that merging costs no accuracy.
+ */
+
+static constexpr std::size_t N = 10'000'000;
+static constexpr unsigned THREADS = 4;
+static constexpr double QS[] = {0.5, 0.9, 0.99, 0.999, 0.9999};
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+struct exact_cdf
+{
+    std::vector<double> sorted;
+
+    double quantile(double q) const
+    {
+        const auto i = static_cast<std::size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+        return sorted[std::min(sorted.size() - 1, i == 0 ? 0 : i - 1)];
+    }
+    // midpoint of the rank interval of x, so ties are not penalised
+    double rank(double x) const
+    {
+        const auto lo = std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin();
+        const auto hi = std::upper_bound(sorted.begin(), sorted.end(), x) - sorted.begin();
+        return (static_cast<double>(lo) + static_cast<double>(hi)) / 2.0 / static_cast<double>(sorted.size());
+    }
+};
+
+static void header()
+{
+    std::printf("%-16s %8s %9s", "method", "ns/ins", "bytes");
+    for (double q : QS) std::printf("   p%-7g", q * 100);
+    std::printf("   (rank err / value err)\n");
+}
+
+template <class Q>
+static void report(const char* what, std::uint64_t ns, std::size_t bytes, const exact_cdf& ex, Q&& quantile)
+{
+    std::printf("%-16s %8.2f %9zu", what, static_cast<double>(ns) / N, bytes);
+    for (double q : QS)
+    {
+        const double est = quantile(q);
+        const double rerr = std::abs(ex.rank(est) - q);
+        const double verr = std::abs(est - ex.quantile(q)) / std::abs(ex.quantile(q));
+        std::printf("  %.0e/%.0e", rerr, verr);
+    }
+    std::printf("\n");
+}
+
+static void run(const char* name, const std::vector<double>& data, bool integral)
+{
+    std::cout << "\n=== " << name << ": " << N << " samples ===\n";
+    header();
+
+    exact_cdf ex;
+    std::uint64_t t = time_ns([&] {
+        ex.sorted = data;
+        std::sort(ex.sorted.begin(), ex.sorted.end());
+    });
+    report("exact sort", t, N * sizeof(double), ex, [&](double q) { return ex.quantile(q); });
+
+    for (auto [k, buffer] : {std::pair{100u, 0u}, {200u, 0u}, {400u, 0u}, {200u, 1024u}})
+    {
+        ll_kll_sketch s(k, buffer);
+        t = time_ns([&] { s.insert(data); });
+        char label[32];
+        std::snprintf(label, sizeof label, buffer ? "kll k=%u b=%u" : "kll k=%u", k, buffer);
+        report(label, t, s.memory_bytes(), ex, [&](double q) { return s.quantile(q); });
+    }
+
+    for (double d : {50.0, 100.0, 200.0, 500.0})
+    {
+        ll_tdigest s(d);
+        t = time_ns([&] {
+            s.insert(data);
+            s.flush();
+        });
+        char label[32];
+        std::snprintf(label, sizeof label, "tdigest d=%g", d);
+        report(label, t, s.memory_bytes(), ex, [&](double q) { return s.quantile(q); });
+    }
+
+    if (integral)
+    {
+        ll_latency_histogram h;
+        t = time_ns([&] {
+            for (double v : data) h.record(static_cast<std::uint64_t>(v));
+        });
+        report("hdr histogram", t, (65 - 7) * 128 * sizeof(std::uint64_t), ex,
+               [&](double q) { return static_cast<double>(h.percentile(q * 100.0)); });
+    }
+
+    // per-thread sketches, merged for reporting
+    std::vector<ll_kll_sketch> kll(THREADS, ll_kll_sketch(200));
+    std::vector<ll_tdigest> td(THREADS, ll_tdigest(100));
+    for (unsigned i = 0; i < THREADS; ++i) kll[i] = ll_kll_sketch(200, 0, 0x1234567ull * (i + 1));
+    t = time_ns([&] {
+        std::vector<std::thread> th;
+        for (unsigned i = 0; i < THREADS; ++i)
+            th.emplace_back([&, i] {
+                const std::size_t lo = N * i / THREADS, hi = N * (i + 1) / THREADS;
+                std::span<const double> slice(data.data() + lo, hi - lo);
+                kll[i].insert(slice);
+                td[i].insert(slice);
+            });
+        for (auto& x : th) x.join();
+        for (unsigned i = 1; i < THREADS; ++i)
+        {
+            kll[0].merge(kll[i]);
+            td[0].merge(td[i]);
+        }
+    });
+    std::printf("%u threads, both sketches, merged: %.1f ms total\n", THREADS, static_cast<double>(t) / 1e6);
+    report("kll merged", 0, kll[0].memory_bytes(), ex, [&](double q) { return kll[0].quantile(q); });
+    report("tdigest merged", 0, td[0].memory_bytes(), ex, [&](double q) { return td[0].quantile(q); });
+}
+
+int main()
+{
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> body(std::log(2000.0), 0.35);
+    std::lognormal_distribution<double> slow(std::log(100000.0), 0.6);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::normal_distribution<double> px(10000.0, 150.0);
+
+    std::vector<double> latency(N), price(N);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        latency[i] = std::round(u(rng) < 0.005 ? slow(rng) : body(rng)); // integral ns
+        price[i] = std::round(px(rng)) / 100.0;                             // 0.01 ticks
+    }
+
+    run("latency (ns, lognormal + slow tail)", latency, true);
+    run("price (normal, 0.01 ticks)", price, false);
+}
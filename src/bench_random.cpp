@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "ll_list_pool.hpp"
+#include "ll_random.hpp"
+
+/*
+ * Benchmark: random number generation for benchmark harnesses
+ *
+ * usage: bench_random [values = 33554432] [splice ops = 5000000]
+ *
+ * 1. Raw 64-bit output, ns per value: std::mt19937 (32-bit values),
+ *    std::mt19937_64, ll_xoshiro256pp, ll_wyrand, ll_xoshiro256pp_x8::fill.
+ * 2. Uniform indices in [0, 1000000), ns per value: the distribution
+ *    benchmark_splice used (mt19937 + uniform_int_distribution), the
+ *    64-bit one, ll_uniform_below on xoshiro / wyrand, and fill_below.
+ *    Checks: chi-square over 1000 buckets, and residues mod 3 for
+ *    range 3 * 2^30 where plain multiply-shift would put half the values
+ *    on multiples of 3.
+ * 3. Zipf over 1M ranks, s = 0.99: std::discrete_distribution,
+ *    ll_zipf_sampler (rejection-inversion) and ll_alias_sampler built from
+ *    ll_zipf_weights. Setup time, ns per value, share of rank 1, and
+ *    chi-square / df of 10M draws over the 20 log2 rank buckets.
+ * 4. What the generator does to a splice benchmark: benchmark_splice's
+ *    loop on a 1M-node ll_list_pool with the index drawn inside the timed
+ *    loop, against an index stream pregenerated outside it.
+ */
+
+static constexpr unsigned REPS = 3;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// best of REPS, ns per value; f(n) must return something derived from
+// every value so the work cannot be dropped
+template <class F>
+static double per_value(std::size_t n, F&& f)
+{
+    std::uint64_t best = ~0ull;
+    volatile std::uint64_t sink = 0;
+    for (unsigned r = 0; r < REPS; ++r)
+    {
+        std::uint64_t x = 0;
+        best = std::min(best, time_ns([&] { x = f(n); }));
+        sink = sink + x;
+    }
+    return static_cast<double>(best) / n;
+}
+
+static void row(const char* name, double ns, const char* note = "")
+{
+    std::printf("%-44s %8.2f  %s\n", name, ns, note);
+}
+
+static void raw_output(std::size_t n)
+{
+    std::printf("\n=== Raw output: %zu values, ns per value, best of %u ===\n", n, REPS);
+    std::printf("%-44s %8s\n", "generator", "ns");
+    row("std::mt19937 (32-bit values)", per_value(n, [](std::size_t k) {
+            std::mt19937 g(1);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; ++i) x ^= g();
+            return x;
+        }));
+    row("std::mt19937_64", per_value(n, [](std::size_t k) {
+            std::mt19937_64 g(1);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; ++i) x ^= g();
+            return x;
+        }));
+    row("ll_xoshiro256pp", per_value(n, [](std::size_t k) {
+            ll_xoshiro256pp g(1);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; ++i) x ^= g();
+            return x;
+        }));
+    row("ll_wyrand", per_value(n, [](std::size_t k) {
+            ll_wyrand g(1);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; ++i) x ^= g();
+            return x;
+        }));
+    row("ll_xoshiro256pp_x8::fill (4096 at a time)", per_value(n, [](std::size_t k) {
+            ll_xoshiro256pp_x8 g(1);
+            std::vector<std::uint64_t> buf(4096);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; i += buf.size())
+            {
+                g.fill(buf.data(), buf.size());
+                for (std::uint64_t v : buf) x ^= v;
+            }
+            return x;
+        }), "includes reading the buffer back");
+}
+
+static double chi_square(const std::vector<std::uint64_t>& counts, std::uint64_t total)
+{
+    const double expect = static_cast<double>(total) / counts.size();
+    double c = 0.0;
+    for (std::uint64_t k : counts) c += (k - expect) * (k - expect) / expect;
+    return c / (counts.size() - 1);
+}
+
+static void bounded(std::size_t n)
+{
+    const std::uint32_t range = 1'000'000;
+    std::printf("\n=== Uniform in [0, %u): %zu values, ns per value, best of %u ===\n", range, n, REPS);
+    std::printf("%-44s %8s\n", "method", "ns");
+    row("mt19937 + uniform_int_distribution<size_t>", per_value(n, [&](std::size_t k) {
+            std::mt19937 g(1);
+            std::uniform_int_distribution<std::size_t> pick(0, range - 1);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; ++i) x += pick(g);
+            return x;
+        }), "benchmark_splice before");
+    row("mt19937_64 + uniform_int_distribution", per_value(n, [&](std::size_t k) {
+            std::mt19937_64 g(1);
+            std::uniform_int_distribution<std::uint64_t> pick(0, range - 1);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; ++i) x += pick(g);
+            return x;
+        }));
+    row("ll_xoshiro256pp + ll_uniform_below", per_value(n, [&](std::size_t k) {
+            ll_xoshiro256pp g(1);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; ++i) x += ll_uniform_below(g, range);
+            return x;
+        }));
+    row("ll_wyrand + ll_uniform_below", per_value(n, [&](std::size_t k) {
+            ll_wyrand g(1);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; ++i) x += ll_uniform_below(g, range);
+            return x;
+        }));
+    row("ll_xoshiro256pp_x8::fill_below (4096)", per_value(n, [&](std::size_t k) {
+            ll_xoshiro256pp_x8 g(1);
+            std::vector<std::uint32_t> buf(4096);
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < k; i += buf.size())
+            {
+                g.fill_below(buf.data(), buf.size(), range);
+                for (std::uint32_t v : buf) x += v;
+            }
+            return x;
+        }), "includes reading the buffer back");
+
+    // quality: chi-square / df over 1000 buckets should be near 1
+    const std::size_t samples = 10'000'000;
+    std::vector<std::uint64_t> a(1000), b(1000), c(1000);
+    ll_xoshiro256pp gx(9);
+    ll_wyrand gw(9);
+    ll_xoshiro256pp_x8 g8(9);
+    std::vector<std::uint32_t> batch(samples);
+    g8.fill_below(batch.data(), samples, 1000);
+    for (std::size_t i = 0; i < samples; ++i)
+    {
+        ++a[ll_uniform_below(gx, 1000)];
+        ++b[ll_uniform_below(gw, 1000)];
+        ++c[batch[i]];
+    }
+    std::printf("chi-square / df, 1000 buckets, %zu draws: xoshiro %.3f, wyrand %.3f, fill_below %.3f\n", samples,
+                chi_square(a, samples), chi_square(b, samples), chi_square(c, samples));
+
+    // range 3 * 2^30: 2^32 mod range = 2^30, so without rejection every
+    // multiple of 3 would get two 32-bit inputs and the rest one
+    const std::uint32_t odd = 3u << 30;
+    g8.fill_below(batch.data(), samples, odd);
+    std::uint64_t mult3 = 0;
+    for (std::uint32_t v : batch) mult3 += v % 3 == 0;
+    std::printf("fill_below(3 * 2^30): share of multiples of 3 = %.4f (unbiased 0.3333, no rejection 0.5000)\n",
+                static_cast<double>(mult3) / samples);
+}
+
+static void zipf(std::size_t n)
+{
+    const std::uint32_t ranks = 1'000'000;
+    const double s = 0.99;
+    std::printf("\n=== Zipf over %u ranks, s = %.2f: %zu values, best of %u ===\n", ranks, s, n, REPS);
+
+    const std::vector<double> w = ll_zipf_weights(ranks, s);
+    double total = 0.0;
+    for (double x : w) total += x;
+
+    std::discrete_distribution<std::uint32_t>* dd = nullptr;
+    const double dd_setup = time_ns([&] { dd = new std::discrete_distribution<std::uint32_t>(w.begin(), w.end()); }) / 1e6;
+    ll_alias_sampler* alias = nullptr;
+    const double alias_setup = time_ns([&] { alias = new ll_alias_sampler(w); }) / 1e6;
+    const ll_zipf_sampler rej(ranks, s);
+
+    // expected share of each log2 rank bucket [2^b - 1, 2^(b+1) - 1)
+    std::vector<double> expect(std::bit_width(ranks));
+    for (std::uint32_t k = 0; k < ranks; ++k) expect[std::bit_width(k + 1) - 1] += w[k] / total;
+
+    std::printf("%-44s %8s %9s %9s %9s\n", "sampler", "ns", "setup ms", "rank 1 %", "chi2/df");
+    auto report = [&](const char* name, double ns, double setup, auto&& draw) {
+        const std::size_t samples = 10'000'000;
+        std::vector<std::uint64_t> hits(expect.size());
+        std::uint64_t top = 0;
+        for (std::size_t i = 0; i < samples; ++i)
+        {
+            const std::uint32_t k = draw();
+            ++hits[std::bit_width(k + 1) - 1];
+            top += k == 0;
+        }
+        double chi = 0.0;
+        for (std::size_t b = 0; b < expect.size(); ++b)
+        {
+            const double e = expect[b] * samples;
+            chi += (hits[b] - e) * (hits[b] - e) / e;
+        }
+        std::printf("%-44s %8.2f %9.1f %9.3f %9.3f\n", name, ns, setup, 100.0 * top / samples,
+                    chi / (expect.size() - 1));
+    };
+    std::printf("%-44s %8s %9s %9.3f %9s\n", "(expected)", "", "", 100.0 * w[0] / total, "~1");
+
+    std::mt19937_64 gm(3);
+    report("std::discrete_distribution + mt19937_64", per_value(n, [&](std::size_t k) {
+               std::mt19937_64 g(1);
+               std::uint64_t x = 0;
+               for (std::size_t i = 0; i < k; ++i) x += (*dd)(g);
+               return x;
+           }), dd_setup, [&] { return (*dd)(gm); });
+    ll_xoshiro256pp g1(3);
+    report("ll_zipf_sampler + ll_xoshiro256pp", per_value(n, [&](std::size_t k) {
+               ll_xoshiro256pp g(1);
+               std::uint64_t x = 0;
+               for (std::size_t i = 0; i < k; ++i) x += rej(g);
+               return x;
+           }), 0.0, [&] { return static_cast<std::uint32_t>(rej(g1)); });
+    ll_xoshiro256pp g2(3);
+    report("ll_alias_sampler + ll_xoshiro256pp", per_value(n, [&](std::size_t k) {
+               ll_xoshiro256pp g(1);
+               std::uint64_t x = 0;
+               for (std::size_t i = 0; i < k; ++i) x += (*alias)(g);
+               return x;
+           }), alias_setup, [&] { return (*alias)(g2); });
+    delete dd;
+    delete alias;
+}
+
+struct order
+{
+    std::uint64_t id;
+    std::int64_t price;
+    std::int32_t qty;
+    std::uint32_t flags;
+};
+
+static void splice(std::size_t ops)
+{
+    const std::size_t nodes = 1'000'000;
+    std::printf("\n=== Splice to front of a %zu-node ll_list_pool, %zu ops, best of %u ===\n", nodes, ops, REPS);
+    std::printf("%-44s %8s %12s\n", "index source", "ns/op", "gen ns/op");
+
+    ll_list_pool<order> pool(nodes);
+    std::vector<ll_list_pool<order>::iterator> it(nodes);
+    for (std::size_t i = 0; i < nodes; ++i) it[i] = pool.emplace_back(order{i, 100, 1, 0});
+
+    std::printf("%-44s %8.2f %12s\n", "in loop: mt19937 + uniform_int_distribution", per_value(ops, [&](std::size_t k) {
+                    std::mt19937 g(42);
+                    std::uniform_int_distribution<std::size_t> pick(0, nodes - 1);
+                    for (std::size_t i = 0; i < k; ++i) pool.splice(pool.begin(), it[pick(g)]);
+                    return pool.begin()->id;
+                }), "-");
+    std::printf("%-44s %8.2f %12s\n", "in loop: ll_xoshiro256pp + ll_uniform_below", per_value(ops, [&](std::size_t k) {
+                    ll_xoshiro256pp g(42);
+                    for (std::size_t i = 0; i < k; ++i) pool.splice(pool.begin(), it[ll_uniform_below(g, nodes)]);
+                    return pool.begin()->id;
+                }), "-");
+
+    std::vector<std::uint32_t> picks;
+    const double gen = static_cast<double>(time_ns([&] { picks = ll_uniform_indices(ops, nodes, 42); })) / ops;
+    std::printf("%-44s %8.2f %12.2f\n", "pregenerated: ll_uniform_indices", per_value(ops, [&](std::size_t k) {
+                    for (std::size_t i = 0; i < k; ++i) pool.splice(pool.begin(), it[picks[i]]);
+                    return pool.begin()->id;
+                }), gen);
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1u << 25);
+    const std::size_t ops = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5'000'000;
+    raw_output(n);
+    bounded(n);
+    zipf(n / 8);
+    splice(ops);
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "ll_range_query.hpp"
+
+/*
+ * Benchmark: range-query structures vs naive scans
+ *
+ * usage: bench_range_query [max_n = 100000000] [memory budget GB = 3]
+ *
+ * For n = 10^5 .. max_n (x10), OPS random operations each, ranges uniform
+ * over [0, n) (mean length n / 3):
+ * - Fenwick, int64 sum   : 50% point add / 50% range sum; plus lower_bound
+ *   (first index where the prefix reaches a target, as on a volume-at-price
+ *   profile)
+ * - lazy segment tree    : int64 sum with range add, 50% add / 50% sum
+ * - sparse table, int32  : range min, after an O(n log n) build
+ * Naive: the same operations on a plain array (point update O(1), range
+ * update / query O(length)). The naive side runs only the first ops, as
+ * many as fit ~3*10^9 element visits; both sides checksum the answers to
+ * those ops and must agree. Structures whose estimated footprint exceeds
+ * the budget are skipped (the sparse table needs 4 n log n bytes).
+ */
+
+static constexpr std::size_t OPS = 1'000'000;
+static constexpr double NAIVE_VISITS = 3e9;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+struct op
+{
+    std::uint32_t l, r; // [l, r) or point l
+    std::int32_t v;     // 0 = query, otherwise the update value
+};
+
+static std::vector<op> make_ops(std::size_t n, bool point_updates, std::uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<op> ops(OPS);
+    for (op& o : ops)
+    {
+        std::uint32_t a = static_cast<std::uint32_t>(rng() % n), b = static_cast<std::uint32_t>(rng() % n);
+        if (a > b) std::swap(a, b);
+        o = {a, b + 1, rng() % 2 ? static_cast<std::int32_t>(1 + rng() % 100) : 0};
+        if (point_updates && o.v) o.r = o.l + 1;
+    }
+    return ops;
+}
+
+static std::size_t naive_ops(std::size_t n)
+{
+    return std::max<std::size_t>(8, std::min<std::size_t>(OPS, static_cast<std::size_t>(NAIVE_VISITS / (n / 3.0))));
+}
+
+static void row(const char* what, std::size_t n, double struct_ns, double naive_ns, bool ok, std::size_t bytes)
+{
+    std::printf("%-22s %11zu %10.1f %14.1f %9.0fx %8.0f MB  %s\n", what, n, struct_ns, naive_ns, naive_ns / struct_ns,
+                bytes / 1048576.0, ok ? "ok" : "MISMATCH");
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t max_n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000'000;
+    const double budget = (argc > 2 ? std::strtod(argv[2], nullptr) : 3.0) * 1073741824.0;
+
+    std::printf("\n=== Range queries, %zu random ops per size (ns per op) ===\n", OPS);
+    std::printf("%-22s %11s %10s %14s %10s %11s\n", "structure", "n", "struct", "naive", "speedup", "memory");
+
+    for (std::size_t n = 100'000; n <= max_n; n *= 10)
+    {
+        std::mt19937_64 rng(n);
+        const std::size_t p = naive_ops(n);
+
+        // Fenwick, point add + range sum
+        if (16.0 * n <= budget)
+        {
+            std::vector<std::int64_t> a(n);
+            for (auto& x : a) x = static_cast<std::int64_t>(rng() % 1000);
+            const std::vector<op> ops = make_ops(n, true, 1);
+            std::int64_t c1 = 0, c2 = 0, lb = 0;
+            ll_fenwick<ll_sum_monoid<std::int64_t>> fw{std::span<const std::int64_t>(a)};
+            const std::uint64_t ts = time_ns([&] {
+                for (std::size_t i = 0; i < OPS; ++i)
+                {
+                    const op& o = ops[i];
+                    if (o.v)
+                        fw.add(o.l, o.v);
+                    else if (i < p)
+                        c1 += fw.range(o.l, o.r);
+                    else
+                        lb += fw.range(o.l, o.r);
+                }
+            });
+            const std::uint64_t tn = time_ns([&] {
+                for (std::size_t i = 0; i < p; ++i)
+                {
+                    const op& o = ops[i];
+                    if (o.v)
+                        a[o.l] += o.v;
+                    else
+                    {
+                        std::int64_t s = 0;
+                        for (std::uint32_t j = o.l; j < o.r; ++j) s += a[j];
+                        c2 += s;
+                    }
+                }
+            });
+            row("fenwick sum", n, static_cast<double>(ts) / OPS, static_cast<double>(tn) / p, c1 == c2, fw.memory_bytes());
+            const std::int64_t total = fw.prefix(n);
+            const std::uint64_t tl = time_ns([&] {
+                for (std::size_t i = 0; i < OPS; ++i)
+                    lb += static_cast<std::int64_t>(fw.lower_bound(1 + static_cast<std::int64_t>(rng() % total)));
+            });
+            std::printf("%-22s %11zu %10.1f   (checksum %lld)\n", "  lower_bound", n, static_cast<double>(tl) / OPS,
+                        static_cast<long long>(lb % 1000));
+        }
+        else
+            std::printf("%-22s %11zu   skipped (%.1f GB)\n", "fenwick sum", n, 16.0 * n / 1073741824.0);
+
+        // lazy segment tree, range add + range sum
+        const double seg_bytes = 8.0 * n + 24.0 * static_cast<double>(std::bit_ceil(n));
+        if (seg_bytes <= budget)
+        {
+            std::vector<std::int64_t> a(n);
+            for (auto& x : a) x = static_cast<std::int64_t>(rng() % 1000);
+            const std::vector<op> ops = make_ops(n, false, 2);
+            std::int64_t c1 = 0, c2 = 0, sink = 0;
+            using M = ll_sum_monoid<std::int64_t>;
+            ll_lazy_segment_tree<M, ll_range_add<M>> st{std::span<const std::int64_t>(a)};
+            const std::uint64_t ts = time_ns([&] {
+                for (std::size_t i = 0; i < OPS; ++i)
+                {
+                    const op& o = ops[i];
+                    if (o.v)
+                        st.update(o.l, o.r, o.v);
+                    else if (i < p)
+                        c1 += st.query(o.l, o.r);
+                    else
+                        sink += st.query(o.l, o.r);
+                }
+            });
+            const std::uint64_t tn = time_ns([&] {
+                for (std::size_t i = 0; i < p; ++i)
+                {
+                    const op& o = ops[i];
+                    if (o.v)
+                        for (std::uint32_t j = o.l; j < o.r; ++j) a[j] += o.v;
+                    else
+                    {
+                        std::int64_t s = 0;
+                        for (std::uint32_t j = o.l; j < o.r; ++j) s += a[j];
+                        c2 += s;
+                    }
+                }
+            });
+            row("lazy segtree add/sum", n, static_cast<double>(ts) / OPS, static_cast<double>(tn) / p,
+                c1 == c2 && sink != 1, st.memory_bytes());
+        }
+        else
+            std::printf("%-22s %11zu   skipped (%.1f GB)\n", "lazy segtree add/sum", n, seg_bytes / 1073741824.0);
+
+        // sparse table, static range min
+        const double sp_bytes = 4.0 * n * (std::bit_width(n) + 1);
+        if (sp_bytes <= budget)
+        {
+            std::vector<std::int32_t> a(n);
+            for (auto& x : a) x = static_cast<std::int32_t>(rng() % 1'000'000'000);
+            const std::vector<op> ops = make_ops(n, false, 3);
+            std::int64_t c1 = 0, c2 = 0, sink = 0;
+            const ll_sparse_table<ll_min_monoid<std::int32_t>>* sp = nullptr;
+            const std::uint64_t tb = time_ns([&] { sp = new ll_sparse_table<ll_min_monoid<std::int32_t>>(a); });
+            const std::uint64_t ts = time_ns([&] {
+                for (std::size_t i = 0; i < OPS; ++i)
+                    (i < p ? c1 : sink) += sp->query(ops[i].l, ops[i].r);
+            });
+            const std::uint64_t tn = time_ns([&] {
+                for (std::size_t i = 0; i < p; ++i)
+                    c2 += *std::min_element(a.begin() + ops[i].l, a.begin() + ops[i].r);
+            });
+            row("sparse table min", n, static_cast<double>(ts) / OPS, static_cast<double>(tn) / p, c1 == c2 && sink != 1,
+                sp->memory_bytes());
+            std::printf("%-22s %11zu %10.1f ns/element\n", "  build", n, static_cast<double>(tb) / n);
+            delete sp;
+        }
+        else
+            std::printf("%-22s %11zu   skipped (%.1f GB)\n", "sparse table min", n, sp_bytes / 1073741824.0);
+    }
+}
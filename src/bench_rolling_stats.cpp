@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "ll_rolling_stats.hpp"
+
+/*
+ * Benchmark: rolling window statistics across a symbol universe
+ *
+ * SYMBOLS series sampled together for TICKS steps (one value per symbol per
+ * step, random-walk prices), window W. After every step each method has the
+ * window mean, variance, min and max of every symbol.
+ *
+ * - naive       : rescan the window per symbol per step (two-pass variance)
+ * - ll_rolling  : one ll_rolling_stats object per symbol (AoS, deques)
+ * - ll_batch    : ll_rolling_stats_batch, all symbols per update (SoA, SIMD)
+ *
+ * The naive scan is timed on a shorter run; all costs are reported per
+ * symbol-update. Results are cross-checked at the end.
+ *
+ * Usage: bench_rolling_stats [window] [symbols]   (default 256 4096)
+ */
+
+static constexpr std::size_t TICKS = 2000;
+static constexpr std::size_t NAIVE_TICKS = 300;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+struct naive_result
+{
+    double mean, var, min, max;
+};
+
+static naive_result naive_window(const std::vector<double>& px, std::size_t symbols, std::size_t sym, std::size_t t,
+                                 std::size_t w)
+{
+    const std::size_t first = t + 1 >= w ? t + 1 - w : 0;
+    const std::size_t n = t + 1 - first;
+    double s = 0.0, mn = px[first * symbols + sym], mx = mn;
+    for (std::size_t k = first; k <= t; ++k)
+    {
+        const double v = px[k * symbols + sym];
+        s += v;
+        mn = std::min(mn, v);
+        mx = std::max(mx, v);
+    }
+    const double mean = s / static_cast<double>(n);
+    double m2 = 0.0;
+    for (std::size_t k = first; k <= t; ++k) m2 += (px[k * symbols + sym] - mean) * (px[k * symbols + sym] - mean);
+    return {mean, n > 1 ? m2 / static_cast<double>(n - 1) : 0.0, mn, mx};
+}
+
+static void line(const char* what, std::uint64_t ns, std::size_t updates)
+{
+    std::printf("%-12s: %8.2f ns per symbol-update  (%7.1f M updates/s)\n", what,
+                static_cast<double>(ns) / static_cast<double>(updates),
+                static_cast<double>(updates) / (static_cast<double>(ns) / 1e9) / 1e6);
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t window = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+    const std::size_t symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4096;
+
+    // [tick][symbol] prices
+    std::vector<double> px(TICKS * symbols);
+    std::uint64_t s = 0x2545F4914F6CDD1Dull;
+    for (std::size_t i = 0; i < symbols; ++i) px[i] = 100.0 + static_cast<double>(i % 50);
+    for (std::size_t t = 1; t < TICKS; ++t)
+        for (std::size_t i = 0; i < symbols; ++i)
+        {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            px[t * symbols + i] = px[(t - 1) * symbols + i] + (static_cast<double>(s >> 11) * 0x1.0p-53 - 0.5) * 0.1;
+        }
+
+    std::cout << "\n=== Rolling stats: " << symbols << " symbols, window " << window << ", " << TICKS << " ticks ===\n";
+
+    // naive: steady state (window full) only
+    double sink = 0.0;
+    const std::size_t t0 = std::min(window, TICKS - NAIVE_TICKS);
+    std::uint64_t t = time_ns([&] {
+        for (std::size_t k = t0; k < t0 + NAIVE_TICKS; ++k)
+            for (std::size_t i = 0; i < symbols; ++i)
+            {
+                const naive_result r = naive_window(px, symbols, i, k, window);
+                sink += r.mean + r.var + r.min + r.max;
+            }
+    });
+    line("naive", t, NAIVE_TICKS * symbols);
+
+    std::vector<ll_rolling_stats> one;
+    one.reserve(symbols);
+    for (std::size_t i = 0; i < symbols; ++i) one.emplace_back(window, 0.05);
+    t = time_ns([&] {
+        for (std::size_t k = 0; k < TICKS; ++k)
+            for (std::size_t i = 0; i < symbols; ++i)
+            {
+                ll_rolling_stats& r = one[i];
+                r.push(px[k * symbols + i]);
+                sink += r.mean() + r.variance() + r.min() + r.max();
+            }
+    });
+    line("ll_rolling", t, TICKS * symbols);
+
+    ll_rolling_stats_batch batch(symbols, window, 0.05);
+    std::vector<double> var(symbols);
+    t = time_ns([&] {
+        for (std::size_t k = 0; k < TICKS; ++k)
+        {
+            batch.update(&px[k * symbols]);
+            batch.variance(var.data());
+            sink += batch.mean()[k % symbols] + var[k % symbols] + batch.min()[k % symbols] + batch.max()[k % symbols];
+        }
+    });
+    line("ll_batch", t, TICKS * symbols);
+
+    // cross-check the final window
+    double err_mean = 0.0, err_var = 0.0;
+    bool minmax = true;
+    for (std::size_t i = 0; i < symbols; ++i)
+    {
+        const naive_result r = naive_window(px, symbols, i, TICKS - 1, window);
+        err_mean = std::max({err_mean, std::abs(one[i].mean() - r.mean) / std::abs(r.mean),
+                             std::abs(batch.mean()[i] - r.mean) / std::abs(r.mean)});
+        err_var = std::max({err_var, std::abs(one[i].variance() - r.var) / r.var, std::abs(var[i] - r.var) / r.var});
+        minmax = minmax && one[i].min() == r.min && one[i].max() == r.max && batch.min()[i] == r.min &&
+                 batch.max()[i] == r.max;
+    }
+    std::printf("vs naive after %zu ticks: max rel error mean %.2e, variance %.2e, min/max %s (sink %.0f)\n", TICKS,
+                err_mean, err_var, minmax ? "exact" : "MISMATCH", sink);
+
+    // strictly monotone runs with a power-of-two window: every push lands
+    // at the back of one deque while the other holds the whole window
+    bool mono = true;
+    for (const bool up : {true, false})
+    {
+        ll_rolling_stats r(8, 0.05);
+        ll_rolling_stats_batch b(1, 8, 0.05);
+        for (int k = 1; k <= 20; ++k)
+        {
+            const double x = up ? k : 21 - k;
+            r.push(x);
+            b.update(&x);
+        }
+        const double lo = up ? 13.0 : 1.0, hi = up ? 20.0 : 8.0;
+        mono = mono && r.min() == lo && r.max() == hi && b.min()[0] == lo && b.max()[0] == hi;
+    }
+    std::printf("monotone 1..20 and 20..1, window 8: min/max %s\n", mono ? "exact" : "MISMATCH");
+}
@@ -0,0 +1,434 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ll_latency_histogram.hpp"
+#include "ll_list_pool.hpp"
+#include "ll_mmap_file.hpp"
+#include "ll_shared_list.hpp"
+
+/*
+ * Benchmark: reader impact on the writer of a shared-memory order list
+ *
+ * usage: bench_shared_list [ops = 4000000] [live orders = 100000] [dir = /dev/shm]
+ *        (bench_shared_list --reader ... is how the readers are started)
+ *
+ * One writer process runs order churn (add = emplace_back, cancel = erase,
+ * modify = update + splice to the back) on a list of ~LIVE orders. Every
+ * operation is timed with steady_clock (timer overhead included). Reader
+ * processes are separate executions of this binary (posix_spawn, not fork:
+ * a forked writer would take copy-on-write faults on its own heap); they
+ * map the segment through its path and copy snapshots until told to stop:
+ * - top-k  : the first 64 orders of the queue
+ * - full   : the whole list
+ * - polled : one top-k snapshot per millisecond, sleeping in between
+ * Writer: ll_list_pool (private heap, no readers possible) as the
+ * baseline, then ll_shared_list_pool and ll_shared_intrusive_list with
+ * 0..4 readers. Reported: wall and CPU ns per operation, latency
+ * percentiles, and for the readers together the snapshots taken, the
+ * attempts per snapshot (torn copies are discarded and retried), and any
+ * delivered order failing its checksum (must be 0).
+ */
+
+using clk = std::chrono::steady_clock;
+
+static std::uint64_t elapsed_ns(clk::time_point a, clk::time_point b)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count();
+}
+
+static std::uint64_t thread_cpu_ns()
+{
+    timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+static std::uint32_t checksum(std::uint64_t id, std::int64_t price, std::int32_t qty)
+{
+    std::uint64_t h = id * 0x9E3779B97F4A7C15ULL ^ static_cast<std::uint64_t>(price) * 0xC2B2AE3D27D4EB4FULL ^
+                      static_cast<std::uint32_t>(qty);
+    return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+struct order
+{
+    std::uint64_t id;
+    std::int64_t price;
+    std::int32_t qty;
+    std::uint32_t check;
+};
+
+struct shared_order
+{
+    ll_shared_hook hook;
+    std::uint64_t id;
+    std::int64_t price;
+    std::int32_t qty;
+    std::uint32_t check;
+};
+
+static bool valid(const order& o)
+{
+    return o.check == checksum(o.id, o.price, o.qty);
+}
+static bool valid(const shared_order& o)
+{
+    return o.check == checksum(o.id, o.price, o.qty);
+}
+
+enum : std::uint32_t
+{
+    ADD,
+    CANCEL,
+    MODIFY
+};
+
+struct event
+{
+    std::uint32_t type;
+    std::int32_t qty;
+    std::uint64_t id;
+    std::int64_t price;
+};
+
+// the first `live` events are adds: they fill the book before readers start
+static std::vector<event> make_events(std::size_t n, std::size_t live_target, std::uint64_t& ids)
+{
+    std::mt19937_64 rng(7);
+    std::vector<event> ev(n);
+    std::vector<std::uint64_t> live;
+    ids = 0;
+    for (event& e : ev)
+    {
+        const unsigned r = static_cast<unsigned>(rng() % 10);
+        const std::int32_t qty = static_cast<std::int32_t>(1 + rng() % 1000);
+        if (live.size() < live_target || r < 4)
+        {
+            e = {ADD, qty, ids, 100'000 + static_cast<std::int64_t>(rng() % 2000)};
+            live.push_back(ids++);
+            continue;
+        }
+        const std::size_t k = rng() % live.size();
+        if (r < 8)
+        {
+            e = {CANCEL, 0, live[k], 0};
+            live[k] = live.back();
+            live.pop_back();
+        }
+        else
+            e = {MODIFY, qty, live[k], 0};
+    }
+    return ev;
+}
+
+// Readers: spawned processes, coordinated through a small control segment
+
+enum class read_mode
+{
+    top_k,
+    full,
+    polled
+};
+
+struct reader_stats
+{
+    std::uint64_t snapshots;
+    std::uint64_t attempts;
+    std::uint64_t bad; // delivered orders failing their checksum
+    std::uint64_t elements;
+};
+
+struct control
+{
+    std::atomic<int> ready;
+    std::atomic<bool> stop;
+    reader_stats stats[8];
+};
+
+constexpr std::size_t top_k = 64;
+
+template <typename Snap>
+static void reader_loop(control* c, int slot, read_mode mode, Snap&& snap)
+{
+    reader_stats st{};
+    c->ready.fetch_add(1);
+    while (!c->stop.load(std::memory_order_relaxed))
+    {
+        const std::size_t limit = mode == read_mode::full ? SIZE_MAX : top_k;
+        std::size_t bad = 0, n = 0;
+        st.attempts += snap(limit, bad, n);
+        st.bad += bad;
+        st.elements += n;
+        ++st.snapshots;
+        if (mode == read_mode::polled) ::usleep(1000);
+    }
+    c->stats[slot] = st;
+}
+
+static void pool_reader(const char* path, control* c, int slot, read_mode mode)
+{
+    ll_shared_list_reader<order> r(path);
+    std::vector<order> out;
+    reader_loop(c, slot, mode, [&](std::size_t limit, std::size_t& bad, std::size_t& n) {
+        const std::size_t a = r.snapshot(out, limit);
+        for (const order& o : out) bad += !valid(o);
+        n = out.size();
+        return a;
+    });
+}
+
+static void intrusive_reader(const char* path, control* c, int slot, read_mode mode)
+{
+    ll_mmap_file seg(path);
+    const auto* list = reinterpret_cast<const ll_shared_intrusive_list*>(seg.data());
+    std::vector<shared_order> out;
+    reader_loop(c, slot, mode, [&](std::size_t limit, std::size_t& bad, std::size_t& n) {
+        const std::size_t a = list->snapshot<shared_order, offsetof(shared_order, hook)>(out, limit);
+        for (const shared_order& o : out) bad += !valid(o);
+        n = out.size();
+        return a;
+    });
+}
+
+struct scenario
+{
+    const char* name;
+    int readers;
+    read_mode mode;
+};
+
+// spawns the readers, runs the writer body, stops and reaps the readers
+template <typename Body>
+static void run(const char* label, const scenario& sc, const char* kind, const std::string& path,
+                const std::string& ctl_path, Body&& body)
+{
+    ll_mmap_file ctl(ctl_path.c_str(), ll_mmap_mode::create, sizeof(control));
+    auto* c = ::new (ctl.data()) control{};
+    std::vector<pid_t> kids;
+    for (int i = 0; i < sc.readers; ++i)
+    {
+        const std::string slot = std::to_string(i), mode = std::to_string(static_cast<int>(sc.mode));
+        const char* args[] = {"bench_shared_list", "--reader", kind, path.c_str(), ctl_path.c_str(),
+                              slot.c_str(), mode.c_str(), nullptr};
+        pid_t p;
+        if (::posix_spawn(&p, "/proc/self/exe", nullptr, nullptr, const_cast<char* const*>(args), environ) != 0)
+        {
+            std::perror("posix_spawn");
+            std::exit(1);
+        }
+        kids.push_back(p);
+    }
+    while (c->ready.load() < sc.readers) ::sched_yield();
+
+    ll_latency_histogram h;
+    const std::uint64_t cpu0 = thread_cpu_ns();
+    const auto t0 = clk::now();
+    const std::size_t ops = body(h);
+    const auto t1 = clk::now();
+    const std::uint64_t cpu = thread_cpu_ns() - cpu0;
+
+    c->stop.store(true);
+    for (pid_t p : kids) ::waitpid(p, nullptr, 0);
+
+    std::printf("%-22s %-22s %8.1f %8.1f %7llu %7llu %9llu %9llu", label, sc.name,
+                static_cast<double>(elapsed_ns(t0, t1)) / ops, static_cast<double>(cpu) / ops,
+                static_cast<unsigned long long>(h.percentile(50)), static_cast<unsigned long long>(h.percentile(99)),
+                static_cast<unsigned long long>(h.percentile(99.9)), static_cast<unsigned long long>(h.max()));
+    if (sc.readers)
+    {
+        reader_stats t{};
+        for (int i = 0; i < sc.readers; ++i)
+        {
+            t.snapshots += c->stats[i].snapshots;
+            t.attempts += c->stats[i].attempts;
+            t.bad += c->stats[i].bad;
+            t.elements += c->stats[i].elements;
+        }
+        const double secs = elapsed_ns(t0, t1) / 1e9;
+        std::printf("   %9.0f %7.2f %7.0f %4llu", t.snapshots / secs,
+                    t.snapshots ? static_cast<double>(t.attempts) / t.snapshots : 0.0,
+                    t.snapshots ? static_cast<double>(t.elements) / t.snapshots : 0.0,
+                    static_cast<unsigned long long>(t.bad));
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 7 && std::string(argv[1]) == "--reader")
+    {
+        ll_mmap_file ctl(argv[4], ll_mmap_mode::read_write);
+        auto* c = reinterpret_cast<control*>(ctl.data());
+        const int slot = std::atoi(argv[5]);
+        const auto mode = static_cast<read_mode>(std::atoi(argv[6]));
+        if (std::string(argv[2]) == "pool")
+            pool_reader(argv[3], c, slot, mode);
+        else
+            intrusive_reader(argv[3], c, slot, mode);
+        return 0;
+    }
+
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+    const std::size_t live = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100'000;
+    const std::string dir = argc > 3 ? argv[3] : "/dev/shm";
+    const std::string pool_path = dir + "/ll_shared_pool.bench", list_path = dir + "/ll_shared_list.bench";
+    const std::string ctl_path = dir + "/ll_shared_ctl.bench";
+    const std::size_t capacity = live * 2;
+
+    std::uint64_t ids = 0;
+    const std::vector<event> ev = make_events(n, live, ids);
+    const std::size_t timed = n - live;
+
+    std::printf("\n=== Shared-memory order list: %zu live orders, %zu timed operations, capacity %zu ===\n", live, timed,
+                capacity);
+    std::printf("%-22s %-22s %8s %8s %7s %7s %9s %9s   %9s %7s %7s %4s\n", "writer", "readers", "wall ns", "cpu ns",
+                "p50", "p99", "p99.9", "max", "snap/s", "tries", "orders", "bad");
+
+    const scenario none{"none", 0, read_mode::top_k};
+    const scenario scenarios[] = {
+        none,
+        {"1 polled top-64 /1ms", 1, read_mode::polled},
+        {"1 spinning top-64", 1, read_mode::top_k},
+        {"4 spinning top-64", 4, read_mode::top_k},
+        {"1 spinning full list", 1, read_mode::full},
+    };
+
+    // baseline: private heap pool, same operations
+    run("ll_list_pool (heap)", none, "pool", pool_path, ctl_path, [&](ll_latency_histogram& h) {
+        ll_list_pool<order> pool(capacity);
+        std::vector<ll_list_pool<order>::iterator> hd(ids);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const event& e = ev[i];
+            const auto a = clk::now();
+            switch (e.type)
+            {
+            case ADD:
+                hd[e.id] = pool.emplace_back(order{e.id, e.price, e.qty, checksum(e.id, e.price, e.qty)});
+                break;
+            case CANCEL:
+                pool.erase(hd[e.id]);
+                break;
+            default:
+                hd[e.id]->qty = e.qty;
+                hd[e.id]->check = checksum(e.id, hd[e.id]->price, e.qty);
+                pool.splice(pool.end(), hd[e.id]);
+                break;
+            }
+            if (i >= live) h.record(elapsed_ns(a, clk::now()));
+        }
+        return timed;
+    });
+
+    for (const scenario& sc : scenarios)
+    {
+        ll_shared_list_pool<order> pool(pool_path.c_str(), capacity);
+        std::vector<ll_shared_list_pool<order>::iterator> hd(ids);
+        auto apply = [&](const event& e) {
+            switch (e.type)
+            {
+            case ADD:
+                hd[e.id] = pool.emplace_back(order{e.id, e.price, e.qty, checksum(e.id, e.price, e.qty)});
+                break;
+            case CANCEL:
+                pool.erase(hd[e.id]);
+                break;
+            default:
+            {
+                auto b = pool.batch(); // update + requeue: one change for readers
+                pool.modify(hd[e.id], [&](order& o) {
+                    o.qty = e.qty;
+                    o.check = checksum(o.id, o.price, o.qty);
+                });
+                pool.splice(pool.end(), hd[e.id]);
+                break;
+            }
+            }
+        };
+        for (std::size_t i = 0; i < live; ++i) apply(ev[i]);
+        run("ll_shared_list_pool", sc, "pool", pool_path, ctl_path, [&](ll_latency_histogram& h) {
+            for (std::size_t i = live; i < n; ++i)
+            {
+                const auto a = clk::now();
+                apply(ev[i]);
+                h.record(elapsed_ns(a, clk::now()));
+            }
+            return timed;
+        });
+    }
+
+    for (const scenario& sc : {none, scenarios[2], scenarios[3]})
+    {
+        // segment: the list, then the objects; free slots are tracked privately
+        constexpr std::size_t head = (sizeof(ll_shared_intrusive_list) + 63) / 64 * 64;
+        const std::size_t bytes = head + capacity * sizeof(shared_order);
+        ll_mmap_file seg(list_path.c_str(), ll_mmap_mode::create, bytes);
+        auto* list = ::new (seg.data()) ll_shared_intrusive_list(seg.data(), bytes);
+        auto* objs = reinterpret_cast<shared_order*>(seg.data() + head);
+        std::vector<std::uint32_t> free_slots(capacity), slot_of(ids);
+        for (std::size_t i = 0; i < capacity; ++i) free_slots[i] = static_cast<std::uint32_t>(capacity - 1 - i);
+        auto apply = [&](const event& e) {
+            switch (e.type)
+            {
+            case ADD:
+            {
+                const std::uint32_t s = free_slots.back();
+                free_slots.pop_back();
+                slot_of[e.id] = s;
+                shared_order& o = objs[s];
+                o.id = e.id;
+                o.price = e.price;
+                o.qty = e.qty;
+                o.check = checksum(e.id, e.price, e.qty);
+                list->push_back(&o.hook);
+                break;
+            }
+            case CANCEL:
+                list->remove(&objs[slot_of[e.id]].hook);
+                free_slots.push_back(slot_of[e.id]);
+                break;
+            default:
+            {
+                shared_order& o = objs[slot_of[e.id]];
+                auto b = list->batch(); // field writes inside the section
+                o.qty = e.qty;
+                o.check = checksum(o.id, o.price, o.qty);
+                list->splice(list->end(), &o.hook);
+                break;
+            }
+            }
+        };
+        for (std::size_t i = 0; i < live; ++i) apply(ev[i]);
+        run("ll_shared_intrusive", sc, "intrusive", list_path, ctl_path, [&](ll_latency_histogram& h) {
+            for (std::size_t i = live; i < n; ++i)
+            {
+                const auto a = clk::now();
+                apply(ev[i]);
+                h.record(elapsed_ns(a, clk::now()));
+            }
+            return timed;
+        });
+    }
+
+    std::printf("\n(wall/cpu ns: mean per operation; p50..max: per-operation latency in ns, steady_clock included;\n"
+                " tries: reader attempts per snapshot, torn ones discarded by the seqlock; bad: delivered orders with a wrong checksum)\n");
+    ::unlink(pool_path.c_str());
+    ::unlink(list_path.c_str());
+    ::unlink(ctl_path.c_str());
+    return 0;
+}
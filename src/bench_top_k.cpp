@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ll_hash.hpp"
+#include "ll_space_saving.hpp"
+
+/*
+ * Benchmark: real-time top-K heavy hitters on Zipfian streams
+ *
+ * EVENTS events over UNIVERSE keys (account / symbol ids), Zipf exponent s.
+ * Every method must produce the current top-100 every QUERY_EVERY events
+ * (the cost of producing it is included):
+ *
+ * - ll_space_saving   : K = 1000 and 10000 counters, top() on demand
+ * - hash map + sort   : exact std::unordered_map counts, partial_sort of
+ *                       all keys every R events (R = 10k, 100k, 1M; the
+ *                       list is stale in between). R = 10k runs on the
+ *                       first EVENTS / 10 events only
+ *
+ * Accuracy is checked against the exact final top-100: recall (how many
+ * of the true top-100 are reported) and the largest relative count error
+ * among them.
+ */
+
+static constexpr std::size_t UNIVERSE = 1'000'000;
+static constexpr std::size_t EVENTS = 20'000'000;
+static constexpr std::size_t TOP = 100;
+static constexpr std::size_t QUERY_EVERY = 10'000;
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+static std::vector<std::uint64_t> zipf_stream(double s, std::mt19937_64& rng)
+{
+    std::vector<double> cdf(UNIVERSE);
+    double acc = 0.0;
+    for (std::size_t i = 0; i < UNIVERSE; ++i) cdf[i] = acc += 1.0 / std::pow(static_cast<double>(i + 1), s);
+    std::uniform_real_distribution<double> u(0.0, acc);
+    std::vector<std::uint64_t> out(EVENTS);
+    for (auto& k : out)
+        k = ll_mix64(static_cast<std::uint64_t>(std::lower_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin()));
+    return out;
+}
+
+using entry = std::pair<std::uint64_t, std::uint64_t>; // (count, key)
+
+static std::vector<entry> exact_top(const std::unordered_map<std::uint64_t, std::uint64_t>& m, std::size_t n)
+{
+    std::vector<entry> v;
+    v.reserve(m.size());
+    for (const auto& [k, c] : m) v.emplace_back(c, k);
+    n = std::min(n, v.size());
+    std::partial_sort(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(n), v.end(), std::greater<>());
+    v.resize(n);
+    return v;
+}
+
+static void run(double s, std::mt19937_64& rng)
+{
+    const std::vector<std::uint64_t> stream = zipf_stream(s, rng);
+    std::unordered_map<std::uint64_t, std::uint64_t> truth;
+    for (std::uint64_t k : stream) ++truth[k];
+    const std::vector<entry> best = exact_top(truth, TOP);
+    std::uint64_t mass = 0;
+    for (const auto& e : best) mass += e.first;
+    std::printf("\n=== Zipf s = %.1f: %zu events, %zu distinct keys, top-%zu holds %.1f%% of events ===\n", s, EVENTS,
+                truth.size(), TOP, 100.0 * static_cast<double>(mass) / EVENTS);
+    std::printf("%-26s %10s %12s %8s %12s %12s\n", "method", "ns/event", "M events/s", "recall", "max cnt err",
+                "bytes");
+
+    std::uint64_t sink = 0;
+    for (std::size_t k : {std::size_t{1000}, std::size_t{10000}})
+    {
+        ll_space_saving<std::uint64_t> ss(k);
+        std::vector<ll_heavy_hitter<std::uint64_t>> top(TOP);
+        const std::uint64_t t = time_ns([&] {
+            for (std::size_t i = 0; i < EVENTS; i += QUERY_EVERY)
+            {
+                ss.offer(std::span<const std::uint64_t>(stream.data() + i, QUERY_EVERY));
+                sink += ss.top(TOP, top.data());
+            }
+        });
+        std::unordered_set<std::uint64_t> got;
+        for (const auto& h : top) got.insert(h.key);
+        std::size_t hit = 0;
+        double err = 0.0;
+        for (const auto& [c, key] : best)
+        {
+            hit += got.count(key);
+            ll_heavy_hitter<std::uint64_t> h;
+            if (ss.lookup(key, h))
+                err = std::max(err, static_cast<double>(h.count - c) / static_cast<double>(c));
+            else
+                err = 1.0;
+        }
+        char label[48];
+        std::snprintf(label, sizeof label, "space-saving K=%zu", k);
+        std::printf("%-26s %10.1f %12.1f %7zu%% %11.3f%% %12zu\n", label, static_cast<double>(t) / EVENTS,
+                    EVENTS / (static_cast<double>(t) / 1e3), hit * 100 / TOP, 100.0 * err, ss.memory_bytes());
+    }
+
+    for (std::size_t r : {std::size_t{10'000}, std::size_t{100'000}, std::size_t{1'000'000}})
+    {
+        // the 10k refresh runs on a prefix only (it would take minutes)
+        const std::size_t events = r < 100'000 ? EVENTS / 10 : EVENTS;
+        std::unordered_map<std::uint64_t, std::uint64_t> m;
+        std::vector<entry> top;
+        const std::uint64_t t = time_ns([&] {
+            for (std::size_t i = 0; i < events; ++i)
+            {
+                ++m[stream[i]];
+                if ((i + 1) % r == 0)
+                {
+                    top = exact_top(m, TOP);
+                    sink += top.size();
+                }
+            }
+        });
+        char label[48];
+        std::snprintf(label, sizeof label, "hash map + sort / %zuk%s", r / 1000, events < EVENTS ? "*" : "");
+        std::printf("%-26s %10.1f %12.1f %7s %12s %12zu\n", label, static_cast<double>(t) / static_cast<double>(events),
+                    static_cast<double>(events) / (static_cast<double>(t) / 1e3), "100%", "exact",
+                    m.size() * 32 + m.bucket_count() * 8);
+    }
+    std::printf("(* first %zu events only; sink %llu)\n", EVENTS / 10, static_cast<unsigned long long>(sink));
+}
+
+int main()
+{
+    std::mt19937_64 rng(11);
+    for (double s : {0.8, 1.0, 1.2}) run(s, rng);
+}
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ll_union_find.hpp"
+
+/*
+ * Benchmark: concurrent union-find vs sequential / mutex-protected
+ *
+ * usage: bench_union_find [n = 2^24] [max threads = 8]
+ *
+ * n elements, n random unions (uniform pairs: a giant set forms, as when
+ * clustering orders / accounts by shared keys), then n random same()
+ * queries. Each thread takes a contiguous slice of the operations.
+ * - ll_union_find, 1 thread            : the sequential baseline
+ * - ll_union_find + std::mutex, T thr  : one lock around every operation
+ * - ll_concurrent_union_find, T thr    : CAS linking + path halving
+ * T = 1, 2, 4, ... max. Every run must produce the same partition as the
+ * sequential one (same set count, and a consistent root mapping) and the
+ * same number of true same() answers.
+ */
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+template <typename F>
+static void run_threads(unsigned n, F&& f)
+{
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < n; ++i) pool.emplace_back([&f, i] { f(i); });
+    f(0u);
+    for (auto& t : pool) t.join();
+}
+
+struct pair32
+{
+    std::uint32_t a, b;
+};
+
+// same partition as the reference: root of x in ref <-> root of x in uf, one to one
+template <typename UF>
+static bool same_partition(ll_union_find& ref, UF& uf)
+{
+    const std::size_t n = ref.size();
+    std::vector<std::uint32_t> map(n, UINT32_MAX);
+    for (std::size_t x = 0; x < n; ++x)
+    {
+        std::uint32_t& m = map[ref.find(static_cast<std::uint32_t>(x))];
+        const std::uint32_t r = uf.find(static_cast<std::uint32_t>(x));
+        if (m == UINT32_MAX) m = r;
+        if (m != r) return false;
+    }
+    return ref.sets() == uf.sets();
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 24;
+    const unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 8;
+
+    std::mt19937_64 rng(11);
+    std::vector<pair32> unions(n), queries(n);
+    for (auto& p : unions) p = {static_cast<std::uint32_t>(rng() % n), static_cast<std::uint32_t>(rng() % n)};
+    for (auto& p : queries) p = {static_cast<std::uint32_t>(rng() % n), static_cast<std::uint32_t>(rng() % n)};
+
+    std::printf("\n=== Union-find: %zu elements, %zu random unions, %zu random same() queries (%u hardware threads) ===\n",
+                n, n, n, std::thread::hardware_concurrency());
+
+    ll_union_find ref(n);
+    std::size_t ref_true = 0;
+    const std::uint64_t tu = time_ns([&] { for (const pair32& p : unions) ref.unite(p.a, p.b); });
+    const std::uint64_t tq = time_ns([&] { for (const pair32& p : queries) ref_true += ref.same(p.a, p.b); });
+    std::printf("%zu sets, largest %zu elements, %zu queries true\n\n", ref.sets(), ref.set_size(ref.find(0)) , ref_true);
+    std::printf("%-32s %8s %12s %12s %8s\n", "method", "threads", "union Mops", "same Mops", "check");
+    std::printf("%-32s %8u %12.1f %12.1f %8s\n", "ll_union_find (sequential)", 1u, n * 1e3 / tu, n * 1e3 / tq, "-");
+
+    for (unsigned t = 1; t <= max_threads; t *= 2)
+    {
+        ll_union_find uf(n);
+        std::mutex mu;
+        std::vector<std::size_t> hits(t);
+        const std::uint64_t u = time_ns([&] {
+            run_threads(t, [&](unsigned i) {
+                for (std::size_t k = n * i / t, e = n * (i + 1) / t; k < e; ++k)
+                {
+                    std::lock_guard<std::mutex> g(mu);
+                    uf.unite(unions[k].a, unions[k].b);
+                }
+            });
+        });
+        const std::uint64_t q = time_ns([&] {
+            run_threads(t, [&](unsigned i) {
+                std::size_t h = 0;
+                for (std::size_t k = n * i / t, e = n * (i + 1) / t; k < e; ++k)
+                {
+                    std::lock_guard<std::mutex> g(mu);
+                    h += uf.same(queries[k].a, queries[k].b);
+                }
+                hits[i] = h;
+            });
+        });
+        std::size_t total = 0;
+        for (std::size_t h : hits) total += h;
+        const bool ok = total == ref_true && same_partition(ref, uf);
+        std::printf("%-32s %8u %12.1f %12.1f %8s\n", "ll_union_find + std::mutex", t, n * 1e3 / u, n * 1e3 / q,
+                    ok ? "ok" : "FAIL");
+    }
+
+    for (unsigned t = 1; t <= max_threads; t *= 2)
+    {
+        ll_concurrent_union_find uf(n);
+        std::vector<std::size_t> hits(t);
+        const std::uint64_t u = time_ns([&] {
+            run_threads(t, [&](unsigned i) {
+                for (std::size_t k = n * i / t, e = n * (i + 1) / t; k < e; ++k) uf.unite(unions[k].a, unions[k].b);
+            });
+        });
+        const std::uint64_t q = time_ns([&] {
+            run_threads(t, [&](unsigned i) {
+                std::size_t h = 0;
+                for (std::size_t k = n * i / t, e = n * (i + 1) / t; k < e; ++k)
+                    h += uf.same(queries[k].a, queries[k].b);
+                hits[i] = h;
+            });
+        });
+        std::size_t total = 0;
+        for (std::size_t h : hits) total += h;
+        const bool ok = total == ref_true && same_partition(ref, uf);
+        std::printf("%-32s %8u %12.1f %12.1f %8s\n", "ll_concurrent_union_find", t, n * 1e3 / u, n * 1e3 / q,
+                    ok ? "ok" : "FAIL");
+    }
+    return 0;
+}
@@ -0,0 +1,251 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "ll_wire.hpp"
+
+/*
+ * Benchmark: zero-copy wire messages vs packed-struct memcpy vs naive stream
+ *
+ * Message: new order (6 fixed fields, 37 bytes on the wire).
+ * - packed memcpy : encode = memcpy struct into buffer, decode = memcpy back out
+ * - naive stream  : field-by-field byte shifts into a growing std::vector,
+ *                   decode = bounds-checked field-by-field reads into a struct
+ * - ll_wire       : encode = writer::set<F>, decode = view::get<F> in place
+ *
+ * Decode is measured twice: reading every field and reading only two fields
+ * (what a filter or router typically does). Throughput counts wire bytes.
+ */
+
+static constexpr std::size_t N_MSGS = 10000000; // 10 million
+
+template <class F>
+uint64_t time_ns(F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// Schema
+
+struct order_id : ll_wire_field<std::uint64_t> {};
+struct price    : ll_wire_field<std::int64_t> {};
+struct qty      : ll_wire_field<std::uint32_t> {};
+struct side     : ll_wire_field<char> {};
+struct symbol   : ll_wire_field<ll_wire_chars<8>> {};
+struct ts_ns    : ll_wire_field<std::uint64_t> {};
+struct note     : ll_wire_tail<char> {};
+
+using new_order = ll_wire_message<order_id, price, qty, side, symbol, ts_ns>;
+using new_order_note = ll_wire_message<order_id, price, qty, side, symbol, ts_ns, note>;
+
+#pragma pack(push, 1)
+struct packed_order
+{
+    std::uint64_t order_id;
+    std::int64_t price;
+    std::uint32_t qty;
+    char side;
+    char symbol[8];
+    std::uint64_t ts_ns;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(packed_order) == new_order::fixed_size);
+
+// Naive stream baseline
+
+struct byte_stream_writer
+{
+    std::vector<std::uint8_t> out;
+
+    template <typename T>
+    void put(T v)
+    {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(T));
+        for (std::size_t i = 0; i < sizeof(T); ++i) out.push_back(static_cast<std::uint8_t>(bits >> (8 * i)));
+    }
+    void put_bytes(const char* p, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) out.push_back(static_cast<std::uint8_t>(p[i]));
+    }
+};
+
+struct byte_stream_reader
+{
+    const std::vector<std::uint8_t>& in;
+    std::size_t pos = 0;
+
+    template <typename T>
+    bool get(T& v)
+    {
+        if (pos + sizeof(T) > in.size()) return false;
+        std::uint64_t bits = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) bits |= std::uint64_t{in[pos + i]} << (8 * i);
+        std::memcpy(&v, &bits, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+    bool get_bytes(char* p, std::size_t n)
+    {
+        if (pos + n > in.size()) return false;
+        for (std::size_t i = 0; i < n; ++i) p[i] = static_cast<char>(in[pos + i]);
+        pos += n;
+        return true;
+    }
+};
+
+static packed_order make_order(std::uint64_t i)
+{
+    packed_order o{};
+    o.order_id = i;
+    o.price = 1000000 + static_cast<std::int64_t>(i % 1000);
+    o.qty = static_cast<std::uint32_t>(100 + i % 900);
+    o.side = (i & 1) ? 'B' : 'S';
+    std::memcpy(o.symbol, "AAPL    ", 8);
+    o.ts_ns = 1700000000000000000ull + i;
+    return o;
+}
+
+static void report(const char* name, uint64_t ns, std::size_t bytes)
+{
+    const double secs = static_cast<double>(ns) / 1e9;
+    std::cout << name << static_cast<double>(ns) / N_MSGS << " ns/msg, "
+              << static_cast<double>(N_MSGS) / secs / 1e6 << " M msg/s, "
+              << static_cast<double>(bytes) / secs / 1e9 << " GB/s\n";
+}
+
+int main()
+{
+    constexpr std::size_t SZ = new_order::fixed_size;
+    const std::size_t bytes = N_MSGS * SZ;
+
+    std::vector<packed_order> src(N_MSGS);
+    for (std::size_t i = 0; i < N_MSGS; ++i) src[i] = make_order(i);
+
+    std::vector<std::byte> buf_memcpy(bytes), buf_wire(bytes);
+    std::uint64_t sink = 0;
+
+    std::cout << "\n=== Encode: " << N_MSGS << " messages, " << SZ << " bytes each ===\n";
+
+    uint64_t t = time_ns([&]
+    {
+        for (std::size_t i = 0; i < N_MSGS; ++i) std::memcpy(&buf_memcpy[i * SZ], &src[i], SZ);
+    });
+    report("packed memcpy : ", t, bytes);
+
+    byte_stream_writer stream;
+    t = time_ns([&]
+    {
+        for (std::size_t i = 0; i < N_MSGS; ++i)
+        {
+            const packed_order& o = src[i];
+            stream.put(o.order_id);
+            stream.put(o.price);
+            stream.put(o.qty);
+            stream.put(o.side);
+            stream.put_bytes(o.symbol, 8);
+            stream.put(o.ts_ns);
+        }
+    });
+    report("naive stream  : ", t, bytes);
+
+    t = time_ns([&]
+    {
+        for (std::size_t i = 0; i < N_MSGS; ++i)
+        {
+            const packed_order& o = src[i];
+            ll_wire_chars<8> sym;
+            std::memcpy(sym.data.data(), o.symbol, 8);
+            new_order::writer(&buf_wire[i * SZ])
+                .set<order_id>(o.order_id)
+                .set<price>(o.price)
+                .set<qty>(o.qty)
+                .set<side>(o.side)
+                .set<symbol>(sym)
+                .set<ts_ns>(o.ts_ns);
+        }
+    });
+    report("ll_wire       : ", t, bytes);
+
+    if (std::memcmp(buf_memcpy.data(), buf_wire.data(), bytes) != 0) std::cout << "MISMATCH: wire != packed\n";
+
+    std::cout << "\n=== Decode: all fields ===\n";
+
+    t = time_ns([&]
+    {
+        for (std::size_t i = 0; i < N_MSGS; ++i)
+        {
+            packed_order o;
+            std::memcpy(&o, &buf_memcpy[i * SZ], SZ);
+            sink += o.order_id + static_cast<std::uint64_t>(o.price) + o.qty + o.side + o.symbol[0] + o.ts_ns;
+        }
+    });
+    report("packed memcpy : ", t, bytes);
+
+    t = time_ns([&]
+    {
+        byte_stream_reader r{stream.out};
+        for (std::size_t i = 0; i < N_MSGS; ++i)
+        {
+            packed_order o;
+            if (!(r.get(o.order_id) && r.get(o.price) && r.get(o.qty) && r.get(o.side) &&
+                  r.get_bytes(o.symbol, 8) && r.get(o.ts_ns))) break;
+            sink += o.order_id + static_cast<std::uint64_t>(o.price) + o.qty + o.side + o.symbol[0] + o.ts_ns;
+        }
+    });
+    report("naive stream  : ", t, bytes);
+
+    t = time_ns([&]
+    {
+        for (std::size_t i = 0; i < N_MSGS; ++i)
+        {
+            new_order::view v(&buf_wire[i * SZ], SZ);
+            sink += v.get<order_id>() + static_cast<std::uint64_t>(v.get<price>()) + v.get<qty>() +
+                    v.get<side>() + v.get<symbol>().data[0] + v.get<ts_ns>();
+        }
+    });
+    report("ll_wire       : ", t, bytes);
+
+    std::cout << "\n=== Decode: two fields (order_id, price) ===\n";
+
+    t = time_ns([&]
+    {
+        for (std::size_t i = 0; i < N_MSGS; ++i)
+        {
+            packed_order o;
+            std::memcpy(&o, &buf_memcpy[i * SZ], SZ);
+            sink += o.order_id + static_cast<std::uint64_t>(o.price);
+        }
+    });
+    report("packed memcpy : ", t, bytes);
+
+    t = time_ns([&]
+    {
+        for (std::size_t i = 0; i < N_MSGS; ++i)
+        {
+            new_order::view v(&buf_wire[i * SZ], SZ);
+            sink += v.get<order_id>() + static_cast<std::uint64_t>(v.get<price>());
+        }
+    });
+    report("ll_wire       : ", t, bytes);
+
+    std::cout << "\n=== Variable-length tail round trip ===\n";
+    {
+        std::vector<std::byte> b(new_order_note::encoded_size<note>(32));
+        new_order_note::writer w(b.data());
+        w.set<order_id>(42).set<price>(1000125).set_tail_text<note>("client=XYZ algo=TWAP");
+        auto v = new_order_note::try_view(std::span<const std::byte>(b.data(), w.size()));
+        std::cout << "size=" << w.size() << " order_id=" << v->get<order_id>()
+                  << " note=\"" << v->tail<note>() << "\"\n";
+        auto truncated = new_order_note::try_view(std::span<const std::byte>(b.data(), w.size() - 1));
+        std::cout << "truncated buffer rejected: " << (truncated ? "no" : "yes") << "\n";
+    }
+
+    std::cout << "\n(sink " << sink % 10 << ")\n";
+}
@@ -1,7 +1,6 @@
 #include <iosfwd>
 #include <chrono>
 #include <vector>
-#include <random>
 #include <cstdint>
 #include <cstddef>
 #include <iostream>
@@ -9,6 +8,7 @@
 // include the two lists we made
 #include "ll_list_pool.hpp"
 #include "ll_intrusive_list.hpp"
+#include "ll_random.hpp"
 
 /*
 Lets configure some values.
@@ -176,14 +176,15 @@ void benchmark_splice()
   intr_list.push_back(&intr_orders[i].hook);
  }
 
- std::mt19937 rng(42);
- std::uniform_int_distribution<std::size_t> pick(0,N_LARGE-1);
+ // draw the indices up front: drawing them inside the timed loops would
+ // time the generator too. Both lists splice the same sequence
+ const std::vector<std::uint32_t> picks = ll_uniform_indices(OPS, N_LARGE, 42);
 
  uint64_t t_pool = time_ns([&]
  {
   for (std::size_t i = 0; i < OPS; ++i)
   {
-   pool_list.splice(pool_list.begin(),pool_iters[pick(rng)]);
+   pool_list.splice(pool_list.begin(),pool_iters[picks[i]]);
   }
  });
 
@@ -191,7 +192,7 @@ void benchmark_splice()
  {
   for (std::size_t i = 0; i < OPS; ++i)
   {
-   intr_list.splice(intr_list.front(), &intr_orders[pick(rng)].hook);
+   intr_list.splice(intr_list.front(), &intr_orders[picks[i]].hook);
   }
  });
 
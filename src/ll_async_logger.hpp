@@ -0,0 +1,438 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ll_spsc_ring.hpp"
+
+/*
+ *Asynchronous Binary Logger
+ * The hot thread never formats text. A log call writes:
+ *   [site pointer][timestamp][raw argument bytes]
+ * into a per-thread SPSC ring and returns. A background thread drains all
+ * rings in batches, formats the records and writes them with one write(2)
+ * per batch.
+ *
+ * Key properties by design:
+ * - the format id is the address of a static constexpr ll_log_site, so it is
+ *   fixed at link time and costs one 8 byte store on the hot path
+ * - the placeholder count is checked against the argument count at compile time
+ * - arguments are copied as raw bytes (strings as length + bytes)
+ * - no allocation on the hot path once the thread's ring exists
+ * - explicit overflow policy when a ring is full (drop / block / count)
+ *
+ * Usage:
+ *   ll_async_logger log("/tmp/app.log");
+ *   LL_LOG(log, "fill id={} px={} qty={}", id, px, qty);
+ *
+ * Formatting: each "{}" is replaced by the next argument. No format specs.
+ */
+
+enum class ll_overflow_policy
+{
+    drop,  // discard the record, nothing is reported
+    block, // spin (yielding) until the consumer frees space
+    count  // discard the record and report the number of drops in the log
+};
+
+struct ll_log_site
+{
+    const char* fmt;
+    void (*decode)(const char* fmt, const std::byte* args, std::string& out);
+};
+
+namespace ll_log_detail
+{
+// Argument encoding
+    // arithmetic / enum values are stored verbatim
+    // const char*, std::string_view and std::string are stored as u32 length + bytes
+
+    template <typename T>
+    inline constexpr bool is_text_v =
+        std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+        std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>;
+
+    template <typename T>
+    inline constexpr bool is_raw_v = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+    template <typename T>
+    std::string_view as_text(const T& v) noexcept
+    {
+        if constexpr (std::is_pointer_v<T>) return v ? std::string_view(v) : std::string_view("(null)");
+        else return std::string_view(v);
+    }
+
+    template <typename T>
+    std::size_t encoded_size(const T& v) noexcept
+    {
+        if constexpr (is_text_v<T>) return sizeof(std::uint32_t) + as_text(v).size();
+        else return sizeof(T);
+    }
+
+    template <typename T>
+    std::byte* encode(std::byte* p, const T& v) noexcept
+    {
+        if constexpr (is_text_v<T>)
+        {
+            const std::string_view s = as_text(v);
+            const auto n = static_cast<std::uint32_t>(s.size());
+            std::memcpy(p, &n, sizeof(n));
+            std::memcpy(p + sizeof(n), s.data(), n);
+            return p + sizeof(n) + n;
+        }
+        else
+        {
+            std::memcpy(p, &v, sizeof(T));
+            return p + sizeof(T);
+        }
+    }
+
+    template <typename T>
+    const std::byte* decode_one(const std::byte* p, std::string& out)
+    {
+        if constexpr (is_text_v<T>)
+        {
+            std::uint32_t n;
+            std::memcpy(&n, p, sizeof(n));
+            out.append(reinterpret_cast<const char*>(p + sizeof(n)), n);
+            return p + sizeof(n) + n;
+        }
+        else
+        {
+            T v;
+            std::memcpy(&v, p, sizeof(T));
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                out.append(v ? "true" : "false");
+            }
+            else if constexpr (std::is_same_v<T, char>)
+            {
+                out.push_back(v);
+            }
+            else
+            {
+                char buf[64];
+                std::to_chars_result r;
+                if constexpr (std::is_enum_v<T>) r = std::to_chars(buf, buf + sizeof(buf), static_cast<std::underlying_type_t<T>>(v));
+                else r = std::to_chars(buf, buf + sizeof(buf), v);
+                out.append(buf, r.ptr);
+            }
+            return p + sizeof(T);
+        }
+    }
+
+    // copy fmt up to the next "{}" and return the position after it
+    inline const char* append_until_placeholder(const char* f, std::string& out)
+    {
+        const char* start = f;
+        while (*f && !(f[0] == '{' && f[1] == '}')) ++f;
+        out.append(start, f);
+        return *f ? f + 2 : f;
+    }
+
+    constexpr std::size_t count_placeholders(const char* f) noexcept
+    {
+        std::size_t n = 0;
+        for (; *f; ++f)
+        {
+            if (f[0] == '{' && f[1] == '}')
+            {
+                ++n;
+                ++f;
+            }
+        }
+        return n;
+    }
+
+    template <typename... Args>
+    struct codec
+    {
+        static constexpr std::size_t arity = sizeof...(Args);
+
+        static_assert(((is_raw_v<Args> || is_text_v<Args>) && ...),
+                      "LL_LOG arguments must be arithmetic, enum, or text");
+
+        static void decode(const char* fmt, const std::byte* p, std::string& out)
+        {
+            ((fmt = append_until_placeholder(fmt, out), p = decode_one<Args>(p, out)), ...);
+            out.append(fmt);
+        }
+    };
+
+    // unevaluated helper: maps call arguments to their codec type
+    template <typename... Args>
+    codec<std::decay_t<Args>...> codec_of(Args&&...);
+
+    struct record_prefix
+    {
+        const ll_log_site* site;
+        std::int64_t ts_ns;
+    };
+}
+
+class ll_async_logger
+{
+public:
+    struct config
+    {
+        std::size_t ring_bytes = std::size_t{1} << 20;      // per producer thread
+        ll_overflow_policy policy = ll_overflow_policy::count;
+        std::size_t batch_bytes = std::size_t{64} << 10;    // write(2) threshold
+        std::chrono::microseconds idle_sleep{50};           // consumer back-off when idle
+    };
+
+    static constexpr std::size_t max_producers = 64;
+
+private:
+    struct producer
+    {
+        ll_spsc_byte_ring ring;
+        std::thread::id owner;
+        alignas(64) std::atomic<std::uint64_t> dropped{0};
+        producer(std::size_t bytes, std::thread::id t) : ring(bytes), owner(t) {}
+    };
+
+    config cfg_;
+    int fd_;
+    std::uint64_t instance_id_;
+
+    std::array<std::unique_ptr<producer>, max_producers> owned_;
+    std::array<std::atomic<producer*>, max_producers> producers_{};
+    std::atomic<std::size_t> n_producers_{0};
+    std::mutex register_mutex_;
+
+    std::atomic<std::uint64_t> flush_requested_{0};
+    std::atomic<std::uint64_t> flush_done_{0};
+    std::atomic<std::uint64_t> total_dropped_{0};
+    std::atomic<std::uint64_t> dropped_bytes_{0};
+    std::atomic<bool> stop_{false};
+    std::string out_;
+    std::thread worker_;
+
+    static std::uint64_t next_instance_id() noexcept
+    {
+        static std::atomic<std::uint64_t> id{1};
+        return id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // per-thread cache keyed by instance id (not address) so a new logger
+    // reusing a destroyed logger's storage never sees a stale ring
+    producer* local_producer()
+    {
+        struct cache_entry
+        {
+            std::uint64_t id = 0;
+            producer* p = nullptr;
+        };
+        thread_local cache_entry cache;
+        if (cache.id == instance_id_) return cache.p;
+
+        std::lock_guard<std::mutex> lock(register_mutex_);
+        const std::size_t n = n_producers_.load(std::memory_order_relaxed);
+        const std::thread::id self = std::this_thread::get_id();
+
+        // thread alternating between loggers: reuse its existing ring
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (owned_[i]->owner == self)
+            {
+                cache = {instance_id_, owned_[i].get()};
+                return cache.p;
+            }
+        }
+
+        if (n == max_producers) throw std::length_error("ll_async_logger: too many producer threads");
+        owned_[n] = std::make_unique<producer>(cfg_.ring_bytes, self);
+        producers_[n].store(owned_[n].get(), std::memory_order_release);
+        n_producers_.store(n + 1, std::memory_order_release);
+        cache = {instance_id_, owned_[n].get()};
+        return cache.p;
+    }
+
+    void write_out()
+    {
+        const char* p = out_.data();
+        std::size_t left = out_.size();
+        while (left)
+        {
+            const ssize_t w = ::write(fd_, p, left);
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                std::this_thread::yield(); // non-blocking fd is full; wait, as a blocking one would
+                continue;
+            }
+            if (w <= 0)
+            {
+                // nowhere to report it; drop the rest of the batch and count it
+                dropped_bytes_.fetch_add(left, std::memory_order_relaxed);
+                break;
+            }
+            p += w;
+            left -= static_cast<std::size_t>(w);
+        }
+        out_.clear();
+    }
+
+    static void append_record(const std::byte* rec, std::string& out)
+    {
+        ll_log_detail::record_prefix pre;
+        std::memcpy(&pre, rec, sizeof(pre));
+        char buf[32];
+        auto r = std::to_chars(buf, buf + sizeof(buf), pre.ts_ns);
+        out.append(buf, r.ptr);
+        out.push_back(' ');
+        pre.site->decode(pre.site->fmt, rec + sizeof(pre), out);
+        out.push_back('\n');
+    }
+
+    // one pass over every ring; returns records formatted
+    std::size_t drain_once()
+    {
+        std::size_t total = 0;
+        const std::size_t n = n_producers_.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            producer* p = producers_[i].load(std::memory_order_acquire);
+            total += p->ring.drain([this](const std::byte* rec, std::size_t)
+            {
+                append_record(rec, out_);
+            }, 1024);
+
+            if (const std::uint64_t d = p->dropped.exchange(0, std::memory_order_relaxed))
+            {
+                out_.append("[ll_async_logger] dropped ");
+                char buf[32];
+                auto r = std::to_chars(buf, buf + sizeof(buf), d);
+                out_.append(buf, r.ptr);
+                out_.append(" records\n");
+            }
+            if (out_.size() >= cfg_.batch_bytes) write_out();
+        }
+        return total;
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            const bool stopping = stop_.load(std::memory_order_acquire);
+            const std::uint64_t flush_req = flush_requested_.load(std::memory_order_acquire);
+
+            std::size_t got = drain_once();
+            if (got == 0 || stopping || flush_req != flush_done_.load(std::memory_order_relaxed))
+            {
+                // drain to empty before writing, sleeping or acknowledging
+                while (got) got = drain_once();
+                if (!out_.empty()) write_out();
+                flush_done_.store(flush_req, std::memory_order_release);
+                if (stopping) return;
+                std::this_thread::sleep_for(cfg_.idle_sleep);
+            }
+        }
+    }
+
+public:
+// Construction/Destruction
+    explicit ll_async_logger(const char* path)
+        : ll_async_logger(path, config{})
+    {
+    }
+
+    ll_async_logger(const char* path, config cfg)
+        : cfg_(cfg)
+        , fd_(::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+        , instance_id_(next_instance_id())
+    {
+        if (fd_ < 0) throw std::runtime_error("ll_async_logger: cannot open log file");
+        out_.reserve(cfg_.batch_bytes * 2);
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ll_async_logger(const ll_async_logger&) = delete;
+    ll_async_logger& operator=(const ll_async_logger&) = delete;
+
+    ~ll_async_logger()
+    {
+        stop_.store(true, std::memory_order_release);
+        worker_.join();
+        ::close(fd_);
+    }
+
+// Hot path
+    // Returns false when the record was dropped by the overflow policy.
+    template <typename... Args>
+    bool write(const ll_log_site& site, const Args&... args)
+    {
+        producer* p = local_producer();
+        const std::size_t n = sizeof(ll_log_detail::record_prefix) + (std::size_t{0} + ... + ll_log_detail::encoded_size<std::decay_t<Args>>(args));
+
+        std::byte* dst = p->ring.try_reserve(n);
+        while (!dst)
+        {
+            if (cfg_.policy != ll_overflow_policy::block || n > p->ring.max_record())
+            {
+                if (cfg_.policy != ll_overflow_policy::drop) p->dropped.fetch_add(1, std::memory_order_relaxed);
+                total_dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            std::this_thread::yield();
+            dst = p->ring.try_reserve(n);
+        }
+
+        const ll_log_detail::record_prefix pre{
+            &site,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count()};
+        std::memcpy(dst, &pre, sizeof(pre));
+        dst += sizeof(pre);
+        ((dst = ll_log_detail::encode<std::decay_t<Args>>(dst, args)), ...);
+        p->ring.commit();
+        return true;
+    }
+
+// Control
+    // blocks until every record committed before the call has been written
+    void flush()
+    {
+        const std::uint64_t id = flush_requested_.fetch_add(1, std::memory_order_acq_rel) + 1;
+        while (flush_done_.load(std::memory_order_acquire) < id) std::this_thread::yield();
+    }
+
+    std::uint64_t dropped() const noexcept
+    {
+        return total_dropped_.load(std::memory_order_relaxed);
+    }
+
+    // formatted bytes the consumer could not write (write(2) failed)
+    std::uint64_t dropped_bytes() const noexcept
+    {
+        return dropped_bytes_.load(std::memory_order_relaxed);
+    }
+};
+
+// compile-time format id + placeholder check, then the hot path write
+#define LL_LOG(logger, fmt_literal, ...)                                                   \
+    do                                                                                     \
+    {                                                                                      \
+        using ll_codec_ = decltype(::ll_log_detail::codec_of(__VA_ARGS__));                \
+        static_assert(::ll_log_detail::count_placeholders(fmt_literal) == ll_codec_::arity, \
+                      "LL_LOG: placeholder count does not match argument count");         \
+        static constexpr ::ll_log_site ll_site_{fmt_literal, &ll_codec_::decode};          \
+        (logger).write(ll_site_ __VA_OPT__(,) __VA_ARGS__);                                \
+    } while (0)
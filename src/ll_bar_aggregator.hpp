@@ -0,0 +1,302 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX512F__) && defined(__AVX512VL__) && defined(__AVX512DQ__)
+#include <immintrin.h>
+#endif
+
+#include "ll_hash.hpp"
+
+/*
+ *OHLCV Bar Aggregation
+ * Streaming time bars (1s, 1m, ...) from trades across a large symbol
+ * universe, plus resampling of fine bars into coarser ones.
+ * - ll_symbol_index : external symbol key (e.g. ticker packed into 8 bytes)
+ *   -> dense id 0..n-1; fixed capacity, open addressing
+ * - ll_bar_aggregator : per-symbol bar state as parallel arrays (SoA)
+ *   indexed by dense id; a trade is a handful of scalar updates to one
+ *   slot. When a trade crosses into the next interval the open bars are
+ *   finalized into a columnar ll_bar_batch:
+ *   - only symbols that traded produce a row (AVX-512 compress-store,
+ *     scalar fallback)
+ *   - vwap = notional / volume computed 8 symbols per instruction
+ *   - state is reset with full-width stores
+ *   Nothing is allocated after construction: the batch columns and the
+ *   state arrays are sized for the universe once.
+ * - empty intervals produce no rows (no forward fill); trades older than
+ *   the open interval are folded into it and counted in late()
+ *
+ * Prices are int64 ticks as in ll_feed_generator.hpp, quantities are
+ * widened to int64 for volume; timestamps are ns, bars are stamped with
+ * the interval start.
+ */
+
+// pack up to 8 characters of a ticker into a key for ll_symbol_index
+inline std::uint64_t ll_symbol_key(std::string_view s) noexcept
+{
+    std::uint64_t k = 0;
+    std::memcpy(&k, s.data(), std::min<std::size_t>(8, s.size()));
+    return k;
+}
+
+class ll_symbol_index
+{
+private:
+    std::vector<std::uint64_t> keys_;
+    std::vector<std::uint32_t> ids_; // UINT32_MAX = empty
+    std::size_t mask_;
+    std::uint32_t size_;
+    std::uint32_t cap_;
+
+public:
+    explicit ll_symbol_index(std::uint32_t capacity)
+        : keys_(std::bit_ceil(std::size_t{2} * capacity))
+        , ids_(keys_.size(), 0xFFFFFFFFu)
+        , mask_(keys_.size() - 1)
+        , size_(0)
+        , cap_(capacity)
+    {
+    }
+
+    // dense id of key, assigned on first sight
+    std::uint32_t id(std::uint64_t key)
+    {
+        std::size_t i = ll_mix64(key) & mask_;
+        while (ids_[i] != 0xFFFFFFFFu)
+        {
+            if (keys_[i] == key) return ids_[i];
+            i = (i + 1) & mask_;
+        }
+        if (size_ == cap_) throw std::length_error("ll_symbol_index: full");
+        keys_[i] = key;
+        return ids_[i] = size_++;
+    }
+
+    // UINT32_MAX if unknown
+    std::uint32_t find(std::uint64_t key) const noexcept
+    {
+        for (std::size_t i = ll_mix64(key) & mask_; ids_[i] != 0xFFFFFFFFu; i = (i + 1) & mask_)
+            if (keys_[i] == key) return ids_[i];
+        return 0xFFFFFFFFu;
+    }
+
+    std::uint32_t size() const noexcept
+    {
+        return size_;
+    }
+};
+
+// one finished interval, one row per symbol that traded
+struct ll_bar_batch
+{
+    std::uint64_t ts = 0; // interval start, ns
+    std::size_t rows = 0;
+    std::vector<std::uint32_t> symbol;
+    std::vector<std::int64_t> open;
+    std::vector<std::int64_t> high;
+    std::vector<std::int64_t> low;
+    std::vector<std::int64_t> close;
+    std::vector<std::int64_t> volume;
+    std::vector<double> vwap;
+    std::vector<std::uint32_t> trades;
+
+    void reserve(std::size_t n)
+    {
+        // +8 lets the compress path store a full vector past the last row
+        for (auto* c : {&symbol, &trades}) c->resize(n + 8);
+        for (auto* c : {&open, &high, &low, &close, &volume}) c->resize(n + 8);
+        vwap.resize(n + 8);
+    }
+};
+
+class ll_bar_aggregator
+{
+private:
+    std::uint32_t symbols_;
+    std::size_t padded_; // multiple of 8
+    std::uint64_t interval_;
+    std::uint64_t start_; // open interval [start_, start_ + interval_)
+    bool open_;
+    std::uint64_t late_;
+
+    // SoA bar state, one slot per dense symbol id
+    std::vector<std::int64_t> open_px_;
+    std::vector<std::int64_t> high_;
+    std::vector<std::int64_t> low_;
+    std::vector<std::int64_t> close_;
+    std::vector<std::int64_t> volume_;
+    std::vector<double> notional_;
+    std::vector<std::uint32_t> trades_;
+    std::vector<std::uint32_t> ids_; // 0..padded_-1, for the compress path
+
+    ll_bar_batch out_;
+
+    void begin(std::uint64_t ts) noexcept
+    {
+        start_ = ts - ts % interval_;
+        open_ = true;
+    }
+
+    void finalize() noexcept
+    {
+        out_.ts = start_;
+        std::size_t n = 0;
+#if defined(__AVX512F__) && defined(__AVX512VL__) && defined(__AVX512DQ__)
+        const __m512i hi0 = _mm512_set1_epi64(std::numeric_limits<std::int64_t>::min());
+        const __m512i lo0 = _mm512_set1_epi64(std::numeric_limits<std::int64_t>::max());
+        const __m512i zero = _mm512_setzero_si512();
+        for (std::size_t i = 0; i < padded_; i += 8)
+        {
+            const __m256i cnt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&trades_[i]));
+            const __mmask8 m = _mm256_cmpneq_epi32_mask(cnt, _mm256_setzero_si256());
+            if (!m) continue;
+            const __m512i vol = _mm512_loadu_si512(&volume_[i]);
+            const __m512d vw = _mm512_div_pd(_mm512_loadu_pd(&notional_[i]), _mm512_cvtepi64_pd(vol));
+            _mm256_mask_compressstoreu_epi32(&out_.symbol[n], m, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&ids_[i])));
+            _mm256_mask_compressstoreu_epi32(&out_.trades[n], m, cnt);
+            _mm512_mask_compressstoreu_epi64(&out_.open[n], m, _mm512_loadu_si512(&open_px_[i]));
+            _mm512_mask_compressstoreu_epi64(&out_.high[n], m, _mm512_loadu_si512(&high_[i]));
+            _mm512_mask_compressstoreu_epi64(&out_.low[n], m, _mm512_loadu_si512(&low_[i]));
+            _mm512_mask_compressstoreu_epi64(&out_.close[n], m, _mm512_loadu_si512(&close_[i]));
+            _mm512_mask_compressstoreu_epi64(&out_.volume[n], m, vol);
+            _mm512_mask_compressstoreu_pd(&out_.vwap[n], m, vw);
+            n += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(m)));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&trades_[i]), _mm256_setzero_si256());
+            _mm512_storeu_si512(&volume_[i], zero);
+            _mm512_storeu_pd(&notional_[i], _mm512_setzero_pd());
+            _mm512_storeu_si512(&high_[i], hi0);
+            _mm512_storeu_si512(&low_[i], lo0);
+        }
+#else
+        for (std::size_t i = 0; i < padded_; ++i)
+        {
+            if (!trades_[i]) continue;
+            out_.symbol[n] = static_cast<std::uint32_t>(i);
+            out_.trades[n] = trades_[i];
+            out_.open[n] = open_px_[i];
+            out_.high[n] = high_[i];
+            out_.low[n] = low_[i];
+            out_.close[n] = close_[i];
+            out_.volume[n] = volume_[i];
+            out_.vwap[n] = notional_[i] / static_cast<double>(volume_[i]);
+            ++n;
+            trades_[i] = 0;
+            volume_[i] = 0;
+            notional_[i] = 0.0;
+            high_[i] = std::numeric_limits<std::int64_t>::min();
+            low_[i] = std::numeric_limits<std::int64_t>::max();
+        }
+#endif
+        out_.rows = n;
+        open_ = false;
+    }
+
+    // route ts to an interval; true if the previous one was just finalized
+    bool advance(std::uint64_t ts) noexcept
+    {
+        if (!open_)
+        {
+            begin(ts);
+            return false;
+        }
+        if (ts < start_)
+        {
+            ++late_;
+            return false;
+        }
+        if (ts - start_ < interval_) return false;
+        finalize();
+        begin(ts);
+        return true;
+    }
+
+public:
+    ll_bar_aggregator(std::uint32_t symbols, std::uint64_t interval_ns)
+        : symbols_(symbols)
+        , padded_((std::size_t{symbols} + 7) & ~std::size_t{7})
+        , interval_(interval_ns)
+        , start_(0)
+        , open_(false)
+        , late_(0)
+        , open_px_(padded_, 0)
+        , high_(padded_, std::numeric_limits<std::int64_t>::min())
+        , low_(padded_, std::numeric_limits<std::int64_t>::max())
+        , close_(padded_, 0)
+        , volume_(padded_, 0)
+        , notional_(padded_, 0.0)
+        , trades_(padded_, 0)
+        , ids_(padded_)
+    {
+        if (symbols == 0 || interval_ns == 0) throw std::invalid_argument("ll_bar_aggregator: empty universe or interval");
+        std::iota(ids_.begin(), ids_.end(), 0u);
+        out_.reserve(padded_);
+    }
+
+    // apply one trade; returns true if it closed the previous interval,
+    // whose rows are then in bars() until the next close
+    bool on_trade(std::uint32_t sym, std::uint64_t ts, std::int64_t price, std::int64_t qty) noexcept
+    {
+        const bool closed = advance(ts);
+        if (trades_[sym]++ == 0) open_px_[sym] = price;
+        high_[sym] = std::max(high_[sym], price);
+        low_[sym] = std::min(low_[sym], price);
+        close_[sym] = price;
+        volume_[sym] += qty;
+        notional_[sym] += static_cast<double>(price) * static_cast<double>(qty);
+        return closed;
+    }
+
+    // resample: fold a finer batch (e.g. 1s bars into 1m); returns true if
+    // it closed the previous interval. Batches must arrive in time order
+    bool on_bars(const ll_bar_batch& b) noexcept
+    {
+        const bool closed = advance(b.ts);
+        for (std::size_t r = 0; r < b.rows; ++r)
+        {
+            const std::uint32_t s = b.symbol[r];
+            if (trades_[s] == 0) open_px_[s] = b.open[r];
+            trades_[s] += b.trades[r];
+            high_[s] = std::max(high_[s], b.high[r]);
+            low_[s] = std::min(low_[s], b.low[r]);
+            close_[s] = b.close[r];
+            volume_[s] += b.volume[r];
+            notional_[s] += b.vwap[r] * static_cast<double>(b.volume[r]);
+        }
+        return closed;
+    }
+
+    // close the open interval (end of session); false if nothing was open
+    bool flush() noexcept
+    {
+        if (!open_) return false;
+        finalize();
+        return true;
+    }
+
+    const ll_bar_batch& bars() const noexcept
+    {
+        return out_;
+    }
+    std::uint64_t interval() const noexcept
+    {
+        return interval_;
+    }
+    std::uint64_t late() const noexcept
+    {
+        return late_;
+    }
+    std::uint32_t symbols() const noexcept
+    {
+        return symbols_;
+    }
+};
@@ -0,0 +1,230 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ll_vmath.hpp"
+
+/*
+ *Batch Black-Scholes Pricing and Greeks
+ * European options with continuous carry (Black-Scholes-Merton), priced
+ * column by column over a struct-of-arrays batch:
+ * - ll_option_batch : spot, strike, expiry (years), vol, rate, carry
+ *   (dividend / foreign rate), cp (+1 call, -1 put)
+ * - ll_greeks_batch : price, delta, gamma, vega, theta (per year), rho;
+ *   each column starts on a 64-byte boundary
+ *
+ * With phi = cp, Dr = e^{-rT}, Dq = e^{-qT}:
+ *   d1 = (ln(S/K) + (r - q + vol^2/2) T) / (vol sqrt T),  d2 = d1 - vol sqrt T
+ *   price = phi (S Dq N(phi d1) - K Dr N(phi d2))
+ *   delta = phi Dq N(phi d1),   gamma = Dq n(d1) / (S vol sqrt T)
+ *   vega  = S Dq n(d1) sqrt T,  rho = phi K T Dr N(phi d2)
+ *   theta = -S Dq n(d1) vol / (2 sqrt T) - phi r K Dr N(phi d2)
+ *           + phi q S Dq N(phi d1)
+ * Calls and puts share one branch-free formula, so mixed batches stay in
+ * the vector path.
+ *
+ * - ll_bs_greeks / ll_bs_price : one kernel over [begin, end), 8 (AVX-512)
+ *   or 4 (AVX2) contracts per step, using ll_vmath exp / log / norm_cdf:
+ *   per contract 5 exp, 1 log, 2 erfc series, no libm calls
+ * - ll_bs_greeks_parallel : the batch cut into per-thread ranges on
+ *   64-byte boundaries, so no two threads write the same cache line
+ * - ll_bs_greeks_reference : the same formulas with std::exp / std::log /
+ *   std::erfc, one contract at a time (the accuracy baseline)
+ *
+ * Inputs must be positive (spot, strike, expiry, vol); no checks are made
+ * per contract.
+ */
+
+struct ll_option_batch
+{
+    std::vector<double> spot;
+    std::vector<double> strike;
+    std::vector<double> expiry; // years
+    std::vector<double> vol;
+    std::vector<double> rate;
+    std::vector<double> carry; // continuous dividend yield / foreign rate
+    std::vector<double> cp;    // +1 call, -1 put
+
+    void resize(std::size_t n)
+    {
+        for (auto* c : {&spot, &strike, &expiry, &vol, &rate, &carry, &cp}) c->resize(n);
+    }
+    std::size_t size() const noexcept
+    {
+        return spot.size();
+    }
+};
+
+namespace ll_bs_detail
+{
+// output columns start on a cache line, so chunks of 8 doubles are whole lines
+template <class T>
+struct line_allocator
+{
+    using value_type = T;
+    static constexpr std::align_val_t align{64};
+
+    line_allocator() noexcept = default;
+    template <class U>
+    line_allocator(const line_allocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), align));
+    }
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        ::operator delete(p, align);
+    }
+
+    template <class U>
+    bool operator==(const line_allocator<U>&) const noexcept
+    {
+        return true;
+    }
+};
+} // namespace ll_bs_detail
+
+using ll_bs_column = std::vector<double, ll_bs_detail::line_allocator<double>>;
+
+struct ll_greeks_batch
+{
+    ll_bs_column price;
+    ll_bs_column delta;
+    ll_bs_column gamma;
+    ll_bs_column vega;
+    ll_bs_column theta; // per year
+    ll_bs_column rho;
+
+    void resize(std::size_t n)
+    {
+        for (auto* c : {&price, &delta, &gamma, &vega, &theta, &rho}) c->resize(n);
+    }
+};
+
+namespace ll_bs_detail
+{
+// declarations, not a using-directive: the scalar build must not see ::exp
+using ll_vmath_detail::bcast, ll_vmath_detail::erfc_coefficients, ll_vmath_detail::exp, ll_vmath_detail::fma;
+using ll_vmath_detail::load, ll_vmath_detail::log, ll_vmath_detail::norm_cdf, ll_vmath_detail::sqrt;
+using ll_vmath_detail::store, ll_vmath_detail::vd, ll_vmath_detail::width;
+
+// x: spot, strike, expiry, vol, rate, carry, cp; y: price, delta, gamma,
+// vega, theta, rho; one vector of contracts starting at offset i
+template <bool Greeks>
+inline void step(const double* const* x, double* const* y, std::size_t i, const double* c) noexcept
+{
+    const vd s = load(x[0] + i), k = load(x[1] + i), t = load(x[2] + i), vol = load(x[3] + i);
+    const vd r = load(x[4] + i), q = load(x[5] + i), phi = load(x[6] + i);
+
+    const vd sqt = sqrt(t);
+    const vd vst = vol * sqt;
+    const vd d1 = fma(fma(bcast(0.5) * vol, vol, r - q), t, log(s / k)) / vst;
+    const vd d2 = d1 - vst;
+    const vd dq = exp(-(q * t));
+    const vd sdq = s * dq, kdr = k * exp(-(r * t));
+    const vd n1 = norm_cdf(phi * d1, c), n2 = norm_cdf(phi * d2, c);
+
+    store(y[0] + i, phi * (sdq * n1 - kdr * n2));
+    if constexpr (Greeks)
+    {
+        const vd pdf = bcast(0.39894228040143267794) * exp(bcast(-0.5) * d1 * d1);
+        store(y[1] + i, phi * dq * n1);
+        store(y[2] + i, dq * pdf / (s * vst));
+        store(y[3] + i, sdq * pdf * sqt);
+        store(y[4] + i, phi * (q * sdq * n1 - r * kdr * n2) - sdq * pdf * vol / (bcast(2.0) * sqt));
+        store(y[5] + i, phi * kdr * t * n2);
+    }
+}
+
+template <bool Greeks>
+inline void run(const ll_option_batch& in, ll_greeks_batch& out, std::size_t begin, std::size_t end) noexcept
+{
+    const double* c = erfc_coefficients().data();
+    const double* x[7] = {in.spot.data(), in.strike.data(), in.expiry.data(), in.vol.data(),
+                          in.rate.data(), in.carry.data(), in.cp.data()};
+    double* y[6] = {out.price.data(), out.delta.data(), out.gamma.data(),
+                    out.vega.data(),  out.theta.data(), out.rho.data()};
+    std::size_t i = begin;
+    for (; i + width <= end; i += width) step<Greeks>(x, y, i, c);
+    if (i == end) return;
+
+    // tail: through lane-sized buffers padded with an at-the-money contract
+    const std::size_t m = end - i;
+    double a[7][width], b[6][width];
+    const double* pa[7];
+    double* pb[6];
+    for (int k = 0; k < 7; ++k)
+    {
+        std::fill_n(a[k], width, 1.0);
+        std::copy_n(x[k] + i, m, a[k]);
+        pa[k] = a[k];
+    }
+    for (int k = 0; k < 6; ++k) pb[k] = b[k];
+    step<Greeks>(pa, pb, 0, c);
+    for (int k = 0; k < (Greeks ? 6 : 1); ++k) std::copy_n(b[k], m, y[k] + i);
+}
+} // namespace ll_bs_detail
+
+// price and Greeks for contracts [begin, end); out must be sized
+inline void ll_bs_greeks(const ll_option_batch& in, ll_greeks_batch& out, std::size_t begin, std::size_t end) noexcept
+{
+    ll_bs_detail::run<true>(in, out, begin, end);
+}
+
+// price only, into out.price
+inline void ll_bs_price(const ll_option_batch& in, ll_greeks_batch& out, std::size_t begin, std::size_t end) noexcept
+{
+    ll_bs_detail::run<false>(in, out, begin, end);
+}
+
+// whole batch over `threads` threads (0 = hardware concurrency); sizes out
+inline void ll_bs_greeks_parallel(const ll_option_batch& in, ll_greeks_batch& out, unsigned threads = 0)
+{
+    const std::size_t n = in.size();
+    for (auto* c : {&in.strike, &in.expiry, &in.vol, &in.rate, &in.carry, &in.cp})
+        if (c->size() != n) throw std::invalid_argument("ll_bs_greeks_parallel: column size mismatch");
+    out.resize(n);
+
+    unsigned t = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    // chunks in whole cache lines of output (8 doubles), at least 4k contracts
+    const std::size_t chunk = (std::max<std::size_t>(4096, (n + t - 1) / t) + 7) & ~std::size_t{7};
+    t = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(t, (n + chunk - 1) / chunk)));
+
+    const auto part = [&](unsigned p) { ll_bs_greeks(in, out, std::min(n, p * chunk), std::min(n, (p + 1) * chunk)); };
+    std::vector<std::thread> pool;
+    pool.reserve(t - 1);
+    for (unsigned p = 1; p < t; ++p) pool.emplace_back(part, p);
+    part(0);
+    for (auto& th : pool) th.join();
+}
+
+// scalar libm baseline: same formulas, std::exp / std::log / std::erfc
+inline void ll_bs_greeks_reference(const ll_option_batch& in, ll_greeks_batch& out, std::size_t begin,
+                                   std::size_t end) noexcept
+{
+    const auto ncdf = [](double x) { return 0.5 * std::erfc(-x * 0.70710678118654752440); };
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const double s = in.spot[i], k = in.strike[i], t = in.expiry[i], vol = in.vol[i];
+        const double r = in.rate[i], q = in.carry[i], phi = in.cp[i];
+        const double sqt = std::sqrt(t), vst = vol * sqt;
+        const double d1 = (std::log(s / k) + (r - q + 0.5 * vol * vol) * t) / vst, d2 = d1 - vst;
+        const double dq = std::exp(-q * t), sdq = s * dq, kdr = k * std::exp(-r * t);
+        const double n1 = ncdf(phi * d1), n2 = ncdf(phi * d2);
+        const double pdf = 0.39894228040143267794 * std::exp(-0.5 * d1 * d1);
+        out.price[i] = phi * (sdq * n1 - kdr * n2);
+        out.delta[i] = phi * dq * n1;
+        out.gamma[i] = dq * pdf / (s * vst);
+        out.vega[i] = sdq * pdf * sqt;
+        out.theta[i] = phi * (q * sdq * n1 - r * kdr * n2) - sdq * pdf * vol / (2.0 * sqt);
+        out.rho[i] = phi * kdr * t * n2;
+    }
+}
@@ -0,0 +1,239 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "ll_hash.hpp"
+
+/*
+ *Cache-Line Blocked Bloom Filter
+ * A Bloom filter whose k = 8 bits per key all live in one 64-byte block:
+ * one cache miss per insert or probe instead of k (Putze et al.; the
+ * "split block" layout of Impala / Parquet widened to a cache line).
+ * - block : 8 x 64-bit words; each key sets exactly one bit in every word
+ * - hash  : upper 32 bits pick the block (multiply-shift range reduction),
+ *   lower 32 bits times 8 odd salts give the 8 bit positions (top 6 bits)
+ * - probe : build the 8-word mask in a vector register, one AND + compare.
+ *   AVX-512 (one register), AVX2 (two) or scalar, chosen at compile time
+ * - bulk  : insert / contains over a span of hashes with the block of key
+ *   i + 8 prefetched while key i is handled
+ *
+ * False positive rate: ~0.5% at 12 bits per key, ~0.1% at 16 (the
+ * blocking costs a little versus a classic filter with the same memory).
+ * Keys are pre-hashed 64-bit values; integer keys go through ll_mix64,
+ * byte strings through ll_hash_bytes. No deletes, no false negatives.
+ */
+
+class ll_blocked_bloom
+{
+public:
+    struct alignas(64) block
+    {
+        std::uint64_t w[8];
+    };
+
+private:
+    std::vector<block> blocks_;
+    std::uint64_t nblocks_;
+
+    static constexpr std::uint32_t salt_[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                               0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+    std::size_t block_of(std::uint64_t h) const noexcept
+    {
+        return static_cast<std::size_t>(((h >> 32) * nblocks_) >> 32);
+    }
+
+#if defined(__AVX512F__)
+    static __m512i make_mask(std::uint64_t h) noexcept
+    {
+        const __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(salt_));
+        const __m256i bit = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(h)), salts), 26);
+        // maskz forms: the plain ones trip GCC 12's -Wmaybe-uninitialized
+        return _mm512_maskz_sllv_epi64(0xFF, _mm512_set1_epi64(1), _mm512_maskz_cvtepu32_epi64(0xFF, bit));
+    }
+    static bool test(const block& b, std::uint64_t h) noexcept
+    {
+        const __m512i m = make_mask(h);
+        return _mm512_cmpneq_epi64_mask(_mm512_and_si512(_mm512_load_si512(b.w), m), m) == 0;
+    }
+    static void set(block& b, std::uint64_t h) noexcept
+    {
+        _mm512_store_si512(b.w, _mm512_or_si512(_mm512_load_si512(b.w), make_mask(h)));
+    }
+#elif defined(__AVX2__)
+    static void make_mask(std::uint64_t h, __m256i& lo, __m256i& hi) noexcept
+    {
+        const __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(salt_));
+        const __m256i bit = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(h)), salts), 26);
+        const __m256i one = _mm256_set1_epi64x(1);
+        lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bit)));
+        hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bit, 1)));
+    }
+    static bool test(const block& b, std::uint64_t h) noexcept
+    {
+        __m256i lo, hi;
+        make_mask(h, lo, hi);
+        const auto* p = reinterpret_cast<const __m256i*>(b.w);
+        return _mm256_testc_si256(_mm256_load_si256(p), lo) & _mm256_testc_si256(_mm256_load_si256(p + 1), hi);
+    }
+    static void set(block& b, std::uint64_t h) noexcept
+    {
+        __m256i lo, hi;
+        make_mask(h, lo, hi);
+        auto* p = reinterpret_cast<__m256i*>(b.w);
+        _mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), lo));
+        _mm256_store_si256(p + 1, _mm256_or_si256(_mm256_load_si256(p + 1), hi));
+    }
+#else
+    static std::uint64_t bit(std::uint64_t h, unsigned i) noexcept
+    {
+        return std::uint64_t{1} << ((static_cast<std::uint32_t>(h) * salt_[i]) >> 26);
+    }
+    static bool test(const block& b, std::uint64_t h) noexcept
+    {
+        std::uint64_t miss = 0;
+        for (unsigned i = 0; i < 8; ++i) miss |= ~b.w[i] & bit(h, i);
+        return miss == 0;
+    }
+    static void set(block& b, std::uint64_t h) noexcept
+    {
+        for (unsigned i = 0; i < 8; ++i) b.w[i] |= bit(h, i);
+    }
+#endif
+
+    void prefetch(std::uint64_t h) const noexcept
+    {
+        __builtin_prefetch(&blocks_[block_of(h)]);
+    }
+
+public:
+    static constexpr std::size_t prefetch_distance = 8;
+
+    // sized for `capacity` keys at `bits_per_key` (rounded up to whole blocks)
+    explicit ll_blocked_bloom(std::size_t capacity, double bits_per_key = 12.0)
+    {
+        if (capacity == 0 || bits_per_key <= 0.0) throw std::invalid_argument("ll_blocked_bloom: empty filter");
+        const double bits = static_cast<double>(capacity) * bits_per_key;
+        nblocks_ = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(bits / 512.0 + 0.999));
+        if (nblocks_ > 0xFFFFFFFFull) throw std::invalid_argument("ll_blocked_bloom: too large");
+        blocks_.assign(nblocks_, block{});
+    }
+
+    void insert_hash(std::uint64_t h) noexcept
+    {
+        set(blocks_[block_of(h)], h);
+    }
+
+    bool contains_hash(std::uint64_t h) const noexcept
+    {
+        return test(blocks_[block_of(h)], h);
+    }
+
+    // dedup primitive: true if h was (probably) present before this call
+    bool test_and_insert_hash(std::uint64_t h) noexcept
+    {
+        block& b = blocks_[block_of(h)];
+        if (test(b, h)) return true;
+        set(b, h);
+        return false;
+    }
+
+    void insert(std::uint64_t key) noexcept
+    {
+        insert_hash(ll_mix64(key));
+    }
+
+    bool contains(std::uint64_t key) const noexcept
+    {
+        return contains_hash(ll_mix64(key));
+    }
+
+// Bulk
+
+    void insert_hashes(std::span<const std::uint64_t> hs) noexcept
+    {
+        const std::size_t n = hs.size();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (i + prefetch_distance < n) prefetch(hs[i + prefetch_distance]);
+            insert_hash(hs[i]);
+        }
+    }
+
+    // out[i] = contains(hs[i]); returns the number of hits
+    std::size_t contains_hashes(std::span<const std::uint64_t> hs, bool* out) const noexcept
+    {
+        const std::size_t n = hs.size();
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (i + prefetch_distance < n) prefetch(hs[i + prefetch_distance]);
+            hits += out[i] = contains_hash(hs[i]);
+        }
+        return hits;
+    }
+
+    // integer keys, hashed in chunks so the mixing loop vectorises
+    void insert(std::span<const std::uint64_t> keys) noexcept
+    {
+        std::uint64_t h[256];
+        for (std::size_t i = 0; i < keys.size(); i += 256)
+        {
+            const std::size_t m = std::min<std::size_t>(256, keys.size() - i);
+            for (std::size_t j = 0; j < m; ++j) h[j] = ll_mix64(keys[i + j]);
+            insert_hashes({h, m});
+        }
+    }
+
+    std::size_t contains(std::span<const std::uint64_t> keys, bool* out) const noexcept
+    {
+        std::uint64_t h[256];
+        std::size_t hits = 0;
+        for (std::size_t i = 0; i < keys.size(); i += 256)
+        {
+            const std::size_t m = std::min<std::size_t>(256, keys.size() - i);
+            for (std::size_t j = 0; j < m; ++j) h[j] = ll_mix64(keys[i + j]);
+            hits += contains_hashes({h, m}, out + i);
+        }
+        return hits;
+    }
+
+// Maintenance
+
+    void clear() noexcept
+    {
+        std::fill(blocks_.begin(), blocks_.end(), block{});
+    }
+
+    // union; both filters must have the same size
+    void merge(const ll_blocked_bloom& o)
+    {
+        if (o.nblocks_ != nblocks_) throw std::invalid_argument("ll_blocked_bloom: size mismatch");
+        for (std::size_t i = 0; i < nblocks_; ++i)
+            for (unsigned j = 0; j < 8; ++j) blocks_[i].w[j] |= o.blocks_[i].w[j];
+    }
+
+    // fraction of bits set; ~0.5 means the filter is at its design load
+    double fill_ratio() const noexcept
+    {
+        std::uint64_t ones = 0;
+        for (const block& b : blocks_)
+            for (std::uint64_t w : b.w) ones += static_cast<std::uint64_t>(std::popcount(w));
+        return static_cast<double>(ones) / static_cast<double>(nblocks_ * 512);
+    }
+
+    std::size_t memory_bytes() const noexcept
+    {
+        return blocks_.size() * sizeof(block);
+    }
+};
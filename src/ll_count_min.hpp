@@ -0,0 +1,173 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "ll_hash.hpp"
+
+/*
+ *Count-Min Sketch
+ * Approximate per-key counts in fixed memory (Cormode, Muthukrishnan).
+ * - depth rows of width counters (width a power of two); a key increments
+ *   one counter per row, its estimate is the minimum over its counters
+ * - never underestimates; overestimates by at most e/width * total with
+ *   probability 1 - e^-depth
+ * - row indices by double hashing from one 64-bit hash (h1 + i * h2,
+ *   Kirsch / Mitzenmacher), so a key costs one hash and depth loads
+ * - conservative update (optional): raise only the counters that equal
+ *   the current minimum. Same bound, much smaller error on skewed streams,
+ *   but the rows can no longer be merged by addition
+ * - bulk add hashes a chunk first and prefetches the counters of key
+ *   i + 8 while key i is applied
+ *
+ * 32-bit counters saturate at 2^32 - 1.
+ */
+
+class ll_count_min
+{
+private:
+    std::vector<std::uint32_t> c_; // depth rows x width
+    std::size_t width_;
+    unsigned depth_;
+    unsigned shift_; // 64 - log2(width)
+    bool conservative_;
+    std::uint64_t total_;
+
+    std::size_t slot(std::uint64_t h, unsigned row) const noexcept
+    {
+        const std::uint64_t h2 = (h >> 32) | 1;
+        return row * width_ + static_cast<std::size_t>(ll_mix64(h + row * h2) >> shift_);
+    }
+
+    static std::uint32_t sat_add(std::uint32_t a, std::uint64_t b) noexcept
+    {
+        const std::uint64_t r = a + b;
+        return r > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<std::uint32_t>(r);
+    }
+
+    void prefetch(std::uint64_t h) const noexcept
+    {
+        for (unsigned r = 0; r < depth_; ++r) __builtin_prefetch(&c_[slot(h, r)], 1);
+    }
+
+public:
+    static constexpr std::size_t prefetch_distance = 8;
+    static constexpr unsigned max_depth = 16;
+
+    // width rounded up to a power of two; error ~ e / width of the total
+    ll_count_min(std::size_t width, unsigned depth = 4, bool conservative = false)
+        : width_(std::bit_ceil(std::max<std::size_t>(width, 16)))
+        , depth_(depth)
+        , shift_(64 - static_cast<unsigned>(std::countr_zero(width_)))
+        , conservative_(conservative)
+        , total_(0)
+    {
+        if (depth == 0 || depth > max_depth) throw std::invalid_argument("ll_count_min: depth must be in [1, 16]");
+        c_.assign(width_ * depth_, 0);
+    }
+
+    void add_hash(std::uint64_t h, std::uint64_t count = 1) noexcept
+    {
+        total_ += count;
+        if (!conservative_)
+        {
+            for (unsigned r = 0; r < depth_; ++r)
+            {
+                std::uint32_t& c = c_[slot(h, r)];
+                c = sat_add(c, count);
+            }
+            return;
+        }
+        std::size_t s[max_depth];
+        std::uint32_t lo = 0xFFFFFFFFu;
+        for (unsigned r = 0; r < depth_; ++r)
+        {
+            s[r] = slot(h, r);
+            lo = std::min(lo, c_[s[r]]);
+        }
+        const std::uint32_t target = sat_add(lo, count);
+        for (unsigned r = 0; r < depth_; ++r) c_[s[r]] = std::max(c_[s[r]], target);
+    }
+
+    std::uint64_t estimate_hash(std::uint64_t h) const noexcept
+    {
+        std::uint32_t lo = 0xFFFFFFFFu;
+        for (unsigned r = 0; r < depth_; ++r) lo = std::min(lo, c_[slot(h, r)]);
+        return lo;
+    }
+
+    void add(std::uint64_t key, std::uint64_t count = 1) noexcept
+    {
+        add_hash(ll_mix64(key), count);
+    }
+
+    std::uint64_t estimate(std::uint64_t key) const noexcept
+    {
+        return estimate_hash(ll_mix64(key));
+    }
+
+// Bulk
+
+    // one occurrence per key
+    void add(std::span<const std::uint64_t> keys) noexcept
+    {
+        std::uint64_t h[256];
+        for (std::size_t i = 0; i < keys.size(); i += 256)
+        {
+            const std::size_t n = std::min<std::size_t>(256, keys.size() - i);
+            for (std::size_t j = 0; j < n; ++j) h[j] = ll_mix64(keys[i + j]);
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                if (j + prefetch_distance < n) prefetch(h[j + prefetch_distance]);
+                add_hash(h[j]);
+            }
+        }
+    }
+
+    void estimate(std::span<const std::uint64_t> keys, std::uint64_t* out) const noexcept
+    {
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            if (i + prefetch_distance < keys.size()) prefetch(ll_mix64(keys[i + prefetch_distance]));
+            out[i] = estimate(keys[i]);
+        }
+    }
+
+// Maintenance
+
+    // counter-wise sum; same shape required, and plain (non-conservative)
+    // updates for the result to keep the error bound
+    void merge(const ll_count_min& o)
+    {
+        if (o.width_ != width_ || o.depth_ != depth_) throw std::invalid_argument("ll_count_min: shape mismatch");
+        for (std::size_t i = 0; i < c_.size(); ++i) c_[i] = sat_add(c_[i], o.c_[i]);
+        total_ += o.total_;
+    }
+
+    void clear() noexcept
+    {
+        std::fill(c_.begin(), c_.end(), 0);
+        total_ = 0;
+    }
+
+    std::uint64_t total() const noexcept
+    {
+        return total_;
+    }
+    std::size_t width() const noexcept
+    {
+        return width_;
+    }
+    unsigned depth() const noexcept
+    {
+        return depth_;
+    }
+    std::size_t memory_bytes() const noexcept
+    {
+        return c_.size() * sizeof(std::uint32_t);
+    }
+};
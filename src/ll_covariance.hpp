@@ -0,0 +1,310 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ll_vmath.hpp"
+
+/*
+ *Blocked Covariance / Correlation
+ * Sample covariance of n return series over T observations as a
+ * symmetric rank-k update (SYRK) C = Xc^T Xc of the centred T x n matrix,
+ * tiled like a GEMM:
+ * - pack   : centred rows are copied once into column panels of 16 (AVX-512)
+ *   or 8 doubles, [panel][t][16], so every kernel load is contiguous
+ * - kernel : 8 rows x 1 panel of C held in 16 vector registers; per
+ *   observation one panel row is loaded and 8 values broadcast (16 FMAs)
+ * - blocks : 256 observations x (64 rows x 256 columns) of C per task, so
+ *   the row slice stays in L1 and the column panels in L2
+ * - upper triangle only; tasks are handed to threads through an atomic
+ *   counter (the triangle makes static splits uneven)
+ *
+ * ll_covariance_matrix / ll_correlation_matrix : one-shot, two-pass (exact
+ * means, then the blocked SYRK), written as a full n x n row-major matrix.
+ *
+ * ll_rolling_covariance : window of the last W rows. Keeps
+ *   S = sum (x - c)(x - c)^T and s = sum (x - c) over the window, where c
+ *   is a fixed shift (the means at the last resync) that keeps the sums
+ *   well conditioned. push(rows, k) is a rank-2k update: the k new rows
+ *   are added and the k rows leaving the window are subtracted, both
+ *   through the same packed kernel, so its cost is one pass over S plus
+ *   2 k n^2 flops. cov = (S - s s^T / W) / (W - 1).
+ *   Rounding accumulates over long runs; resync() re-centres and rebuilds
+ *   S from the window.
+ */
+
+namespace ll_cov_detail
+{
+using ll_vmath_detail::bcast, ll_vmath_detail::fma, ll_vmath_detail::load, ll_vmath_detail::store;
+using ll_vmath_detail::vd, ll_vmath_detail::width;
+
+inline constexpr std::size_t panel = width >= 8 ? 16 : 8; // columns per packed panel
+inline constexpr std::size_t nv = panel / width;          // vectors per panel row
+inline constexpr std::size_t mr = 8;                      // C rows per kernel call
+inline constexpr std::size_t kc = 256;                    // observations per block
+inline constexpr std::size_t mb = 64;                     // C rows per task
+inline constexpr std::size_t nb = 256;                    // C columns per task
+
+inline std::size_t padded(std::size_t n) noexcept
+{
+    return (n + panel - 1) / panel * panel;
+}
+
+template <typename F>
+inline void parallel_for(unsigned n, F&& f)
+{
+    if (n == 1)
+    {
+        f(0u);
+        return;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(n - 1);
+    for (unsigned i = 1; i < n; ++i) pool.emplace_back([&f, i] { f(i); });
+    f(0u);
+    for (auto& t : pool) t.join();
+}
+
+// row t of a k-row packed block: out[p][t][0..panel) = x - shift, zero padded
+inline void pack_row(const double* __restrict x, const double* __restrict shift, std::size_t n, std::size_t t,
+                     std::size_t k, double* __restrict out) noexcept
+{
+    const std::size_t np = padded(n);
+    for (std::size_t p = 0; p < np; p += panel)
+    {
+        double* o = out + p * k + t * panel;
+        const std::size_t m = std::min(panel, n - std::min(n, p));
+        for (std::size_t j = 0; j < m; ++j) o[j] = x[p + j] - shift[p + j];
+        for (std::size_t j = m; j < panel; ++j) o[j] = 0.0;
+    }
+}
+
+// c[0..8)[0..panel) += alpha * sum_t a[t][0..8)^T b[t][0..panel)
+inline void micro(const double* __restrict a, const double* __restrict b, std::size_t k, double* __restrict c,
+                  std::size_t ldc, double alpha) noexcept
+{
+    vd acc[mr][nv];
+    for (std::size_t r = 0; r < mr; ++r)
+        for (std::size_t v = 0; v < nv; ++v) acc[r][v] = bcast(0.0);
+    for (std::size_t t = 0; t < k; ++t)
+    {
+        const double* at = a + t * panel;
+        const double* bt = b + t * panel;
+        vd bv[nv];
+        for (std::size_t v = 0; v < nv; ++v) bv[v] = load(bt + v * width);
+        for (std::size_t r = 0; r < mr; ++r)
+        {
+            const vd ar = bcast(at[r]);
+            for (std::size_t v = 0; v < nv; ++v) acc[r][v] = fma(ar, bv[v], acc[r][v]);
+        }
+    }
+    const vd al = bcast(alpha);
+    for (std::size_t r = 0; r < mr; ++r)
+        for (std::size_t v = 0; v < nv; ++v)
+        {
+            double* cp = c + r * ldc + v * width;
+            store(cp, fma(al, acc[r][v], load(cp)));
+        }
+}
+
+// upper triangle (by panel) of c[np][np] += alpha * P^T P, P packed k x np
+inline void syrk(const double* p, std::size_t k, std::size_t np, double* c, double alpha, unsigned threads)
+{
+    if (k == 0) return;
+    std::vector<std::pair<std::size_t, std::size_t>> tasks;
+    for (std::size_t i0 = 0; i0 < np; i0 += mb)
+        for (std::size_t j0 = 0; j0 < np; j0 += nb)
+            if (j0 + nb > i0) tasks.emplace_back(i0, j0);
+    std::atomic<std::size_t> next{0};
+    const unsigned t = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, tasks.size())));
+    parallel_for(t, [&](unsigned)
+    {
+        for (std::size_t w; (w = next.fetch_add(1, std::memory_order_relaxed)) < tasks.size();)
+        {
+            const auto [i0, j0] = tasks[w];
+            const std::size_t i1 = std::min(i0 + mb, np), j1 = std::min(j0 + nb, np);
+            for (std::size_t t0 = 0; t0 < k; t0 += kc)
+            {
+                const std::size_t kk = std::min(kc, k - t0);
+                for (std::size_t i = i0; i < i1; i += mr)
+                {
+                    const double* a = p + (i - i % panel) * k + t0 * panel + i % panel;
+                    for (std::size_t j = j0; j < j1; j += panel)
+                    {
+                        if (j + panel <= i) continue; // wholly below the diagonal
+                        micro(a, p + j * k + t0 * panel, kk, c + i * np + j, np, alpha);
+                    }
+                }
+            }
+        }
+    });
+}
+
+// out[n][n] from the upper triangle of c: (c - s s^T / m) / (m - 1), or the
+// correlation of that; s may be null (already centred)
+inline void finish(const double* c, std::size_t np, const double* s, std::size_t m, std::size_t n, double* out,
+                   bool corr)
+{
+    const double inv_m = 1.0 / static_cast<double>(m), inv = m > 1 ? 1.0 / static_cast<double>(m - 1) : 0.0;
+    const auto cov = [&](std::size_t i, std::size_t j) { return (c[i * np + j] - (s ? s[i] * s[j] * inv_m : 0.0)) * inv; };
+    std::vector<double> scale(n, 1.0);
+    if (corr)
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double v = cov(i, i);
+            scale[i] = v > 0.0 ? 1.0 / std::sqrt(v) : 0.0;
+        }
+    // 64 x 64 blocks keep the mirrored (column) writes in cache
+    constexpr std::size_t b = 64;
+    for (std::size_t i0 = 0; i0 < n; i0 += b)
+        for (std::size_t j0 = i0; j0 < n; j0 += b)
+            for (std::size_t i = i0; i < std::min(i0 + b, n); ++i)
+                for (std::size_t j = std::max(j0, i); j < std::min(j0 + b, n); ++j)
+                    out[i * n + j] = out[j * n + i] = cov(i, j) * scale[i] * scale[j];
+}
+
+inline void one_shot(const double* x, std::size_t rows, std::size_t n, double* out, unsigned threads, bool corr)
+{
+    if (rows < 2 || n == 0) throw std::invalid_argument("ll_covariance_matrix: need two rows and one series");
+    const std::size_t np = padded(n);
+    std::vector<double> mean(np, 0.0);
+    for (std::size_t t = 0; t < rows; ++t)
+        for (std::size_t j = 0; j < n; ++j) mean[j] += x[t * n + j];
+    for (double& v : mean) v /= static_cast<double>(rows);
+    std::vector<double> packed(np * rows);
+    for (std::size_t t = 0; t < rows; ++t) pack_row(x + t * n, mean.data(), n, t, rows, packed.data());
+    std::vector<double> c(np * np, 0.0);
+    syrk(packed.data(), rows, np, c.data(), 1.0, threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+    finish(c.data(), np, nullptr, rows, n, out, corr);
+}
+} // namespace ll_cov_detail
+
+// x: rows x n row-major (one observation per row); out: n x n sample covariance
+inline void ll_covariance_matrix(const double* x, std::size_t rows, std::size_t n, double* out, unsigned threads = 0)
+{
+    ll_cov_detail::one_shot(x, rows, n, out, threads, false);
+}
+
+inline void ll_correlation_matrix(const double* x, std::size_t rows, std::size_t n, double* out, unsigned threads = 0)
+{
+    ll_cov_detail::one_shot(x, rows, n, out, threads, true);
+}
+
+class ll_rolling_covariance
+{
+private:
+    static constexpr std::size_t max_chunk = 256; // rows packed per update
+
+    std::size_t n_;
+    std::size_t np_;
+    std::size_t window_;
+    unsigned threads_;
+    std::size_t pos_;   // ring slot of the next row
+    std::size_t count_; // rows in the window
+    std::vector<double> ring_;  // [window][n]
+    std::vector<double> shift_; // [np]
+    std::vector<double> sum_;   // [np] sum (x - shift)
+    std::vector<double> cross_; // [np][np] upper triangle of sum (x - shift)(x - shift)^T
+    std::vector<double> in_;    // packed rows entering
+    std::vector<double> out_;   // packed rows leaving
+
+    void push_chunk(const double* rows, std::size_t m)
+    {
+        const std::size_t leaving = count_ + m > window_ ? count_ + m - window_ : 0;
+        const std::size_t oldest = (pos_ + window_ - count_) % window_;
+        for (std::size_t t = 0; t < leaving; ++t)
+        {
+            const double* x = &ring_[(oldest + t) % window_ * n_];
+            ll_cov_detail::pack_row(x, shift_.data(), n_, t, leaving, out_.data());
+            for (std::size_t j = 0; j < n_; ++j) sum_[j] -= x[j] - shift_[j];
+        }
+        for (std::size_t t = 0; t < m; ++t)
+        {
+            const double* x = rows + t * n_;
+            ll_cov_detail::pack_row(x, shift_.data(), n_, t, m, in_.data());
+            for (std::size_t j = 0; j < n_; ++j) sum_[j] += x[j] - shift_[j];
+            std::copy_n(x, n_, &ring_[pos_ * n_]);
+            pos_ = (pos_ + 1) % window_;
+        }
+        ll_cov_detail::syrk(in_.data(), m, np_, cross_.data(), 1.0, threads_);
+        ll_cov_detail::syrk(out_.data(), leaving, np_, cross_.data(), -1.0, threads_);
+        count_ = std::min(window_, count_ + m);
+    }
+
+public:
+    ll_rolling_covariance(std::size_t series, std::size_t window, unsigned threads = 0)
+        : n_(series)
+        , np_(ll_cov_detail::padded(series))
+        , window_(window)
+        , threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+        , pos_(0)
+        , count_(0)
+        , ring_(window * series)
+        , shift_(np_, 0.0)
+        , sum_(np_, 0.0)
+        , cross_(np_ * np_, 0.0)
+        , in_(np_ * std::min(window, max_chunk))
+        , out_(np_ * std::min(window, max_chunk))
+    {
+        if (series == 0 || window < 2) throw std::invalid_argument("ll_rolling_covariance: need a series and window >= 2");
+    }
+
+    // k observations, row-major k x series
+    void push(const double* rows, std::size_t k)
+    {
+        const std::size_t chunk = std::min(window_, max_chunk);
+        for (std::size_t i = 0; i < k; i += chunk) push_chunk(rows + i * n_, std::min(chunk, k - i));
+    }
+
+    void push(const double* x)
+    {
+        push(x, 1);
+    }
+
+    // re-centre on the current window means and rebuild the sums exactly
+    void resync()
+    {
+        std::fill(shift_.begin(), shift_.end(), 0.0);
+        std::fill(sum_.begin(), sum_.end(), 0.0);
+        std::fill(cross_.begin(), cross_.end(), 0.0);
+        if (count_ == 0) return;
+        const std::size_t oldest = (pos_ + window_ - count_) % window_;
+        for (std::size_t t = 0; t < count_; ++t)
+            for (std::size_t j = 0; j < n_; ++j) shift_[j] += ring_[(oldest + t) % window_ * n_ + j];
+        for (std::size_t j = 0; j < n_; ++j) shift_[j] /= static_cast<double>(count_);
+        std::vector<double> packed(np_ * count_);
+        for (std::size_t t = 0; t < count_; ++t)
+            ll_cov_detail::pack_row(&ring_[(oldest + t) % window_ * n_], shift_.data(), n_, t, count_, packed.data());
+        ll_cov_detail::syrk(packed.data(), count_, np_, cross_.data(), 1.0, threads_);
+    }
+
+// Queries
+
+    // out[series][series], row-major
+    void covariance(double* out) const
+    {
+        ll_cov_detail::finish(cross_.data(), np_, sum_.data(), count_, n_, out, false);
+    }
+
+    void correlation(double* out) const
+    {
+        ll_cov_detail::finish(cross_.data(), np_, sum_.data(), count_, n_, out, true);
+    }
+
+    std::size_t series() const noexcept
+    {
+        return n_;
+    }
+    std::size_t window() const noexcept
+    {
+        return window_;
+    }
+    std::size_t count() const noexcept
+    {
+        return count_;
+    }
+};
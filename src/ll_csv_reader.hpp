@@ -0,0 +1,339 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ll_fast_parse.hpp"
+#include "ll_simd_scan.hpp"
+
+/*
+ *Parallel CSV Ingest
+ * Reads RFC 4180 style CSV (quoted fields, "" inside quotes) from an
+ * in-memory buffer — typically an ll_mmap_file — into typed columns.
+ *
+ * Pipeline:
+ * 1. split the body into T equal byte ranges
+ * 2. (parallel) count quote characters per range with 64 byte SIMD blocks
+ * 3. prefix-xor the per-range counts: quote parity at every range start
+ * 4. move each split point forward to the first newline that is outside
+ *    quotes (prefix-xor of the quote mask seeded with that parity)
+ * 5. (parallel) parse each record-aligned range: delimiters and newlines
+ *    outside quotes come from the same bitmask, fields are parsed in place
+ *    with ll_fast_parse into per-thread columns
+ * 6. (parallel) concatenate the per-thread columns in order
+ *
+ * String columns are std::string_view into the input (outer quotes removed,
+ * doubled "" left as-is): the input must outlive the table.
+ * Numeric fields must be present and well formed; a malformed field or a
+ * record with the wrong number of fields throws ll_csv_error.
+ * Blank lines are skipped; a trailing '\r' (CRLF files) is ignored.
+ */
+
+class ll_csv_error : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+enum class ll_csv_type
+{
+    i64,
+    f64,
+    str,
+    skip
+};
+
+struct ll_csv_column
+{
+    ll_csv_type type = ll_csv_type::skip;
+    std::vector<std::int64_t> i64;
+    std::vector<double> f64;
+    std::vector<std::string_view> str;
+};
+
+struct ll_csv_table
+{
+    std::vector<std::string_view> names; // header fields, if any
+    std::vector<ll_csv_column> columns;
+    std::size_t rows = 0;
+};
+
+struct ll_csv_options
+{
+    char delimiter = ',';
+    bool header = true;
+    unsigned threads = 0;                          // 0 = hardware_concurrency
+    std::size_t min_chunk_bytes = std::size_t{1} << 20; // smaller inputs use fewer threads
+};
+
+class ll_csv_reader
+{
+private:
+    std::vector<ll_csv_type> schema_;
+    ll_csv_options opt_;
+
+    struct chunk_result
+    {
+        std::vector<ll_csv_column> cols;
+        std::size_t rows = 0;
+        std::exception_ptr error;
+    };
+
+    template <typename F>
+    static void parallel_for(unsigned n, F&& f)
+    {
+        if (n == 1)
+        {
+            f(0u);
+            return;
+        }
+        std::vector<std::thread> pool;
+        pool.reserve(n - 1);
+        for (unsigned i = 1; i < n; ++i) pool.emplace_back([&f, i] { f(i); });
+        f(0u);
+        for (auto& t : pool) t.join();
+    }
+
+    static ll_block64 block_at(const char* p, std::size_t left) noexcept
+    {
+        return left >= 64 ? ll_block64::load(p) : ll_block64::load_partial(p, left, '\0');
+    }
+
+    static std::size_t count_quotes(const char* p, std::size_t n) noexcept
+    {
+        std::size_t q = 0;
+        for (std::size_t base = 0; base < n; base += 64)
+            q += static_cast<std::size_t>(std::popcount(block_at(p + base, n - base).eq('"')));
+        return q;
+    }
+
+    // offset just past the first newline outside quotes at or after from
+    static std::size_t next_record(const char* p, std::size_t n, std::size_t from, bool in_quote) noexcept
+    {
+        std::uint64_t carry = in_quote ? ~std::uint64_t{0} : 0;
+        for (std::size_t base = from; base < n; base += 64)
+        {
+            const ll_block64 b = block_at(p + base, n - base);
+            const std::uint64_t inq = ll_prefix_xor(b.eq('"')) ^ carry;
+            carry = static_cast<std::uint64_t>(static_cast<std::int64_t>(inq) >> 63);
+            const std::uint64_t nl = b.eq('\n') & ~inq;
+            if (nl) return std::min(n, base + static_cast<std::size_t>(std::countr_zero(nl)) + 1);
+        }
+        return n;
+    }
+
+    static std::string_view unquote(std::string_view f) noexcept
+    {
+        if (f.size() >= 2 && f.front() == '"' && f.back() == '"') return f.substr(1, f.size() - 2);
+        return f;
+    }
+
+    void emit(std::vector<ll_csv_column>& cols, std::size_t c, std::string_view f) const
+    {
+        ll_csv_column& col = cols[c];
+        switch (col.type)
+        {
+        case ll_csv_type::i64:
+        {
+            f = unquote(f);
+            std::int64_t v;
+            const auto r = ll_parse_int(f.data(), f.data() + f.size(), v);
+            if (r.ec != std::errc{} || r.ptr != f.data() + f.size()) throw ll_csv_error("ll_csv: bad integer field");
+            col.i64.push_back(v);
+            break;
+        }
+        case ll_csv_type::f64:
+        {
+            f = unquote(f);
+            double v;
+            const auto r = ll_parse_double(f.data(), f.data() + f.size(), v);
+            if (r.ec != std::errc{} || r.ptr != f.data() + f.size()) throw ll_csv_error("ll_csv: bad number field");
+            col.f64.push_back(v);
+            break;
+        }
+        case ll_csv_type::str: col.str.push_back(unquote(f)); break;
+        case ll_csv_type::skip: break;
+        }
+    }
+
+    // parse whole records in [p, p + n)
+    void parse_range(const char* p, std::size_t n, chunk_result& out) const
+    {
+        const std::size_t ncols = schema_.size();
+        out.cols.resize(ncols);
+        const std::size_t guess = n / (8 * ncols + 1);
+        for (std::size_t c = 0; c < ncols; ++c)
+        {
+            out.cols[c].type = schema_[c];
+            if (schema_[c] == ll_csv_type::i64) out.cols[c].i64.reserve(guess);
+            if (schema_[c] == ll_csv_type::f64) out.cols[c].f64.reserve(guess);
+            if (schema_[c] == ll_csv_type::str) out.cols[c].str.reserve(guess);
+        }
+
+        std::size_t start = 0; // current field start
+        std::size_t col = 0;
+        std::uint64_t carry = 0;
+
+        auto end_field = [&](std::size_t end, bool eol)
+        {
+            if (eol)
+            {
+                if (end > start && p[end - 1] == '\r') --end;
+                if (col == 0 && end == start) return; // blank line
+                if (col + 1 != ncols) throw ll_csv_error("ll_csv: wrong number of fields");
+                emit(out.cols, col, {p + start, end - start});
+                col = 0;
+                ++out.rows;
+            }
+            else
+            {
+                if (col + 1 >= ncols) throw ll_csv_error("ll_csv: wrong number of fields");
+                emit(out.cols, col++, {p + start, end - start});
+            }
+        };
+
+        for (std::size_t base = 0; base < n; base += 64)
+        {
+            const ll_block64 b = block_at(p + base, n - base);
+            const std::uint64_t inq = ll_prefix_xor(b.eq('"')) ^ carry;
+            carry = static_cast<std::uint64_t>(static_cast<std::int64_t>(inq) >> 63);
+
+            const std::uint64_t nl = b.eq('\n') & ~inq;
+            std::uint64_t sep = (b.eq(opt_.delimiter) & ~inq) | nl;
+            if (n - base < 64) sep &= (std::uint64_t{1} << (n - base)) - 1;
+
+            while (sep)
+            {
+                const unsigned bit = static_cast<unsigned>(std::countr_zero(sep));
+                const std::size_t pos = base + bit;
+                end_field(pos, (nl >> bit) & 1);
+                start = pos + 1;
+                sep &= sep - 1;
+            }
+        }
+        if (start < n) end_field(n, true); // last record without a newline
+    }
+
+public:
+    explicit ll_csv_reader(std::vector<ll_csv_type> schema)
+        : ll_csv_reader(std::move(schema), ll_csv_options{})
+    {
+    }
+
+    ll_csv_reader(std::vector<ll_csv_type> schema, ll_csv_options opt)
+        : schema_(std::move(schema))
+        , opt_(opt)
+    {
+        if (schema_.empty()) throw ll_csv_error("ll_csv: empty schema");
+        if (opt_.delimiter == '"' || opt_.delimiter == '\n' || opt_.delimiter == '\0')
+            throw ll_csv_error("ll_csv: invalid delimiter");
+    }
+
+    ll_csv_table read(std::string_view text) const
+    {
+        ll_csv_table table;
+        const char* p = text.data();
+        std::size_t n = text.size();
+
+        if (opt_.header && n)
+        {
+            std::size_t h = next_record(p, n, 0, false);
+            std::string_view line(p, h);
+            while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) line.remove_suffix(1);
+            bool inq = false;
+            std::size_t s = 0;
+            for (std::size_t i = 0; i <= line.size(); ++i)
+            {
+                if (i < line.size() && line[i] == '"') inq = !inq;
+                if (i == line.size() || (!inq && line[i] == opt_.delimiter))
+                {
+                    table.names.push_back(unquote(line.substr(s, i - s)));
+                    s = i + 1;
+                }
+            }
+            p += h;
+            n -= h;
+        }
+
+        unsigned t = opt_.threads ? opt_.threads : std::max(1u, std::thread::hardware_concurrency());
+        t = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(t, n / std::max<std::size_t>(1, opt_.min_chunk_bytes))));
+
+        // 1-3: quote parity at each split point
+        std::vector<std::size_t> split(t + 1), quotes(t);
+        for (unsigned i = 0; i <= t; ++i) split[i] = n / t * i;
+        split[t] = n;
+        if (t > 1) parallel_for(t, [&](unsigned i) { quotes[i] = count_quotes(p + split[i], split[i + 1] - split[i]); });
+
+        // 4: align to record boundaries
+        std::vector<std::size_t> bound(t + 1);
+        bound[0] = 0;
+        bound[t] = n;
+        std::size_t parity = 0;
+        for (unsigned i = 1; i < t; ++i)
+        {
+            parity ^= quotes[i - 1] & 1;
+            bound[i] = std::max(bound[i - 1], next_record(p, n, split[i], parity != 0));
+        }
+
+        // 5: parse
+        std::vector<chunk_result> parts(t);
+        parallel_for(t, [&](unsigned i)
+        {
+            try
+            {
+                parse_range(p + bound[i], bound[i + 1] - bound[i], parts[i]);
+            }
+            catch (...)
+            {
+                parts[i].error = std::current_exception();
+            }
+        });
+        for (auto& part : parts)
+            if (part.error) std::rethrow_exception(part.error);
+
+        // 6: concatenate in order
+        std::vector<std::size_t> row_off(t + 1, 0);
+        for (unsigned i = 0; i < t; ++i) row_off[i + 1] = row_off[i] + parts[i].rows;
+        table.rows = row_off[t];
+
+        if (t == 1)
+        {
+            table.columns = std::move(parts[0].cols);
+            return table;
+        }
+
+        table.columns.resize(schema_.size());
+        for (std::size_t c = 0; c < schema_.size(); ++c)
+        {
+            ll_csv_column& col = table.columns[c];
+            col.type = schema_[c];
+            if (col.type == ll_csv_type::i64) col.i64.resize(table.rows);
+            if (col.type == ll_csv_type::f64) col.f64.resize(table.rows);
+            if (col.type == ll_csv_type::str) col.str.resize(table.rows);
+        }
+        parallel_for(t, [&](unsigned i)
+        {
+            for (std::size_t c = 0; c < schema_.size(); ++c)
+            {
+                const ll_csv_column& src = parts[i].cols[c];
+                ll_csv_column& dst = table.columns[c];
+                const auto off = static_cast<std::ptrdiff_t>(row_off[i]);
+                switch (dst.type)
+                {
+                case ll_csv_type::i64: std::copy(src.i64.begin(), src.i64.end(), dst.i64.begin() + off); break;
+                case ll_csv_type::f64: std::copy(src.f64.begin(), src.f64.end(), dst.f64.begin() + off); break;
+                case ll_csv_type::str: std::copy(src.str.begin(), src.str.end(), dst.str.begin() + off); break;
+                case ll_csv_type::skip: break;
+                }
+            }
+        });
+        return table;
+    }
+};
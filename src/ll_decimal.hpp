@@ -0,0 +1,406 @@
+#pragma once
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#include "ll_fast_parse.hpp"
+
+/*
+ *Fixed-Point Decimal Prices
+ * ll_decimal64<Scale> is a signed 64-bit count of 10^-Scale units: decimal
+ * prices are exact, compare as integers and never need std::round.
+ * - Scale is a template argument (0 .. 18); 10^Scale and the reciprocal
+ *   used to rescale a product are compile-time constants
+ * - + - and * are overflow-checked and throw std::overflow_error; a
+ *   decimal * decimal product rounds half away from zero
+ * - ll_fast_divider: unsigned division by a divisor fixed at run time
+ *   (tick size, lot size) as a multiply and a shift, the magic constant
+ *   computed once (libdivide style, Granlund / Montgomery)
+ * - ll_tick_size<Scale>: prices to whole ticks (int64, as ll_l2_book and
+ *   ll_feed_generator carry them) and back, rounding down / up / nearest
+ * - ll_parse_decimal / ll_format_decimal: text to and from the integer
+ *   representation with no double in between, on ll_fast_parse's digit
+ *   loops
+ */
+
+namespace ll_decimal_detail
+{
+
+__extension__ typedef unsigned __int128 u128;
+__extension__ typedef __int128 i128;
+
+constexpr std::uint64_t pow10(int n) noexcept
+{
+    std::uint64_t r = 1;
+    while (n-- > 0) r *= 10;
+    return r;
+}
+
+// (hi:lo) / d for a divisor known in advance and a quotient below 2^64:
+// two multiplies and two corrections instead of __udivti3.
+// Möller / Granlund, "Improved division by invariant integers" (2011):
+// d normalized (top bit set), v = floor((2^128 - 1) / d) - 2^64
+struct div_2by1
+{
+    std::uint64_t d;
+    std::uint64_t v;
+    int shift;
+
+    constexpr explicit div_2by1(std::uint64_t divisor) noexcept
+        : d(divisor << std::countl_zero(divisor))
+        , v(static_cast<std::uint64_t>(~u128{0} / (divisor << std::countl_zero(divisor))))
+        , shift(std::countl_zero(divisor))
+    {
+    }
+
+    // n / divisor; needs n / divisor < 2^64
+    constexpr std::uint64_t divide(u128 n) const noexcept
+    {
+        n <<= shift;
+        const std::uint64_t u1 = static_cast<std::uint64_t>(n >> 64);
+        const std::uint64_t u0 = static_cast<std::uint64_t>(n);
+        // (q1:q0) = v * u1 + (u1 + 1 : u0), in halves so nothing 128-bit is spilled
+        const u128 vu = static_cast<u128>(v) * u1;
+        const std::uint64_t q0 = static_cast<std::uint64_t>(vu) + u0;
+        std::uint64_t q1 = static_cast<std::uint64_t>(vu >> 64) + u1 + 1 + (q0 < u0);
+        std::uint64_t r = u0 - q1 * d;
+        // taken about half the time: masks, not a branch
+        const std::uint64_t over = 0 - static_cast<std::uint64_t>(r > q0);
+        q1 += over;
+        r += over & d;
+        if (r >= d) [[unlikely]] ++q1;
+        return q1;
+    }
+};
+
+[[noreturn]] inline void throw_overflow(const char* what)
+{
+    throw std::overflow_error(what);
+}
+
+} // namespace ll_decimal_detail
+
+// Division by a run-time invariant
+
+class ll_fast_divider
+{
+private:
+    std::uint64_t d_;
+    std::uint64_t m_;
+    int l_;
+
+public:
+    // 1 <= d < 2^63, std::invalid_argument otherwise. With l = ceil(log2 d)
+    // and m = floor(2^(63 + l) / d) + 1 (which fits 64 bits), n * m >> (63 + l)
+    // is exact for every n < 2^63
+    explicit ll_fast_divider(std::uint64_t d)
+        : d_(d)
+    {
+        if (d == 0 || d >> 63) throw std::invalid_argument("ll_fast_divider: divisor must be in [1, 2^63)");
+        l_ = d == 1 ? 0 : 64 - std::countl_zero(d - 1);
+        m_ = static_cast<std::uint64_t>((ll_decimal_detail::u128{1} << (63 + l_)) / d) + 1;
+    }
+
+    std::uint64_t divisor() const noexcept
+    {
+        return d_;
+    }
+
+    // n < 2^63. Doubling n first turns the shift by 63 + l into the high
+    // product word shifted by l, so there is no 128-bit shift
+    std::uint64_t divide(std::uint64_t n) const noexcept
+    {
+        using ll_decimal_detail::u128;
+        return static_cast<std::uint64_t>((static_cast<u128>(n << 1) * m_) >> 64) >> l_;
+    }
+};
+
+// Decimal type
+
+template <int Scale>
+class ll_decimal64
+{
+    static_assert(Scale >= 0 && Scale <= 18, "ll_decimal64: Scale must be 0 .. 18");
+
+private:
+    std::int64_t raw_ = 0;
+
+    static constexpr ll_decimal_detail::div_2by1 rescale_{ll_decimal_detail::pow10(Scale)};
+
+public:
+    static constexpr int scale = Scale;
+    static constexpr std::int64_t unit = static_cast<std::int64_t>(ll_decimal_detail::pow10(Scale)); // raw value of 1
+
+    constexpr ll_decimal64() noexcept = default;
+
+    static constexpr ll_decimal64 from_raw(std::int64_t raw) noexcept
+    {
+        ll_decimal64 d;
+        d.raw_ = raw;
+        return d;
+    }
+
+    static ll_decimal64 from_int(std::int64_t v)
+    {
+        std::int64_t r;
+        if (__builtin_mul_overflow(v, unit, &r)) [[unlikely]] ll_decimal_detail::throw_overflow("ll_decimal64: from_int");
+        return from_raw(r);
+    }
+
+    // nearest, half away from zero; std::overflow_error for NaN or out of range
+    static ll_decimal64 from_double(double v)
+    {
+        const double r = std::round(v * static_cast<double>(unit));
+        if (!(r >= -0x1p63 && r < 0x1p63)) [[unlikely]] ll_decimal_detail::throw_overflow("ll_decimal64: from_double");
+        return from_raw(static_cast<std::int64_t>(r));
+    }
+
+    constexpr std::int64_t raw() const noexcept
+    {
+        return raw_;
+    }
+
+    // correctly rounded while |raw| < 2^53
+    double to_double() const noexcept
+    {
+        return static_cast<double>(raw_) / static_cast<double>(unit);
+    }
+
+    friend constexpr bool operator==(ll_decimal64, ll_decimal64) noexcept = default;
+    friend constexpr auto operator<=>(ll_decimal64, ll_decimal64) noexcept = default;
+
+// Checked arithmetic
+
+    ll_decimal64 operator-() const
+    {
+        if (raw_ == std::numeric_limits<std::int64_t>::min()) [[unlikely]] ll_decimal_detail::throw_overflow("ll_decimal64: -");
+        return from_raw(-raw_);
+    }
+
+    friend ll_decimal64 operator+(ll_decimal64 a, ll_decimal64 b)
+    {
+        std::int64_t r;
+        if (__builtin_add_overflow(a.raw_, b.raw_, &r)) [[unlikely]] ll_decimal_detail::throw_overflow("ll_decimal64: +");
+        return from_raw(r);
+    }
+
+    friend ll_decimal64 operator-(ll_decimal64 a, ll_decimal64 b)
+    {
+        std::int64_t r;
+        if (__builtin_sub_overflow(a.raw_, b.raw_, &r)) [[unlikely]] ll_decimal_detail::throw_overflow("ll_decimal64: -");
+        return from_raw(r);
+    }
+
+    ll_decimal64& operator+=(ll_decimal64 b)
+    {
+        return *this = *this + b;
+    }
+
+    ll_decimal64& operator-=(ll_decimal64 b)
+    {
+        return *this = *this - b;
+    }
+
+    // exact: price * quantity
+    friend ll_decimal64 operator*(ll_decimal64 a, std::int64_t n)
+    {
+        std::int64_t r;
+        if (__builtin_mul_overflow(a.raw_, n, &r)) [[unlikely]] ll_decimal_detail::throw_overflow("ll_decimal64: *");
+        return from_raw(r);
+    }
+
+    friend ll_decimal64 operator*(std::int64_t n, ll_decimal64 a)
+    {
+        return a * n;
+    }
+
+    // rounded to Scale places, half away from zero: the 128-bit product is
+    // divided by 10^Scale with the precomputed reciprocal
+    friend ll_decimal64 operator*(ll_decimal64 a, ll_decimal64 b)
+    {
+        using namespace ll_decimal_detail;
+        const i128 p = static_cast<i128>(a.raw_) * b.raw_;
+        const bool neg = p < 0;
+        const u128 mag = neg ? -static_cast<u128>(p) : static_cast<u128>(p);
+        std::uint64_t q;
+        if constexpr (Scale == 0)
+        {
+            if (mag >> 64) [[unlikely]] throw_overflow("ll_decimal64: *");
+            q = static_cast<std::uint64_t>(mag);
+        }
+        else
+        {
+            const u128 n = mag + static_cast<std::uint64_t>(unit / 2);
+            // quotient >= 2^64: far out of range, and outside divide()'s contract
+            if ((n >> 64) >= static_cast<std::uint64_t>(unit)) [[unlikely]] throw_overflow("ll_decimal64: *");
+            q = rescale_.divide(n);
+        }
+        if (q > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + neg) [[unlikely]]
+            throw_overflow("ll_decimal64: *");
+        return from_raw(neg ? static_cast<std::int64_t>(0 - q) : static_cast<std::int64_t>(q));
+    }
+};
+
+// Ticks
+
+enum class ll_rounding
+{
+    nearest, // half away from zero
+    down,    // toward -infinity (bids)
+    up       // toward +infinity (asks)
+};
+
+template <int Scale>
+class ll_tick_size
+{
+private:
+    std::int64_t tick_;
+    ll_fast_divider div_;
+
+    static std::uint64_t positive(std::int64_t raw)
+    {
+        if (raw <= 0) throw std::invalid_argument("ll_tick_size: tick must be positive");
+        return static_cast<std::uint64_t>(raw);
+    }
+
+public:
+    using decimal = ll_decimal64<Scale>;
+
+    // std::invalid_argument unless tick > 0
+    explicit ll_tick_size(decimal tick)
+        : tick_(tick.raw())
+        , div_(positive(tick.raw()))
+    {
+    }
+
+    decimal tick() const noexcept
+    {
+        return decimal::from_raw(tick_);
+    }
+
+    // whole ticks in p, rounded. |p| < 2^62 raw units takes the multiply
+    // path; larger values fall back to a 128-bit division
+    std::int64_t to_ticks(decimal p, ll_rounding mode = ll_rounding::nearest) const noexcept
+    {
+        using ll_decimal_detail::u128;
+        const bool neg = p.raw() < 0;
+        const std::uint64_t a = neg ? 0 - static_cast<std::uint64_t>(p.raw()) : static_cast<std::uint64_t>(p.raw());
+        const std::uint64_t t = static_cast<std::uint64_t>(tick_);
+        std::uint64_t bias;
+        if (mode == ll_rounding::nearest) bias = t / 2;
+        else bias = (mode == ll_rounding::up) != neg ? t - 1 : 0;
+        std::uint64_t q;
+        if (a < (std::uint64_t{1} << 62)) [[likely]] q = div_.divide(a + bias);
+        else q = static_cast<std::uint64_t>((static_cast<u128>(a) + bias) / t);
+        return neg ? static_cast<std::int64_t>(0 - q) : static_cast<std::int64_t>(q);
+    }
+
+    decimal from_ticks(std::int64_t ticks) const
+    {
+        std::int64_t r;
+        if (__builtin_mul_overflow(ticks, tick_, &r)) [[unlikely]] ll_decimal_detail::throw_overflow("ll_tick_size: from_ticks");
+        return decimal::from_raw(r);
+    }
+
+    // p moved onto the tick grid
+    decimal round(decimal p, ll_rounding mode = ll_rounding::nearest) const
+    {
+        return from_ticks(to_ticks(p, mode));
+    }
+};
+
+// Text
+
+// [-]digits[.[digits]] or [-].digits, no exponent, no '+'. Fraction digits
+// past Scale round half away from zero. Same contract as from_chars:
+// {past the number, errc{}}, invalid_argument with no digits,
+// result_out_of_range when the value does not fit
+template <int Scale>
+std::from_chars_result ll_parse_decimal(const char* first, const char* last, ll_decimal64<Scale>& value) noexcept
+{
+    using namespace ll_fast_parse_detail;
+    constexpr std::uint64_t unit = static_cast<std::uint64_t>(ll_decimal64<Scale>::unit);
+
+    const char* p = first;
+    bool neg = false;
+    if (p != last && *p == '-')
+    {
+        neg = true;
+        ++p;
+    }
+
+    const char* start = p;
+    while (p != last && *p == '0') ++p;
+    std::uint64_t w = 0;
+    int nd = 0;
+    p = parse_digits(p, last, w, nd, 19);
+    bool range = true;
+    if (p != last && is_digit(*p))
+    {
+        range = false;
+        while (p != last && is_digit(*p)) ++p;
+    }
+    const bool int_digits = p != start;
+
+    std::uint64_t f = 0;
+    bool frac_digits = false;
+    if (p != last && *p == '.')
+    {
+        const char* fs = ++p;
+        int fd = 0;
+        p = parse_digits(p, last, f, fd, Scale);
+        f *= ll_decimal_detail::pow10(Scale - fd);
+        if (p != last && is_digit(*p))
+        {
+            f += *p >= '5';
+            while (p != last && is_digit(*p)) ++p;
+        }
+        frac_digits = p != fs;
+    }
+    if (!int_digits && !frac_digits) return {first, std::errc::invalid_argument};
+
+    std::uint64_t mag;
+    if (!range || __builtin_mul_overflow(w, unit, &mag) || __builtin_add_overflow(mag, f, &mag) ||
+        mag > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + neg)
+        return {p, std::errc::result_out_of_range};
+    value = ll_decimal64<Scale>::from_raw(neg ? static_cast<std::int64_t>(0 - mag) : static_cast<std::int64_t>(mag));
+    return {p, std::errc{}};
+}
+
+// always Scale fraction digits: "-12.5000" at Scale 4; errc::value_too_large
+// (and last) when [first, last) is too short
+template <int Scale>
+std::to_chars_result ll_format_decimal(char* first, char* last, ll_decimal64<Scale> value) noexcept
+{
+    constexpr std::uint64_t unit = static_cast<std::uint64_t>(ll_decimal64<Scale>::unit);
+    const bool neg = value.raw() < 0;
+    const std::uint64_t mag = neg ? 0 - static_cast<std::uint64_t>(value.raw()) : static_cast<std::uint64_t>(value.raw());
+
+    char* p = first;
+    if (neg)
+    {
+        if (p == last) return {last, std::errc::value_too_large};
+        *p++ = '-';
+    }
+    const std::to_chars_result r = std::to_chars(p, last, mag / unit);
+    if (r.ec != std::errc{}) return r;
+    p = r.ptr;
+    if constexpr (Scale > 0)
+    {
+        if (last - p < Scale + 1) return {last, std::errc::value_too_large};
+        *p = '.';
+        std::uint64_t frac = mag % unit;
+        for (int i = Scale; i > 0; --i)
+        {
+            p[i] = static_cast<char>('0' + frac % 10);
+            frac /= 10;
+        }
+        p += Scale + 1;
+    }
+    return {p, std::errc{}};
+}
@@ -0,0 +1,182 @@
+#pragma once
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+/*
+ *Fast Number Parsing
+ * Drop-in replacements for std::from_chars on the hot paths of text parsers
+ * (JSON, CSV, decimal prices). Same contract: parse a prefix of
+ * [first, last), return {ptr past the number, errc}.
+ *
+ * - integers: eight digits at a time with SWAR arithmetic (little-endian)
+ * - doubles : Clinger's fast path — when the decimal significand fits in
+ *   53 bits and the power of ten is <= 22, w * 10^e (or w / 10^-e) is one
+ *   correctly rounded IEEE operation. Everything else (long significands,
+ *   huge exponents, inf/nan) falls back to std::from_chars, so results are
+ *   always correctly rounded.
+ */
+
+namespace ll_fast_parse_detail
+{
+    inline bool is_digit(char c) noexcept
+    {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    inline bool is_eight_digits(const char* p) noexcept
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        return (((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+                0x3333333333333333ull);
+    }
+
+    inline std::uint32_t parse_eight_digits(const char* p) noexcept
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        v -= 0x3030303030303030ull;
+        v = (v * 10) + (v >> 8);
+        v = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+             (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+        return static_cast<std::uint32_t>(v);
+    }
+
+    // accumulate up to max_digits digits into w, adding their count to
+    // ndigits; returns a pointer past the last digit consumed
+    inline const char* parse_digits(const char* p, const char* last, std::uint64_t& w, int& ndigits, int max_digits) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little)
+        {
+            while (last - p >= 8 && ndigits + 8 <= max_digits && is_eight_digits(p))
+            {
+                w = w * 100000000 + parse_eight_digits(p);
+                p += 8;
+                ndigits += 8;
+            }
+        }
+        while (p != last && is_digit(*p) && ndigits < max_digits)
+        {
+            w = w * 10 + static_cast<std::uint64_t>(*p - '0');
+            ++p;
+            ++ndigits;
+        }
+        return p;
+    }
+
+    inline constexpr double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+}
+
+// integers: optional '-' for signed types, no '+', no whitespace (like from_chars)
+template <typename Int>
+std::from_chars_result ll_parse_int(const char* first, const char* last, Int& value) noexcept
+{
+    static_assert(std::is_integral_v<Int>, "ll_parse_int needs an integral type");
+    using namespace ll_fast_parse_detail;
+
+    const char* p = first;
+    bool neg = false;
+    if constexpr (std::is_signed_v<Int>)
+    {
+        if (p != last && *p == '-')
+        {
+            neg = true;
+            ++p;
+        }
+    }
+    if (p == last || !is_digit(*p)) return {first, std::errc::invalid_argument};
+
+    std::uint64_t w = 0;
+    int nd = 0;
+    const char* end = parse_digits(p, last, w, nd, 19);
+    if (end != last && is_digit(*end))
+    {
+        // 20+ digits: rare, let the standard library handle range checks
+        return std::from_chars(first, last, value);
+    }
+
+    if constexpr (std::is_signed_v<Int>)
+    {
+        using U = std::make_unsigned_t<Int>;
+        const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<Int>::max()) + (neg ? 1 : 0);
+        if (w > limit) return {end, std::errc::result_out_of_range};
+        value = neg ? static_cast<Int>(U{0} - static_cast<U>(w)) : static_cast<Int>(w);
+    }
+    else
+    {
+        if (w > std::numeric_limits<Int>::max()) return {end, std::errc::result_out_of_range};
+        value = static_cast<Int>(w);
+    }
+    return {end, std::errc{}};
+}
+
+// doubles: [-]digits[.digits][(e|E)[+|-]digits], same grammar as from_chars(general)
+inline std::from_chars_result ll_parse_double(const char* first, const char* last, double& value) noexcept
+{
+    using namespace ll_fast_parse_detail;
+
+    const char* p = first;
+    bool neg = false;
+    if (p != last && *p == '-')
+    {
+        neg = true;
+        ++p;
+    }
+
+    std::uint64_t w = 0;
+    int nd = 0;
+    const char* start = p;
+    p = parse_digits(p, last, w, nd, 19);
+    const bool more_int_digits = p != last && is_digit(*p);
+    int int_digits = static_cast<int>(p - start);
+
+    int frac_digits = 0;
+    if (!more_int_digits && p != last && *p == '.')
+    {
+        const char* f = p + 1;
+        p = parse_digits(f, last, w, nd, 19);
+        frac_digits = static_cast<int>(p - f);
+        if (p != last && is_digit(*p)) return std::from_chars(first, last, value);
+    }
+    if (more_int_digits || (int_digits == 0 && frac_digits == 0)) return std::from_chars(first, last, value);
+
+    int exp10 = 0;
+    if (p != last && (*p == 'e' || *p == 'E'))
+    {
+        const char* e = p + 1;
+        bool eneg = false;
+        if (e != last && (*e == '-' || *e == '+'))
+        {
+            eneg = *e == '-';
+            ++e;
+        }
+        if (e != last && is_digit(*e))
+        {
+            while (e != last && is_digit(*e))
+            {
+                if (exp10 < 100000) exp10 = exp10 * 10 + (*e - '0');
+                ++e;
+            }
+            exp10 = eneg ? -exp10 : exp10;
+            p = e;
+        }
+        // "1e" / "1e+" : exponent not part of the number, like from_chars
+    }
+    exp10 -= frac_digits;
+
+    if (w <= (std::uint64_t{1} << 53) && exp10 >= -22 && exp10 <= 22)
+    {
+        double d = static_cast<double>(w);
+        d = exp10 < 0 ? d / pow10[-exp10] : d * pow10[exp10];
+        value = neg ? -d : d;
+        return {p, std::errc{}};
+    }
+    return std::from_chars(first, last, value);
+}
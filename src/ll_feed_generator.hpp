@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ll_replay.hpp"
+#include "ll_wire.hpp"
+
+/*
+ *Bursty Synthetic Feed Generator
+ * Arrival times follow a self-exciting (Hawkes) process with an exponential
+ * kernel, which reproduces the clustering of real market data: every
+ * message raises the arrival rate for a short while, so activity comes in
+ * bursts separated by quiet stretches.
+ *
+ *   intensity(t) = base_rate + sum over past events of alpha * exp(-decay * (t - t_i))
+ *   alpha        = branching * decay
+ *   mean rate    = base_rate / (1 - branching)
+ *
+ * Sampled exactly with Ogata thinning (the intensity only decays between
+ * events, so its current value bounds the next interval).
+ *
+ * Payloads are ll_md_update wire messages: adds, cancels and executions on
+ * a per-symbol random-walk price. Symbols are Zipf-like skewed (a few names
+ * carry most of the traffic) and map to channels by symbol id.
+ */
+
+// Payload schema
+
+struct ll_md_seq    : ll_wire_field<std::uint64_t> {};
+struct ll_md_symbol : ll_wire_field<std::uint32_t> {};
+struct ll_md_type   : ll_wire_field<char> {};          // 'A' add, 'X' cancel, 'E' execute
+struct ll_md_side   : ll_wire_field<char> {};          // 'B' / 'S'
+struct ll_md_price  : ll_wire_field<std::int64_t> {};  // ticks
+struct ll_md_qty    : ll_wire_field<std::uint32_t> {};
+
+using ll_md_update = ll_wire_message<ll_md_seq, ll_md_symbol, ll_md_type, ll_md_side, ll_md_price, ll_md_qty>;
+
+struct ll_feed_config
+{
+    double base_rate = 15000.0;  // messages per second without excitation
+    double branching = 0.85;     // expected children per message, < 1
+    double decay = 200.0;        // 1/s; a burst fades with time constant 1/decay
+    double duration_s = 2.0;
+    std::uint32_t symbols = 64;
+    std::uint32_t channels = 4;
+    std::uint64_t start_ns = 1700000000000000000ull;
+    std::uint64_t seed = 42;
+};
+
+class ll_feed_generator
+{
+private:
+    ll_feed_config cfg_;
+
+public:
+    explicit ll_feed_generator(const ll_feed_config& cfg)
+        : cfg_(cfg)
+    {
+    }
+
+    // emit(ts_ns, channel, std::span<const std::byte> payload) per message,
+    // in timestamp order; returns the message count
+    template <typename F>
+    std::uint64_t generate(F&& emit) const
+    {
+        std::mt19937_64 rng(cfg_.seed);
+        std::uniform_real_distribution<double> u01(0.0, 1.0);
+
+        const double alpha = cfg_.branching * cfg_.decay;
+        const double horizon = cfg_.duration_s;
+
+        // symbol popularity ~ 1/(rank+1), sampled by inverse cdf
+        std::vector<double> cdf(cfg_.symbols);
+        double acc = 0.0;
+        for (std::uint32_t i = 0; i < cfg_.symbols; ++i) cdf[i] = acc += 1.0 / (i + 1);
+        for (double& c : cdf) c /= acc;
+
+        std::vector<std::int64_t> mid(cfg_.symbols);
+        for (std::uint32_t i = 0; i < cfg_.symbols; ++i) mid[i] = 10000 + 500 * static_cast<std::int64_t>(i);
+
+        std::byte buf[ll_md_update::fixed_size];
+        double t = 0.0;
+        double excess = 0.0; // intensity above base_rate right after the last event
+        std::uint64_t seq = 0;
+
+        for (;;)
+        {
+            const double bound = cfg_.base_rate + excess;
+            const double w = -std::log(1.0 - u01(rng)) / bound;
+            t += w;
+            if (t >= horizon) break;
+            excess *= std::exp(-cfg_.decay * w);
+            if (u01(rng) * bound > cfg_.base_rate + excess) continue; // thinned
+            excess += alpha;
+
+            const auto sym = static_cast<std::uint32_t>(std::lower_bound(cdf.begin(), cdf.end(), u01(rng)) - cdf.begin());
+            const double r = u01(rng);
+            const char type = r < 0.6 ? 'A' : r < 0.9 ? 'X' : 'E';
+            const char side = u01(rng) < 0.5 ? 'B' : 'S';
+            if (type == 'E') mid[sym] += u01(rng) < 0.5 ? -1 : 1;
+            const auto offset = static_cast<std::int64_t>(u01(rng) * 10.0);
+
+            ll_md_update::writer m(buf);
+            m.set<ll_md_seq>(++seq);
+            m.set<ll_md_symbol>(sym);
+            m.set<ll_md_type>(type);
+            m.set<ll_md_side>(side);
+            m.set<ll_md_price>(side == 'B' ? mid[sym] - offset : mid[sym] + offset);
+            m.set<ll_md_qty>(static_cast<std::uint32_t>(1 + u01(rng) * 10.0) * 100);
+
+            const auto ts = cfg_.start_ns + static_cast<std::uint64_t>(t * 1e9);
+            emit(ts, sym % cfg_.channels, std::span<const std::byte>(buf, sizeof(buf)));
+        }
+        return seq;
+    }
+
+    // generate straight into a replay file
+    std::uint64_t write(const char* path) const
+    {
+        ll_replay_writer w(path);
+        generate([&](std::uint64_t ts, std::uint32_t ch, std::span<const std::byte> p)
+        {
+            w.append(ts, ch, p.data(), static_cast<std::uint32_t>(p.size()));
+        });
+        w.close();
+        return w.count();
+    }
+};
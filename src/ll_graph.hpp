@@ -0,0 +1,516 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ll_union_find.hpp"
+
+/*
+ *CSR Graph, Direction-Optimizing BFS, Connected Components
+ * - ll_csr_graph : offsets[n + 1] (64-bit) + targets[m] (32-bit vertex ids);
+ *   neighbours of v are targets[offsets[v], offsets[v + 1]), contiguous
+ * - built from an edge list by a parallel two-pass radix sort on the source
+ *   (a direct scatter into targets[] misses cache on every edge):
+ *     1. each thread counts its slice of edges per block of 4096 sources
+ *     2. scan -> a write cursor per (thread, block), so the result is
+ *        stable and identical for any thread count
+ *     3. each thread partitions its slice into the blocks (no atomics);
+ *        one sequential write stream per block
+ *     4. blocks handed out dynamically: counting sort within the block,
+ *        whose slice of targets[] fits in L2, then (optional) sort each
+ *        list (LSD radix for long ones) and drop duplicates and self loops
+ *        while it is still hot
+ *     5. close the gaps left by step 4 in one in-place pass
+ *   temporary memory: one copy of the directed edges as (from, to) pairs
+ * - ll_bfs : Beamer-style direction-optimizing BFS
+ *     top-down  : frontier queue, claim children with CAS on parent[]
+ *                 (plain stores when single-threaded)
+ *     bottom-up : every unvisited vertex scans its neighbours for one in the
+ *                 frontier bitmap and stops at the first hit
+ *   switches to bottom-up when the frontier's edges exceed 1/alpha of the
+ *   unexplored edges, and back once the frontier drops under n / beta.
+ *   Bottom-up needs in-edges, so it is used only on symmetric graphs
+ * - ll_connected_components : union-find over each undirected edge once
+ *   (weak components for directed graphs); with threads != 1 the
+ *   lock-free ll_concurrent_union_find over edge-balanced vertex ranges
+ */
+
+using ll_vertex = std::uint32_t;
+inline constexpr ll_vertex ll_no_vertex = std::numeric_limits<ll_vertex>::max();
+
+struct ll_edge
+{
+    ll_vertex from;
+    ll_vertex to;
+};
+
+struct ll_csr_options
+{
+    bool symmetric = true; // store both directions of every edge (undirected graph)
+    bool dedupe = true;    // sorted adjacency, no duplicate edges, no self loops
+    unsigned threads = 0;  // 0 = hardware_concurrency
+};
+
+namespace ll_graph_detail
+{
+template <typename F>
+inline void parallel_for(unsigned n, F&& f)
+{
+    if (n == 1)
+    {
+        f(0u);
+        return;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(n - 1);
+    for (unsigned i = 1; i < n; ++i) pool.emplace_back([&f, i] { f(i); });
+    f(0u);
+    for (auto& t : pool) t.join();
+}
+
+inline unsigned resolve_threads(unsigned threads) noexcept
+{
+    return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+// BFS top-down step over count frontier vertices: claim unvisited neighbours.
+// Shared: other threads claim concurrently, so check then CAS; alone, plain
+// loads and stores (atomic accesses would stop the compiler overlapping the
+// parent[] misses)
+template <bool Shared>
+inline void top_down(const std::uint64_t* off, const ll_vertex* tgt, ll_vertex* parent, const ll_vertex* q,
+                     std::size_t count, bool scout, std::vector<ll_vertex>& out, std::uint64_t& examined,
+                     std::uint64_t& scouted)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const ll_vertex u = q[i];
+        examined += off[u + 1] - off[u];
+        for (std::uint64_t k = off[u], ke = off[u + 1]; k < ke; ++k)
+        {
+            const ll_vertex v = tgt[k];
+            if constexpr (Shared)
+            {
+                std::atomic_ref<ll_vertex> p(parent[v]);
+                ll_vertex expect = ll_no_vertex;
+                if (p.load(std::memory_order_relaxed) != ll_no_vertex ||
+                    !p.compare_exchange_strong(expect, u, std::memory_order_relaxed))
+                    continue;
+            }
+            else
+            {
+                if (parent[v] != ll_no_vertex) continue;
+                parent[v] = u;
+            }
+            out.push_back(v);
+            if (scout) scouted += off[v + 1] - off[v];
+        }
+    }
+}
+
+// ids below 2^bits: LSD radix on 11-bit digits for long lists (power-law
+// hubs hold most of the edges), std::sort for short ones
+inline void sort_ids(ll_vertex* b, ll_vertex* e, unsigned bits, std::vector<ll_vertex>& tmp)
+{
+    const std::size_t d = static_cast<std::size_t>(e - b);
+    if (d < 512)
+    {
+        std::sort(b, e);
+        return;
+    }
+    tmp.resize(d);
+    ll_vertex* src = b;
+    ll_vertex* dst = tmp.data();
+    for (unsigned sh = 0; sh < bits; sh += 11)
+    {
+        std::uint32_t cnt[2048] = {};
+        for (std::size_t k = 0; k < d; ++k) ++cnt[src[k] >> sh & 2047];
+        std::uint32_t s = 0;
+        for (std::uint32_t& c : cnt)
+        {
+            const std::uint32_t x = c;
+            c = s;
+            s += x;
+        }
+        for (std::size_t k = 0; k < d; ++k) dst[cnt[src[k] >> sh & 2047]++] = src[k];
+        std::swap(src, dst);
+    }
+    if (src != b) std::copy_n(src, d, b);
+}
+} // namespace ll_graph_detail
+
+class ll_csr_graph
+{
+private:
+    std::vector<std::uint64_t> offsets_; // [n + 1]
+    std::vector<ll_vertex> targets_;     // [m]
+    bool symmetric_ = false;
+
+    static constexpr unsigned block_bits = 12; // 4096 sources per partition block: its targets stay in L2
+
+    // close the gaps left by per-vertex dedupe, in place: lists only move
+    // left, so one ascending pass is safe and needs no second targets array
+    void compact(const std::vector<ll_vertex>& kept) noexcept
+    {
+        const std::size_t n = vertices();
+        ll_vertex* t = targets_.data();
+        std::uint64_t w = 0;
+        for (std::size_t v = 0; v < n; ++v)
+        {
+            const std::uint64_t from = offsets_[v];
+            offsets_[v] = w;
+            if (from != w) std::copy_n(t + from, kept[v], t + w);
+            w += kept[v];
+        }
+        offsets_[n] = w;
+        targets_.resize(w);
+    }
+
+public:
+    ll_csr_graph() = default;
+
+    ll_csr_graph(std::size_t n, std::span<const ll_edge> edges, const ll_csr_options& opt = {})
+        : symmetric_(opt.symmetric)
+    {
+        using namespace ll_graph_detail;
+        if (n >= ll_no_vertex) throw std::length_error("ll_csr_graph: too many vertices");
+        offsets_.assign(n + 1, 0);
+        if (n == 0)
+        {
+            if (!edges.empty()) throw std::invalid_argument("ll_csr_graph: edge endpoint out of range");
+            return;
+        }
+        const std::size_t m = edges.size();
+        const unsigned t = static_cast<unsigned>(
+            std::min<std::size_t>(resolve_threads(opt.threads), std::max<std::size_t>(1, m >> 16)));
+        constexpr unsigned shift = block_bits;
+        const std::size_t blocks = ((n - 1) >> shift) + 1;
+        const unsigned id_bits = static_cast<unsigned>(std::bit_width(n - 1));
+
+        // 1: per-thread edge counts per source block over each thread's slice
+        std::vector<std::uint64_t> cur(std::size_t{t} * blocks, 0); // [thread][block]
+        std::atomic<bool> bad{false};
+        parallel_for(t, [&](unsigned i)
+        {
+            std::uint64_t* c = cur.data() + std::size_t{i} * blocks;
+            for (std::size_t k = m * i / t, e = m * (i + 1) / t; k < e; ++k)
+            {
+                const ll_edge x = edges[k];
+                if (x.from >= n || x.to >= n)
+                {
+                    bad.store(true, std::memory_order_relaxed);
+                    return;
+                }
+                ++c[x.from >> shift];
+                if (opt.symmetric) ++c[x.to >> shift];
+            }
+        });
+        if (bad.load()) throw std::invalid_argument("ll_csr_graph: edge endpoint out of range");
+
+        // 2: block starts, and a write cursor per (thread, block): stable for any thread count
+        std::vector<std::uint64_t> start(blocks + 1);
+        std::uint64_t total = 0;
+        for (std::size_t b = 0; b < blocks; ++b)
+        {
+            start[b] = total;
+            for (unsigned i = 0; i < t; ++i)
+            {
+                const std::uint64_t c = cur[std::size_t{i} * blocks + b];
+                cur[std::size_t{i} * blocks + b] = total;
+                total += c;
+            }
+        }
+        start[blocks] = total;
+
+        // 3: partition by source block: one sequential write stream per block
+        std::vector<ll_edge> part(total);
+        parallel_for(t, [&](unsigned i)
+        {
+            std::uint64_t* c = cur.data() + std::size_t{i} * blocks;
+            ll_edge* out = part.data();
+            for (std::size_t k = m * i / t, e = m * (i + 1) / t; k < e; ++k)
+            {
+                const ll_edge x = edges[k];
+                out[c[x.from >> shift]++] = x;
+                if (opt.symmetric) out[c[x.to >> shift]++] = {x.to, x.from};
+            }
+        });
+
+        // 4: per block: counting sort on the source, then sort + dedupe each
+        //    list while the block's targets are still in cache. A block's
+        //    edges land exactly on its own slice [start[b], start[b + 1])
+        targets_.resize(total);
+        std::vector<ll_vertex> kept(opt.dedupe ? n : 0);
+        std::atomic<std::size_t> next{0};
+        parallel_for(t, [&](unsigned)
+        {
+            std::vector<std::uint64_t> pos(std::size_t{1} << shift);
+            std::vector<ll_vertex> tmp;
+            for (std::size_t b; (b = next.fetch_add(1, std::memory_order_relaxed)) < blocks;)
+            {
+                const std::size_t v0 = b << shift, v1 = std::min(n, (b + 1) << shift);
+                std::fill_n(pos.begin(), v1 - v0, 0);
+                for (std::uint64_t k = start[b]; k < start[b + 1]; ++k) ++pos[part[k].from - v0];
+                std::uint64_t s = start[b];
+                for (std::size_t v = v0; v < v1; ++v)
+                {
+                    const std::uint64_t d = pos[v - v0];
+                    offsets_[v] = pos[v - v0] = s;
+                    s += d;
+                }
+                for (std::uint64_t k = start[b]; k < start[b + 1]; ++k) targets_[pos[part[k].from - v0]++] = part[k].to;
+                if (!opt.dedupe) continue;
+                for (std::size_t v = v0; v < v1; ++v)
+                {
+                    ll_vertex* lb = targets_.data() + offsets_[v];
+                    ll_vertex* le = targets_.data() + pos[v - v0];
+                    sort_ids(lb, le, id_bits, tmp);
+                    le = std::unique(lb, le);
+                    le = std::remove(lb, le, static_cast<ll_vertex>(v));
+                    kept[v] = static_cast<ll_vertex>(le - lb);
+                }
+            }
+        });
+        offsets_[n] = total;
+        part = {};
+
+        if (opt.dedupe) compact(kept);
+    }
+
+    std::size_t vertices() const noexcept
+    {
+        return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+    // directed edges stored (each undirected edge counts twice)
+    std::size_t edges() const noexcept
+    {
+        return targets_.size();
+    }
+    bool symmetric() const noexcept
+    {
+        return symmetric_;
+    }
+    std::size_t degree(ll_vertex v) const noexcept
+    {
+        return static_cast<std::size_t>(offsets_[v + 1] - offsets_[v]);
+    }
+    std::span<const ll_vertex> neighbours(ll_vertex v) const noexcept
+    {
+        return {targets_.data() + offsets_[v], degree(v)};
+    }
+    const std::uint64_t* offsets() const noexcept
+    {
+        return offsets_.data();
+    }
+    const ll_vertex* targets() const noexcept
+    {
+        return targets_.data();
+    }
+    std::size_t memory_bytes() const noexcept
+    {
+        return offsets_.capacity() * sizeof(std::uint64_t) + targets_.capacity() * sizeof(ll_vertex);
+    }
+};
+
+// BFS
+
+struct ll_bfs_options
+{
+    unsigned threads = 0;             // 0 = hardware_concurrency
+    bool direction_optimizing = true; // false = top-down only
+    unsigned alpha = 15;              // to bottom-up: frontier edges > unexplored edges / alpha
+    unsigned beta = 18;               // back to top-down: frontier vertices < n / beta
+};
+
+struct ll_bfs_result
+{
+    std::vector<ll_vertex> parent; // ll_no_vertex = unreached, parent[source] = source
+    std::size_t visited = 0;
+    unsigned levels = 0;
+    unsigned bottom_up_levels = 0;
+    std::uint64_t edges_examined = 0;
+};
+
+inline ll_bfs_result ll_bfs(const ll_csr_graph& g, ll_vertex source, const ll_bfs_options& opt = {})
+{
+    using namespace ll_graph_detail;
+    const std::size_t n = g.vertices();
+    if (source >= n) throw std::invalid_argument("ll_bfs: source out of range");
+    const unsigned t = resolve_threads(opt.threads);
+    const bool allow_bu = opt.direction_optimizing && g.symmetric();
+    const std::uint64_t* off = g.offsets();
+    const ll_vertex* tgt = g.targets();
+
+    ll_bfs_result r;
+    r.parent.assign(n, ll_no_vertex);
+    ll_vertex* parent = r.parent.data();
+    parent[source] = source;
+    r.visited = 1;
+
+    const std::size_t words = (n + 63) / 64;
+    std::vector<ll_vertex> queue{source};
+    std::vector<std::uint64_t> front, next;
+    std::vector<std::vector<ll_vertex>> local(t);
+    std::vector<std::uint64_t> examined(t), scouted(t), woken(t);
+
+    std::uint64_t unexplored = g.edges();
+    std::uint64_t scout = g.degree(source);
+    std::size_t frontier = 1;
+    bool bottom_up = false;
+
+    while (frontier)
+    {
+        ++r.levels;
+        if (!bottom_up && allow_bu && scout > unexplored / opt.alpha)
+        {
+            front.assign(words, 0);
+            for (ll_vertex v : queue) front[v >> 6] |= std::uint64_t{1} << (v & 63);
+            next.assign(words, 0);
+            bottom_up = true;
+        }
+        else if (bottom_up && frontier < n / opt.beta)
+        {
+            queue.clear();
+            for (std::size_t w = 0; w < words; ++w)
+                for (std::uint64_t b = front[w]; b; b &= b - 1)
+                    queue.push_back(static_cast<ll_vertex>(w * 64 + static_cast<std::size_t>(std::countr_zero(b))));
+            bottom_up = false;
+        }
+
+        std::fill(examined.begin(), examined.end(), 0);
+        std::fill(scouted.begin(), scouted.end(), 0);
+        std::fill(woken.begin(), woken.end(), 0);
+        if (bottom_up)
+        {
+            // chunks of 64 words, so each bitmap word of next has one writer
+            constexpr std::size_t chunk = 64;
+            std::atomic<std::size_t> cursor{0};
+            parallel_for(t, [&](unsigned i)
+            {
+                std::uint64_t ex = 0, sc = 0, wk = 0;
+                for (std::size_t w0; (w0 = cursor.fetch_add(chunk, std::memory_order_relaxed)) < words;)
+                {
+                    for (std::size_t w = w0, we = std::min(words, w0 + chunk); w < we; ++w)
+                    {
+                        std::uint64_t bits = 0;
+                        for (std::size_t v = w * 64, ve = std::min(n, v + 64); v < ve; ++v)
+                        {
+                            if (parent[v] != ll_no_vertex) continue;
+                            for (std::uint64_t k = off[v], ke = off[v + 1]; k < ke; ++k)
+                            {
+                                ++ex;
+                                const ll_vertex u = tgt[k];
+                                if (front[u >> 6] >> (u & 63) & 1)
+                                {
+                                    parent[v] = u;
+                                    bits |= std::uint64_t{1} << (v & 63);
+                                    sc += off[v + 1] - off[v];
+                                    ++wk;
+                                    break;
+                                }
+                            }
+                        }
+                        next[w] = bits;
+                    }
+                }
+                examined[i] = ex;
+                scouted[i] = sc;
+                woken[i] = wk;
+            });
+            front.swap(next);
+            ++r.bottom_up_levels;
+        }
+        else
+        {
+            constexpr std::size_t chunk = 256;
+            std::atomic<std::size_t> cursor{0};
+            parallel_for(t, [&](unsigned i)
+            {
+                std::vector<ll_vertex>& out = local[i];
+                out.clear();
+                std::uint64_t ex = 0, sc = 0;
+                for (std::size_t q0; (q0 = cursor.fetch_add(chunk, std::memory_order_relaxed)) < queue.size();)
+                {
+                    const std::size_t qe = std::min(queue.size(), q0 + chunk);
+                    if (t == 1)
+                        top_down<false>(off, tgt, parent, queue.data() + q0, qe - q0, allow_bu, out, ex, sc);
+                    else
+                        top_down<true>(off, tgt, parent, queue.data() + q0, qe - q0, allow_bu, out, ex, sc);
+                }
+                examined[i] = ex;
+                scouted[i] = sc;
+                woken[i] = out.size();
+            });
+            queue.clear();
+            for (const auto& l : local) queue.insert(queue.end(), l.begin(), l.end());
+        }
+
+        frontier = 0;
+        scout = 0;
+        for (unsigned i = 0; i < t; ++i)
+        {
+            r.edges_examined += examined[i];
+            scout += scouted[i];
+            frontier += woken[i];
+        }
+        unexplored -= std::min(unexplored, scout);
+        r.visited += frontier;
+    }
+    return r;
+}
+
+// Connected components
+
+struct ll_components
+{
+    std::vector<ll_vertex> label; // representative vertex of each vertex's component
+    std::size_t count = 0;
+};
+
+// threads != 1: ll_concurrent_union_find, vertex ranges cut by edge count
+inline ll_components ll_connected_components(const ll_csr_graph& g, unsigned threads = 1)
+{
+    using namespace ll_graph_detail;
+    const std::size_t n = g.vertices();
+    const std::uint64_t* off = g.offsets();
+    const ll_vertex* tgt = g.targets();
+    const bool sym = g.symmetric();
+    ll_components c;
+    c.label.resize(n);
+    const unsigned t = resolve_threads(threads);
+    if (t == 1)
+    {
+        ll_union_find uf(n);
+        for (std::size_t u = 0; u < n; ++u)
+            for (std::uint64_t k = off[u], ke = off[u + 1]; k < ke; ++k)
+                if (!sym || tgt[k] > u) uf.unite(static_cast<ll_vertex>(u), tgt[k]);
+        for (std::size_t v = 0; v < n; ++v) c.label[v] = uf.find(static_cast<ll_vertex>(v));
+        c.count = uf.sets();
+        return c;
+    }
+
+    ll_concurrent_union_find uf(n);
+    std::vector<std::size_t> lo(t + 1, n);
+    for (unsigned i = 0; i < t; ++i)
+        lo[i] = static_cast<std::size_t>(std::lower_bound(off, off + n, g.edges() * i / t) - off);
+    parallel_for(t, [&](unsigned i)
+    {
+        for (std::size_t u = lo[i]; u < lo[i + 1]; ++u)
+            for (std::uint64_t k = off[u], ke = off[u + 1]; k < ke; ++k)
+                if (!sym || tgt[k] > u) uf.unite(static_cast<ll_vertex>(u), tgt[k]);
+    });
+    parallel_for(t, [&](unsigned i)
+    {
+        for (std::size_t v = n * i / t, e = n * (i + 1) / t; v < e; ++v) c.label[v] = uf.find(static_cast<ll_vertex>(v));
+    });
+    c.count = uf.sets();
+    return c;
+}
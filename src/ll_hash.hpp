@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/*
+ *Fast Non-Cryptographic Hashing
+ * Hashes for probabilistic structures and hash tables: every output bit
+ * depends on every input bit, so callers may slice a hash into several
+ * independent indices (block, bit positions, register, rho).
+ * - ll_mix64       : bijective 64-bit finalizer (splitmix64 / Stafford
+ *   variant 13), for integer keys such as order ids and sequence numbers
+ * - ll_hash_bytes  : byte strings, 16 bytes per step with 64x64->128
+ *   multiply-fold mixing (wyhash style); not DoS resistant
+ * - ll_hash_combine: fold a second value into a hash, e.g. (channel, seq)
+ */
+
+namespace ll_hash_detail
+{
+
+__extension__ typedef unsigned __int128 u128;
+
+inline std::uint64_t mum(std::uint64_t a, std::uint64_t b) noexcept
+{
+    const u128 r = static_cast<u128>(a) * b;
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+}
+
+inline std::uint64_t read64(const unsigned char* p) noexcept
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline std::uint64_t read32(const unsigned char* p) noexcept
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline constexpr std::uint64_t k0 = 0xa0761d6478bd642full;
+inline constexpr std::uint64_t k1 = 0xe7037ed1a0b428dbull;
+inline constexpr std::uint64_t k2 = 0x8ebc6af09c88c6e3ull;
+
+} // namespace ll_hash_detail
+
+constexpr std::uint64_t ll_mix64(std::uint64_t x) noexcept
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+constexpr std::uint64_t ll_hash_combine(std::uint64_t h, std::uint64_t v) noexcept
+{
+    return ll_mix64(h ^ (v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2)));
+}
+
+inline std::uint64_t ll_hash_bytes(const void* data, std::size_t n, std::uint64_t seed = 0) noexcept
+{
+    using namespace ll_hash_detail;
+    const auto* p = static_cast<const unsigned char*>(data);
+    std::uint64_t s = seed ^ mum(seed ^ k0, k1);
+    std::uint64_t a, b;
+    if (n <= 16)
+    {
+        if (n >= 4)
+        {
+            // two overlapping reads cover 4..16 bytes
+            a = (read32(p) << 32) | read32(p + ((n >> 3) << 2));
+            b = (read32(p + n - 4) << 32) | read32(p + n - 4 - ((n >> 3) << 2));
+        }
+        else if (n > 0)
+        {
+            a = (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[n >> 1]} << 8) | p[n - 1];
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
+    {
+        std::size_t i = n;
+        while (i > 16)
+        {
+            s = mum(read64(p) ^ k1, read64(p + 8) ^ s);
+            p += 16;
+            i -= 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    return mum(k1 ^ n, mum(a ^ k1, b ^ s) ^ k2);
+}
+
+inline std::uint64_t ll_hash_bytes(std::string_view s, std::uint64_t seed = 0) noexcept
+{
+    return ll_hash_bytes(s.data(), s.size(), seed);
+}
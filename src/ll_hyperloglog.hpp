@@ -0,0 +1,256 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ll_hash.hpp"
+
+/*
+ *HyperLogLog Distinct Counting
+ * Cardinality estimate of a stream in m = 2^p one-byte registers, with
+ * relative standard error ~1.04 / sqrt(m) (p = 12: 1.6%, p = 14: 0.8%).
+ * - dense  : register[top p hash bits] = max(rho) where rho is the position
+ *   of the first 1 bit in the remaining hash bits
+ * - sparse : while few keys were seen, distinct (index, rho) pairs at
+ *   precision 25 are kept as sorted 32-bit entries (HLL++, Heule et al.).
+ *   Small sets are then near-exact and cost 4 bytes per distinct key
+ *   instead of m bytes; converts to dense once it would be larger
+ * - estimate: Ertl's improved estimator ("New cardinality estimation
+ *   algorithms for HyperLogLog sketches", 2017) from the register
+ *   histogram. It needs no bias tables and is unbiased from 0 to 2^64
+ * - merge : register-wise max (vectorised); sketches need the same p
+ *
+ * Sized for many small sets, e.g. distinct order ids per client: most
+ * clients stay sparse at a few hundred bytes, heavy ones cap at m bytes.
+ */
+
+class ll_hyperloglog
+{
+private:
+    static constexpr unsigned sp_ = 25; // sparse precision
+
+    unsigned p_;
+    std::vector<std::uint8_t> reg_;     // dense registers (empty while sparse)
+    std::vector<std::uint32_t> sparse_; // sorted (index25 << 6 | rho25), unique index
+    std::vector<std::uint32_t> pending_;
+    bool dense_;
+
+    static std::uint32_t encode_sparse(std::uint64_t h) noexcept
+    {
+        const auto idx = static_cast<std::uint32_t>(h >> (64 - sp_));
+        const std::uint64_t w = (h << sp_) | (std::uint64_t{1} << (sp_ - 1)); // rho <= 64 - 25 + 1
+        return idx << 6 | static_cast<std::uint32_t>(std::countl_zero(w) + 1);
+    }
+
+    // sparse entry -> (dense index, dense rho)
+    std::pair<std::uint32_t, std::uint8_t> decode_sparse(std::uint32_t e) const noexcept
+    {
+        const std::uint32_t idx25 = e >> 6;
+        const std::uint32_t extra = sp_ - p_;
+        const std::uint32_t low = idx25 & ((std::uint32_t{1} << extra) - 1);
+        const auto rho = low ? static_cast<std::uint8_t>(extra - std::bit_width(low) + 1)
+                             : static_cast<std::uint8_t>(extra + (e & 63));
+        return {idx25 >> extra, rho};
+    }
+
+    void dense_add(std::uint64_t h) noexcept
+    {
+        const std::size_t idx = h >> (64 - p_);
+        const std::uint64_t w = (h << p_) | (std::uint64_t{1} << (p_ - 1));
+        const auto rho = static_cast<std::uint8_t>(std::countl_zero(w) + 1);
+        reg_[idx] = std::max(reg_[idx], rho);
+    }
+
+    // fold pending entries into the sorted sparse list; keep max rho per index
+    void flush_pending()
+    {
+        if (pending_.empty()) return;
+        std::sort(pending_.begin(), pending_.end());
+        const std::size_t mid = sparse_.size();
+        sparse_.insert(sparse_.end(), pending_.begin(), pending_.end());
+        pending_.clear();
+        std::inplace_merge(sparse_.begin(), sparse_.begin() + static_cast<std::ptrdiff_t>(mid), sparse_.end());
+        // equal index: entries sorted by rho, keep the last
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < sparse_.size(); ++i)
+        {
+            if (out > 0 && (sparse_[out - 1] >> 6) == (sparse_[i] >> 6))
+                sparse_[out - 1] = sparse_[i];
+            else
+                sparse_[out++] = sparse_[i];
+        }
+        sparse_.resize(out);
+        if ((sparse_.capacity() + pending_.capacity()) * sizeof(std::uint32_t) > reg_capacity()) to_dense();
+    }
+
+    std::size_t reg_capacity() const noexcept
+    {
+        return std::size_t{1} << p_;
+    }
+
+    void to_dense()
+    {
+        reg_.assign(reg_capacity(), 0);
+        for (std::uint32_t e : sparse_)
+        {
+            const auto [idx, rho] = decode_sparse(e);
+            reg_[idx] = std::max(reg_[idx], rho);
+        }
+        for (std::uint32_t e : pending_)
+        {
+            const auto [idx, rho] = decode_sparse(e);
+            reg_[idx] = std::max(reg_[idx], rho);
+        }
+        std::vector<std::uint32_t>().swap(sparse_);
+        std::vector<std::uint32_t>().swap(pending_);
+        dense_ = true;
+    }
+
+    // Ertl: sigma(x) = x + sum_k x^(2^k) 2^(k-1)
+    static double sigma(double x) noexcept
+    {
+        if (x == 1.0) return std::numeric_limits<double>::infinity();
+        double y = 1.0, z = x, prev;
+        do
+        {
+            x *= x;
+            prev = z;
+            z += x * y;
+            y += y;
+        } while (z != prev);
+        return z;
+    }
+
+    // Ertl: tau(x) = (1 - x - sum_k (1 - x^(2^-k))^2 2^-k) / 3
+    static double tau(double x) noexcept
+    {
+        if (x == 0.0 || x == 1.0) return 0.0;
+        double y = 1.0, z = 1.0 - x, prev;
+        do
+        {
+            x = std::sqrt(x);
+            prev = z;
+            y *= 0.5;
+            z -= (1.0 - x) * (1.0 - x) * y;
+        } while (z != prev);
+        return z / 3.0;
+    }
+
+    // histogram of register values c[0..q+1] -> estimate for m registers
+    static double ertl(const std::uint64_t* c, unsigned q, double m) noexcept
+    {
+        double z = m * tau(1.0 - static_cast<double>(c[q + 1]) / m);
+        for (unsigned k = q; k >= 1; --k) z = 0.5 * (z + static_cast<double>(c[k]));
+        z += m * sigma(static_cast<double>(c[0]) / m);
+        return m * m / (2.0 * std::numbers::ln2 * z);
+    }
+
+public:
+    // p: dense precision, 4..18
+    explicit ll_hyperloglog(unsigned p = 12)
+        : p_(p)
+        , dense_(false)
+    {
+        if (p < 4 || p > 18) throw std::invalid_argument("ll_hyperloglog: p must be in [4, 18]");
+    }
+
+    void add_hash(std::uint64_t h)
+    {
+        if (dense_)
+        {
+            dense_add(h);
+            return;
+        }
+        pending_.push_back(encode_sparse(h));
+        if (pending_.size() * sizeof(std::uint32_t) * 4 >= reg_capacity()) flush_pending();
+    }
+
+    void add(std::uint64_t key)
+    {
+        add_hash(ll_mix64(key));
+    }
+
+    // bulk: hashes in chunks so the mixing loop vectorises
+    void add(std::span<const std::uint64_t> keys)
+    {
+        std::uint64_t h[256];
+        for (std::size_t i = 0; i < keys.size(); i += 256)
+        {
+            const std::size_t n = std::min<std::size_t>(256, keys.size() - i);
+            for (std::size_t j = 0; j < n; ++j) h[j] = ll_mix64(keys[i + j]);
+            if (dense_)
+                for (std::size_t j = 0; j < n; ++j) dense_add(h[j]);
+            else
+                for (std::size_t j = 0; j < n; ++j) add_hash(h[j]);
+        }
+    }
+
+    void merge(const ll_hyperloglog& o)
+    {
+        if (o.p_ != p_) throw std::invalid_argument("ll_hyperloglog: precision mismatch");
+        if (&o == this) return; // a sketch merged with itself is unchanged
+        if (!o.dense_)
+        {
+            pending_.insert(pending_.end(), o.sparse_.begin(), o.sparse_.end());
+            pending_.insert(pending_.end(), o.pending_.begin(), o.pending_.end());
+            if (dense_)
+            {
+                for (std::uint32_t e : pending_)
+                {
+                    const auto [idx, rho] = decode_sparse(e);
+                    reg_[idx] = std::max(reg_[idx], rho);
+                }
+                pending_.clear();
+            }
+            else
+                flush_pending();
+            return;
+        }
+        if (!dense_) to_dense();
+        std::uint8_t* __restrict a = reg_.data();
+        const std::uint8_t* __restrict b = o.reg_.data();
+        for (std::size_t i = 0; i < reg_.size(); ++i) a[i] = a[i] > b[i] ? a[i] : b[i];
+    }
+
+// Queries
+
+    double estimate()
+    {
+        if (!dense_)
+        {
+            flush_pending();
+            if (!dense_)
+            {
+                // register histogram at precision 25 (sparse entries are the non-zero registers)
+                std::uint64_t c[66] = {};
+                c[0] = (std::uint64_t{1} << sp_) - sparse_.size();
+                for (std::uint32_t e : sparse_) ++c[e & 63];
+                return ertl(c, 64 - sp_, static_cast<double>(std::uint64_t{1} << sp_));
+            }
+        }
+        std::uint64_t c[66] = {};
+        for (std::uint8_t r : reg_) ++c[r];
+        return ertl(c, 64 - p_, static_cast<double>(reg_.size()));
+    }
+
+    bool is_dense() const noexcept
+    {
+        return dense_;
+    }
+    unsigned precision() const noexcept
+    {
+        return p_;
+    }
+    std::size_t memory_bytes() const noexcept
+    {
+        return sizeof(*this) + reg_.capacity() + (sparse_.capacity() + pending_.capacity()) * sizeof(std::uint32_t);
+    }
+};
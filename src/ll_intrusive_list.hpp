@@ -173,5 +173,129 @@ public:
   pos->prev = tail;
  }
 
+ // SORT / MERGE / UNIQUE
+ /* Same algorithm as ll_list_pool::sort: bottom-up merge sort by relinking
+  * hooks only. Stable, no allocation, objects never move.
+  * comp(a, b) compares two hooks (container_of them to the objects) and
+  * must not throw: the list is cut open while sorting.
+  */
+
+ template <typename Compare>
+ void sort(Compare comp)
+ {
+  if (empty() || sentinel_.next->next == &sentinel_) return;
+  intrusive_hook* bins[64] = {};
+  int top = 0;
+  sentinel_.prev->next = nullptr;
+  for (intrusive_hook* x = sentinel_.next; x;)
+  {
+   intrusive_hook* carry = x;
+   x = x->next;
+   carry->next = nullptr;
+   int i = 0;
+   for (; bins[i]; ++i)
+   {
+    carry = merge_chains(bins[i], carry, comp);
+    bins[i] = nullptr;
+   }
+   bins[i] = carry;
+   top = i + 1 > top ? i + 1 : top;
+  }
+  // lower bins hold later elements
+  intrusive_hook* rest = nullptr;
+  for (int i = 0; i < top - 1; ++i)
+   if (bins[i]) rest = rest ? merge_chains(bins[i], rest, comp) : bins[i];
+  relink_merged(bins[top - 1], rest, comp);
+ }
+
+ // merges sorted other into this sorted list by relinking; stable (this
+ // list's hooks first on ties); other ends empty
+ template <typename Compare>
+ void merge(intrusive_list& other, Compare comp)
+ {
+  if (&other == this || other.empty()) return;
+  // cut both circles open into null-terminated chains
+  intrusive_hook* a = nullptr;
+  if (!empty())
+  {
+   a = sentinel_.next;
+   sentinel_.prev->next = nullptr;
+  }
+  intrusive_hook* b = other.sentinel_.next;
+  other.sentinel_.prev->next = nullptr;
+  other.sentinel_.prev = &other.sentinel_;
+  other.sentinel_.next = &other.sentinel_;
+  relink_merged(a, b, comp);
+ }
+
+ // unlinks every hook equal (pred) to the one kept before it and hands it
+ // to dispose(hook) (the list never owns objects); returns the count
+ template <typename BinaryPredicate, typename Disposer>
+ std::size_t unique(BinaryPredicate pred, Disposer dispose)
+ {
+  std::size_t removed = 0;
+  if (empty()) return 0;
+  intrusive_hook* kept = sentinel_.next;
+  for (intrusive_hook* cur = kept->next; cur != &sentinel_;)
+  {
+   intrusive_hook* next = cur->next;
+   if (pred(kept, cur))
+   {
+    unlink(cur);
+    dispose(cur);
+    ++removed;
+   }
+   else
+    kept = cur;
+   cur = next;
+  }
+  return removed;
+ }
+
+ template <typename BinaryPredicate>
+ std::size_t unique(BinaryPredicate pred)
+ {
+  return unique(pred, [](intrusive_hook*) noexcept {});
+ }
+
+private:
+ // merge two null-terminated next chains; ties take a (stable)
+ template <typename Compare>
+ static intrusive_hook* merge_chains(intrusive_hook* a, intrusive_hook* b, Compare& comp)
+ {
+  intrusive_hook* head;
+  intrusive_hook** link = &head;
+  while (a && b)
+  {
+   if (comp(b, a)) { *link = b; link = &b->next; b = b->next; }
+   else { *link = a; link = &a->next; a = a->next; }
+  }
+  *link = a ? a : b;
+  return head;
+ }
+
+ // final merge straight into the list: sets prev links, closes the circle
+ template <typename Compare>
+ void relink_merged(intrusive_hook* a, intrusive_hook* b, Compare& comp)
+ {
+  intrusive_hook* tail = &sentinel_;
+  while (a && b)
+  {
+   intrusive_hook*& take = comp(b, a) ? b : a;
+   tail->next = take;
+   take->prev = tail;
+   tail = take;
+   take = take->next;
+  }
+  for (intrusive_hook* r = a ? a : b; r; r = r->next)
+  {
+   tail->next = r;
+   r->prev = tail;
+   tail = r;
+  }
+  tail->next = &sentinel_;
+  sentinel_.prev = tail;
+ }
+
 };
 
@@ -0,0 +1,622 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ll_fast_parse.hpp"
+#include "ll_simd_scan.hpp"
+
+/*
+ *On-Demand JSON
+ * Two stages, in the spirit of simdjson:
+ *
+ * Stage 1 (structural index) — 64 bytes per step, branch-free:
+ * - classify quotes, backslashes, operators { } [ ] : , and whitespace
+ * - remove escaped quotes (odd backslash runs), prefix-xor the quotes to get
+ *   "inside string", drop everything inside strings
+ * - record the offset of every operator, every opening quote and the first
+ *   byte of every bare scalar (number / true / false / null)
+ * - one linear pass pairs each { / [ with its closing index (O(1) skip)
+ *
+ * Stage 2 (on-demand) — nothing is materialised until asked for:
+ * - ll_json_value is (parser, index into the structural array)
+ * - objects / arrays are walked by hopping over the index; skipping an
+ *   unneeded subtree is one lookup
+ * - strings come back as std::string_view into the input (unescaped into a
+ *   caller scratch buffer only when they contain a backslash)
+ * - numbers go through ll_fast_parse
+ *
+ * NDJSON: parse_many() indexes the input in windows cut after the last
+ * complete top-level value and hands each value to a callback; index
+ * buffers are reused.
+ *
+ * Scope: structural errors (unbalanced brackets, unterminated strings,
+ * missing ':' or ',') throw ll_json_error; the contents of scalars are only
+ * validated when they are read. Object keys are compared in their raw
+ * (escaped) form. Values are valid until the next parse on the same parser.
+ */
+
+class ll_json_error : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+enum class ll_json_type
+{
+    object,
+    array,
+    string,
+    number,
+    boolean,
+    null
+};
+
+class ll_json_parser;
+class ll_json_object;
+class ll_json_array;
+
+class ll_json_value
+{
+    friend class ll_json_parser;
+    friend class ll_json_object;
+    friend class ll_json_array;
+
+    const ll_json_parser* p_;
+    std::uint32_t k_; // index into the structural array
+
+    ll_json_value(const ll_json_parser* p, std::uint32_t k) noexcept : p_(p), k_(k) {}
+    char first() const noexcept;
+    std::size_t pos() const noexcept;
+    bool at_scalar_end(const char* p) const noexcept;
+
+public:
+    ll_json_value() noexcept : p_(nullptr), k_(0) {}
+
+    ll_json_type type() const;
+    bool is_null() const noexcept
+    {
+        return first() == 'n';
+    }
+
+    ll_json_object get_object() const;
+    ll_json_array get_array() const;
+
+    // text between the quotes, escape sequences left as-is
+    std::string_view get_raw_string() const;
+    // unescaped; points into the input unless a backslash forced a copy into scratch
+    std::string_view get_string(std::string& scratch) const;
+
+    double get_double() const;
+    std::int64_t get_int64() const;
+    std::uint64_t get_uint64() const;
+    bool get_bool() const;
+
+    // the complete JSON text of this value
+    std::string_view raw_json() const;
+
+    // object member lookup; nullopt if absent, throws if this is not an object
+    std::optional<ll_json_value> find_field(std::string_view key) const;
+    // object member lookup; throws if absent
+    ll_json_value operator[](std::string_view key) const;
+};
+
+struct ll_json_field
+{
+    std::string_view key; // raw key text
+    ll_json_value value;
+};
+
+class ll_json_parser
+{
+    friend class ll_json_value;
+    friend class ll_json_object;
+    friend class ll_json_array;
+
+    std::string_view buf_;
+    std::vector<std::uint32_t> idx_;   // structural offsets + sentinel (buf_.size())
+    std::vector<std::uint32_t> match_; // for { and [ : index of the closing bracket
+    std::vector<std::uint32_t> stack_;
+    std::uint32_t n_ = 0;
+
+    // '\0' past the last structural, so malformed input cannot walk off the index
+    char at(std::uint32_t k) const noexcept
+    {
+        return k < n_ ? buf_[idx_[k]] : '\0';
+    }
+
+    // index of the next sibling after the value starting at k
+    std::uint32_t skip(std::uint32_t k) const noexcept
+    {
+        const char c = at(k);
+        return (c == '{' || c == '[') ? match_[k] + 1 : k + 1;
+    }
+
+    void expect(std::uint32_t k, char c, const char* what) const
+    {
+        if (k >= n_ || at(k) != c) throw ll_json_error(what);
+    }
+
+// Stage 1
+    // (byte | 0x20) folds '[' ']' onto '{' '}'; ',' and ':' are unchanged.
+    // Control bytes 0x0C / 0x1A alias ',' / ':' — both are invalid JSON outside strings.
+    static constexpr char op_table[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ':', '{', ',', '}', 0, 0};
+    static constexpr char ws_table[16] = {' ', 0, 0, 0, 0, 0, 0, 0, 0, '\t', '\n', 0, 0, '\r', 0, 0};
+
+    // partial: json is a window of a longer stream and may end inside a
+    // value. An open string or bracket is then not an error; n_ is cut back
+    // to the start of the last top-level value not known to be complete
+    // (still open, or a bare scalar / string the next window may extend),
+    // and idx_[n_] is that offset.
+    void build_index(std::string_view json, bool partial = false)
+    {
+        if (json.size() >= 0xFFFFFFFFu) throw ll_json_error("ll_json: input larger than 4 GiB");
+        buf_ = json;
+        const std::size_t len = json.size();
+        if (idx_.size() < len + 65) idx_.resize(len + 65); // sentinel + flatten slack; grows, never shrinks
+
+        const char* p = json.data();
+        std::uint32_t* out = idx_.data();
+        ll_escape_scanner esc;
+        std::uint64_t prev_in_string = 0;
+        std::uint64_t prev_scalar = 0;
+
+        for (std::size_t base = 0; base < len; base += 64)
+        {
+            const ll_block64 b = len - base >= 64 ? ll_block64::load(p + base)
+                                                  : ll_block64::load_partial(p + base, len - base, ' ');
+
+            const std::uint64_t escaped = esc.next(b.eq('\\'));
+            const std::uint64_t quote = b.eq('"') & ~escaped;
+            const std::uint64_t in_string = ll_prefix_xor(quote) ^ prev_in_string;
+            prev_in_string = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+            const std::uint64_t op = b.eq_lookup(op_table, 0x20);
+            const std::uint64_t ws = b.eq_lookup(ws_table, 0);
+
+            const std::uint64_t nonquote_scalar = ~(op | ws | quote);
+            const std::uint64_t follows_scalar = (nonquote_scalar << 1) | prev_scalar;
+            prev_scalar = nonquote_scalar >> 63;
+
+            const std::uint64_t string_interior = in_string & ~quote;
+            const std::uint64_t structural =
+                (op | (nonquote_scalar & ~follows_scalar) | (quote & in_string)) & ~string_interior;
+
+            out = ll_flatten_bits(out, static_cast<std::uint32_t>(base), structural);
+        }
+        if (prev_in_string && !partial) throw ll_json_error("ll_json: unterminated string");
+
+        n_ = static_cast<std::uint32_t>(out - idx_.data());
+        *out = static_cast<std::uint32_t>(len);
+
+        // pair brackets
+        if (match_.size() < n_) match_.resize(n_);
+        stack_.clear();
+        std::uint32_t last_top = 0; // start of the last top-level value
+        bool last_closed = false;   // it was a bracket value and has closed
+        for (std::uint32_t k = 0; k < n_; ++k)
+        {
+            const char c = p[idx_[k]];
+            if (stack_.empty() && c != ',' && c != ':' && c != '}' && c != ']')
+            {
+                last_top = k;
+                last_closed = false;
+            }
+            if (c == '{' || c == '[')
+            {
+                stack_.push_back(k);
+            }
+            else if (c == '}' || c == ']')
+            {
+                if (stack_.empty() || p[idx_[stack_.back()]] != (c == '}' ? '{' : '['))
+                    throw ll_json_error("ll_json: unbalanced brackets");
+                match_[stack_.back()] = k;
+                stack_.pop_back();
+                last_closed = stack_.empty();
+            }
+        }
+        if (partial)
+        {
+            if (n_ && (!stack_.empty() || !last_closed)) n_ = last_top;
+        }
+        else if (!stack_.empty())
+        {
+            throw ll_json_error("ll_json: unclosed bracket");
+        }
+    }
+
+public:
+    ll_json_parser() = default;
+    ll_json_parser(const ll_json_parser&) = delete;
+    ll_json_parser& operator=(const ll_json_parser&) = delete;
+
+    // index a single document; json must outlive every value returned
+    ll_json_value parse(std::string_view json)
+    {
+        build_index(json);
+        if (n_ == 0) throw ll_json_error("ll_json: empty document");
+        if (skip(0) != n_) throw ll_json_error("ll_json: trailing content after document");
+        return ll_json_value(this, 0);
+    }
+
+    // stage 1 only (for measuring the index on its own); returns structural count
+    std::size_t index_only(std::string_view json)
+    {
+        build_index(json);
+        return n_;
+    }
+
+    // NDJSON / concatenated values: f(ll_json_value) per top-level value.
+    // Input is indexed window_bytes at a time. Each window is cut after its
+    // last complete top-level value and the rest is carried into the next,
+    // so values may span lines and windows; a value longer than the window
+    // grows the window.
+    template <typename F>
+    std::size_t parse_many(std::string_view json, F&& f, std::size_t window_bytes = std::size_t{1} << 20)
+    {
+        std::size_t docs = 0;
+        std::size_t off = 0;
+        std::size_t window = std::max<std::size_t>(window_bytes, 1);
+        while (off < json.size())
+        {
+            const std::size_t end = json.size() - off > window ? off + window : json.size();
+            build_index(json.substr(off, end - off), end < json.size());
+            for (std::uint32_t k = 0; k < n_; k = skip(k))
+            {
+                const char c = at(k);
+                if (c == ',' || c == ':') throw ll_json_error("ll_json: expected a value");
+                f(ll_json_value(this, k));
+                ++docs;
+            }
+            const std::uint32_t used = idx_[n_];
+            window = used ? std::max<std::size_t>(window_bytes, 1) : 2 * window;
+            off += used;
+        }
+        return docs;
+    }
+};
+
+// Object / array cursors
+
+class ll_json_object
+{
+    friend class ll_json_value;
+    const ll_json_parser* p_;
+    std::uint32_t open_;
+
+    ll_json_object(const ll_json_parser* p, std::uint32_t k) noexcept : p_(p), open_(k) {}
+
+public:
+    class iterator
+    {
+        friend class ll_json_object;
+        const ll_json_parser* p_;
+        std::uint32_t k_; // index of the key, or of the closing '}'
+
+        iterator(const ll_json_parser* p, std::uint32_t k) : p_(p), k_(k)
+        {
+            check();
+        }
+        void check() const
+        {
+            if (p_->at(k_) == '}') return;
+            p_->expect(k_, '"', "ll_json: expected object key");
+            p_->expect(k_ + 1, ':', "ll_json: expected ':'");
+        }
+
+    public:
+        ll_json_field operator*() const
+        {
+            return {ll_json_value(p_, k_).get_raw_string(), ll_json_value(p_, k_ + 2)};
+        }
+        iterator& operator++()
+        {
+            const std::uint32_t next = p_->skip(k_ + 2);
+            const char c = p_->at(next);
+            if (c == ',') k_ = next + 1;
+            else if (c == '}') k_ = next;
+            else throw ll_json_error("ll_json: expected ',' or '}'");
+            check();
+            return *this;
+        }
+        bool operator==(const iterator& o) const noexcept
+        {
+            return k_ == o.k_;
+        }
+        bool operator!=(const iterator& o) const noexcept
+        {
+            return k_ != o.k_;
+        }
+    };
+
+    iterator begin() const
+    {
+        return iterator(p_, open_ + 1);
+    }
+    iterator end() const
+    {
+        return iterator(p_, p_->match_[open_]);
+    }
+
+    std::optional<ll_json_value> find(std::string_view key) const
+    {
+        for (auto it = begin(), e = end(); it != e; ++it)
+        {
+            const ll_json_field f = *it;
+            if (f.key == key) return f.value;
+        }
+        return std::nullopt;
+    }
+};
+
+class ll_json_array
+{
+    friend class ll_json_value;
+    const ll_json_parser* p_;
+    std::uint32_t open_;
+
+    ll_json_array(const ll_json_parser* p, std::uint32_t k) noexcept : p_(p), open_(k) {}
+
+public:
+    class iterator
+    {
+        friend class ll_json_array;
+        const ll_json_parser* p_;
+        std::uint32_t k_;
+
+        iterator(const ll_json_parser* p, std::uint32_t k) noexcept : p_(p), k_(k) {}
+
+    public:
+        ll_json_value operator*() const noexcept
+        {
+            return ll_json_value(p_, k_);
+        }
+        iterator& operator++()
+        {
+            const std::uint32_t next = p_->skip(k_);
+            const char c = p_->at(next);
+            if (c == ',') k_ = next + 1;
+            else if (c == ']') k_ = next;
+            else throw ll_json_error("ll_json: expected ',' or ']'");
+            return *this;
+        }
+        bool operator==(const iterator& o) const noexcept
+        {
+            return k_ == o.k_;
+        }
+        bool operator!=(const iterator& o) const noexcept
+        {
+            return k_ != o.k_;
+        }
+    };
+
+    iterator begin() const noexcept
+    {
+        return iterator(p_, open_ + 1);
+    }
+    iterator end() const noexcept
+    {
+        return iterator(p_, p_->match_[open_]);
+    }
+
+    // O(elements): each element is skipped, not parsed
+    std::size_t size() const
+    {
+        std::size_t n = 0;
+        for (auto it = begin(), e = end(); it != e; ++it) ++n;
+        return n;
+    }
+};
+
+// ll_json_value implementation
+
+inline char ll_json_value::first() const noexcept
+{
+    return p_->at(k_);
+}
+
+inline std::size_t ll_json_value::pos() const noexcept
+{
+    return p_->idx_[k_];
+}
+
+// a number or literal must run up to whitespace, ',', '}', ']' or the end of
+// input: "1.5" is not an int64 and "trueX" is not a boolean
+inline bool ll_json_value::at_scalar_end(const char* p) const noexcept
+{
+    if (p == p_->buf_.data() + p_->buf_.size()) return true;
+    const char c = *p;
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == '}' || c == ']';
+}
+
+inline ll_json_type ll_json_value::type() const
+{
+    switch (first())
+    {
+    case '{': return ll_json_type::object;
+    case '[': return ll_json_type::array;
+    case '"': return ll_json_type::string;
+    case 't':
+    case 'f': return ll_json_type::boolean;
+    case 'n': return ll_json_type::null;
+    case '-':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9': return ll_json_type::number;
+    default: throw ll_json_error("ll_json: unexpected character");
+    }
+}
+
+inline ll_json_object ll_json_value::get_object() const
+{
+    if (first() != '{') throw ll_json_error("ll_json: not an object");
+    return ll_json_object(p_, k_);
+}
+
+inline ll_json_array ll_json_value::get_array() const
+{
+    if (first() != '[') throw ll_json_error("ll_json: not an array");
+    return ll_json_array(p_, k_);
+}
+
+inline std::string_view ll_json_value::get_raw_string() const
+{
+    if (first() != '"') throw ll_json_error("ll_json: not a string");
+    // closing quote is the last '"' before the next structural, past any whitespace
+    const std::string_view b = p_->buf_;
+    std::size_t e = p_->idx_[k_ + 1];
+    while (e > pos() + 1 && (b[e - 1] == ' ' || b[e - 1] == '\n' || b[e - 1] == '\r' || b[e - 1] == '\t')) --e;
+    if (e <= pos() + 1 || b[e - 1] != '"') throw ll_json_error("ll_json: malformed string");
+    return b.substr(pos() + 1, e - pos() - 2);
+}
+
+inline std::string_view ll_json_value::get_string(std::string& scratch) const
+{
+    const std::string_view raw = get_raw_string();
+    if (std::memchr(raw.data(), '\\', raw.size()) == nullptr) return raw;
+
+    auto hex4 = [](const char* h) -> std::uint32_t
+    {
+        std::uint32_t v = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            const char c = h[i];
+            v <<= 4;
+            if (c >= '0' && c <= '9') v |= static_cast<std::uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') v |= static_cast<std::uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') v |= static_cast<std::uint32_t>(c - 'A' + 10);
+            else throw ll_json_error("ll_json: bad \\u escape");
+        }
+        return v;
+    };
+
+    scratch.clear();
+    for (std::size_t i = 0; i < raw.size(); ++i)
+    {
+        const char c = raw[i];
+        if (c != '\\')
+        {
+            scratch.push_back(c);
+            continue;
+        }
+        if (++i == raw.size()) throw ll_json_error("ll_json: dangling escape");
+        switch (raw[i])
+        {
+        case '"': scratch.push_back('"'); break;
+        case '\\': scratch.push_back('\\'); break;
+        case '/': scratch.push_back('/'); break;
+        case 'b': scratch.push_back('\b'); break;
+        case 'f': scratch.push_back('\f'); break;
+        case 'n': scratch.push_back('\n'); break;
+        case 'r': scratch.push_back('\r'); break;
+        case 't': scratch.push_back('\t'); break;
+        case 'u':
+        {
+            if (i + 4 >= raw.size()) throw ll_json_error("ll_json: short \\u escape");
+            std::uint32_t cp = hex4(raw.data() + i + 1);
+            i += 4;
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u')
+            {
+                const std::uint32_t lo = hex4(raw.data() + i + 3);
+                if (lo >= 0xDC00 && lo <= 0xDFFF)
+                {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    i += 6;
+                }
+            }
+            if (cp < 0x80)
+            {
+                scratch.push_back(static_cast<char>(cp));
+            }
+            else if (cp < 0x800)
+            {
+                scratch.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                scratch.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+            else if (cp < 0x10000)
+            {
+                scratch.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                scratch.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                scratch.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+            else
+            {
+                scratch.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                scratch.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                scratch.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                scratch.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+            break;
+        }
+        default: throw ll_json_error("ll_json: bad escape");
+        }
+    }
+    return scratch;
+}
+
+inline double ll_json_value::get_double() const
+{
+    const std::string_view b = p_->buf_;
+    double v;
+    const auto r = ll_parse_double(b.data() + pos(), b.data() + b.size(), v);
+    if (r.ec != std::errc{} || !at_scalar_end(r.ptr)) throw ll_json_error("ll_json: not a number");
+    return v;
+}
+
+inline std::int64_t ll_json_value::get_int64() const
+{
+    const std::string_view b = p_->buf_;
+    std::int64_t v;
+    const auto r = ll_parse_int(b.data() + pos(), b.data() + b.size(), v);
+    if (r.ec != std::errc{} || !at_scalar_end(r.ptr)) throw ll_json_error("ll_json: not an int64");
+    return v;
+}
+
+inline std::uint64_t ll_json_value::get_uint64() const
+{
+    const std::string_view b = p_->buf_;
+    std::uint64_t v;
+    const auto r = ll_parse_int(b.data() + pos(), b.data() + b.size(), v);
+    if (r.ec != std::errc{} || !at_scalar_end(r.ptr)) throw ll_json_error("ll_json: not a uint64");
+    return v;
+}
+
+inline bool ll_json_value::get_bool() const
+{
+    const std::string_view rest = p_->buf_.substr(pos());
+    if (rest.starts_with("true") && at_scalar_end(rest.data() + 4)) return true;
+    if (rest.starts_with("false") && at_scalar_end(rest.data() + 5)) return false;
+    throw ll_json_error("ll_json: not a boolean");
+}
+
+inline std::string_view ll_json_value::raw_json() const
+{
+    const std::string_view b = p_->buf_;
+    const char c = first();
+    if (c == '{' || c == '[') return b.substr(pos(), p_->idx_[p_->match_[k_]] - pos() + 1);
+    if (c == '"')
+    {
+        const std::string_view s = get_raw_string();
+        return b.substr(pos(), s.size() + 2);
+    }
+    std::size_t e = p_->idx_[k_ + 1];
+    while (e > pos() && (b[e - 1] == ' ' || b[e - 1] == '\n' || b[e - 1] == '\r' || b[e - 1] == '\t')) --e;
+    return b.substr(pos(), e - pos());
+}
+
+inline std::optional<ll_json_value> ll_json_value::find_field(std::string_view key) const
+{
+    return get_object().find(key);
+}
+
+inline ll_json_value ll_json_value::operator[](std::string_view key) const
+{
+    const std::optional<ll_json_value> v = find_field(key);
+    if (!v) throw ll_json_error("ll_json: missing field");
+    return *v;
+}
@@ -0,0 +1,296 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "ll_seqlock.hpp"
+
+/*
+ *L2 Order Book Aggregation
+ * Maintains aggregated depth (price, total qty, order count) from
+ * order-level events and publishes top-of-book snapshots incrementally.
+ *
+ * - each side is a vector of levels sorted so the best price is at the
+ *   back: the busy end of the book is where inserts/erases are cheapest
+ * - orders are looked up by id (price, side, remaining qty)
+ * - dirty tracking: an event marks its side dirty only if it touches a
+ *   level inside the published window (rank < Depth) or changes which
+ *   levels are in it; events deeper in the book cost no publication
+ * - publish(): for each dirty side, the new top-Depth is diffed against
+ *   the last published one (O(Depth) merge) into deltas - only changed,
+ *   added or removed levels - and the snapshot goes out through a seqlock
+ *
+ * Readers on other threads (or processes) call snapshots().load().
+ */
+
+enum class ll_side : std::uint8_t
+{
+    bid,
+    ask
+};
+
+struct ll_l2_level
+{
+    std::int64_t price;
+    std::uint64_t qty;
+    std::uint32_t orders;
+};
+
+template <std::size_t Depth>
+struct ll_l2_snapshot
+{
+    std::uint64_t seq;   // publication number
+    std::uint64_t ts_ns; // event time of the last update included
+    std::uint32_t bid_levels;
+    std::uint32_t ask_levels;
+    ll_l2_level bids[Depth]; // best first
+    ll_l2_level asks[Depth];
+};
+
+struct ll_l2_delta
+{
+    ll_side side;
+    std::int64_t price;
+    std::uint64_t qty;      // 0: level removed from the window
+    std::uint32_t orders;
+};
+
+template <std::size_t Depth = 10>
+class ll_l2_book
+{
+public:
+    using snapshot = ll_l2_snapshot<Depth>;
+
+private:
+    struct order
+    {
+        std::int64_t price;
+        std::uint64_t qty;
+        ll_side side;
+    };
+
+    struct book_side
+    {
+        std::vector<ll_l2_level> levels; // best at the back
+        bool dirty = false;
+        std::uint32_t published_n = 0;
+        ll_l2_level published[Depth] = {};
+    };
+
+    std::unordered_map<std::uint64_t, order> orders_;
+    book_side sides_[2];
+    std::vector<ll_l2_delta> deltas_;
+    std::uint64_t seq_ = 0;
+    ll_seqlock<snapshot> snap_;
+
+    // bids ascend, asks descend: in both the best price is at the back
+    static bool worse(ll_side s, std::int64_t a, std::int64_t b) noexcept
+    {
+        return s == ll_side::bid ? a < b : a > b;
+    }
+
+    book_side& side_of(ll_side s) noexcept
+    {
+        return sides_[static_cast<unsigned>(s)];
+    }
+
+    // index of price (or of its insertion point), searching from the best end
+    std::size_t find_level(ll_side s, std::int64_t price) noexcept
+    {
+        std::vector<ll_l2_level>& lv = side_of(s).levels;
+        std::size_t i = lv.size();
+        // most traffic is near the top of the book: scan a few levels first
+        for (std::size_t k = 0; k < 8 && i > 0; ++k, --i)
+            if (!worse(s, price, lv[i - 1].price)) return lv[i - 1].price == price ? i - 1 : i;
+        return static_cast<std::size_t>(std::lower_bound(lv.begin(), lv.begin() + static_cast<std::ptrdiff_t>(i), price,
+                                                         [s](const ll_l2_level& l, std::int64_t p) { return worse(s, l.price, p); }) -
+                                        lv.begin());
+    }
+
+    void touch(book_side& bs, std::size_t idx) noexcept
+    {
+        // rank from the best end, before or after a size change
+        if (bs.levels.size() - idx <= Depth) bs.dirty = true;
+    }
+
+    void add_qty(ll_side s, std::int64_t price, std::uint64_t qty)
+    {
+        book_side& bs = side_of(s);
+        const std::size_t i = find_level(s, price);
+        if (i < bs.levels.size() && bs.levels[i].price == price)
+        {
+            bs.levels[i].qty += qty;
+            ++bs.levels[i].orders;
+        }
+        else
+        {
+            bs.levels.insert(bs.levels.begin() + static_cast<std::ptrdiff_t>(i), ll_l2_level{price, qty, 1});
+        }
+        touch(bs, i);
+    }
+
+    void sub_qty(ll_side s, std::int64_t price, std::uint64_t qty, bool order_gone) noexcept
+    {
+        book_side& bs = side_of(s);
+        const std::size_t i = find_level(s, price);
+        ll_l2_level& l = bs.levels[i];
+        touch(bs, i);
+        l.qty -= qty;
+        l.orders -= order_gone;
+        if (l.orders == 0) bs.levels.erase(bs.levels.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    // diff the new window against the published one; both are best first
+    void diff_side(ll_side s, book_side& bs, ll_l2_level* out, std::uint32_t& out_n)
+    {
+        const std::size_t n = std::min(Depth, bs.levels.size());
+        for (std::size_t k = 0; k < n; ++k) out[k] = bs.levels[bs.levels.size() - 1 - k];
+        out_n = static_cast<std::uint32_t>(n);
+
+        std::size_t a = 0, b = 0;
+        while (a < bs.published_n || b < n)
+        {
+            if (b == n || (a < bs.published_n && worse(s, out[b].price, bs.published[a].price)))
+            {
+                deltas_.push_back({s, bs.published[a].price, 0, 0}); // left the window
+                ++a;
+            }
+            else if (a == bs.published_n || worse(s, bs.published[a].price, out[b].price))
+            {
+                deltas_.push_back({s, out[b].price, out[b].qty, out[b].orders}); // entered the window
+                ++b;
+            }
+            else
+            {
+                if (bs.published[a].qty != out[b].qty || bs.published[a].orders != out[b].orders)
+                    deltas_.push_back({s, out[b].price, out[b].qty, out[b].orders});
+                ++a;
+                ++b;
+            }
+        }
+        std::copy(out, out + n, bs.published);
+        bs.published_n = out_n;
+        bs.dirty = false;
+    }
+
+public:
+    explicit ll_l2_book(std::size_t expected_orders = 1 << 16)
+    {
+        orders_.reserve(expected_orders);
+        deltas_.reserve(4 * Depth);
+        for (book_side& bs : sides_) bs.levels.reserve(1024);
+    }
+
+// Order-level events
+    // false if the id is already live
+    bool add(std::uint64_t id, ll_side side, std::int64_t price, std::uint64_t qty)
+    {
+        if (qty == 0 || !orders_.emplace(id, order{price, qty, side}).second) return false;
+        add_qty(side, price, qty);
+        return true;
+    }
+
+    // partial cancel or execution; the order is removed when nothing is left.
+    // false for an unknown id (e.g. book joined mid-session)
+    bool reduce(std::uint64_t id, std::uint64_t qty) noexcept
+    {
+        auto it = orders_.find(id);
+        if (it == orders_.end()) return false;
+        order& o = it->second;
+        qty = std::min(qty, o.qty);
+        o.qty -= qty;
+        sub_qty(o.side, o.price, qty, o.qty == 0);
+        if (o.qty == 0) orders_.erase(it);
+        return true;
+    }
+
+    bool remove(std::uint64_t id) noexcept
+    {
+        auto it = orders_.find(id);
+        if (it == orders_.end()) return false;
+        sub_qty(it->second.side, it->second.price, it->second.qty, true);
+        orders_.erase(it);
+        return true;
+    }
+
+    // price/qty change; like most venues this loses time priority
+    bool modify(std::uint64_t id, std::int64_t price, std::uint64_t qty)
+    {
+        if (qty == 0) return remove(id);
+        auto it = orders_.find(id);
+        if (it == orders_.end()) return false;
+        order& o = it->second;
+        if (o.price == price)
+        {
+            book_side& bs = side_of(o.side);
+            const std::size_t i = find_level(o.side, price);
+            bs.levels[i].qty = bs.levels[i].qty - o.qty + qty;
+            o.qty = qty;
+            touch(bs, i);
+            return true;
+        }
+        const ll_side s = o.side;
+        remove(id);
+        return add(id, s, price, qty);
+    }
+
+// Publication
+    // publishes a snapshot if the window changed; the deltas of that
+    // publication stay valid until the next publish()
+    bool publish(std::uint64_t ts_ns)
+    {
+        deltas_.clear();
+        if (!sides_[0].dirty && !sides_[1].dirty) return false;
+
+        snapshot s;
+        s.seq = seq_ + 1;
+        s.ts_ns = ts_ns;
+        // both windows are kept current in published[]; only dirty sides are rebuilt
+        for (unsigned k = 0; k < 2; ++k)
+        {
+            book_side& bs = sides_[k];
+            ll_l2_level* out = k == 0 ? s.bids : s.asks;
+            std::uint32_t& n = k == 0 ? s.bid_levels : s.ask_levels;
+            if (bs.dirty) diff_side(static_cast<ll_side>(k), bs, out, n);
+            else
+            {
+                std::copy(bs.published, bs.published + bs.published_n, out);
+                n = bs.published_n;
+            }
+            std::fill(out + n, out + Depth, ll_l2_level{});
+        }
+        if (deltas_.empty()) return false; // touched but unchanged (e.g. modify to the same qty)
+        ++seq_;
+        snap_.store(s);
+        return true;
+    }
+
+    std::span<const ll_l2_delta> deltas() const noexcept
+    {
+        return deltas_;
+    }
+
+    const ll_seqlock<snapshot>& snapshots() const noexcept
+    {
+        return snap_;
+    }
+
+// Inspection
+    std::size_t orders() const noexcept
+    {
+        return orders_.size();
+    }
+    std::size_t levels(ll_side s) const noexcept
+    {
+        return sides_[static_cast<unsigned>(s)].levels.size();
+    }
+    // nullptr if the side is empty
+    const ll_l2_level* best(ll_side s) const noexcept
+    {
+        const auto& lv = sides_[static_cast<unsigned>(s)].levels;
+        return lv.empty() ? nullptr : &lv.back();
+    }
+};
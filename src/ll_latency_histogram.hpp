@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/*
+ *Latency Histogram
+ * Log-linear histogram (HdrHistogram style) for nanosecond latencies.
+ * - values below 2^sub_bits are recorded exactly
+ * - every power-of-two range above is split into 2^sub_bits linear buckets,
+ *   so the relative error of any reported percentile is <= 2^-sub_bits
+ * - record() is a clz, a shift and an increment: safe inside timed loops
+ * - fixed memory, allocated once ((65 - sub_bits) * 2^sub_bits counters)
+ * - histograms with the same sub_bits can be merged (per-thread recording)
+ */
+
+class ll_latency_histogram
+{
+private:
+    unsigned sub_bits_;
+    std::uint64_t sub_;
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_;
+    std::uint64_t min_;
+    std::uint64_t max_;
+    long double sum_;
+
+    std::size_t index_of(std::uint64_t v) const noexcept
+    {
+        if (v < sub_) return static_cast<std::size_t>(v);
+        const unsigned msb = 63u - static_cast<unsigned>(std::countl_zero(v));
+        const unsigned shift = msb - sub_bits_;
+        return static_cast<std::size_t>(shift * sub_ + (v >> shift));
+    }
+
+    // midpoint of the bucket; exact for the linear region
+    std::uint64_t value_of(std::size_t idx) const noexcept
+    {
+        if (idx < sub_) return idx;
+        const std::uint64_t shift = idx / sub_ - 1;
+        const std::uint64_t top = idx % sub_ + sub_;
+        return (top << shift) + ((std::uint64_t{1} << shift) >> 1);
+    }
+
+public:
+    explicit ll_latency_histogram(unsigned sub_bits = 7)
+        : sub_bits_(sub_bits)
+        , sub_(std::uint64_t{1} << sub_bits)
+        , counts_((65 - sub_bits) * (std::size_t{1} << sub_bits), 0)
+        , total_(0)
+        , min_(~std::uint64_t{0})
+        , max_(0)
+        , sum_(0)
+    {
+    }
+
+    void record(std::uint64_t v) noexcept
+    {
+        ++counts_[index_of(v)];
+        ++total_;
+        sum_ += v;
+        min_ = v < min_ ? v : min_;
+        max_ = v > max_ ? v : max_;
+    }
+
+    void record_n(std::uint64_t v, std::uint64_t n) noexcept
+    {
+        if (n == 0) return;
+        counts_[index_of(v)] += n;
+        total_ += n;
+        sum_ += static_cast<long double>(v) * n;
+        min_ = v < min_ ? v : min_;
+        max_ = v > max_ ? v : max_;
+    }
+
+    void merge(const ll_latency_histogram& o) noexcept
+    {
+        const std::size_t n = std::min(counts_.size(), o.counts_.size());
+        for (std::size_t i = 0; i < n; ++i) counts_[i] += o.counts_[i];
+        total_ += o.total_;
+        sum_ += o.sum_;
+        min_ = std::min(min_, o.min_);
+        max_ = std::max(max_, o.max_);
+    }
+
+    void reset() noexcept
+    {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        min_ = ~std::uint64_t{0};
+        max_ = 0;
+        sum_ = 0;
+    }
+
+// Queries
+
+    std::uint64_t count() const noexcept
+    {
+        return total_;
+    }
+    std::uint64_t min() const noexcept
+    {
+        return total_ ? min_ : 0;
+    }
+    std::uint64_t max() const noexcept
+    {
+        return max_;
+    }
+    double mean() const noexcept
+    {
+        return total_ ? static_cast<double>(sum_ / total_) : 0.0;
+    }
+
+    // p in [0, 100]
+    std::uint64_t percentile(double p) const noexcept
+    {
+        if (total_ == 0) return 0;
+        if (p >= 100.0) return max_;
+        auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(total_));
+        if (rank >= total_) rank = total_ - 1;
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); ++i)
+        {
+            seen += counts_[i];
+            if (seen > rank) return std::clamp(value_of(i), min_, max_);
+        }
+        return max_;
+    }
+
+    // one line: label count mean p50 p90 p99 p99.9 p99.99 max
+    void print(std::ostream& os, std::string_view label) const
+    {
+        os << label
+           << " n=" << total_
+           << " mean=" << static_cast<std::uint64_t>(mean())
+           << " p50=" << percentile(50)
+           << " p90=" << percentile(90)
+           << " p99=" << percentile(99)
+           << " p99.9=" << percentile(99.9)
+           << " p99.99=" << percentile(99.99)
+           << " max=" << max_ << "\n";
+    }
+};
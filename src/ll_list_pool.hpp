@@ -1,7 +1,12 @@
 #pragma once
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <new>
+#include <optional>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 
@@ -16,8 +21,43 @@
  * - std::list-style splice semantics
  * - stable node addresses
  * - suitable for latency sensitive applications
+ * - bulk snapshot (slab copy + link rebase) for trivially copyable T
+ * - sort / merge / unique by relinking: stable, no allocation
+ * - exhaustion handling: try_emplace_*, high/low watermarks, occupancy stats
  */
 
+// Occupancy watermarks
+    // pressure turns on when size reaches high and off when it falls back to
+    // low (hysteresis, so a queue hovering at the mark does not flap).
+    // On each transition the pool calls on_high / on_low (ctx, size) and
+    // stores true / false to *flag (relaxed), for a throttle on another
+    // thread. Callbacks run inside emplace / erase: keep them short, and
+    // they must not throw or touch the pool. high == 0 disables.
+struct ll_pool_watermarks
+{
+    std::size_t high = 0;
+    std::size_t low = 0;
+    void (*on_high)(void* ctx, std::size_t size) = nullptr;
+    void (*on_low)(void* ctx, std::size_t size) = nullptr;
+    void* ctx = nullptr;
+    std::atomic<bool>* flag = nullptr;
+};
+
+struct ll_pool_stats
+{
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::size_t peak = 0;              // highest size since construction / reset_stats()
+    std::uint64_t pressure_events = 0; // times the high watermark was reached
+    std::uint64_t exhausted = 0;       // allocations refused: emplace or merge threw, try_emplace failed
+    bool under_pressure = false;
+
+    double occupancy() const noexcept
+    {
+        return capacity ? static_cast<double>(size) / static_cast<double>(capacity) : 0.0;
+    }
+};
+
 // Node layout
 template <typename T>
 class ll_list_pool
@@ -54,6 +94,23 @@ private:
     std::size_t cap_;
     std::size_t size_;
 
+// Occupancy state
+    // - high_ / low_ : active watermarks; high_ = SIZE_MAX when off
+    // - grow_trip_ / shrink_trip_ : the next size at which growing / size
+    //   below which shrinking has work to do (new peak, pressure on / off),
+    //   so the hot path pays one compare per operation
+    // - peak_, pressure_events_, exhausted_ : ll_pool_stats counters
+
+    ll_pool_watermarks wm_{};
+    std::size_t high_ = SIZE_MAX;
+    std::size_t low_ = 0;
+    std::size_t grow_trip_ = 1;
+    std::size_t shrink_trip_ = 0;
+    bool pressure_ = false;
+    std::size_t peak_ = 0;
+    std::uint64_t pressure_events_ = 0;
+    std::uint64_t exhausted_ = 0;
+
 private:
 // Internal helpers
 
@@ -86,8 +143,9 @@ private:
         if (!free_)
         {
             // pool exhausted: deterministic failure
-            // in real systems this would trigger:
-            // presizing, backpressure, or fatal error
+            // callers that can shed load use try_emplace_* instead, and
+            // watermarks to throttle upstream before it comes to this
+            ++exhausted_;
             throw std::bad_alloc();
         }
         node* n = free_;
@@ -103,6 +161,96 @@ private:
         free_ = n;
     }
 
+    // call after size_ grows / shrinks
+    void note_grow() noexcept
+    {
+        if (size_ >= grow_trip_) [[unlikely]] grew();
+    }
+
+    void note_shrink() noexcept
+    {
+        if (size_ < shrink_trip_) [[unlikely]] shrank();
+    }
+
+    void grew() noexcept
+    {
+        if (size_ > peak_) peak_ = size_;
+        if (!pressure_ && size_ >= high_)
+        {
+            pressure_ = true;
+            ++pressure_events_;
+            if (wm_.flag) wm_.flag->store(true, std::memory_order_relaxed);
+            if (wm_.on_high) wm_.on_high(wm_.ctx, size_);
+        }
+        retrip();
+    }
+
+    void shrank() noexcept
+    {
+        if (pressure_ && size_ <= low_)
+        {
+            pressure_ = false;
+            if (wm_.flag) wm_.flag->store(false, std::memory_order_relaxed);
+            if (wm_.on_low) wm_.on_low(wm_.ctx, size_);
+        }
+        retrip();
+    }
+
+    void retrip() noexcept
+    {
+        grow_trip_ = (pressure_ || peak_ < high_) ? peak_ + 1 : high_;
+        shrink_trip_ = pressure_ ? low_ + 1 : 0;
+    }
+
+    // merge two null-terminated next chains; on ties a comes first (stable)
+    template <typename Compare>
+    static node* merge_chains(node* a, node* b, Compare& comp)
+    {
+        node* head;
+        node** link = &head;
+        while (a && b)
+        {
+            if (comp(b->value, a->value))
+            {
+                *link = b;
+                link = &b->next;
+                b = b->next;
+            }
+            else
+            {
+                *link = a;
+                link = &a->next;
+                a = a->next;
+            }
+        }
+        *link = a ? a : b;
+        return head;
+    }
+
+    // last merge: also rebuilds prev links and closes the circle at the
+    // sentinel, so sort needs no separate fix-up pass
+    template <typename Compare>
+    void merge_final(node* a, node* b, Compare& comp)
+    {
+        node* tail = &sentinel_;
+        while (a && b)
+        {
+            node*& take = comp(b->value, a->value) ? b : a;
+            tail->next = take;
+            take->prev = tail;
+            tail = take;
+            take = take->next;
+        }
+        for (node* rest = a ? a : b; rest; rest = rest->next)
+        {
+            tail->next = rest;
+            rest->prev = tail;
+            tail = rest;
+        }
+        tail->next = &sentinel_;
+        sentinel_.prev = tail;
+    }
+
 public:
 // Iterator - very thin wrapper around the node
     class iterator
@@ -152,9 +300,11 @@ public:
         // allocate contigous slab for nodes
         slab_ = static_cast<node*>(
             ::operator new(sizeof(node)*cap_, std::align_val_t(alignof(node))));
-        // build free list
+        // build free list; prev is set too, so every link in the slab is a
+        // determinate pointer (snapshot rebases all of them)
         for (std::size_t i = 0; i < cap_; ++i)
         {
+            slab_[i].prev = nullptr;
             slab_[i].next = free_;
             free_ = &slab_[i];
         }
@@ -167,6 +317,19 @@ public:
     ll_list_pool(const ll_list_pool&) = delete;
     ll_list_pool& operator=(const ll_list_pool&) = delete;
 
+private:
+    // snapshot(): allocate only, snapshot_to fills every node
+    struct snapshot_tag {};
+    ll_list_pool(snapshot_tag, const ll_list_pool& src)
+        :slab_(static_cast<node*>(::operator new(sizeof(node)*src.cap_, std::align_val_t(alignof(node)))))
+        , free_(nullptr)
+        , cap_(src.cap_)
+        , size_(0)
+    {
+        src.snapshot_to(*this);
+    }
+
+public:
     ~ll_list_pool()
     {
         clear();
@@ -183,6 +346,14 @@ public:
     {
         return size_;
     }
+    std::size_t capacity() const noexcept
+    {
+        return cap_;
+    }
+    std::size_t available() const noexcept
+    {
+        return cap_ - size_;
+    }
     iterator begin() noexcept
     {
         return iterator(sentinel_.next);
@@ -192,6 +363,71 @@ public:
         return iterator(&sentinel_);
     }
 
+// Snapshot
+/* Copy for what-if use, trivially copyable T only:
+ * one sequential pass over the whole slab (live and free nodes) copying
+ * each value as bytes and each non-null link plus a fixed delta (copy slab
+ * - source slab). The sentinel is a member, not a slab node, so the copy's
+ * sentinel and the two links pointing at it (front->prev, back->next) are
+ * set apart.
+ * - O(capacity) sequential work vs O(size) pointer chasing for a rebuild
+ * - node positions are preserved: the copy's free list and allocation
+ *   order match the source, and counterpart() maps handles across
+ */
+    ll_list_pool snapshot() const requires std::is_trivially_copyable_v<T>
+    {
+        return ll_list_pool(snapshot_tag{}, *this);
+    }
+
+    // same, into an existing pool of equal capacity (no allocation, no
+    // page faults); dst's contents are overwritten
+    void snapshot_to(ll_list_pool& dst) const requires std::is_trivially_copyable_v<T>
+    {
+        if (&dst == this) return;
+        if (dst.cap_ != cap_) throw std::length_error("ll_list_pool: snapshot_to needs equal capacity");
+
+        const std::uintptr_t delta = reinterpret_cast<std::uintptr_t>(dst.slab_) - reinterpret_cast<std::uintptr_t>(slab_);
+        auto rebase = [delta](node* p) noexcept
+        {
+            return p ? reinterpret_cast<node*>(reinterpret_cast<std::uintptr_t>(p) + delta) : nullptr;
+        };
+        // one pass: copy each node with its links rebased. Links to the
+        // source sentinel come out wrong here (front->prev, back->next,
+        // stale prev of free nodes) and are fixed below or never read
+        for (std::size_t i = 0; i < cap_; ++i)
+        {
+            node* d = &dst.slab_[i];
+            const node* s = &slab_[i];
+            std::memcpy(static_cast<void*>(&d->value), static_cast<const void*>(&s->value), sizeof(T));
+            d->prev = rebase(s->prev);
+            d->next = rebase(s->next);
+        }
+        if (size_ == 0)
+        {
+            dst.sentinel_.prev = &dst.sentinel_;
+            dst.sentinel_.next = &dst.sentinel_;
+        }
+        else
+        {
+            dst.sentinel_.next = rebase(sentinel_.next);
+            dst.sentinel_.prev = rebase(sentinel_.prev);
+            dst.sentinel_.next->prev = &dst.sentinel_;
+            dst.sentinel_.prev->next = &dst.sentinel_;
+        }
+        dst.free_ = rebase(free_);
+        dst.size_ = size_;
+        // dst keeps its own watermarks
+        dst.note_grow();
+        dst.note_shrink();
+    }
+
+    // in a snapshot: the iterator at the position 'it' has in original
+    iterator counterpart(const ll_list_pool& original, iterator it) noexcept
+    {
+        if (it.n_ == &original.sentinel_) return end();
+        return iterator(slab_ + (it.n_ - original.slab_));
+    }
+
 // Clear list
 
     // destroys all values and returns nodes to pool
@@ -213,6 +449,7 @@ public:
         sentinel_.prev = &sentinel_;
         sentinel_.next = &sentinel_;
         size_ = 0;
+        note_shrink();
     }
 
 // Emplacement
@@ -223,6 +460,7 @@ public:
         ::new (&n->value) T(std::forward<Args>(args)...);
         link_between(n, &sentinel_, sentinel_.next);
         ++size_;
+        note_grow();
         return iterator(n);
     }
 
@@ -233,9 +471,164 @@ public:
         ::new (&n->value) T(std::forward<Args>(args)...);
         link_between(n, sentinel_.prev, &sentinel_);
         ++size_;
+        note_grow();
         return iterator(n);
     }
 
+    // non-throwing on exhaustion: nullopt when no node is free (counted in
+    // stats().exhausted); exceptions from T's constructor still propagate
+    template <typename... Args>
+    std::optional<iterator> try_emplace_front(Args&&... args)
+    {
+        if (!free_) [[unlikely]]
+        {
+            ++exhausted_;
+            return std::nullopt;
+        }
+        return emplace_front(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::optional<iterator> try_emplace_back(Args&&... args)
+    {
+        if (!free_) [[unlikely]]
+        {
+            ++exhausted_;
+            return std::nullopt;
+        }
+        return emplace_back(std::forward<Args>(args)...);
+    }
+
+// Occupancy / backpressure
+    // installs w and re-evaluates at the current size (on_high fires now if
+    // size is already at high); std::invalid_argument unless
+    // low < high <= capacity, or high == 0 to disable
+    void set_watermarks(const ll_pool_watermarks& w)
+    {
+        if (w.high != 0 && (w.low >= w.high || w.high > cap_))
+            throw std::invalid_argument("ll_list_pool: watermarks need low < high <= capacity");
+        if (pressure_ && wm_.flag) wm_.flag->store(false, std::memory_order_relaxed); // release the old flag
+        wm_ = w;
+        high_ = w.high ? w.high : SIZE_MAX;
+        low_ = w.low;
+        pressure_ = false;
+        if (wm_.flag) wm_.flag->store(false, std::memory_order_relaxed);
+        retrip();
+        note_grow();
+    }
+
+    bool under_pressure() const noexcept
+    {
+        return pressure_;
+    }
+
+    ll_pool_stats stats() const noexcept
+    {
+        return {cap_, size_, peak_, pressure_events_, exhausted_, pressure_};
+    }
+
+    // restarts peak at the current size and zeroes the counters
+    void reset_stats() noexcept
+    {
+        peak_ = size_;
+        pressure_events_ = 0;
+        exhausted_ = 0;
+        retrip();
+    }
+
+// Sort / merge / unique
+/* Bottom-up merge sort by relinking, as std::list::sort: stable, O(n log n)
+ * comparisons, no allocation, no value moves or swaps; iterators stay
+ * valid and keep pointing at their values.
+ * - the list is cut open into a null-terminated next chain
+ * - bins[i] holds a sorted run of 2^i nodes or nothing; each node is
+ *   carried up like a binary counter, so merges run on recently touched
+ *   nodes while they are still in cache
+ * - the last merge rebuilds prev links and reattaches the sentinel
+ * comp must not throw: the list is cut open while sorting.
+ */
+    template <typename Compare = std::less<>>
+    void sort(Compare comp = {})
+    {
+        if (size_ < 2) return;
+        node* bins[64] = {};
+        int top = 0; // bins in use: [0, top)
+        sentinel_.prev->next = nullptr;
+        for (node* x = sentinel_.next; x;)
+        {
+            node* carry = x;
+            x = x->next;
+            carry->next = nullptr;
+            int i = 0;
+            for (; bins[i]; ++i)
+            {
+                carry = merge_chains(bins[i], carry, comp);
+                bins[i] = nullptr;
+            }
+            bins[i] = carry;
+            top = i + 1 > top ? i + 1 : top;
+        }
+        // lower bins hold later elements: fold them as the right operand
+        node* rest = nullptr;
+        for (int i = 0; i < top - 1; ++i)
+            if (bins[i]) rest = rest ? merge_chains(bins[i], rest, comp) : bins[i];
+        merge_final(bins[top - 1], rest, comp);
+    }
+
+    // merges sorted other into this sorted list; stable (on ties this list's
+    // elements come first). Nodes cannot change slabs, so each element of
+    // other is moved once into a free node of this pool; placing it is
+    // relinking. other is left empty. std::bad_alloc up front, with both
+    // lists unchanged, if this pool cannot take every element
+    template <typename Compare = std::less<>>
+    void merge(ll_list_pool& other, Compare comp = {})
+    {
+        if (&other == this || other.empty()) return;
+        if (other.size_ > cap_ - size_)
+        {
+            ++exhausted_;
+            throw std::bad_alloc();
+        }
+        node* pos = sentinel_.next;
+        for (node* src = other.sentinel_.next; src != &other.sentinel_; src = src->next)
+        {
+            while (pos != &sentinel_ && !comp(src->value, pos->value)) pos = pos->next;
+            node* n = alloc_node();
+            ::new (&n->value) T(std::move(src->value));
+            link_between(n, pos->prev, pos);
+            ++size_;
+        }
+        note_grow();
+        other.clear();
+    }
+
+    // erases every element equal (pred) to the one kept before it; returns
+    // the number erased
+    template <typename BinaryPredicate = std::equal_to<>>
+    std::size_t unique(BinaryPredicate pred = {})
+    {
+        if (size_ < 2) return 0;
+        std::size_t removed = 0;
+        node* kept = sentinel_.next;
+        for (node* cur = kept->next; cur != &sentinel_;)
+        {
+            node* next = cur->next;
+            if (pred(kept->value, cur->value))
+            {
+                unlink(cur);
+                cur->value.~T();
+                free_node(cur);
+                ++removed;
+            }
+            else
+                kept = cur;
+            cur = next;
+        }
+        size_ -= removed;
+        note_shrink();
+        return removed;
+    }
+
 // Erase
     iterator erase(iterator it) noexcept
     {
@@ -245,6 +638,7 @@ public:
         n->value.~T();
         free_node(n);
         --size_;
+        note_shrink();
         return next;
     }
 
@@ -0,0 +1,158 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ *Memory Mapped File
+ * RAII wrapper over open + mmap:
+ * - read_only  : map an existing file (replay, pcap, CSV ingest)
+ * - read_write : map an existing file shared, writes go to the page cache
+ * - create     : create / truncate to the requested size, then map shared
+ *
+ * The descriptor is closed right after mapping; the mapping lives until the
+ * object is destroyed. Failures throw std::system_error with errno.
+ * Movable, not copyable.
+ */
+
+enum class ll_mmap_mode
+{
+    read_only,
+    read_write,
+    create
+};
+
+class ll_mmap_file
+{
+private:
+    void* addr_;
+    std::size_t size_;
+    bool writable_;
+
+    static void fail(const char* what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+public:
+// Construction/Destruction
+    // size is required for create and ignored otherwise
+    explicit ll_mmap_file(const char* path, ll_mmap_mode mode = ll_mmap_mode::read_only, std::size_t size = 0)
+        : addr_(nullptr)
+        , size_(0)
+        , writable_(mode != ll_mmap_mode::read_only)
+    {
+        const int flags = mode == ll_mmap_mode::read_only ? O_RDONLY
+                        : mode == ll_mmap_mode::read_write ? O_RDWR
+                        : O_RDWR | O_CREAT | O_TRUNC;
+        const int fd = ::open(path, flags | O_CLOEXEC, 0644);
+        if (fd < 0) fail("ll_mmap_file: open");
+
+        if (mode == ll_mmap_mode::create)
+        {
+            if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+            {
+                ::close(fd);
+                fail("ll_mmap_file: ftruncate");
+            }
+            size_ = size;
+        }
+        else
+        {
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                fail("ll_mmap_file: fstat");
+            }
+            size_ = static_cast<std::size_t>(st.st_size);
+        }
+
+        if (size_ > 0)
+        {
+            const int prot = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+            void* a = ::mmap(nullptr, size_, prot, MAP_SHARED, fd, 0);
+            if (a == MAP_FAILED)
+            {
+                ::close(fd);
+                fail("ll_mmap_file: mmap");
+            }
+            addr_ = a;
+        }
+        ::close(fd);
+    }
+
+    ll_mmap_file(const ll_mmap_file&) = delete;
+    ll_mmap_file& operator=(const ll_mmap_file&) = delete;
+
+    ll_mmap_file(ll_mmap_file&& o) noexcept
+        : addr_(std::exchange(o.addr_, nullptr))
+        , size_(std::exchange(o.size_, 0))
+        , writable_(o.writable_)
+    {
+    }
+
+    ll_mmap_file& operator=(ll_mmap_file&& o) noexcept
+    {
+        if (this != &o)
+        {
+            if (addr_) ::munmap(addr_, size_);
+            addr_ = std::exchange(o.addr_, nullptr);
+            size_ = std::exchange(o.size_, 0);
+            writable_ = o.writable_;
+        }
+        return *this;
+    }
+
+    ~ll_mmap_file()
+    {
+        if (addr_) ::munmap(addr_, size_);
+    }
+
+// Access
+    const char* data() const noexcept
+    {
+        return static_cast<const char*>(addr_);
+    }
+    char* data() noexcept
+    {
+        return static_cast<char*>(addr_);
+    }
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+    std::string_view view() const noexcept
+    {
+        return {data(), size_};
+    }
+
+// Paging hints / durability
+    // e.g. MADV_SEQUENTIAL for one pass, MADV_WILLNEED to prefetch; best effort
+    void advise(int advice) noexcept
+    {
+        if (addr_) ::madvise(addr_, size_, advice);
+    }
+
+    // write dirty pages back; synchronous (MS_SYNC) unless async is requested
+    void sync(bool async = false)
+    {
+        if (addr_ && writable_ && ::msync(addr_, size_, async ? MS_ASYNC : MS_SYNC) != 0) fail("ll_mmap_file: msync");
+    }
+
+    // sync a sub-range; offset is rounded down to the page size
+    void sync_range(std::size_t offset, std::size_t len, bool async = false)
+    {
+        if (!addr_ || !writable_ || len == 0) return;
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t start = offset & ~(page - 1);
+        if (::msync(data() + start, offset + len - start, async ? MS_ASYNC : MS_SYNC) != 0) fail("ll_mmap_file: msync");
+    }
+};
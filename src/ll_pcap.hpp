@@ -0,0 +1,464 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <arpa/inet.h>
+
+#include "ll_mmap_file.hpp"
+
+/*
+ *Offline Capture Reader (pcap / pcapng)
+ * Walks an mmap'd capture file and hands out UDP payloads as spans into the
+ * mapping - nothing is copied.
+ *
+ * - pcap   : µs (a1b2c3d4) and ns (a1b23c4d) magics, either byte order
+ * - pcapng : SHB / IDB / EPB / SPB blocks, per-section byte order,
+ *            per-interface link type and if_tsresol (any power of 10 or 2)
+ * - link   : Ethernet (+ 802.1Q / QinQ tags), raw IPv4, Linux SLL / SLL2
+ * - IPv4 / UDP only; fragments and non-UDP frames are counted and skipped
+ * - timestamps are nanoseconds since the epoch
+ *
+ * A capture that ends mid-record (still being written, cut by a size limit)
+ * stops the walk and sets ll_pcap_stats::truncated; a bad file header
+ * throws ll_pcap_error.
+ *
+ * Payload framing: ll_moldudp64_for_each splits a MoldUDP64 packet (the
+ * transport of ITCH style feeds) into its sequenced messages.
+ */
+
+class ll_pcap_error : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+enum class ll_pcap_format
+{
+    pcap,
+    pcapng
+};
+
+struct ll_pcap_frame
+{
+    std::uint64_t ts_ns;
+    std::uint32_t linktype;
+    std::uint32_t orig_len;           // length on the wire
+    std::span<const std::byte> data;  // captured bytes (may be shorter)
+};
+
+struct ll_udp_packet
+{
+    std::uint64_t ts_ns;
+    std::uint32_t src_ip; // host byte order
+    std::uint32_t dst_ip;
+    std::uint16_t src_port;
+    std::uint16_t dst_port;
+    std::span<const std::byte> payload;
+};
+
+struct ll_pcap_stats
+{
+    std::uint64_t frames = 0;
+    std::uint64_t udp = 0;
+    std::uint64_t matched = 0;
+    std::uint64_t non_udp = 0;    // other link / network / transport protocols
+    std::uint64_t fragments = 0;  // IPv4 fragments (not reassembled)
+    std::uint64_t malformed = 0;  // headers cut short by the snap length or corrupt
+    bool truncated = false;       // file ended inside a record
+};
+
+// "233.54.12.1" -> host order address; throws on a malformed address
+inline std::uint32_t ll_ipv4(const char* dotted)
+{
+    in_addr a;
+    if (::inet_pton(AF_INET, dotted, &a) != 1) throw std::invalid_argument("ll_ipv4: bad address");
+    return ntohl(a.s_addr);
+}
+
+// (group, port) pairs; 0 is a wildcard for either. An empty filter matches every UDP packet.
+class ll_pcap_filter
+{
+private:
+    struct entry
+    {
+        std::uint32_t group;
+        std::uint16_t port;
+    };
+    std::vector<entry> entries_;
+
+public:
+    ll_pcap_filter& add(std::uint32_t group, std::uint16_t port)
+    {
+        entries_.push_back({group, port});
+        return *this;
+    }
+
+    bool empty() const noexcept
+    {
+        return entries_.empty();
+    }
+
+    bool match(std::uint32_t dst_ip, std::uint16_t dst_port) const noexcept
+    {
+        if (entries_.empty()) return true;
+        for (const entry& e : entries_)
+            if ((e.group == 0 || e.group == dst_ip) && (e.port == 0 || e.port == dst_port)) return true;
+        return false;
+    }
+};
+
+namespace ll_pcap_detail
+{
+    inline constexpr std::uint32_t magic_us = 0xA1B2C3D4;
+    inline constexpr std::uint32_t magic_ns = 0xA1B23C4D;
+    inline constexpr std::uint32_t ng_shb = 0x0A0D0D0A;
+    inline constexpr std::uint32_t ng_idb = 0x00000001;
+    inline constexpr std::uint32_t ng_spb = 0x00000003;
+    inline constexpr std::uint32_t ng_epb = 0x00000006;
+    inline constexpr std::uint32_t ng_byte_order = 0x1A2B3C4D;
+
+    inline constexpr std::uint32_t link_ethernet = 1;
+    inline constexpr std::uint32_t link_raw = 101;
+    inline constexpr std::uint32_t link_sll = 113;
+    inline constexpr std::uint32_t link_ipv4 = 228;
+    inline constexpr std::uint32_t link_sll2 = 276;
+
+    template <typename T>
+    T load(const std::byte* p, bool swap) noexcept
+    {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        return swap ? std::byteswap(v) : v;
+    }
+
+    // network (big-endian) fields
+    template <typename T>
+    T load_be(const std::byte* p) noexcept
+    {
+        return load<T>(p, std::endian::native == std::endian::little);
+    }
+
+    __extension__ typedef unsigned __int128 u128;
+
+    // pcapng timestamp units of one interface
+    struct ng_clock
+    {
+        std::uint64_t ticks_per_sec;
+        std::uint64_t ns_per_tick; // 0 when a tick is not a whole number of ns
+
+        explicit ng_clock(std::uint64_t tps) noexcept
+            : ticks_per_sec(tps)
+            , ns_per_tick(1000000000u % tps == 0 ? 1000000000u / tps : 0)
+        {
+        }
+
+        std::uint64_t to_ns(std::uint64_t ticks) const noexcept
+        {
+            if (ns_per_tick) return ticks * ns_per_tick;
+            return static_cast<std::uint64_t>(static_cast<u128>(ticks) * 1000000000u / ticks_per_sec);
+        }
+    };
+
+    enum class udp_result
+    {
+        ok,
+        not_udp,
+        fragment,
+        malformed
+    };
+
+    inline udp_result parse_udp(const ll_pcap_frame& f, ll_udp_packet& out) noexcept
+    {
+        const std::byte* p = f.data.data();
+        std::size_t n = f.data.size();
+        std::uint16_t proto;
+
+        switch (f.linktype)
+        {
+        case link_ethernet:
+        {
+            if (n < 14) return udp_result::malformed;
+            std::size_t off = 12;
+            proto = load_be<std::uint16_t>(p + off);
+            while (proto == 0x8100 || proto == 0x88A8) // VLAN tags
+            {
+                off += 4;
+                if (n < off + 2) return udp_result::malformed;
+                proto = load_be<std::uint16_t>(p + off);
+            }
+            off += 2;
+            p += off;
+            n -= off;
+            break;
+        }
+        case link_sll:
+            if (n < 16) return udp_result::malformed;
+            proto = load_be<std::uint16_t>(p + 14);
+            p += 16;
+            n -= 16;
+            break;
+        case link_sll2:
+            if (n < 20) return udp_result::malformed;
+            proto = load_be<std::uint16_t>(p);
+            p += 20;
+            n -= 20;
+            break;
+        case link_raw:
+        case link_ipv4:
+            proto = n && (std::to_integer<unsigned>(p[0]) >> 4) == 4 ? 0x0800 : 0;
+            break;
+        default: return udp_result::not_udp;
+        }
+        if (proto != 0x0800) return udp_result::not_udp;
+
+        // IPv4
+        if (n < 20) return udp_result::malformed;
+        const unsigned vihl = std::to_integer<unsigned>(p[0]);
+        const std::size_t ihl = (vihl & 0x0F) * 4u;
+        if ((vihl >> 4) != 4 || ihl < 20 || n < ihl) return udp_result::malformed;
+        if (std::to_integer<unsigned>(p[9]) != 17) return udp_result::not_udp;
+        if (load_be<std::uint16_t>(p + 6) & 0x3FFF) return udp_result::fragment; // MF or offset
+        const std::size_t ip_len = load_be<std::uint16_t>(p + 2);
+        if (ip_len < ihl) return udp_result::malformed;
+        if (ip_len < n) n = ip_len; // drop Ethernet padding
+
+        out.src_ip = load_be<std::uint32_t>(p + 12);
+        out.dst_ip = load_be<std::uint32_t>(p + 16);
+        p += ihl;
+        n -= ihl;
+
+        // UDP
+        if (n < 8) return udp_result::malformed;
+        const std::size_t udp_len = load_be<std::uint16_t>(p + 4);
+        if (udp_len < 8) return udp_result::malformed;
+        out.src_port = load_be<std::uint16_t>(p);
+        out.dst_port = load_be<std::uint16_t>(p + 2);
+        const std::size_t len = udp_len - 8 < n - 8 ? udp_len - 8 : n - 8;
+        out.payload = {p + 8, len};
+        out.ts_ns = f.ts_ns;
+        return udp_result::ok;
+    }
+}
+
+class ll_pcap_reader
+{
+private:
+    ll_mmap_file map_;
+    ll_pcap_format format_;
+
+    const std::byte* base() const noexcept
+    {
+        return reinterpret_cast<const std::byte*>(map_.data());
+    }
+
+    template <typename F>
+    bool walk_pcap(F& f) const
+    {
+        using namespace ll_pcap_detail;
+        const std::byte* p = base();
+        const std::size_t n = map_.size();
+        const std::uint32_t raw_magic = load<std::uint32_t>(p, false);
+        const bool swap = raw_magic != magic_us && raw_magic != magic_ns;
+        const std::uint32_t magic = load<std::uint32_t>(p, swap);
+        const std::uint64_t frac_ns = magic == magic_ns ? 1 : 1000;
+        const std::uint32_t linktype = load<std::uint32_t>(p + 20, swap) & 0x0FFFFFFF;
+
+        std::size_t off = 24;
+        while (off < n)
+        {
+            if (n - off < 16) return false;
+            const std::uint32_t sec = load<std::uint32_t>(p + off, swap);
+            const std::uint32_t frac = load<std::uint32_t>(p + off + 4, swap);
+            const std::uint32_t incl = load<std::uint32_t>(p + off + 8, swap);
+            const std::uint32_t orig = load<std::uint32_t>(p + off + 12, swap);
+            off += 16;
+            if (n - off < incl) return false;
+            f(ll_pcap_frame{std::uint64_t{sec} * 1000000000u + frac * frac_ns, linktype, orig, {p + off, incl}});
+            off += incl;
+        }
+        return true;
+    }
+
+    template <typename F>
+    bool walk_pcapng(F& f) const
+    {
+        using namespace ll_pcap_detail;
+        struct interface
+        {
+            std::uint32_t linktype;
+            ng_clock clock;
+        };
+        std::vector<interface> ifs;
+        const std::byte* p = base();
+        const std::size_t n = map_.size();
+        bool swap = false;
+
+        std::size_t off = 0;
+        while (off < n)
+        {
+            if (n - off < 12) return false;
+            const std::uint32_t raw_type = load<std::uint32_t>(p + off, false);
+            if (raw_type == ng_shb) // new section: byte order and interfaces reset
+            {
+                swap = load<std::uint32_t>(p + off + 8, false) != ng_byte_order;
+                if (load<std::uint32_t>(p + off + 8, swap) != ng_byte_order) throw ll_pcap_error("ll_pcap: bad section header");
+                ifs.clear();
+            }
+            const std::uint32_t type = swap ? std::byteswap(raw_type) : raw_type;
+            const std::uint32_t len = load<std::uint32_t>(p + off + 4, swap);
+            if (len < 12 || (len & 3)) throw ll_pcap_error("ll_pcap: bad block length");
+            if (n - off < len) return false;
+            const std::byte* body = p + off + 8;
+            const std::size_t body_len = len - 12;
+
+            if (type == ng_idb && body_len >= 8)
+            {
+                interface itf{load<std::uint16_t>(body, swap), ng_clock(1000000)};
+                // options: u16 code, u16 length, value padded to 4
+                for (std::size_t o = 8; o + 4 <= body_len;)
+                {
+                    const std::uint16_t code = load<std::uint16_t>(body + o, swap);
+                    const std::uint16_t olen = load<std::uint16_t>(body + o + 2, swap);
+                    if (code == 0 || o + 4 + olen > body_len) break;
+                    if (code == 9 && olen >= 1) // if_tsresol
+                    {
+                        const unsigned r = std::to_integer<unsigned>(body[o + 4]);
+                        const unsigned e = r & 0x7F;
+                        if (e > ((r & 0x80) ? 63u : 19u)) throw ll_pcap_error("ll_pcap: unsupported timestamp resolution");
+                        std::uint64_t tps = 1;
+                        if (r & 0x80) tps <<= e;
+                        else for (unsigned i = 0; i < e; ++i) tps *= 10;
+                        itf.clock = ng_clock(tps);
+                    }
+                    o += 4 + ((olen + 3u) & ~3u);
+                }
+                ifs.push_back(itf);
+            }
+            else if (type == ng_epb && body_len >= 20)
+            {
+                const std::uint32_t id = load<std::uint32_t>(body, swap);
+                if (id >= ifs.size()) throw ll_pcap_error("ll_pcap: packet for unknown interface");
+                const std::uint64_t ticks = (std::uint64_t{load<std::uint32_t>(body + 4, swap)} << 32) |
+                                            load<std::uint32_t>(body + 8, swap);
+                std::uint32_t cap = load<std::uint32_t>(body + 12, swap);
+                const std::uint32_t orig = load<std::uint32_t>(body + 16, swap);
+                if (cap > body_len - 20) throw ll_pcap_error("ll_pcap: bad packet length");
+                f(ll_pcap_frame{ifs[id].clock.to_ns(ticks), ifs[id].linktype, orig, {body + 20, cap}});
+            }
+            else if (type == ng_spb && body_len >= 4)
+            {
+                if (ifs.empty()) throw ll_pcap_error("ll_pcap: packet for unknown interface");
+                const std::uint32_t orig = load<std::uint32_t>(body, swap);
+                const std::uint32_t cap = orig < body_len - 4 ? orig : static_cast<std::uint32_t>(body_len - 4);
+                f(ll_pcap_frame{0, ifs[0].linktype, orig, {body + 4, cap}}); // simple packets carry no timestamp
+            }
+            off += len;
+        }
+        return true;
+    }
+
+public:
+    explicit ll_pcap_reader(const char* path)
+        : map_(path)
+    {
+        using namespace ll_pcap_detail;
+        if (map_.size() < 24) throw ll_pcap_error("ll_pcap: file too small");
+        const std::uint32_t m = load<std::uint32_t>(base(), false);
+        if (m == magic_us || m == magic_ns || std::byteswap(m) == magic_us || std::byteswap(m) == magic_ns)
+            format_ = ll_pcap_format::pcap;
+        else if (m == ng_shb)
+            format_ = ll_pcap_format::pcapng;
+        else
+            throw ll_pcap_error("ll_pcap: not a pcap or pcapng file");
+        map_.advise(MADV_SEQUENTIAL);
+    }
+
+    ll_pcap_format format() const noexcept
+    {
+        return format_;
+    }
+    std::size_t bytes() const noexcept
+    {
+        return map_.size();
+    }
+
+    // f(const ll_pcap_frame&) for every captured frame; false if the file ends mid-record
+    template <typename F>
+    bool for_each_frame(F&& f) const
+    {
+        return format_ == ll_pcap_format::pcap ? walk_pcap(f) : walk_pcapng(f);
+    }
+
+    // f(const ll_udp_packet&) for every IPv4/UDP packet accepted by the filter
+    template <typename F>
+    ll_pcap_stats for_each_udp(F&& f, const ll_pcap_filter& filter = {}) const
+    {
+        using ll_pcap_detail::udp_result;
+        ll_pcap_stats st;
+        ll_udp_packet pkt;
+        st.truncated = !for_each_frame([&](const ll_pcap_frame& fr)
+        {
+            ++st.frames;
+            switch (ll_pcap_detail::parse_udp(fr, pkt))
+            {
+            case udp_result::ok:
+                ++st.udp;
+                if (filter.match(pkt.dst_ip, pkt.dst_port))
+                {
+                    ++st.matched;
+                    f(static_cast<const ll_udp_packet&>(pkt));
+                }
+                break;
+            case udp_result::not_udp: ++st.non_udp; break;
+            case udp_result::fragment: ++st.fragments; break;
+            case udp_result::malformed: ++st.malformed; break;
+            }
+        });
+        return st;
+    }
+};
+
+// Framing: MoldUDP64
+//   header : session[10]  u64 sequence  u16 count   (big-endian)
+//   block  : u16 length   message[length]           x count
+// count 0 is a heartbeat, 0xFFFF marks end of session.
+
+struct ll_moldudp64_header
+{
+    std::string_view session;
+    std::uint64_t seq;    // sequence number of the first message
+    std::uint16_t count;
+};
+
+inline constexpr std::size_t ll_moldudp64_header_size = 20;
+
+// f(std::uint64_t seq, std::span<const std::byte> msg) per message; false if malformed
+template <typename F>
+bool ll_moldudp64_for_each(std::span<const std::byte> pkt, F&& f, ll_moldudp64_header* hdr = nullptr)
+{
+    using ll_pcap_detail::load_be;
+    if (pkt.size() < ll_moldudp64_header_size) return false;
+    const std::byte* p = pkt.data();
+    const std::uint64_t seq = load_be<std::uint64_t>(p + 10);
+    const std::uint16_t count = load_be<std::uint16_t>(p + 18);
+    if (hdr) *hdr = {std::string_view(reinterpret_cast<const char*>(p), 10), seq, count};
+    if (count == 0xFFFF) return true;
+
+    std::size_t off = ll_moldudp64_header_size;
+    for (std::uint16_t i = 0; i < count; ++i)
+    {
+        if (pkt.size() - off < 2) return false;
+        const std::size_t len = load_be<std::uint16_t>(p + off);
+        off += 2;
+        if (pkt.size() - off < len) return false;
+        f(seq + i, pkt.subspan(off, len));
+        off += len;
+    }
+    return true;
+}
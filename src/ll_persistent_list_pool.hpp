@@ -0,0 +1,424 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ll_mmap_file.hpp"
+
+/*
+ *Persistent List + Pool
+ * ll_list_pool whose slab lives in a memory-mapped file, so the list is
+ * still there after a restart, with no replay:
+ * - file = one 4 KiB header page + node slab. Node 0 is the sentinel, so
+ *   head and tail live in the file with everything else
+ * - links are 32-bit node indices (slab offset / sizeof(node)), not
+ *   pointers: the file maps correctly at any address. Indices also serve
+ *   as handles that stay valid across restarts (iterator::index, at())
+ * - T must be trivially copyable: its bytes are the persistent state
+ *
+ * Consistency header: magic, version, layout (node and value size and
+ * alignment), capacity, size, free-list head, checkpoint generation and a
+ * clean flag.
+ * - checkpoint(): msync the slab, then set clean and msync the header
+ * - the first mutation after a checkpoint clears clean and msyncs that one
+ *   page before any node is written, so a clean header on disk always
+ *   describes the nodes on disk
+ * - the destructor checkpoints, so a normal shutdown leaves a clean file
+ *
+ * Open: a clean file is ready in O(1). A dirty one (crash since the last
+ * checkpoint) is recovered in one O(capacity) pass: walk the next chain
+ * from the sentinel (range and cycle checked), rebuild prev links and
+ * size, and rebuild the free list from every node not on the list.
+ * - process crash: the mapping is MAP_SHARED, so every completed store is
+ *   already in the page cache. Only the operation in flight can be lost;
+ *   its node is reported as an orphan
+ * - OS crash / power loss: changes since the last checkpoint may be lost
+ *   or torn, and recovery still yields a well-formed list
+ */
+
+struct ll_persistent_open_info
+{
+    bool created = false;   // new file
+    bool was_clean = true;  // opened straight from a checkpoint, no recovery needed
+    bool truncated = false; // recovery found a broken link and cut the list there
+    std::size_t orphans = 0; // nodes on neither the list nor the free list (operation in flight)
+};
+
+template <typename T>
+class ll_persistent_list_pool
+{
+    static_assert(std::is_trivially_copyable_v<T>, "ll_persistent_list_pool: T is stored as raw bytes");
+
+public:
+    using index_type = std::uint32_t;
+
+private:
+    struct node
+    {
+        index_type prev;
+        index_type next;
+        T value;
+    };
+
+    struct header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t node_size;
+        std::uint32_t value_size;
+        std::uint32_t value_align;
+        std::uint64_t capacity;
+        std::uint64_t size;
+        std::uint64_t generation; // completed checkpoints
+        index_type free_head;     // 0 = exhausted (node 0 is the sentinel, never free)
+        std::uint32_t clean;      // 1: the nodes on disk match this header
+    };
+
+    static constexpr std::size_t header_bytes = 4096;
+    static constexpr char file_magic[8] = {'L', 'L', 'P', 'O', 'O', 'L', '\0', '\1'};
+    static constexpr std::uint32_t file_version = 1;
+    static_assert(sizeof(header) <= header_bytes && alignof(node) <= header_bytes);
+
+    ll_mmap_file file_;
+    header* hdr_;
+    node* slab_; // slab_[0] = sentinel
+    ll_persistent_open_info info_;
+
+    static std::size_t file_bytes(std::size_t capacity) noexcept
+    {
+        return header_bytes + (capacity + 1) * sizeof(node);
+    }
+
+    // argument checks before the file is opened (create truncates)
+    static ll_mmap_mode checked_mode(ll_mmap_mode mode, std::size_t capacity)
+    {
+        if (mode == ll_mmap_mode::read_only)
+            throw std::invalid_argument("ll_persistent_list_pool: read_only mapping is not supported");
+        if (mode == ll_mmap_mode::create && (capacity == 0 || capacity >= std::numeric_limits<index_type>::max()))
+            throw std::length_error("ll_persistent_list_pool: bad capacity");
+        return mode;
+    }
+
+    // before the first write after a checkpoint: make "dirty" durable first
+    void touch()
+    {
+        if (hdr_->clean) [[unlikely]]
+        {
+            hdr_->clean = 0;
+            file_.sync_range(0, header_bytes);
+        }
+    }
+
+    // link x between a and b: a <-> x <-> b; x's own links first, so the
+    // next chain only ever points at a fully linked node
+    void link_between(index_type x, index_type a, index_type b) noexcept
+    {
+        slab_[x].prev = a;
+        slab_[x].next = b;
+        slab_[a].next = x;
+        slab_[b].prev = x;
+    }
+
+    void unlink(index_type x) noexcept
+    {
+        slab_[slab_[x].prev].next = slab_[x].next;
+        slab_[slab_[x].next].prev = slab_[x].prev;
+    }
+
+    index_type alloc_node()
+    {
+        const index_type n = hdr_->free_head;
+        if (n == 0) throw std::bad_alloc();
+        hdr_->free_head = slab_[n].next;
+        return n;
+    }
+
+    void free_node(index_type n) noexcept
+    {
+        slab_[n].next = hdr_->free_head;
+        hdr_->free_head = n;
+    }
+
+    void recover()
+    {
+        const std::size_t cap = static_cast<std::size_t>(hdr_->capacity);
+        std::vector<std::uint8_t> seen(cap + 1, 0); // 1 = on the list, 2 = on the old free list
+
+        // the next chain is authoritative: prev links and size follow from it
+        index_type prev = 0;
+        std::size_t n = 0;
+        for (index_type cur = slab_[0].next; cur != 0; cur = slab_[cur].next)
+        {
+            if (cur > cap || seen[cur])
+            {
+                info_.truncated = true;
+                break;
+            }
+            seen[cur] = 1;
+            slab_[cur].prev = prev;
+            prev = cur;
+            ++n;
+        }
+        slab_[prev].next = 0;
+        slab_[0].prev = prev;
+
+        std::size_t on_free = 0;
+        for (index_type cur = hdr_->free_head; cur != 0 && cur <= cap && !seen[cur]; cur = slab_[cur].next)
+        {
+            seen[cur] = 2;
+            ++on_free;
+        }
+        info_.orphans = cap - n - on_free;
+
+        // every node not on the list is free, ascending
+        index_type head = 0;
+        for (std::size_t i = cap; i >= 1; --i)
+            if (seen[i] != 1)
+            {
+                slab_[i].next = head;
+                head = static_cast<index_type>(i);
+            }
+        hdr_->free_head = head;
+        hdr_->size = n;
+        checkpoint();
+    }
+
+public:
+// Iterator - a node index plus the slab it indexes
+    class iterator
+    {
+        friend class ll_persistent_list_pool;
+        node* slab_;
+        index_type i_;
+        iterator(node* s, index_type i) noexcept : slab_(s), i_(i) {}
+        public:
+        iterator() noexcept : slab_(nullptr), i_(0) {}
+        T& operator*() const noexcept
+        {
+            return slab_[i_].value;
+        }
+        T* operator->() const noexcept
+        {
+            return &slab_[i_].value;
+        }
+        iterator& operator++() noexcept
+        {
+            i_ = slab_[i_].next;
+            return *this;
+        }
+        iterator& operator--() noexcept
+        {
+            i_ = slab_[i_].prev;
+            return *this;
+        }
+        // stable across restarts: a handle to persist alongside the element
+        index_type index() const noexcept
+        {
+            return i_;
+        }
+
+        bool operator==(const iterator& o) const noexcept
+        {
+            return i_ == o.i_;
+        }
+        bool operator!=(const iterator& o) const noexcept
+        {
+            return i_ != o.i_;
+        }
+    };
+
+public:
+// Construction/Destruction
+    // create: new file holding capacity nodes (truncates an existing one)
+    // read_write: reopen; capacity is ignored, recovery runs if the file is dirty
+    ll_persistent_list_pool(const char* path, ll_mmap_mode mode, std::size_t capacity = 0)
+        : file_(path, checked_mode(mode, capacity), mode == ll_mmap_mode::create ? file_bytes(capacity) : 0)
+        , hdr_(nullptr)
+        , slab_(nullptr)
+    {
+        if (file_.size() < header_bytes) throw std::runtime_error("ll_persistent_list_pool: file too small");
+        hdr_ = reinterpret_cast<header*>(file_.data());
+        slab_ = reinterpret_cast<node*>(file_.data() + header_bytes);
+
+        if (mode == ll_mmap_mode::create)
+        {
+            info_.created = true;
+            std::memcpy(hdr_->magic, file_magic, sizeof file_magic);
+            hdr_->version = file_version;
+            hdr_->node_size = sizeof(node);
+            hdr_->value_size = sizeof(T);
+            hdr_->value_align = alignof(T);
+            hdr_->capacity = capacity;
+            hdr_->size = 0;
+            hdr_->generation = 0;
+            hdr_->clean = 0;
+            slab_[0].prev = slab_[0].next = 0;
+            for (std::size_t i = 1; i <= capacity; ++i)
+                slab_[i].next = static_cast<index_type>(i == capacity ? 0 : i + 1);
+            hdr_->free_head = 1;
+            checkpoint();
+            return;
+        }
+
+        if (std::memcmp(hdr_->magic, file_magic, sizeof file_magic) != 0 || hdr_->version != file_version)
+            throw std::runtime_error("ll_persistent_list_pool: not a pool file");
+        if (hdr_->node_size != sizeof(node) || hdr_->value_size != sizeof(T) || hdr_->value_align != alignof(T))
+            throw std::runtime_error("ll_persistent_list_pool: element layout differs from the file");
+        if (hdr_->capacity >= std::numeric_limits<index_type>::max() ||
+            file_.size() != file_bytes(static_cast<std::size_t>(hdr_->capacity)))
+            throw std::runtime_error("ll_persistent_list_pool: file size does not match its header");
+        info_.was_clean = hdr_->clean != 0;
+        if (!info_.was_clean) recover();
+    }
+
+    ll_persistent_list_pool(const ll_persistent_list_pool&) = delete;
+    ll_persistent_list_pool& operator=(const ll_persistent_list_pool&) = delete;
+
+    ~ll_persistent_list_pool()
+    {
+        try
+        {
+            checkpoint();
+        }
+        catch (...)
+        {
+            // left dirty: the next open recovers
+        }
+    }
+
+// Durability
+    // make the current state durable and mark the file clean; a no-op when
+    // nothing changed since the last checkpoint
+    void checkpoint()
+    {
+        if (hdr_->clean) return;
+        file_.sync_range(header_bytes, file_.size() - header_bytes);
+        hdr_->clean = 1;
+        ++hdr_->generation;
+        file_.sync_range(0, header_bytes);
+    }
+
+    std::uint64_t generation() const noexcept
+    {
+        return hdr_->generation;
+    }
+    const ll_persistent_open_info& open_info() const noexcept
+    {
+        return info_;
+    }
+
+// Basic properties
+
+    bool empty() const noexcept
+    {
+        return hdr_->size == 0;
+    }
+    std::size_t size() const noexcept
+    {
+        return static_cast<std::size_t>(hdr_->size);
+    }
+    std::size_t capacity() const noexcept
+    {
+        return static_cast<std::size_t>(hdr_->capacity);
+    }
+    iterator begin() noexcept
+    {
+        return iterator(slab_, slab_[0].next);
+    }
+    iterator end() noexcept
+    {
+        return iterator(slab_, 0);
+    }
+    // iterator for a handle from iterator::index(); must name a live element
+    iterator at(index_type i) noexcept
+    {
+        return iterator(slab_, i);
+    }
+
+// Clear list
+
+    void clear()
+    {
+        touch();
+        for (index_type cur = slab_[0].next; cur != 0;)
+        {
+            const index_type next = slab_[cur].next;
+            free_node(cur);
+            cur = next;
+        }
+        slab_[0].prev = slab_[0].next = 0;
+        hdr_->size = 0;
+    }
+
+// Emplacement
+    template <typename... Args>
+    iterator emplace_front(Args&&... args)
+    {
+        touch();
+        const index_type n = alloc_node();
+        ::new (&slab_[n].value) T(std::forward<Args>(args)...);
+        link_between(n, 0, slab_[0].next);
+        ++hdr_->size;
+        return iterator(slab_, n);
+    }
+
+    template <typename... Args>
+    iterator emplace_back(Args&&... args)
+    {
+        touch();
+        const index_type n = alloc_node();
+        ::new (&slab_[n].value) T(std::forward<Args>(args)...);
+        link_between(n, slab_[0].prev, 0);
+        ++hdr_->size;
+        return iterator(slab_, n);
+    }
+
+// Erase
+    iterator erase(iterator it)
+    {
+        touch();
+        const index_type n = it.i_;
+        const index_type next = slab_[n].next;
+        unlink(n);
+        free_node(n);
+        --hdr_->size;
+        return iterator(slab_, next);
+    }
+
+// Splice
+    // moves node 'what' before 'pos'
+    void splice(iterator pos, iterator what)
+    {
+        const index_type x = what.i_;
+        if (x == pos.i_) return;
+        touch();
+        unlink(x);
+        link_between(x, slab_[pos.i_].prev, pos.i_);
+    }
+
+    // splice range [first, last) before pos
+    void splice(iterator pos, iterator first, iterator last)
+    {
+        const index_type a = first.i_, b = last.i_;
+        if (a == b) return;
+        touch();
+        const index_type tail = slab_[b].prev;
+
+        // detach [a, tail]
+        slab_[slab_[a].prev].next = b;
+        slab_[b].prev = slab_[a].prev;
+
+        // attach before pos
+        const index_type before = slab_[pos.i_].prev;
+        slab_[a].prev = before;
+        slab_[tail].next = pos.i_;
+        slab_[before].next = a;
+        slab_[pos.i_].prev = tail;
+    }
+};
@@ -0,0 +1,508 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "ll_hash.hpp"
+
+/*
+ *Fast Random Numbers for Benchmarks and Simulations
+ * Generators and samplers cheap enough to sit next to the code being
+ * measured, or to pregenerate whole index streams outside the timed
+ * region. Not cryptographic.
+ * - ll_xoshiro256pp : xoshiro256++ (Blackman / Vigna), 256-bit state,
+ *   jump() for 2^128 non-overlapping streams of 2^128 values each; a
+ *   UniformRandomBitGenerator
+ * - ll_wyrand       : 64-bit state, one 64x64->128 multiply per value
+ * - ll_xoshiro256pp_x8 : 8 xoshiro256++ lanes (lane i = seed jumped i
+ *   times) stepped together with AVX-512 / AVX2 / scalar, chosen at
+ *   compile time from -march; fill(), fill_below(), fill_unit()
+ * - ll_uniform_below : Lemire's nearly divisionless bounded integers
+ *   (multiply-shift, a division only on the rare rejection path)
+ * - ll_alias_sampler : Walker / Vose alias method, any discrete
+ *   distribution, O(1) per sample from one 64-bit draw
+ * - ll_zipf_sampler  : Zipf(n, s) by rejection-inversion (Hörmann /
+ *   Derflinger), no table, any n
+ * - ll_uniform_indices / ll_sampled_indices : pregenerated index streams
+ */
+
+namespace ll_random_detail
+{
+
+__extension__ typedef unsigned __int128 u128;
+
+inline std::uint64_t splitmix_next(std::uint64_t& s) noexcept
+{
+    s += 0x9e3779b97f4a7c15ull;
+    return ll_mix64(s);
+}
+
+} // namespace ll_random_detail
+
+// Generators
+
+class ll_xoshiro256pp
+{
+private:
+    friend class ll_xoshiro256pp_x8;
+    std::uint64_t s_[4];
+
+public:
+    using result_type = std::uint64_t;
+
+    // the 256-bit state is expanded from the seed with splitmix64, so
+    // nearby seeds give unrelated streams and the state is never all zero
+    explicit ll_xoshiro256pp(std::uint64_t seed = 0x5eedull) noexcept
+    {
+        for (std::uint64_t& w : s_) w = ll_random_detail::splitmix_next(seed);
+    }
+
+    static constexpr result_type min() noexcept
+    {
+        return 0;
+    }
+    static constexpr result_type max() noexcept
+    {
+        return ~result_type{0};
+    }
+
+    result_type operator()() noexcept
+    {
+        const std::uint64_t r = std::rotl(s_[0] + s_[3], 23) + s_[0];
+        const std::uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = std::rotl(s_[3], 45);
+        return r;
+    }
+
+    // advances 2^128 steps: gives a stream that cannot overlap this one
+    void jump() noexcept
+    {
+        static constexpr std::uint64_t poly[4] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+                                                  0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+        std::uint64_t j[4] = {0, 0, 0, 0};
+        for (std::uint64_t p : poly)
+            for (int b = 0; b < 64; ++b)
+            {
+                if (p & (std::uint64_t{1} << b))
+                    for (int k = 0; k < 4; ++k) j[k] ^= s_[k];
+                (*this)();
+            }
+        std::memcpy(s_, j, sizeof(s_));
+    }
+};
+
+class ll_wyrand
+{
+private:
+    std::uint64_t s_;
+
+public:
+    using result_type = std::uint64_t;
+
+    explicit ll_wyrand(std::uint64_t seed = 0x5eedull) noexcept : s_(seed) {}
+
+    static constexpr result_type min() noexcept
+    {
+        return 0;
+    }
+    static constexpr result_type max() noexcept
+    {
+        return ~result_type{0};
+    }
+
+    // counter plus one multiply-fold: no dependency between outputs other
+    // than the add, so a loop of calls pipelines well
+    result_type operator()() noexcept
+    {
+        s_ += ll_hash_detail::k0;
+        return ll_hash_detail::mum(s_, s_ ^ ll_hash_detail::k1);
+    }
+};
+
+// Bounded integers and unit doubles
+
+// [0, range), range > 0, unbiased. Multiply-shift maps x to x * range >> 64;
+// only the low product word below 2^64 mod range is rejected, and that
+// threshold (the one division) is computed only when the low word is
+// small enough for it to matter
+template <typename G>
+std::uint64_t ll_uniform_below(G& g, std::uint64_t range)
+{
+    using ll_random_detail::u128;
+    u128 m = static_cast<u128>(g()) * range;
+    std::uint64_t low = static_cast<std::uint64_t>(m);
+    if (low < range) [[unlikely]]
+    {
+        const std::uint64_t t = (0 - range) % range;
+        while (low < t)
+        {
+            m = static_cast<u128>(g()) * range;
+            low = static_cast<std::uint64_t>(m);
+        }
+    }
+    return static_cast<std::uint64_t>(m >> 64);
+}
+
+// [0, 1) with 53 random bits
+inline double ll_unit_double(std::uint64_t x) noexcept
+{
+    return static_cast<double>(x >> 11) * 0x1.0p-53;
+}
+
+// Batch generator
+
+class ll_xoshiro256pp_x8
+{
+private:
+    // state word k of lane i at s_[k][i]
+    alignas(64) std::uint64_t s_[4][8];
+
+#if defined(__AVX512F__)
+    // maskz forms: the plain ones trip GCC 12's -Wmaybe-uninitialized
+    static __m512i step(__m512i& s0, __m512i& s1, __m512i& s2, __m512i& s3) noexcept
+    {
+        const __m512i r = _mm512_add_epi64(_mm512_maskz_rol_epi64(0xFF, _mm512_add_epi64(s0, s3), 23), s0);
+        const __m512i t = _mm512_maskz_slli_epi64(0xFF, s1, 17);
+        s2 = _mm512_xor_si512(s2, s0);
+        s3 = _mm512_xor_si512(s3, s1);
+        s1 = _mm512_xor_si512(s1, s2);
+        s0 = _mm512_xor_si512(s0, s3);
+        s2 = _mm512_xor_si512(s2, t);
+        s3 = _mm512_maskz_rol_epi64(0xFF, s3, 45);
+        return r;
+    }
+#elif defined(__AVX2__)
+    template <int K>
+    static __m256i rotl(__m256i x) noexcept
+    {
+        return _mm256_or_si256(_mm256_slli_epi64(x, K), _mm256_srli_epi64(x, 64 - K));
+    }
+
+    static __m256i step(__m256i& s0, __m256i& s1, __m256i& s2, __m256i& s3) noexcept
+    {
+        const __m256i r = _mm256_add_epi64(rotl<23>(_mm256_add_epi64(s0, s3)), s0);
+        const __m256i t = _mm256_slli_epi64(s1, 17);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = rotl<45>(s3);
+        return r;
+    }
+#endif
+
+public:
+    static constexpr std::size_t lanes = 8;
+
+    explicit ll_xoshiro256pp_x8(std::uint64_t seed = 0x5eedull) noexcept
+    {
+        ll_xoshiro256pp g(seed);
+        for (std::size_t i = 0; i < lanes; ++i)
+        {
+            for (int k = 0; k < 4; ++k) s_[k][i] = g.s_[k];
+            g.jump();
+        }
+    }
+
+    // n values; lane i supplies out[i], out[i + 8], ... A partial last
+    // block still advances every lane and drops the unused values, so
+    // splitting one stream across calls is reproducible only in blocks of 8
+    void fill(std::uint64_t* out, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+#if defined(__AVX512F__)
+        __m512i s0 = _mm512_load_si512(s_[0]);
+        __m512i s1 = _mm512_load_si512(s_[1]);
+        __m512i s2 = _mm512_load_si512(s_[2]);
+        __m512i s3 = _mm512_load_si512(s_[3]);
+        for (; i + lanes <= n; i += lanes) _mm512_storeu_si512(out + i, step(s0, s1, s2, s3));
+        if (i < n)
+        {
+            alignas(64) std::uint64_t tail[lanes];
+            _mm512_store_si512(tail, step(s0, s1, s2, s3));
+            std::memcpy(out + i, tail, (n - i) * sizeof(std::uint64_t));
+        }
+        _mm512_store_si512(s_[0], s0);
+        _mm512_store_si512(s_[1], s1);
+        _mm512_store_si512(s_[2], s2);
+        _mm512_store_si512(s_[3], s3);
+#elif defined(__AVX2__)
+        __m256i a0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_[0]));
+        __m256i a1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_[1]));
+        __m256i a2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_[2]));
+        __m256i a3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_[3]));
+        __m256i b0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_[0] + 4));
+        __m256i b1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_[1] + 4));
+        __m256i b2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_[2] + 4));
+        __m256i b3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_[3] + 4));
+        for (; i < n; i += lanes)
+        {
+            alignas(32) std::uint64_t block[lanes];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(block), step(a0, a1, a2, a3));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(block + 4), step(b0, b1, b2, b3));
+            std::memcpy(out + i, block, (n - i < lanes ? n - i : lanes) * sizeof(std::uint64_t));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(s_[0]), a0);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(s_[1]), a1);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(s_[2]), a2);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(s_[3]), a3);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(s_[0] + 4), b0);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(s_[1] + 4), b1);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(s_[2] + 4), b2);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(s_[3] + 4), b3);
+#else
+        for (; i < n; i += lanes)
+        {
+            std::uint64_t block[lanes];
+            for (std::size_t l = 0; l < lanes; ++l)
+            {
+                block[l] = std::rotl(s_[0][l] + s_[3][l], 23) + s_[0][l];
+                const std::uint64_t t = s_[1][l] << 17;
+                s_[2][l] ^= s_[0][l];
+                s_[3][l] ^= s_[1][l];
+                s_[1][l] ^= s_[2][l];
+                s_[0][l] ^= s_[3][l];
+                s_[2][l] ^= t;
+                s_[3][l] = std::rotl(s_[3][l], 45);
+            }
+            std::memcpy(out + i, block, (n - i < lanes ? n - i : lanes) * sizeof(std::uint64_t));
+        }
+#endif
+    }
+
+    // n values uniform in [0, range), range > 0, unbiased: Lemire's
+    // multiply-shift on each 32-bit half of a 64-bit draw. The rejection
+    // threshold is one division per call; rejected halves (probability
+    // < range / 2^32) are dropped by a branchless compaction through a
+    // staging block and made up from further draws
+    void fill_below(std::uint32_t* out, std::size_t n, std::uint32_t range) noexcept
+    {
+        const std::uint32_t t = (0u - range) % range;
+        std::uint64_t raw[256];
+        std::uint32_t keep[512];
+        std::size_t i = 0;
+        while (i < n)
+        {
+            const std::size_t left = n - i;
+            const std::size_t k = left < 512 ? (left + 2 * lanes - 1) / (2 * lanes) * lanes : 256;
+            fill(raw, k);
+            std::size_t m = 0;
+            for (std::size_t j = 0; j < k; ++j)
+            {
+                const std::uint64_t lo = static_cast<std::uint32_t>(raw[j]) * static_cast<std::uint64_t>(range);
+                const std::uint64_t hi = (raw[j] >> 32) * static_cast<std::uint64_t>(range);
+                keep[m] = static_cast<std::uint32_t>(lo >> 32);
+                m += static_cast<std::uint32_t>(lo) >= t;
+                keep[m] = static_cast<std::uint32_t>(hi >> 32);
+                m += static_cast<std::uint32_t>(hi) >= t;
+            }
+            if (m > left) m = left;
+            std::memcpy(out + i, keep, m * sizeof(std::uint32_t));
+            i += m;
+        }
+    }
+
+    // n doubles in [0, 1) with 53 random bits each
+    void fill_unit(double* out, std::size_t n) noexcept
+    {
+        std::uint64_t raw[256];
+        for (std::size_t i = 0; i < n; i += 256)
+        {
+            const std::size_t k = n - i < 256 ? n - i : 256;
+            fill(raw, k);
+            for (std::size_t j = 0; j < k; ++j) out[i + j] = ll_unit_double(raw[j]);
+        }
+    }
+};
+
+// Samplers
+
+class ll_alias_sampler
+{
+private:
+    // one entry per outcome: keep i if the low draw word < cut, else alias
+    struct column
+    {
+        std::uint32_t cut;
+        std::uint32_t alias;
+    };
+    std::vector<column> table_;
+
+public:
+    // weights >= 0, not all zero, fewer than 2^32 of them;
+    // std::invalid_argument otherwise. O(n) (Vose)
+    explicit ll_alias_sampler(std::span<const double> weights)
+    {
+        const std::size_t n = weights.size();
+        if (n == 0 || n > 0xFFFFFFFFull) throw std::invalid_argument("ll_alias_sampler: need 1 .. 2^32-1 weights");
+        double sum = 0.0;
+        for (double w : weights)
+        {
+            if (!(w >= 0.0) || !std::isfinite(w)) throw std::invalid_argument("ll_alias_sampler: bad weight");
+            sum += w;
+        }
+        if (!(sum > 0.0)) throw std::invalid_argument("ll_alias_sampler: weights sum to zero");
+
+        // scaled so the average column holds exactly 1
+        std::vector<double> p(n);
+        std::vector<std::uint32_t> small, large;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            p[i] = weights[i] * static_cast<double>(n) / sum;
+            (p[i] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+        }
+        table_.resize(n);
+        while (!small.empty() && !large.empty())
+        {
+            const std::uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+            table_[s] = {static_cast<std::uint32_t>(p[s] * 4294967296.0), l};
+            p[l] -= 1.0 - p[s];
+            if (p[l] < 1.0)
+            {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // leftovers are 1 up to rounding: always keep
+        for (std::uint32_t i : large) table_[i] = {0xFFFFFFFFu, i};
+        for (std::uint32_t i : small) table_[i] = {0xFFFFFFFFu, i};
+    }
+
+    std::size_t size() const noexcept
+    {
+        return table_.size();
+    }
+
+    // column from the high 32 bits (multiply-shift: each column's chance
+    // is within n / 2^32 of 1/n, relative), coin from the low 32 bits
+    std::uint32_t sample(std::uint64_t x) const noexcept
+    {
+        const std::uint64_t col = ((x >> 32) * table_.size()) >> 32;
+        const column c = table_[col];
+        return static_cast<std::uint32_t>(x) < c.cut ? static_cast<std::uint32_t>(col) : c.alias;
+    }
+
+    template <typename G>
+    std::uint32_t operator()(G& g) const noexcept(noexcept(g()))
+    {
+        return sample(g());
+    }
+};
+
+// weights 1 / (k + 1)^s for ranks k = 0 .. n-1, e.g. for ll_alias_sampler
+inline std::vector<double> ll_zipf_weights(std::size_t n, double s)
+{
+    std::vector<double> w(n);
+    for (std::size_t k = 0; k < n; ++k) w[k] = std::pow(static_cast<double>(k + 1), -s);
+    return w;
+}
+
+// Zipf over ranks 0 .. n-1 with P(k) ~ 1 / (k + 1)^s, s > 0, by
+// rejection-inversion: invert the integral of the hat x^-s, accept when
+// the point lands under the histogram step. No table, so any n; about one
+// log and one exp per sample, and few rejections (< 10% for s >= 0.5)
+class ll_zipf_sampler
+{
+private:
+    double n_;
+    double s_;
+    double h_x1_;    // H(1.5) - 1
+    double h_n_;     // H(n + 0.5)
+    double accept_;  // k - x <= accept_ is inside the step without the test
+
+    // log1p(x) / x and expm1(x) / x, with their series near 0
+    static double helper1(double x) noexcept
+    {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+    static double helper2(double x) noexcept
+    {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+    }
+
+    double h(double x) const noexcept
+    {
+        return std::exp(-s_ * std::log(x));
+    }
+    double big_h(double x) const noexcept
+    {
+        const double lx = std::log(x);
+        return helper2((1.0 - s_) * lx) * lx;
+    }
+    double big_h_inv(double x) const noexcept
+    {
+        double t = x * (1.0 - s_);
+        if (t < -1.0) t = -1.0;
+        return std::exp(helper1(t) * x);
+    }
+
+public:
+    // std::invalid_argument unless n >= 1 and s > 0
+    ll_zipf_sampler(std::uint64_t n, double s)
+        : n_(static_cast<double>(n))
+        , s_(s)
+    {
+        if (n == 0 || !(s > 0.0)) throw std::invalid_argument("ll_zipf_sampler: need n >= 1, s > 0");
+        h_x1_ = big_h(1.5) - 1.0;
+        h_n_ = big_h(n_ + 0.5);
+        accept_ = 2.0 - big_h_inv(big_h(2.5) - h(2.0));
+    }
+
+    // takes uniform [0, 1) doubles from next_unit(), usually one
+    template <typename U>
+    std::uint64_t sample(U&& next_unit) const
+    {
+        for (;;)
+        {
+            const double u = h_n_ + next_unit() * (h_x1_ - h_n_);
+            const double x = big_h_inv(u);
+            double k = std::floor(x + 0.5);
+            if (k < 1.0) k = 1.0;
+            else if (k > n_) k = n_;
+            if (k - x <= accept_ || u >= big_h(k + 0.5) - h(k)) return static_cast<std::uint64_t>(k) - 1;
+        }
+    }
+
+    template <typename G>
+    std::uint64_t operator()(G& g) const
+    {
+        return sample([&g] { return ll_unit_double(g()); });
+    }
+};
+
+// Pregenerated index streams: draw every index before the timed region,
+// so the loop under test pays one sequential load per index instead of
+// the generator
+
+inline std::vector<std::uint32_t> ll_uniform_indices(std::size_t n, std::uint32_t range, std::uint64_t seed)
+{
+    std::vector<std::uint32_t> v(n);
+    ll_xoshiro256pp_x8 g(seed);
+    g.fill_below(v.data(), n, range);
+    return v;
+}
+
+template <typename Sampler>
+std::vector<std::uint32_t> ll_sampled_indices(std::size_t n, const Sampler& sampler, std::uint64_t seed)
+{
+    std::vector<std::uint32_t> v(n);
+    ll_xoshiro256pp g(seed);
+    for (std::uint32_t& x : v) x = static_cast<std::uint32_t>(sampler(g));
+    return v;
+}
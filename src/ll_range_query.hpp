@@ -0,0 +1,349 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/*
+ *Range Queries: Fenwick Tree, Lazy Segment Tree, Sparse Table
+ * Implicit (pointer-free) array layouts, templated on a monoid:
+ *
+ *   struct Monoid {
+ *       using value_type = T;
+ *       static T identity();
+ *       static T op(T, T);              // associative
+ *       static T inverse(T);            // optional: enables Fenwick range()
+ *       static constexpr bool idempotent; // op(x, x) == x: min, max, gcd
+ *   };
+ * ll_sum_monoid, ll_min_monoid, ll_max_monoid are provided.
+ *
+ * - ll_fenwick<M> : n + 1 slots; point update and prefix query in
+ *   O(log n), range() when M has an inverse, O(n) build, lower_bound on
+ *   prefix sums (e.g. the price level where cumulative volume reaches X)
+ * - ll_lazy_segment_tree<M, A> : iterative bottom-up tree (leaves at
+ *   [size, 2 size), no recursion), range update / range query in O(log n)
+ *   with lazy tags pushed only along the two boundary paths. A is the
+ *   update action:
+ *     struct Action {
+ *         using value_type = F;
+ *         static F identity();
+ *         static F compose(F f, F g);    // f applied after g
+ *         static T apply(F f, T x, std::size_t len); // len = leaves under x
+ *     };
+ *   ll_range_add<M> adds a constant (sum: x + f len; min / max: x + f,
+ *   identity left as is)
+ * - ll_sparse_table<M> : static O(1) query for idempotent monoids (RMQ);
+ *   levels stored back to back, level k holding op over [i, i + 2^k);
+ *   each level is built by one vectorisable pass over the previous one.
+ *   n log n values: 10^8 int32 would need ~10 GB, size accordingly
+ */
+
+template <typename T>
+struct ll_sum_monoid
+{
+    using value_type = T;
+    static constexpr bool idempotent = false;
+    static constexpr T identity() noexcept { return T{}; }
+    static constexpr T op(T a, T b) noexcept { return a + b; }
+    static constexpr T inverse(T a) noexcept { return -a; }
+};
+
+template <typename T>
+struct ll_min_monoid
+{
+    using value_type = T;
+    static constexpr bool idempotent = true;
+    static constexpr T identity() noexcept { return std::numeric_limits<T>::max(); }
+    static constexpr T op(T a, T b) noexcept { return b < a ? b : a; }
+};
+
+template <typename T>
+struct ll_max_monoid
+{
+    using value_type = T;
+    static constexpr bool idempotent = true;
+    static constexpr T identity() noexcept { return std::numeric_limits<T>::lowest(); }
+    static constexpr T op(T a, T b) noexcept { return a < b ? b : a; }
+};
+
+// range add over sum / min / max; under min / max an identity value (an
+// empty subtree, or a leaf set to it) stays the identity instead of
+// overflowing
+template <typename M>
+struct ll_range_add
+{
+    using T = typename M::value_type;
+    using value_type = T;
+    static constexpr T identity() noexcept { return T{}; }
+    static constexpr T compose(T f, T g) noexcept { return f + g; }
+    static constexpr T apply(T f, T x, std::size_t len) noexcept
+    {
+        if constexpr (M::idempotent)
+            return x == M::identity() ? x : x + f;
+        else
+            return x + f * static_cast<T>(len);
+    }
+};
+
+template <typename M>
+class ll_fenwick
+{
+public:
+    using T = typename M::value_type;
+
+private:
+    std::vector<T> t_; // 1-based, t_[i] = op over (i - lowbit(i), i]
+    std::size_t n_;
+
+public:
+    explicit ll_fenwick(std::size_t n)
+        : t_(n + 1, M::identity())
+        , n_(n)
+    {
+    }
+
+    // O(n): each node folds itself into its parent once
+    explicit ll_fenwick(std::span<const T> a)
+        : t_(a.size() + 1)
+        , n_(a.size())
+    {
+        t_[0] = M::identity();
+        std::copy(a.begin(), a.end(), t_.begin() + 1);
+        for (std::size_t i = 1; i <= n_; ++i)
+        {
+            const std::size_t j = i + (i & (~i + 1));
+            if (j <= n_) t_[j] = M::op(t_[j], t_[i]);
+        }
+    }
+
+    // a[i] = op(a[i], v)
+    void add(std::size_t i, T v) noexcept
+    {
+        for (++i; i <= n_; i += i & (~i + 1)) t_[i] = M::op(t_[i], v);
+    }
+
+    // op over a[0, r)
+    T prefix(std::size_t r) const noexcept
+    {
+        T s = M::identity();
+        for (; r > 0; r &= r - 1) s = M::op(s, t_[r]);
+        return s;
+    }
+
+    // op over a[l, r)
+    T range(std::size_t l, std::size_t r) const noexcept
+        requires requires(T x) { M::inverse(x); }
+    {
+        return M::op(prefix(r), M::inverse(prefix(l)));
+    }
+
+    // smallest r with prefix(r + 1) >= target, n if none; needs a
+    // monotone prefix (non-negative values under sum)
+    std::size_t lower_bound(T target) const noexcept
+    {
+        std::size_t pos = 0;
+        T acc = M::identity();
+        for (std::size_t step = std::bit_floor(n_); step; step >>= 1)
+        {
+            if (pos + step <= n_ && M::op(acc, t_[pos + step]) < target)
+            {
+                pos += step;
+                acc = M::op(acc, t_[pos]);
+            }
+        }
+        return pos;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return n_;
+    }
+    std::size_t memory_bytes() const noexcept
+    {
+        return t_.size() * sizeof(T);
+    }
+};
+
+template <typename M, typename A>
+class ll_lazy_segment_tree
+{
+public:
+    using T = typename M::value_type;
+    using F = typename A::value_type;
+
+private:
+    std::size_t n_;
+    std::size_t size_; // leaves, power of two
+    unsigned log_;
+    std::vector<T> d_;  // [2 size], d_[1] = root, leaves at [size, 2 size)
+    std::vector<F> lz_; // [size], pending action of each inner node
+
+    std::size_t len(std::size_t k) const noexcept
+    {
+        return size_ >> (std::bit_width(k) - 1);
+    }
+    void pull(std::size_t k) noexcept
+    {
+        d_[k] = M::op(d_[2 * k], d_[2 * k + 1]);
+    }
+    void all_apply(std::size_t k, F f) noexcept
+    {
+        d_[k] = A::apply(f, d_[k], len(k));
+        if (k < size_) lz_[k] = A::compose(f, lz_[k]);
+    }
+    void push(std::size_t k) noexcept
+    {
+        all_apply(2 * k, lz_[k]);
+        all_apply(2 * k + 1, lz_[k]);
+        lz_[k] = A::identity();
+    }
+    // push pending tags down the paths to the boundaries l and r
+    void push_bounds(std::size_t l, std::size_t r) noexcept
+    {
+        for (unsigned i = log_; i >= 1; --i)
+        {
+            if (((l >> i) << i) != l) push(l >> i);
+            if (((r >> i) << i) != r) push((r - 1) >> i);
+        }
+    }
+
+public:
+    // n elements of value T{} (0 for arithmetic types)
+    explicit ll_lazy_segment_tree(std::size_t n)
+        : ll_lazy_segment_tree(std::span<const T>(std::vector<T>(n)))
+    {
+    }
+
+    explicit ll_lazy_segment_tree(std::span<const T> a)
+        : n_(a.size())
+        , size_(std::bit_ceil(std::max<std::size_t>(1, a.size())))
+        , log_(static_cast<unsigned>(std::countr_zero(size_)))
+        , d_(2 * size_, M::identity())
+        , lz_(size_, A::identity())
+    {
+        std::copy(a.begin(), a.end(), d_.begin() + static_cast<std::ptrdiff_t>(size_));
+        for (std::size_t k = size_ - 1; k >= 1; --k) pull(k);
+    }
+
+    void set(std::size_t p, T x) noexcept
+    {
+        p += size_;
+        for (unsigned i = log_; i >= 1; --i) push(p >> i);
+        d_[p] = x;
+        for (unsigned i = 1; i <= log_; ++i) pull(p >> i);
+    }
+
+    T get(std::size_t p) noexcept
+    {
+        p += size_;
+        for (unsigned i = log_; i >= 1; --i) push(p >> i);
+        return d_[p];
+    }
+
+    // op over [l, r)
+    T query(std::size_t l, std::size_t r) noexcept
+    {
+        if (l >= r) return M::identity();
+        l += size_;
+        r += size_;
+        push_bounds(l, r);
+        T sl = M::identity(), sr = M::identity();
+        for (; l < r; l >>= 1, r >>= 1)
+        {
+            if (l & 1) sl = M::op(sl, d_[l++]);
+            if (r & 1) sr = M::op(d_[--r], sr);
+        }
+        return M::op(sl, sr);
+    }
+
+    T all() const noexcept
+    {
+        return d_[1];
+    }
+
+    // apply f to every element of [l, r)
+    void update(std::size_t l, std::size_t r, F f) noexcept
+    {
+        if (l >= r) return;
+        l += size_;
+        r += size_;
+        push_bounds(l, r);
+        for (std::size_t a = l, b = r; a < b; a >>= 1, b >>= 1)
+        {
+            if (a & 1) all_apply(a++, f);
+            if (b & 1) all_apply(--b, f);
+        }
+        for (unsigned i = 1; i <= log_; ++i)
+        {
+            if (((l >> i) << i) != l) pull(l >> i);
+            if (((r >> i) << i) != r) pull((r - 1) >> i);
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        return n_;
+    }
+    std::size_t memory_bytes() const noexcept
+    {
+        return d_.size() * sizeof(T) + lz_.size() * sizeof(F);
+    }
+};
+
+template <typename M>
+class ll_sparse_table
+{
+    static_assert(M::idempotent, "ll_sparse_table: the monoid must be idempotent (min, max, gcd, ...)");
+
+public:
+    using T = typename M::value_type;
+
+private:
+    std::size_t n_;
+    std::vector<T> t_;               // levels back to back
+    std::vector<std::size_t> level_; // offset of level k in t_
+
+    static void build_level(const T* __restrict prev, T* __restrict next, std::size_t half, std::size_t m) noexcept
+    {
+        for (std::size_t i = 0; i < m; ++i) next[i] = M::op(prev[i], prev[i + half]);
+    }
+
+public:
+    explicit ll_sparse_table(std::span<const T> a)
+        : n_(a.size())
+    {
+        if (n_ == 0) throw std::invalid_argument("ll_sparse_table: empty input");
+        const unsigned levels = static_cast<unsigned>(std::bit_width(n_));
+        std::size_t total = 0;
+        for (unsigned k = 0; k < levels; ++k)
+        {
+            level_.push_back(total);
+            total += n_ - (std::size_t{1} << k) + 1;
+        }
+        t_.resize(total);
+        std::copy(a.begin(), a.end(), t_.begin());
+        for (unsigned k = 1; k < levels; ++k)
+            build_level(&t_[level_[k - 1]], &t_[level_[k]], std::size_t{1} << (k - 1), n_ - (std::size_t{1} << k) + 1);
+    }
+
+    // op over [l, r), l < r: two overlapping power-of-two windows
+    T query(std::size_t l, std::size_t r) const noexcept
+    {
+        const unsigned k = static_cast<unsigned>(std::bit_width(r - l) - 1);
+        const T* lv = &t_[level_[k]];
+        return M::op(lv[l], lv[r - (std::size_t{1} << k)]);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return n_;
+    }
+    std::size_t memory_bytes() const noexcept
+    {
+        return t_.size() * sizeof(T) + level_.size() * sizeof(std::size_t);
+    }
+};
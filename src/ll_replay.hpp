@@ -0,0 +1,278 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+#include "ll_latency_histogram.hpp"
+#include "ll_mmap_file.hpp"
+
+/*
+ *Market Data Replay
+ * Records a timestamped message stream to a flat file and replays it into a
+ * handler with deterministic pacing.
+ *
+ * File layout (little-endian, 8 byte aligned):
+ *   header : "LLREPLAY" u32 version u32 reserved u64 record_count
+ *   record : u64 ts_ns  u32 size  u32 channel  payload[size] padded to 8
+ *
+ * Pacing:
+ * - the schedule is computed from the recorded timestamps only:
+ *     intended(i) = start + (ts(i) - ts(0)) / speed
+ *   so a slow handler never shifts later messages (no drift accumulation)
+ * - the engine sleeps until spin_threshold before a deadline, then spins
+ * - speed = 0 replays as fast as possible
+ *
+ * Measurement (coordinated-omission correct):
+ * - latency : handler completion - intended send time. If the handler
+ *   falls behind, the queueing delay of every later message is counted,
+ *   exactly as a live feed would experience it.
+ * - service : handler completion - actual dispatch (what a naive
+ *   benchmark reports; hides backlog)
+ */
+
+struct ll_replay_file_header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t count;
+};
+
+struct ll_replay_record_header
+{
+    std::uint64_t ts_ns;
+    std::uint32_t size;
+    std::uint32_t channel;
+};
+
+struct ll_replay_record
+{
+    std::uint64_t ts_ns;
+    std::uint32_t channel;
+    std::span<const std::byte> payload;
+};
+
+namespace ll_replay_detail
+{
+    inline constexpr char magic[8] = {'L', 'L', 'R', 'E', 'P', 'L', 'A', 'Y'};
+    inline constexpr std::uint32_t version = 1;
+
+    constexpr std::size_t pad8(std::size_t n) noexcept
+    {
+        return (n + 7) & ~std::size_t{7};
+    }
+
+    inline void cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+}
+
+// Writer: buffered append, header count patched on close
+
+class ll_replay_writer
+{
+private:
+    std::FILE* f_;
+    std::uint64_t count_;
+    std::uint64_t last_ts_;
+
+public:
+    explicit ll_replay_writer(const char* path)
+        : f_(std::fopen(path, "wb"))
+        , count_(0)
+        , last_ts_(0)
+    {
+        if (!f_) throw std::runtime_error("ll_replay_writer: cannot open file");
+        ll_replay_file_header h{};
+        std::memcpy(h.magic, ll_replay_detail::magic, sizeof(h.magic));
+        h.version = ll_replay_detail::version;
+        std::fwrite(&h, sizeof(h), 1, f_);
+    }
+
+    ll_replay_writer(const ll_replay_writer&) = delete;
+    ll_replay_writer& operator=(const ll_replay_writer&) = delete;
+
+    ~ll_replay_writer()
+    {
+        close();
+    }
+
+    // timestamps must be non-decreasing
+    void append(std::uint64_t ts_ns, std::uint32_t channel, const void* payload, std::uint32_t size)
+    {
+        if (ts_ns < last_ts_) throw std::invalid_argument("ll_replay_writer: timestamps must not go backwards");
+        last_ts_ = ts_ns;
+        const ll_replay_record_header h{ts_ns, size, channel};
+        static constexpr char zeros[8] = {};
+        std::fwrite(&h, sizeof(h), 1, f_);
+        std::fwrite(payload, 1, size, f_);
+        std::fwrite(zeros, 1, ll_replay_detail::pad8(size) - size, f_);
+        ++count_;
+    }
+
+    std::uint64_t count() const noexcept
+    {
+        return count_;
+    }
+
+    void close()
+    {
+        if (!f_) return;
+        std::fseek(f_, offsetof(ll_replay_file_header, count), SEEK_SET);
+        std::fwrite(&count_, sizeof(count_), 1, f_);
+        std::fclose(f_);
+        f_ = nullptr;
+    }
+};
+
+// Reader: mmap'd, records are walked in place
+
+class ll_replay_file
+{
+private:
+    ll_mmap_file map_;
+    std::uint64_t count_;
+
+public:
+    explicit ll_replay_file(const char* path)
+        : map_(path)
+        , count_(0)
+    {
+        ll_replay_file_header h;
+        if (map_.size() < sizeof(h)) throw std::runtime_error("ll_replay_file: file too small");
+        std::memcpy(&h, map_.data(), sizeof(h));
+        if (std::memcmp(h.magic, ll_replay_detail::magic, sizeof(h.magic)) != 0 || h.version != ll_replay_detail::version)
+            throw std::runtime_error("ll_replay_file: not a replay file");
+        count_ = h.count;
+        map_.advise(MADV_SEQUENTIAL);
+    }
+
+    std::uint64_t count() const noexcept
+    {
+        return count_;
+    }
+    std::size_t bytes() const noexcept
+    {
+        return map_.size();
+    }
+
+    // f(const ll_replay_record&) for every record; throws on a truncated record
+    template <typename F>
+    void for_each(F&& f) const
+    {
+        const char* p = map_.data() + sizeof(ll_replay_file_header);
+        const char* end = map_.data() + map_.size();
+        for (std::uint64_t i = 0; i < count_; ++i)
+        {
+            ll_replay_record_header h;
+            if (end - p < static_cast<std::ptrdiff_t>(sizeof(h))) throw std::runtime_error("ll_replay_file: truncated");
+            std::memcpy(&h, p, sizeof(h));
+            p += sizeof(h);
+            if (end - p < static_cast<std::ptrdiff_t>(h.size)) throw std::runtime_error("ll_replay_file: truncated");
+            f(ll_replay_record{h.ts_ns, h.channel, {reinterpret_cast<const std::byte*>(p), h.size}});
+            p += ll_replay_detail::pad8(h.size);
+        }
+    }
+};
+
+// Engine
+
+struct ll_replay_options
+{
+    double speed = 1.0; // 1 = original pacing, N = N times faster, 0 = as fast as possible
+    std::chrono::nanoseconds spin_threshold{std::chrono::milliseconds(1)}; // covers sleep overshoot
+};
+
+struct ll_replay_stats
+{
+    std::uint64_t messages = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t wall_ns = 0;
+    std::uint64_t max_lag_ns = 0;     // worst dispatch delay behind schedule
+    ll_latency_histogram latency;     // completion - intended
+    ll_latency_histogram service;     // completion - dispatch
+};
+
+class ll_replay_engine
+{
+private:
+    using clk = std::chrono::steady_clock;
+
+    static std::uint64_t now_ns() noexcept
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clk::now().time_since_epoch()).count());
+    }
+
+    static std::uint64_t wait_until(std::uint64_t deadline, std::uint64_t spin_ns) noexcept
+    {
+        std::uint64_t now = now_ns();
+        if (now + spin_ns < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - spin_ns - now));
+            now = now_ns();
+        }
+        while (now < deadline)
+        {
+            ll_replay_detail::cpu_relax();
+            now = now_ns();
+        }
+        return now;
+    }
+
+public:
+    // handler(const ll_replay_record&) is called once per record, in file order
+    template <typename F>
+    static ll_replay_stats run(const ll_replay_file& file, F&& handler, ll_replay_options opt = {})
+    {
+        ll_replay_stats st;
+        const bool paced = opt.speed > 0.0;
+        const double inv_speed = paced ? 1.0 / opt.speed : 0.0;
+        const auto spin_ns = static_cast<std::uint64_t>(opt.spin_threshold.count());
+
+        bool first = true;
+        std::uint64_t ts0 = 0;
+        const std::uint64_t start = now_ns();
+
+        file.for_each([&](const ll_replay_record& r)
+        {
+            if (first)
+            {
+                ts0 = r.ts_ns;
+                first = false;
+            }
+
+            std::uint64_t intended;
+            std::uint64_t dispatch;
+            if (paced)
+            {
+                intended = start + static_cast<std::uint64_t>(static_cast<double>(r.ts_ns - ts0) * inv_speed);
+                dispatch = wait_until(intended, spin_ns);
+            }
+            else
+            {
+                dispatch = intended = now_ns();
+            }
+
+            handler(r);
+            const std::uint64_t done = now_ns();
+
+            st.latency.record(done - intended);
+            st.service.record(done - dispatch);
+            if (dispatch - intended > st.max_lag_ns) st.max_lag_ns = dispatch - intended;
+            ++st.messages;
+            st.bytes += r.payload.size();
+        });
+
+        st.wall_ns = now_ns() - start;
+        return st;
+    }
+};
@@ -0,0 +1,367 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+/*
+ *Rolling Window Statistics
+ * O(1) per update mean / variance / min / max over the last W samples, plus
+ * an EWMA. All storage is sized at construction; updates never allocate.
+ *
+ * ll_rolling_stats - one series
+ * - ring of the last W values
+ * - sliding Welford: the sample leaving the window is removed and the new
+ *   one added in a single step
+ *     mean' = mean + (x - old) / W
+ *     M2'   = M2 + (x - old) * (x - mean' + old - mean)
+ * - min / max: monotonic deques of (sequence, value), amortised O(1)
+ *
+ * ll_rolling_stats_batch - thousands of series updated together, SoA
+ * - one update() takes one new value per series (time-aligned sampling)
+ * - every array is [series] contiguous, so each step is a straight loop
+ *   over series that the compiler vectorises (AVX2 / AVX-512 at -march=native)
+ * - min / max use the van Herk / Gil-Werman block scheme instead of deques
+ *   (deques branch per series and do not vectorise): time is cut into
+ *   blocks of W samples; the window is "suffix of the previous block" +
+ *   "prefix of the current block", so
+ *     min = min(suffix_min_prev[pos + 1], prefix_min_cur)
+ *   with the suffix table rebuilt once per block: O(1) amortised, no branches
+ *
+ * Sliding Welford accumulates rounding over very long runs; variance is
+ * clamped at 0, and resync() recomputes the moments from the ring.
+ */
+
+class ll_rolling_stats
+{
+private:
+    struct entry
+    {
+        std::uint64_t seq;
+        double value;
+    };
+
+    // fixed capacity deque of entries (capacity is a power of two >= W)
+    struct mono_deque
+    {
+        std::vector<entry> buf;
+        std::size_t mask = 0;
+        std::size_t head = 0; // front index
+        std::size_t tail = 0; // one past back
+
+        void init(std::size_t w)
+        {
+            buf.resize(std::bit_ceil(w));
+            mask = buf.size() - 1;
+        }
+        bool empty() const noexcept { return head == tail; }
+        const entry& front() const noexcept { return buf[head & mask]; }
+        const entry& back() const noexcept { return buf[(tail - 1) & mask]; }
+        void pop_front() noexcept { ++head; }
+        void pop_back() noexcept { --tail; }
+        void push_back(entry e) noexcept { buf[tail++ & mask] = e; }
+        void clear() noexcept { head = tail = 0; }
+    };
+
+    std::vector<double> ring_;
+    std::size_t window_;
+    std::size_t pos_;   // next slot to write
+    std::uint64_t seq_; // samples seen
+    double mean_;
+    double m2_;
+    double alpha_;
+    double ewma_;
+    mono_deque min_q_;
+    mono_deque max_q_;
+
+public:
+    // alpha: EWMA weight of the newest sample, in (0, 1]
+    explicit ll_rolling_stats(std::size_t window, double alpha = 0.1)
+        : ring_(window, 0.0)
+        , window_(window)
+        , pos_(0)
+        , seq_(0)
+        , mean_(0.0)
+        , m2_(0.0)
+        , alpha_(alpha)
+        , ewma_(0.0)
+    {
+        if (window == 0) throw std::invalid_argument("ll_rolling_stats: window must be > 0");
+        min_q_.init(window);
+        max_q_.init(window);
+    }
+
+    void push(double x) noexcept
+    {
+        const std::size_t n = count();
+        if (n < window_)
+        {
+            const double d = x - mean_;
+            mean_ += d / static_cast<double>(n + 1);
+            m2_ += d * (x - mean_);
+        }
+        else
+        {
+            const double old = ring_[pos_];
+            const double m = mean_ + (x - old) / static_cast<double>(window_);
+            m2_ += (x - old) * (x - m + old - mean_);
+            mean_ = m;
+        }
+        ring_[pos_] = x;
+        pos_ = pos_ + 1 == window_ ? 0 : pos_ + 1;
+
+        ewma_ = seq_ == 0 ? x : ewma_ + alpha_ * (x - ewma_);
+
+        // expire before pushing: the deques then never hold more than W
+        // entries, which is all the ring holds when W is a power of two
+        const std::uint64_t s = seq_++;
+        if (s >= window_)
+        {
+            const std::uint64_t oldest = s - window_ + 1;
+            if (!min_q_.empty() && min_q_.front().seq < oldest) min_q_.pop_front();
+            if (!max_q_.empty() && max_q_.front().seq < oldest) max_q_.pop_front();
+        }
+        while (!min_q_.empty() && min_q_.back().value >= x) min_q_.pop_back();
+        min_q_.push_back({s, x});
+        while (!max_q_.empty() && max_q_.back().value <= x) max_q_.pop_back();
+        max_q_.push_back({s, x});
+    }
+
+    // samples currently in the window
+    std::size_t count() const noexcept
+    {
+        return seq_ < window_ ? static_cast<std::size_t>(seq_) : window_;
+    }
+    bool full() const noexcept
+    {
+        return seq_ >= window_;
+    }
+    std::size_t window() const noexcept
+    {
+        return window_;
+    }
+
+    double mean() const noexcept
+    {
+        return mean_;
+    }
+    // sample variance (n - 1); 0 with fewer than two samples
+    double variance() const noexcept
+    {
+        const std::size_t n = count();
+        return n < 2 ? 0.0 : std::max(0.0, m2_ / static_cast<double>(n - 1));
+    }
+    double stddev() const noexcept
+    {
+        return std::sqrt(variance());
+    }
+    // NaN while empty
+    double min() const noexcept
+    {
+        return min_q_.empty() ? std::numeric_limits<double>::quiet_NaN() : min_q_.front().value;
+    }
+    double max() const noexcept
+    {
+        return max_q_.empty() ? std::numeric_limits<double>::quiet_NaN() : max_q_.front().value;
+    }
+    double ewma() const noexcept
+    {
+        return ewma_;
+    }
+
+    // recompute mean / M2 exactly from the ring (two-pass), e.g. once per day
+    void resync() noexcept
+    {
+        const std::size_t n = count();
+        if (n == 0) return;
+        double s = 0.0;
+        for (std::size_t i = 0; i < n; ++i) s += ring_[i];
+        mean_ = s / static_cast<double>(n);
+        double m2 = 0.0;
+        for (std::size_t i = 0; i < n; ++i) m2 += (ring_[i] - mean_) * (ring_[i] - mean_);
+        m2_ = m2;
+    }
+
+    void reset() noexcept
+    {
+        pos_ = 0;
+        seq_ = 0;
+        mean_ = m2_ = ewma_ = 0.0;
+        min_q_.clear();
+        max_q_.clear();
+    }
+};
+
+class ll_rolling_stats_batch
+{
+private:
+    std::size_t series_;
+    std::size_t stride_; // series rounded up to a multiple of 8 (one 64 byte line)
+    std::size_t window_;
+    std::size_t pos_;    // slot of the next sample = position inside the current block
+    std::uint64_t seq_;
+    double alpha_;
+
+    // [window][stride]: sample ring; its slots are exactly the current block
+    std::vector<double> ring_;
+    // [window + 1][stride]: suffix min / max of the previous block, row window = +/-inf
+    std::vector<double> suf_min_;
+    std::vector<double> suf_max_;
+    // [stride] each
+    std::vector<double> pre_min_, pre_max_, mean_, m2_, ewma_, win_min_, win_max_;
+
+    double* row(std::vector<double>& v, std::size_t r) noexcept
+    {
+        return v.data() + r * stride_;
+    }
+
+    void rebuild_suffix() noexcept
+    {
+        const std::size_t s = stride_;
+        for (std::size_t r = window_; r-- > 0;)
+        {
+            const double* __restrict x = row(ring_, r);
+            const double* __restrict nmin = row(suf_min_, r + 1);
+            const double* __restrict nmax = row(suf_max_, r + 1);
+            double* __restrict omin = row(suf_min_, r);
+            double* __restrict omax = row(suf_max_, r);
+            for (std::size_t i = 0; i < s; ++i)
+            {
+                omin[i] = x[i] < nmin[i] ? x[i] : nmin[i];
+                omax[i] = x[i] > nmax[i] ? x[i] : nmax[i];
+            }
+        }
+    }
+
+public:
+    ll_rolling_stats_batch(std::size_t series, std::size_t window, double alpha = 0.1)
+        : series_(series)
+        , stride_((series + 7) & ~std::size_t{7})
+        , window_(window)
+        , pos_(0)
+        , seq_(0)
+        , alpha_(alpha)
+        , ring_(window * stride_, 0.0)
+        , suf_min_((window + 1) * stride_, std::numeric_limits<double>::infinity())
+        , suf_max_((window + 1) * stride_, -std::numeric_limits<double>::infinity())
+        , pre_min_(stride_, std::numeric_limits<double>::infinity())
+        , pre_max_(stride_, -std::numeric_limits<double>::infinity())
+        , mean_(stride_, 0.0)
+        , m2_(stride_, 0.0)
+        , ewma_(stride_, 0.0)
+        , win_min_(stride_, 0.0)
+        , win_max_(stride_, 0.0)
+    {
+        if (window == 0 || series == 0) throw std::invalid_argument("ll_rolling_stats_batch: empty window or no series");
+    }
+
+    // Kernels: one straight loop over series each. Restrict-qualified
+    // parameters (rather than locals) are what lets GCC vectorise them.
+
+    static void welford_grow(double* __restrict mean, double* __restrict m2, const double* __restrict x,
+                             double inv, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double d = x[i] - mean[i];
+            mean[i] += d * inv;
+            m2[i] += d * (x[i] - mean[i]);
+        }
+    }
+
+    static void welford_slide(double* __restrict mean, double* __restrict m2, const double* __restrict old,
+                              const double* __restrict x, double inv, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double m = mean[i] + (x[i] - old[i]) * inv;
+            m2[i] += (x[i] - old[i]) * (x[i] - m + old[i] - mean[i]);
+            mean[i] = m;
+        }
+    }
+
+    static void store_extrema(double* __restrict slot, double* __restrict ew, double* __restrict pmin,
+                              double* __restrict pmax, double* __restrict wmin, double* __restrict wmax,
+                              const double* __restrict smin, const double* __restrict smax,
+                              const double* __restrict x, double a, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double v = x[i];
+            slot[i] = v;
+            ew[i] += a * (v - ew[i]);
+            const double lo = v < pmin[i] ? v : pmin[i];
+            const double hi = v > pmax[i] ? v : pmax[i];
+            pmin[i] = lo;
+            pmax[i] = hi;
+            wmin[i] = smin[i] < lo ? smin[i] : lo;
+            wmax[i] = smax[i] > hi ? smax[i] : hi;
+        }
+    }
+
+    // x[series]: the next sample of every series
+    void update(const double* x) noexcept
+    {
+        const bool full = seq_ >= window_;
+        const double inv = 1.0 / static_cast<double>(full ? window_ : seq_ + 1);
+        double* slot = row(ring_, pos_); // still holds the sample leaving the window
+
+        if (full) welford_slide(mean_.data(), m2_.data(), slot, x, inv, series_);
+        else welford_grow(mean_.data(), m2_.data(), x, inv, series_);
+
+        store_extrema(slot, ewma_.data(), pre_min_.data(), pre_max_.data(), win_min_.data(), win_max_.data(),
+                      row(suf_min_, pos_ + 1), row(suf_max_, pos_ + 1), x, seq_ == 0 ? 1.0 : alpha_, series_);
+
+        ++seq_;
+        if (++pos_ == window_) // block complete: it becomes the previous block
+        {
+            pos_ = 0;
+            rebuild_suffix();
+            std::fill(pre_min_.begin(), pre_min_.end(), std::numeric_limits<double>::infinity());
+            std::fill(pre_max_.begin(), pre_max_.end(), -std::numeric_limits<double>::infinity());
+        }
+    }
+
+    std::size_t series() const noexcept
+    {
+        return series_;
+    }
+    std::size_t count() const noexcept
+    {
+        return seq_ < window_ ? static_cast<std::size_t>(seq_) : window_;
+    }
+
+    // per-series results of the last update, each an array of series() values
+    const double* mean() const noexcept
+    {
+        return mean_.data();
+    }
+    const double* min() const noexcept
+    {
+        return win_min_.data();
+    }
+    const double* max() const noexcept
+    {
+        return win_max_.data();
+    }
+    const double* ewma() const noexcept
+    {
+        return ewma_.data();
+    }
+    double variance(std::size_t i) const noexcept
+    {
+        const std::size_t n = count();
+        return n < 2 ? 0.0 : std::max(0.0, m2_[i] / static_cast<double>(n - 1));
+    }
+    // sample variance of every series into out[series()]
+    void variance(double* out) const noexcept
+    {
+        const std::size_t n = count();
+        const double k = n < 2 ? 0.0 : 1.0 / static_cast<double>(n - 1);
+        for (std::size_t i = 0; i < series_; ++i) out[i] = std::max(0.0, m2_[i] * k);
+    }
+};
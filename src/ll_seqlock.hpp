@@ -0,0 +1,139 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/*
+ *Seqlock
+ * Single writer, any number of readers, readers never block the writer.
+ * - the writer bumps a sequence counter to odd, writes, bumps it to even
+ * - a reader copies the data between two reads of the counter and retries
+ *   if the counter was odd or changed (a torn copy is discarded, never used)
+ *
+ * The payload is copied as 64-bit words through std::atomic_ref with relaxed
+ * ordering, so concurrent reads of data being written are not data races;
+ * the fences around the copy give the ordering.
+ *
+ * Two layers:
+ * - ll_seqlock_counter + ll_seqlock_copy : the protocol on its own, for
+ *   payloads that live elsewhere (a shared memory segment, a large slab)
+ * - ll_seqlock<T> : counter + one trivially copyable T, load()/store()
+ *
+ * Everything is lock-free and address-free on x86-64 / AArch64, so both
+ * layers also work when placed in memory shared between processes.
+ */
+
+// word-wise copy; both pointers 8 byte aligned, bytes a multiple of 8
+inline void ll_seqlock_copy(void* dst, const void* src, std::size_t bytes) noexcept
+{
+    auto* d = static_cast<std::uint64_t*>(dst);
+    auto* s = static_cast<std::uint64_t*>(const_cast<void*>(src));
+    for (std::size_t i = 0; i < bytes / 8; ++i)
+        std::atomic_ref<std::uint64_t>(d[i]).store(std::atomic_ref<std::uint64_t>(s[i]).load(std::memory_order_relaxed),
+                                                   std::memory_order_relaxed);
+}
+
+class ll_seqlock_counter
+{
+private:
+    std::atomic<std::uint64_t> seq_{0};
+
+public:
+// Writer (one at a time)
+    void write_begin() noexcept
+    {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    void write_end() noexcept
+    {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+// Reader
+    // spins while a write is in progress; pass the result to read_retry()
+    std::uint64_t read_begin() const noexcept
+    {
+        std::uint64_t s;
+        while ((s = seq_.load(std::memory_order_acquire)) & 1)
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+        return s;
+    }
+    // no spinning: false while a write is in progress (or its writer died
+    // inside it); otherwise s is set for read_retry()
+    bool try_read_begin(std::uint64_t& s) const noexcept
+    {
+        s = seq_.load(std::memory_order_acquire);
+        return (s & 1) == 0;
+    }
+    // true if the data read since read_begin() may be torn
+    bool read_retry(std::uint64_t begin) const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq_.load(std::memory_order_relaxed) != begin;
+    }
+
+    // number of completed writes
+    std::uint64_t version() const noexcept
+    {
+        return seq_.load(std::memory_order_acquire) >> 1;
+    }
+};
+
+template <typename T>
+class ll_seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "ll_seqlock<T>: T must be trivially copyable");
+
+private:
+    static constexpr std::size_t words = (sizeof(T) + 7) / 8;
+
+    alignas(64) ll_seqlock_counter seq_;
+    alignas(64) std::uint64_t data_[words] = {};
+
+public:
+    void store(const T& v) noexcept
+    {
+        std::uint64_t tmp[words] = {};
+        std::memcpy(tmp, &v, sizeof(T));
+        seq_.write_begin();
+        ll_seqlock_copy(data_, tmp, sizeof(tmp));
+        seq_.write_end();
+    }
+
+    T load() const noexcept
+    {
+        std::uint64_t tmp[words];
+        std::uint64_t s;
+        do
+        {
+            s = seq_.read_begin();
+            ll_seqlock_copy(tmp, data_, sizeof(tmp));
+        } while (seq_.read_retry(s));
+        T v;
+        std::memcpy(&v, tmp, sizeof(T));
+        return v;
+    }
+
+    // one attempt; false if a write overlapped
+    bool try_load(T& out) const noexcept
+    {
+        std::uint64_t tmp[words];
+        const std::uint64_t s = seq_.read_begin();
+        ll_seqlock_copy(tmp, data_, sizeof(tmp));
+        if (seq_.read_retry(s)) return false;
+        std::memcpy(&out, tmp, sizeof(T));
+        return true;
+    }
+
+    std::uint64_t version() const noexcept
+    {
+        return seq_.version();
+    }
+};
@@ -0,0 +1,722 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ll_mmap_file.hpp"
+#include "ll_seqlock.hpp"
+
+/*
+ *Shared-Memory List + Pool
+ * ll_list_pool and intrusive_list for a segment shared between processes:
+ * one writer process mutates, any number of reader processes (monitoring,
+ * risk views) copy consistent snapshots straight out of the mapping, with
+ * no IPC round trip and without ever blocking the writer.
+ * - position independent links: the pool links nodes by 32-bit index, the
+ *   intrusive list by self-relative byte offsets, so each process may map
+ *   the segment at a different address
+ * - one ll_seqlock_counter per list, inside the segment. Every structural
+ *   operation is a write section; a reader copies between two reads of
+ *   the counter and discards the copy if a write overlapped
+ * - shared words are written through std::atomic_ref (relaxed: plain
+ *   stores on x86-64 / AArch64), the seqlock fences give the ordering
+ * - readers never trust the segment: indices and offsets are range
+ *   checked and walks are bounded, so a torn read or a writer that died
+ *   mid-update costs a retry, never a wild read
+ *
+ * Choose what a reader copies: the first k elements of a queue is a short
+ * window that nearly always succeeds first time; a full walk of a long list
+ * races every write the writer makes meanwhile.
+ * batch() groups several operations into one section: readers see all of
+ * them or none, and the counter is bumped once.
+ */
+
+namespace ll_shared_list_detail
+{
+template <typename U>
+U load(const U& x) noexcept
+{
+    return std::atomic_ref<U>(const_cast<U&>(x)).load(std::memory_order_relaxed);
+}
+
+template <typename U>
+void store(U& x, U v) noexcept
+{
+    std::atomic_ref<U>(x).store(v, std::memory_order_relaxed);
+}
+
+// between snapshot attempts: spin briefly, then give the CPU away. A writer
+// preempted inside a section cannot finish it while a reader spins on its core
+inline void backoff(std::size_t attempt) noexcept
+{
+    if (attempt < 64)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    else
+        std::this_thread::yield();
+}
+
+// segment = header page + slab; slab[0] is the sentinel
+template <typename T>
+struct pool_segment
+{
+    using index_type = std::uint32_t;
+
+    struct alignas(8) node
+    {
+        index_type prev;
+        index_type next;
+        T value;
+    };
+
+    struct header
+    {
+        std::uint64_t magic; // stored last by the writer (release)
+        std::uint32_t version;
+        std::uint32_t node_size;
+        std::uint32_t value_size;
+        std::uint32_t value_align;
+        std::uint64_t capacity;
+        alignas(64) ll_seqlock_counter seq; // the line readers poll
+        std::uint64_t size;
+        index_type free_head; // 0 = exhausted
+    };
+
+    static constexpr std::size_t header_bytes = 4096;
+    static constexpr std::uint64_t segment_magic = 0x0154534C4853'4C4CULL; // "LLSHLST\1"
+    static constexpr std::uint32_t segment_version = 1;
+    static_assert(sizeof(header) <= header_bytes && alignof(node) <= header_bytes);
+    static_assert(sizeof(node) % 8 == 0, "nodes are copied as 64-bit words");
+
+    static std::size_t bytes(std::size_t capacity) noexcept
+    {
+        return header_bytes + (capacity + 1) * sizeof(node);
+    }
+};
+} // namespace ll_shared_list_detail
+
+/*
+ *Write section
+ * RAII bracket around a group of writes (write_begin / write_end on the
+ * list's counter). Sections nest; only the outermost touches the counter.
+ */
+class ll_shared_write_section
+{
+private:
+    ll_seqlock_counter& seq_;
+    std::uint32_t& depth_;
+
+public:
+    ll_shared_write_section(ll_seqlock_counter& seq, std::uint32_t& depth) noexcept
+        : seq_(seq)
+        , depth_(depth)
+    {
+        if (depth_++ == 0) seq_.write_begin();
+    }
+    ~ll_shared_write_section()
+    {
+        if (--depth_ == 0) seq_.write_end();
+    }
+    ll_shared_write_section(const ll_shared_write_section&) = delete;
+    ll_shared_write_section& operator=(const ll_shared_write_section&) = delete;
+};
+
+/*
+ *Shared list pool - writer side
+ * ll_list_pool in a shared segment (a file under /dev/shm, or any path).
+ * The writer creates the segment; T must be trivially copyable and
+ * standard layout, since readers copy its bytes. Elements are read-only
+ * through iterators: change one with modify(), inside a write section.
+ */
+template <typename T>
+class ll_shared_list_pool
+{
+    static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>,
+                  "ll_shared_list_pool: T is shared as raw bytes");
+
+    using seg = ll_shared_list_detail::pool_segment<T>;
+    using node = typename seg::node;
+    using header = typename seg::header;
+
+public:
+    using index_type = typename seg::index_type;
+
+private:
+    ll_mmap_file file_;
+    header* hdr_;
+    node* slab_;
+    std::uint32_t depth_; // write section nesting, this process only
+
+    static std::size_t checked_bytes(std::size_t capacity)
+    {
+        if (capacity == 0 || capacity >= std::numeric_limits<index_type>::max())
+            throw std::length_error("ll_shared_list_pool: bad capacity");
+        return seg::bytes(capacity);
+    }
+
+    void set_next(index_type x, index_type v) noexcept
+    {
+        ll_shared_list_detail::store(slab_[x].next, v);
+    }
+    void set_prev(index_type x, index_type v) noexcept
+    {
+        ll_shared_list_detail::store(slab_[x].prev, v);
+    }
+    void set_size(std::uint64_t v) noexcept
+    {
+        ll_shared_list_detail::store(hdr_->size, v);
+    }
+
+    void unlink(index_type x) noexcept
+    {
+        set_next(slab_[x].prev, slab_[x].next);
+        set_prev(slab_[x].next, slab_[x].prev);
+    }
+
+    index_type alloc_node()
+    {
+        const index_type n = hdr_->free_head;
+        if (n == 0) throw std::bad_alloc();
+        ll_shared_list_detail::store(hdr_->free_head, slab_[n].next);
+        return n;
+    }
+
+    void free_node(index_type n) noexcept
+    {
+        set_next(n, hdr_->free_head);
+        ll_shared_list_detail::store(hdr_->free_head, n);
+    }
+
+    // fill node n in one word-wise copy (its own links included), then
+    // link it between a and b
+    void place(index_type n, index_type a, index_type b, const T& v) noexcept
+    {
+        node tmp{a, b, v};
+        ll_seqlock_copy(&slab_[n], &tmp, sizeof(node));
+        set_next(a, n);
+        set_prev(b, n);
+    }
+
+public:
+// Iterator - a node index plus the slab it indexes; const access only
+    class iterator
+    {
+        friend class ll_shared_list_pool;
+        const node* slab_;
+        index_type i_;
+        iterator(const node* s, index_type i) noexcept : slab_(s), i_(i) {}
+        public:
+        iterator() noexcept : slab_(nullptr), i_(0) {}
+        const T& operator*() const noexcept
+        {
+            return slab_[i_].value;
+        }
+        const T* operator->() const noexcept
+        {
+            return &slab_[i_].value;
+        }
+        iterator& operator++() noexcept
+        {
+            i_ = slab_[i_].next;
+            return *this;
+        }
+        iterator& operator--() noexcept
+        {
+            i_ = slab_[i_].prev;
+            return *this;
+        }
+        index_type index() const noexcept
+        {
+            return i_;
+        }
+
+        bool operator==(const iterator& o) const noexcept
+        {
+            return i_ == o.i_;
+        }
+        bool operator!=(const iterator& o) const noexcept
+        {
+            return i_ != o.i_;
+        }
+    };
+
+public:
+// Construction/Destruction
+    // creates (truncates) the segment file and publishes an empty list
+    ll_shared_list_pool(const char* path, std::size_t capacity)
+        : file_(path, ll_mmap_mode::create, checked_bytes(capacity))
+        , hdr_(reinterpret_cast<header*>(file_.data()))
+        , slab_(reinterpret_cast<node*>(file_.data() + seg::header_bytes))
+        , depth_(0)
+    {
+        ::new (hdr_) header{};
+        hdr_->version = seg::segment_version;
+        hdr_->node_size = sizeof(node);
+        hdr_->value_size = sizeof(T);
+        hdr_->value_align = alignof(T);
+        hdr_->capacity = capacity;
+        slab_[0].prev = slab_[0].next = 0;
+        for (std::size_t i = 1; i <= capacity; ++i)
+            slab_[i].next = static_cast<index_type>(i == capacity ? 0 : i + 1);
+        hdr_->free_head = 1;
+        std::atomic_ref<std::uint64_t>(hdr_->magic).store(seg::segment_magic, std::memory_order_release);
+    }
+
+    ll_shared_list_pool(const ll_shared_list_pool&) = delete;
+    ll_shared_list_pool& operator=(const ll_shared_list_pool&) = delete;
+
+// Basic properties
+    bool empty() const noexcept
+    {
+        return hdr_->size == 0;
+    }
+    std::size_t size() const noexcept
+    {
+        return static_cast<std::size_t>(hdr_->size);
+    }
+    std::size_t capacity() const noexcept
+    {
+        return static_cast<std::size_t>(hdr_->capacity);
+    }
+    // completed write sections
+    std::uint64_t version() const noexcept
+    {
+        return hdr_->seq.version();
+    }
+    iterator begin() const noexcept
+    {
+        return iterator(slab_, slab_[0].next);
+    }
+    iterator end() const noexcept
+    {
+        return iterator(slab_, 0);
+    }
+
+// Write sections
+    // auto b = pool.batch(); ... : everything until b is destroyed is one write
+    [[nodiscard]] ll_shared_write_section batch() noexcept
+    {
+        return ll_shared_write_section(hdr_->seq, depth_);
+    }
+
+// Clear list
+    void clear() noexcept
+    {
+        auto section = batch();
+        for (index_type cur = slab_[0].next; cur != 0;)
+        {
+            const index_type next = slab_[cur].next;
+            free_node(cur);
+            cur = next;
+        }
+        set_next(0, 0);
+        set_prev(0, 0);
+        set_size(0);
+    }
+
+// Emplacement
+    template <typename... Args>
+    iterator emplace_front(Args&&... args)
+    {
+        const T v(std::forward<Args>(args)...);
+        auto section = batch();
+        const index_type n = alloc_node();
+        place(n, 0, slab_[0].next, v);
+        set_size(hdr_->size + 1);
+        return iterator(slab_, n);
+    }
+
+    template <typename... Args>
+    iterator emplace_back(Args&&... args)
+    {
+        const T v(std::forward<Args>(args)...);
+        auto section = batch();
+        const index_type n = alloc_node();
+        place(n, slab_[0].prev, 0, v);
+        set_size(hdr_->size + 1);
+        return iterator(slab_, n);
+    }
+
+// Update
+    // f(T&) edits a copy, which then replaces the element in one write
+    template <typename F>
+    void modify(iterator it, F&& f)
+    {
+        node tmp = slab_[it.i_];
+        f(tmp.value);
+        auto section = batch();
+        ll_seqlock_copy(&slab_[it.i_], &tmp, sizeof(node));
+    }
+
+// Erase
+    iterator erase(iterator it) noexcept
+    {
+        auto section = batch();
+        const index_type n = it.i_;
+        const index_type next = slab_[n].next;
+        unlink(n);
+        free_node(n);
+        set_size(hdr_->size - 1);
+        return iterator(slab_, next);
+    }
+
+// Splice
+    // moves node 'what' before 'pos'
+    void splice(iterator pos, iterator what) noexcept
+    {
+        const index_type x = what.i_;
+        if (x == pos.i_) return;
+        auto section = batch();
+        unlink(x);
+        const index_type before = slab_[pos.i_].prev;
+        set_prev(x, before);
+        set_next(x, pos.i_);
+        set_next(before, x);
+        set_prev(pos.i_, x);
+    }
+
+    // splice range [first,last) before pos
+    void splice(iterator pos, iterator first, iterator last) noexcept
+    {
+        const index_type a = first.i_, b = last.i_;
+        if (a == b) return;
+        auto section = batch();
+        const index_type tail = slab_[b].prev;
+
+        // detach [a, tail]
+        set_next(slab_[a].prev, b);
+        set_prev(b, slab_[a].prev);
+
+        // attach before pos
+        const index_type before = slab_[pos.i_].prev;
+        set_prev(a, before);
+        set_next(tail, pos.i_);
+        set_next(before, a);
+        set_prev(pos.i_, tail);
+    }
+};
+
+/*
+ *Shared list pool - reader side
+ * Maps a segment created by ll_shared_list_pool<T> read-only. Any number
+ * of readers, in any processes; they never write to the segment.
+ */
+template <typename T>
+class ll_shared_list_reader
+{
+    using seg = ll_shared_list_detail::pool_segment<T>;
+    using node = typename seg::node;
+    using header = typename seg::header;
+    using index_type = typename seg::index_type;
+    static constexpr std::size_t words = sizeof(node) / 8;
+
+    ll_mmap_file file_;
+    const header* hdr_;
+    const node* slab_;
+    std::size_t cap_;
+
+public:
+// Construction/Destruction
+    // throws std::runtime_error until the writer has published the segment
+    explicit ll_shared_list_reader(const char* path)
+        : file_(path)
+        , hdr_(reinterpret_cast<const header*>(file_.data()))
+        , slab_(reinterpret_cast<const node*>(file_.data() + seg::header_bytes))
+        , cap_(0)
+    {
+        if (file_.size() < seg::header_bytes ||
+            std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(hdr_->magic)).load(std::memory_order_acquire) !=
+                seg::segment_magic ||
+            hdr_->version != seg::segment_version)
+            throw std::runtime_error("ll_shared_list_reader: no published segment");
+        if (hdr_->node_size != sizeof(node) || hdr_->value_size != sizeof(T) || hdr_->value_align != alignof(T))
+            throw std::runtime_error("ll_shared_list_reader: element layout differs from the writer's");
+        cap_ = static_cast<std::size_t>(hdr_->capacity);
+        if (file_.size() != seg::bytes(cap_))
+            throw std::runtime_error("ll_shared_list_reader: segment size does not match its header");
+    }
+
+// Basic properties
+    // a moment's value, not synchronised with anything else
+    std::size_t size() const noexcept
+    {
+        return static_cast<std::size_t>(ll_shared_list_detail::load(hdr_->size));
+    }
+    std::size_t capacity() const noexcept
+    {
+        return cap_;
+    }
+    std::uint64_t version() const noexcept
+    {
+        return hdr_->seq.version();
+    }
+
+// Snapshots
+    // one attempt: copy the first min(limit, size) elements into out.
+    // false if a write overlapped (out is then garbage)
+    bool try_snapshot(std::vector<T>& out, std::size_t limit = std::numeric_limits<std::size_t>::max()) const
+    {
+        out.clear();
+        std::uint64_t s;
+        if (!hdr_->seq.try_read_begin(s)) return false;
+        const std::size_t n = std::min<std::size_t>(limit, ll_shared_list_detail::load(hdr_->size));
+        if (n > cap_) return false;
+        out.reserve(n);
+
+        std::uint64_t w[words];
+        index_type cur = ll_shared_list_detail::load(slab_[0].next);
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            if (cur == 0 || cur > cap_) return false;
+            ll_seqlock_copy(w, &slab_[cur], sizeof(node));
+            node c;
+            std::memcpy(&c, w, sizeof(node));
+            out.push_back(c.value);
+            cur = c.next;
+        }
+        return !hdr_->seq.read_retry(s);
+    }
+
+    // retries until a copy is consistent; returns the number of attempts.
+    // Waits while the writer is inside a section: bound it with try_snapshot
+    std::size_t snapshot(std::vector<T>& out, std::size_t limit = std::numeric_limits<std::size_t>::max()) const
+    {
+        std::size_t attempts = 1;
+        while (!try_snapshot(out, limit)) ll_shared_list_detail::backoff(attempts++);
+        return attempts;
+    }
+};
+
+/*
+ *Shared intrusive list
+ * intrusive_list for objects that live in a shared segment. Hooks hold
+ * byte offsets to their neighbours' hooks, relative to themselves, so
+ * the links mean the same thing at any mapping address.
+ * - construct the list inside the segment (placement new) and tell it the
+ *   segment's bounds: readers only ever copy objects inside them
+ * - readers map the same segment and call try_snapshot / snapshot through
+ *   a const pointer to the list, passing offsetof(T, hook)
+ * - T must be trivially copyable; readers copy whole objects, hook
+ *   included, and follow the copied hook
+ */
+struct ll_shared_hook
+{
+    std::int64_t prev = 0; // byte offset to the previous hook, 0 = not linked
+    std::int64_t next = 0;
+
+    [[nodiscard]] bool is_linked() const noexcept
+    {
+        return next != 0;
+    }
+};
+
+class ll_shared_intrusive_list
+{
+private:
+    ll_shared_hook sentinel_;
+    std::uint64_t size_;
+    std::int64_t lo_, hi_;  // segment bounds, relative to this
+    std::uint32_t depth_;   // write section nesting (writer only)
+    alignas(64) ll_seqlock_counter seq_;
+
+    static ll_shared_hook* step(ll_shared_hook* h, std::int64_t off) noexcept
+    {
+        return reinterpret_cast<ll_shared_hook*>(reinterpret_cast<char*>(h) + off);
+    }
+    static std::int64_t offset(const ll_shared_hook* from, const ll_shared_hook* to) noexcept
+    {
+        return reinterpret_cast<const char*>(to) - reinterpret_cast<const char*>(from);
+    }
+    static void set_next(ll_shared_hook* h, ll_shared_hook* to) noexcept
+    {
+        ll_shared_list_detail::store(h->next, offset(h, to));
+    }
+    static void set_prev(ll_shared_hook* h, ll_shared_hook* to) noexcept
+    {
+        ll_shared_list_detail::store(h->prev, offset(h, to));
+    }
+
+    static void link_between(ll_shared_hook* x, ll_shared_hook* a, ll_shared_hook* b) noexcept
+    {
+        set_prev(x, a);
+        set_next(x, b);
+        set_next(a, x);
+        set_prev(b, x);
+    }
+
+    static void unlink(ll_shared_hook* x) noexcept
+    {
+        ll_shared_hook* a = step(x, x->prev);
+        ll_shared_hook* b = step(x, x->next);
+        set_next(a, b);
+        set_prev(b, a);
+        ll_shared_list_detail::store(x->prev, std::int64_t{0});
+        ll_shared_list_detail::store(x->next, std::int64_t{0});
+    }
+
+public:
+// Construction
+    // *this and every object ever linked must lie in [segment, segment + bytes)
+    ll_shared_intrusive_list(const void* segment, std::size_t bytes) noexcept
+        : size_(0)
+        , lo_(reinterpret_cast<const char*>(segment) - reinterpret_cast<const char*>(this))
+        , hi_(lo_ + static_cast<std::int64_t>(bytes))
+        , depth_(0)
+    {
+        sentinel_.prev = sentinel_.next = 0; // offset 0 = itself: empty
+    }
+
+    ll_shared_intrusive_list(const ll_shared_intrusive_list&) = delete;
+    ll_shared_intrusive_list& operator=(const ll_shared_intrusive_list&) = delete;
+
+// Basic properties
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return sentinel_.next == 0;
+    }
+    std::size_t size() const noexcept
+    {
+        return static_cast<std::size_t>(ll_shared_list_detail::load(size_));
+    }
+    std::uint64_t version() const noexcept
+    {
+        return seq_.version();
+    }
+    ll_shared_hook* front() noexcept
+    {
+        return step(&sentinel_, sentinel_.next);
+    }
+    ll_shared_hook* back() noexcept
+    {
+        return step(&sentinel_, sentinel_.prev);
+    }
+    ll_shared_hook* end() noexcept
+    {
+        return &sentinel_;
+    }
+    static ll_shared_hook* next(ll_shared_hook* h) noexcept
+    {
+        return step(h, h->next);
+    }
+    static ll_shared_hook* prev(ll_shared_hook* h) noexcept
+    {
+        return step(h, h->prev);
+    }
+
+// Write sections
+    [[nodiscard]] ll_shared_write_section batch() noexcept
+    {
+        return ll_shared_write_section(seq_, depth_);
+    }
+
+    void clear() noexcept
+    {
+        auto section = batch();
+        while (!empty()) remove(front());
+    }
+
+// Insertion
+    void push_front(ll_shared_hook* h) noexcept
+    {
+        auto section = batch();
+        link_between(h, &sentinel_, front());
+        ll_shared_list_detail::store(size_, size_ + 1);
+    }
+    void push_back(ll_shared_hook* h) noexcept
+    {
+        auto section = batch();
+        link_between(h, back(), &sentinel_);
+        ll_shared_list_detail::store(size_, size_ + 1);
+    }
+
+// Removal
+    void remove(ll_shared_hook* h) noexcept
+    {
+        if (!h->is_linked()) return;
+        auto section = batch();
+        unlink(h);
+        ll_shared_list_detail::store(size_, size_ - 1);
+    }
+
+// Splice
+    // moves linked node h before pos (both in this list)
+    void splice(ll_shared_hook* pos, ll_shared_hook* h) noexcept
+    {
+        if (h == pos) return;
+        auto section = batch();
+        ll_shared_hook* a = prev(h);
+        ll_shared_hook* b = next(h);
+        set_next(a, b);
+        set_prev(b, a);
+        link_between(h, prev(pos), pos);
+    }
+
+    // range splice - [first,last) before pos, all in this list
+    void splice(ll_shared_hook* pos, ll_shared_hook* first, ll_shared_hook* last) noexcept
+    {
+        if (first == last) return;
+        auto section = batch();
+        ll_shared_hook* tail = prev(last);
+        ll_shared_hook* before_first = prev(first);
+        set_next(before_first, last);
+        set_prev(last, before_first);
+
+        ll_shared_hook* before = prev(pos);
+        set_next(before, first);
+        set_prev(first, before);
+        set_next(tail, pos);
+        set_prev(pos, tail);
+    }
+
+// Snapshots (readers)
+    // one attempt: copy the first min(limit, size) objects into out; false
+    // if a write overlapped. HookOffset = offsetof(T, hook)
+    template <typename T, std::size_t HookOffset>
+    bool try_snapshot(std::vector<T>& out, std::size_t limit = std::numeric_limits<std::size_t>::max()) const
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % 8 == 0 && alignof(T) >= 8,
+                      "ll_shared_intrusive_list: T is copied as 64-bit words");
+        out.clear();
+        std::uint64_t s;
+        if (!seq_.try_read_begin(s)) return false;
+        const std::size_t n = std::min<std::size_t>(limit, ll_shared_list_detail::load(size_));
+        const char* base = reinterpret_cast<const char*>(this);
+        if (n > static_cast<std::size_t>(hi_ - lo_) / sizeof(T)) return false;
+        out.reserve(n);
+
+        std::uint64_t w[sizeof(T) / 8];
+        const char* h = reinterpret_cast<const char*>(&sentinel_);
+        std::int64_t off = ll_shared_list_detail::load(sentinel_.next);
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            h += off;
+            const std::int64_t obj = (h - base) - static_cast<std::int64_t>(HookOffset);
+            if (obj < lo_ || obj + static_cast<std::int64_t>(sizeof(T)) > hi_ || (obj & 7) != 0) return false;
+            ll_seqlock_copy(w, base + obj, sizeof(T));
+            T& v = out.emplace_back();
+            std::memcpy(&v, w, sizeof(T));
+            std::memcpy(&off, reinterpret_cast<const char*>(w) + HookOffset + offsetof(ll_shared_hook, next), sizeof off);
+        }
+        return !seq_.read_retry(s);
+    }
+
+    // retries until a copy is consistent; returns the number of attempts
+    template <typename T, std::size_t HookOffset>
+    std::size_t snapshot(std::vector<T>& out, std::size_t limit = std::numeric_limits<std::size_t>::max()) const
+    {
+        std::size_t attempts = 1;
+        while (!try_snapshot<T, HookOffset>(out, limit)) ll_shared_list_detail::backoff(attempts++);
+        return attempts;
+    }
+};
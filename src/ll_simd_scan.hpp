@@ -0,0 +1,190 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX512BW__) || defined(__AVX2__) || defined(__PCLMUL__)
+#include <immintrin.h>
+#endif
+
+/*
+ *SIMD Byte Scanning
+ * Building blocks for structural indexing of text formats (JSON, CSV):
+ * - ll_block64 : 64 input bytes, queried for "which bytes equal c" as a
+ *   64-bit mask (bit i <=> byte i). AVX-512BW, AVX2 or scalar, chosen at
+ *   compile time from -march. eq_lookup() classifies against a whole set
+ *   of characters with one nibble-indexed shuffle:
+ *   (byte | or_bits) == table[byte & 0x0F]
+ * - ll_prefix_xor : bit i of the result is the xor of bits [0, i] of the
+ *   input; turns a mask of quote characters into a mask of "inside quotes".
+ *   One carry-less multiply when PCLMUL is available.
+ * - ll_escape_scanner : which bytes are escaped by an odd run of backslashes,
+ *   carried across blocks (branch-free, from the simdjson paper).
+ *
+ * Everything works on 64 byte blocks; callers pad the final partial block
+ * (ll_block64::load_partial fills with a caller supplied byte).
+ */
+
+struct ll_block64
+{
+#if defined(__AVX512BW__)
+    __m512i v;
+
+    static ll_block64 load(const char* p) noexcept
+    {
+        return {_mm512_loadu_si512(reinterpret_cast<const void*>(p))};
+    }
+    std::uint64_t eq(char c) const noexcept
+    {
+        return _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(c));
+    }
+    // bytes <= c (unsigned), e.g. control characters / whitespace <= ' '
+    std::uint64_t le(unsigned char c) const noexcept
+    {
+        return _mm512_cmple_epu8_mask(v, _mm512_set1_epi8(static_cast<char>(c)));
+    }
+    std::uint64_t eq_lookup(const char (&table)[16], char or_bits) const noexcept
+    {
+        const __m512i t = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+        const __m512i x = _mm512_or_si512(v, _mm512_set1_epi8(or_bits));
+        return _mm512_cmpeq_epi8_mask(x, _mm512_shuffle_epi8(t, v));
+    }
+#elif defined(__AVX2__)
+    __m256i lo;
+    __m256i hi;
+
+    static ll_block64 load(const char* p) noexcept
+    {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32))};
+    }
+    std::uint64_t eq(char c) const noexcept
+    {
+        const __m256i k = _mm256_set1_epi8(c);
+        const auto a = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, k)));
+        const auto b = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, k)));
+        return std::uint64_t{a} | (std::uint64_t{b} << 32);
+    }
+    std::uint64_t le(unsigned char c) const noexcept
+    {
+        const __m256i k = _mm256_set1_epi8(static_cast<char>(c));
+        // x <= c  <=>  min(x, c) == x
+        const auto a = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(lo, k), lo)));
+        const auto b = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(hi, k), hi)));
+        return std::uint64_t{a} | (std::uint64_t{b} << 32);
+    }
+    std::uint64_t eq_lookup(const char (&table)[16], char or_bits) const noexcept
+    {
+        const __m256i t = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+        const __m256i o = _mm256_set1_epi8(or_bits);
+        const auto a = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_or_si256(lo, o), _mm256_shuffle_epi8(t, lo))));
+        const auto b = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_or_si256(hi, o), _mm256_shuffle_epi8(t, hi))));
+        return std::uint64_t{a} | (std::uint64_t{b} << 32);
+    }
+#else
+    unsigned char b[64];
+
+    static ll_block64 load(const char* p) noexcept
+    {
+        ll_block64 r;
+        std::memcpy(r.b, p, 64);
+        return r;
+    }
+    std::uint64_t eq(char c) const noexcept
+    {
+        std::uint64_t m = 0;
+        for (int i = 0; i < 64; ++i) m |= std::uint64_t{b[i] == static_cast<unsigned char>(c)} << i;
+        return m;
+    }
+    std::uint64_t le(unsigned char c) const noexcept
+    {
+        std::uint64_t m = 0;
+        for (int i = 0; i < 64; ++i) m |= std::uint64_t{b[i] <= c} << i;
+        return m;
+    }
+    std::uint64_t eq_lookup(const char (&table)[16], char or_bits) const noexcept
+    {
+        std::uint64_t m = 0;
+        for (int i = 0; i < 64; ++i)
+        {
+            // pshufb semantics: a set high bit selects 0
+            const unsigned char t = (b[i] & 0x80) ? 0 : static_cast<unsigned char>(table[b[i] & 0x0F]);
+            m |= std::uint64_t{static_cast<unsigned char>(b[i] | or_bits) == t} << i;
+        }
+        return m;
+    }
+#endif
+
+    // final partial block: copy n < 64 bytes, fill the rest with pad
+    static ll_block64 load_partial(const char* p, std::size_t n, char pad) noexcept
+    {
+        alignas(64) char tmp[64];
+        std::memset(tmp, pad, sizeof(tmp));
+        std::memcpy(tmp, p, n);
+        return load(tmp);
+    }
+};
+
+inline std::uint64_t ll_prefix_xor(std::uint64_t m) noexcept
+{
+#if defined(__PCLMUL__)
+    const __m128i all_ones = _mm_set1_epi8(static_cast<char>(0xFF));
+    const __m128i r = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<long long>(m)), all_ones, 0);
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si64(r));
+#else
+    m ^= m << 1;
+    m ^= m << 2;
+    m ^= m << 4;
+    m ^= m << 8;
+    m ^= m << 16;
+    m ^= m << 32;
+    return m;
+#endif
+}
+
+// bit positions of a mask, appended as base + index.
+// Writes in unconditional groups of 8: out needs 64 entries of slack.
+inline std::uint32_t* ll_flatten_bits(std::uint32_t* out, std::uint32_t base, std::uint64_t m) noexcept
+{
+    std::uint32_t* const next = out + std::popcount(m);
+    while (out < next)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            out[i] = base + static_cast<std::uint32_t>(std::countr_zero(m));
+            m &= m - 1;
+        }
+        out += 8;
+    }
+    return next;
+}
+
+class ll_escape_scanner
+{
+    static constexpr std::uint64_t odd_bits = 0xAAAAAAAAAAAAAAAAull;
+    std::uint64_t next_is_escaped_ = 0;
+
+public:
+    // returns the mask of bytes escaped by a preceding backslash
+    std::uint64_t next(std::uint64_t backslash) noexcept
+    {
+        if (!backslash)
+        {
+            const std::uint64_t escaped = next_is_escaped_;
+            next_is_escaped_ = 0;
+            return escaped;
+        }
+        // a backslash escaped by the previous block cannot start an escape
+        const std::uint64_t potential_escape = backslash & ~next_is_escaped_;
+        const std::uint64_t maybe_escaped = potential_escape << 1;
+        const std::uint64_t even_series = (maybe_escaped | odd_bits) - potential_escape;
+        const std::uint64_t escape_and_terminal = even_series ^ odd_bits;
+        const std::uint64_t escaped = escape_and_terminal ^ (backslash | next_is_escaped_);
+        const std::uint64_t escape = escape_and_terminal & backslash;
+        next_is_escaped_ = escape >> 63;
+        return escaped;
+    }
+};
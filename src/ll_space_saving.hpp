@@ -0,0 +1,283 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "ll_hash.hpp"
+#include "ll_intrusive_list.hpp"
+
+/*
+ *Space-Saving Top-K (Stream-Summary)
+ * Heavy hitters of an unbounded stream in K counters (Metwally, Agrawal,
+ * El Abbadi 2005). Every key whose true count exceeds N / K is guaranteed
+ * to be monitored; each monitored key carries an upper bound (count) and
+ * the overestimation it may include (error), so count - error is a lower
+ * bound.
+ *
+ * Stream-summary layout, all on intrusive_list:
+ * - buckets_  : list of buckets in ascending count order (front = minimum)
+ * - bucket    : one count value + intrusive_list of the counters holding it
+ * - increment : move the counter to the neighbouring bucket (splice), or
+ *   bump the bucket in place when the counter is alone in it. O(1) for
+ *   unit weights, no allocation
+ * - new key when full: the minimum bucket's counter is taken over; its
+ *   count becomes the new key's error
+ *
+ * Memory is fixed at construction: K counters and K + 1 buckets in two
+ * arrays (free buckets sit on an intrusive free list) and a linear-probing
+ * key index of 2K..4K slots with backward-shift deletion. Keys must be
+ * trivially copyable (symbol ids, account ids).
+ */
+
+template <typename Key>
+struct ll_heavy_hitter
+{
+    Key key;
+    std::uint64_t count; // upper bound on the true count
+    std::uint64_t error; // count - error is a lower bound
+};
+
+template <typename Key, typename Hash = std::hash<Key>>
+class ll_space_saving
+{
+    static_assert(std::is_trivially_copyable_v<Key>, "ll_space_saving: Key must be trivially copyable");
+
+private:
+    struct bucket
+    {
+        intrusive_hook hook; // in buckets_
+        std::uint64_t count = 0;
+        intrusive_list members;
+    };
+
+    struct counter
+    {
+        intrusive_hook hook; // in parent->members
+        bucket* parent = nullptr;
+        std::uint64_t error = 0;
+        Key key{};
+    };
+
+    static constexpr std::uint32_t empty_slot = 0xFFFFFFFFu;
+
+    std::size_t k_;
+    std::unique_ptr<counter[]> counters_;
+    std::unique_ptr<bucket[]> bucket_pool_;
+    std::unique_ptr<std::uint32_t[]> slots_;
+    std::size_t mask_;
+    std::size_t used_;
+    std::uint64_t total_;
+    intrusive_list buckets_;
+    intrusive_list free_buckets_;
+
+    static bucket* bucket_of(intrusive_hook* h) noexcept
+    {
+        return reinterpret_cast<bucket*>(reinterpret_cast<char*>(h) - offsetof(bucket, hook));
+    }
+    static counter* counter_of(intrusive_hook* h) noexcept
+    {
+        return reinterpret_cast<counter*>(reinterpret_cast<char*>(h) - offsetof(counter, hook));
+    }
+
+    std::size_t home(const Key& key) const noexcept
+    {
+        return static_cast<std::size_t>(ll_mix64(static_cast<std::uint64_t>(Hash{}(key)))) & mask_;
+    }
+
+// Key index
+
+    std::uint32_t find(const Key& key) const noexcept
+    {
+        for (std::size_t i = home(key);; i = (i + 1) & mask_)
+        {
+            const std::uint32_t id = slots_[i];
+            if (id == empty_slot || counters_[id].key == key) return id;
+        }
+    }
+
+    void index_insert(std::uint32_t id) noexcept
+    {
+        std::size_t i = home(counters_[id].key);
+        while (slots_[i] != empty_slot) i = (i + 1) & mask_;
+        slots_[i] = id;
+    }
+
+    // backward-shift deletion keeps probe chains intact without tombstones
+    void index_erase(const Key& key) noexcept
+    {
+        std::size_t i = home(key);
+        while (counters_[slots_[i]].key != key) i = (i + 1) & mask_;
+        for (std::size_t j = (i + 1) & mask_; slots_[j] != empty_slot; j = (j + 1) & mask_)
+        {
+            const std::size_t h = home(counters_[slots_[j]].key);
+            // move j back to the hole at i unless its home lies in (i, j]
+            if (((j - h) & mask_) >= ((j - i) & mask_))
+            {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i] = empty_slot;
+    }
+
+// Buckets
+
+    bucket* alloc_bucket(std::uint64_t count) noexcept
+    {
+        bucket* b = bucket_of(free_buckets_.front());
+        free_buckets_.remove(&b->hook);
+        b->count = count;
+        return b;
+    }
+
+    // first bucket at or after h with count >= c (or end)
+    intrusive_hook* lower_bound(intrusive_hook* h, std::uint64_t c) noexcept
+    {
+        while (h != buckets_.end() && bucket_of(h)->count < c) h = h->next;
+        return h;
+    }
+
+    // put an unlinked counter into the bucket for count c, searching from h
+    void place(counter* x, intrusive_hook* from, std::uint64_t c) noexcept
+    {
+        intrusive_hook* h = lower_bound(from, c);
+        bucket* b;
+        if (h != buckets_.end() && bucket_of(h)->count == c)
+            b = bucket_of(h);
+        else
+        {
+            b = alloc_bucket(c);
+            buckets_.splice(h, &b->hook); // insert before h
+        }
+        b->members.push_back(&x->hook);
+        x->parent = b;
+    }
+
+    void increment(counter* x, std::uint64_t w) noexcept
+    {
+        bucket* b = x->parent;
+        const std::uint64_t c = b->count + w;
+        intrusive_hook* next = b->hook.next;
+        // alone in the bucket and no bucket in between: bump in place
+        if (b->members.front() == b->members.back() &&
+            (next == buckets_.end() || bucket_of(next)->count > c))
+        {
+            b->count = c;
+            return;
+        }
+        b->members.remove(&x->hook);
+        place(x, next, c);
+        if (b->members.empty())
+        {
+            buckets_.remove(&b->hook);
+            free_buckets_.push_back(&b->hook);
+        }
+    }
+
+public:
+    explicit ll_space_saving(std::size_t k)
+        : k_(k)
+        , counters_(new counter[k])
+        , bucket_pool_(new bucket[k + 1])
+        , mask_(std::bit_ceil(2 * k) - 1)
+        , used_(0)
+        , total_(0)
+    {
+        if (k == 0 || k >= empty_slot) throw std::invalid_argument("ll_space_saving: bad capacity");
+        slots_.reset(new std::uint32_t[mask_ + 1]);
+        std::fill_n(slots_.get(), mask_ + 1, empty_slot);
+        for (std::size_t i = 0; i <= k; ++i) free_buckets_.push_back(&bucket_pool_[i].hook);
+    }
+
+    ll_space_saving(const ll_space_saving&) = delete;
+    ll_space_saving& operator=(const ll_space_saving&) = delete;
+
+    // count one occurrence (or w) of key
+    void offer(const Key& key, std::uint64_t w = 1) noexcept
+    {
+        total_ += w;
+        const std::uint32_t id = find(key);
+        if (id != empty_slot)
+        {
+            increment(&counters_[id], w);
+            return;
+        }
+        if (used_ < k_)
+        {
+            counter* x = &counters_[used_];
+            x->key = key;
+            x->error = 0;
+            index_insert(static_cast<std::uint32_t>(used_++));
+            place(x, buckets_.front(), w);
+            return;
+        }
+        // take over a counter of the minimum bucket
+        bucket* min = bucket_of(buckets_.front());
+        counter* x = counter_of(min->members.back());
+        index_erase(x->key);
+        x->key = key;
+        x->error = min->count;
+        index_insert(static_cast<std::uint32_t>(x - counters_.get()));
+        increment(x, w);
+    }
+
+    void offer(std::span<const Key> keys) noexcept
+    {
+        for (const Key& k : keys) offer(k);
+    }
+
+// Queries
+
+    // monitored keys by descending count; returns how many were written
+    std::size_t top(std::size_t n, ll_heavy_hitter<Key>* out)
+    {
+        std::size_t i = 0;
+        for (intrusive_hook* b = buckets_.back(); b != buckets_.end() && i < n; b = b->prev)
+            for (intrusive_hook* h = bucket_of(b)->members.front(); h != bucket_of(b)->members.end() && i < n;
+                 h = h->next)
+            {
+                const counter* x = counter_of(h);
+                out[i++] = {x->key, bucket_of(b)->count, x->error};
+            }
+        return i;
+    }
+
+    // false if the key is not monitored (its count is then <= min_count())
+    bool lookup(const Key& key, ll_heavy_hitter<Key>& out) const noexcept
+    {
+        const std::uint32_t id = find(key);
+        if (id == empty_slot) return false;
+        const counter& x = counters_[id];
+        out = {x.key, x.parent->count, x.error};
+        return true;
+    }
+
+    // smallest monitored count; any unmonitored key occurred at most this often
+    std::uint64_t min_count() noexcept
+    {
+        return used_ < k_ || buckets_.empty() ? 0 : bucket_of(buckets_.front())->count;
+    }
+
+    std::uint64_t total() const noexcept
+    {
+        return total_;
+    }
+    std::size_t capacity() const noexcept
+    {
+        return k_;
+    }
+    std::size_t size() const noexcept
+    {
+        return used_;
+    }
+    std::size_t memory_bytes() const noexcept
+    {
+        return sizeof(*this) + k_ * sizeof(counter) + (k_ + 1) * sizeof(bucket) + (mask_ + 1) * sizeof(std::uint32_t);
+    }
+};
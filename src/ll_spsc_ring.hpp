@@ -0,0 +1,193 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+/*
+ *SPSC Byte Ring
+ * Bounded single-producer / single-consumer ring for variable length records.
+ * Key properties by design:
+ * - one allocation at construction, none afterwards
+ * - records are contiguous in memory (a record never wraps around the end)
+ * - producer and consumer indices live on separate cache lines
+ * - each side caches the other side's index and only re-reads the shared
+ *   atomic when the cached value says "full" / "empty"
+ * - consumer can drain a batch and publish its tail once per batch
+ *
+ * Record layout (8 byte aligned):
+ *   [u32 size][u32 flags][payload ... padded to 8]
+ * When a record does not fit before the end of the buffer, the producer
+ * writes a padding record covering the remainder and restarts at offset 0.
+ */
+
+class ll_spsc_byte_ring
+{
+private:
+    struct record_header
+    {
+        std::uint32_t size;
+        std::uint32_t flags;
+    };
+
+    static constexpr std::uint32_t pad_flag = 1;
+    static constexpr std::size_t header_bytes = sizeof(record_header);
+    static constexpr std::size_t cache_line = 64;
+
+    static constexpr std::size_t round8(std::size_t n) noexcept
+    {
+        return (n + 7) & ~std::size_t{7};
+    }
+
+    std::byte* buf_;
+    std::size_t cap_;
+    std::size_t mask_;
+
+// Producer side
+    // head_ : published write position (monotonic, never wrapped)
+    // tail_cache_ : producer's last view of tail_
+    // reserved_ : write position after the record handed out by try_reserve
+    alignas(cache_line) std::atomic<std::uint64_t> head_;
+    std::uint64_t tail_cache_;
+    std::uint64_t reserved_;
+
+// Consumer side
+    alignas(cache_line) std::atomic<std::uint64_t> tail_;
+    std::uint64_t head_cache_;
+
+    record_header* header_at(std::uint64_t pos) const noexcept
+    {
+        return reinterpret_cast<record_header*>(buf_ + (pos & mask_));
+    }
+
+public:
+// Construction/Destruction
+    // capacity_bytes is rounded up to a power of two (minimum 64)
+    explicit ll_spsc_byte_ring(std::size_t capacity_bytes)
+        : buf_(nullptr)
+        , cap_(cache_line)
+        , mask_(0)
+        , head_(0)
+        , tail_cache_(0)
+        , reserved_(0)
+        , tail_(0)
+        , head_cache_(0)
+    {
+        while (cap_ < capacity_bytes)
+        {
+            if (cap_ > (std::size_t{1} << 40)) throw std::length_error("ll_spsc_byte_ring: capacity");
+            cap_ <<= 1;
+        }
+        mask_ = cap_ - 1;
+        buf_ = static_cast<std::byte*>(::operator new(cap_, std::align_val_t(cache_line)));
+        // prefault every page now rather than on the producer's first lap
+        std::memset(buf_, 0, cap_);
+    }
+
+    ll_spsc_byte_ring(const ll_spsc_byte_ring&) = delete;
+    ll_spsc_byte_ring& operator=(const ll_spsc_byte_ring&) = delete;
+
+    ~ll_spsc_byte_ring()
+    {
+        ::operator delete(buf_, std::align_val_t(cache_line));
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return cap_;
+    }
+
+    // largest payload a single record can carry
+    std::size_t max_record() const noexcept
+    {
+        return cap_ / 2 - header_bytes;
+    }
+
+// Producer API
+
+    // Reserve n contiguous payload bytes.
+    // Returns nullptr when the ring is full (or n can never fit).
+    // Nothing is visible to the consumer until commit().
+    std::byte* try_reserve(std::size_t n) noexcept
+    {
+        if (n > max_record()) return nullptr;
+
+        const std::size_t total = header_bytes + round8(n);
+        std::uint64_t h = head_.load(std::memory_order_relaxed);
+        const std::size_t contig = cap_ - (h & mask_);
+        const std::size_t need = total <= contig ? total : contig + total;
+
+        if (h + need - tail_cache_ > cap_)
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (h + need - tail_cache_ > cap_) return nullptr;
+        }
+
+        if (total > contig)
+        {
+            // pad the remainder of the buffer, restart at offset 0
+            record_header* pad = header_at(h);
+            pad->size = static_cast<std::uint32_t>(contig - header_bytes);
+            pad->flags = pad_flag;
+            h += contig;
+        }
+
+        record_header* hdr = header_at(h);
+        hdr->size = static_cast<std::uint32_t>(n);
+        hdr->flags = 0;
+        reserved_ = h + total;
+        return reinterpret_cast<std::byte*>(hdr) + header_bytes;
+    }
+
+    // publish the record returned by the last successful try_reserve
+    void commit() noexcept
+    {
+        head_.store(reserved_, std::memory_order_release);
+    }
+
+    bool try_push(const void* data, std::size_t n) noexcept
+    {
+        std::byte* p = try_reserve(n);
+        if (!p) return false;
+        std::memcpy(p, data, n);
+        commit();
+        return true;
+    }
+
+// Consumer API
+
+    // Invoke f(const std::byte* payload, std::size_t size) for up to max_records
+    // records, then publish the new tail once. Returns records consumed.
+    template <typename F>
+    std::size_t drain(F&& f, std::size_t max_records = ~std::size_t{0})
+    {
+        std::uint64_t t = tail_.load(std::memory_order_relaxed);
+        std::size_t done = 0;
+
+        while (done < max_records)
+        {
+            if (t == head_cache_)
+            {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (t == head_cache_) break;
+            }
+            const record_header* hdr = header_at(t);
+            t += header_bytes + round8(hdr->size);
+            if (hdr->flags & pad_flag) continue;
+
+            f(reinterpret_cast<const std::byte*>(hdr) + header_bytes, std::size_t{hdr->size});
+            ++done;
+        }
+
+        tail_.store(t, std::memory_order_release);
+        return done;
+    }
+
+    // approximate; exact only when called from either side while the other is idle
+    bool empty() const noexcept
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+};
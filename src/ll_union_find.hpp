@@ -0,0 +1,182 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*
+ *Union-Find (Disjoint Sets)
+ * - parent array of 32-bit indices, union by size, full path compression
+ *   (two-pass, iterative: no recursion depth on long chains)
+ * - find / unite are amortised inverse-Ackermann, i.e. constant in practice
+ * - sets() tracks the number of disjoint sets as unions happen
+ *
+ *Concurrent Union-Find (ll_concurrent_union_find)
+ * - lock-free: any number of threads may call find / unite / same at once
+ * - parent array of std::atomic<uint32_t>; a root is linked by one CAS on
+ *   its own slot, which fails (and the union retries) if another thread
+ *   linked it first
+ * - randomized linking: the root with the lower priority goes under the
+ *   other, priority = a fixed bijective hash of the index. Expected depth
+ *   stays O(log n) with no rank or size word to keep consistent
+ * - path halving: every other node on a find path is pointed at its
+ *   grandparent with a plain store (only ever an ancestor, so a race just
+ *   loses a shortcut); only linking needs CAS (Jayanti & Tarjan)
+ * - no shared counters on the union path; sets() counts roots and is
+ *   meant for a quiescent structure
+ */
+
+class ll_union_find
+{
+public:
+    using index_type = std::uint32_t;
+
+private:
+    std::vector<index_type> parent_;
+    std::vector<index_type> size_; // valid at roots only
+    std::size_t sets_;
+
+public:
+    explicit ll_union_find(std::size_t n)
+        : parent_(n)
+        , size_(n, 1)
+        , sets_(n)
+    {
+        if (n > std::numeric_limits<index_type>::max()) throw std::length_error("ll_union_find: too many elements");
+        std::iota(parent_.begin(), parent_.end(), index_type{0});
+    }
+
+    index_type find(index_type x) noexcept
+    {
+        index_type root = x;
+        while (parent_[root] != root) root = parent_[root];
+        while (parent_[x] != root)
+        {
+            const index_type next = parent_[x];
+            parent_[x] = root;
+            x = next;
+        }
+        return root;
+    }
+
+    // false if a and b were already in the same set
+    bool unite(index_type a, index_type b) noexcept
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (size_[a] < size_[b]) std::swap(a, b);
+        parent_[b] = a;
+        size_[a] += size_[b];
+        --sets_;
+        return true;
+    }
+
+    bool same(index_type a, index_type b) noexcept
+    {
+        return find(a) == find(b);
+    }
+
+    std::size_t set_size(index_type x) noexcept
+    {
+        return size_[find(x)];
+    }
+
+    std::size_t sets() const noexcept
+    {
+        return sets_;
+    }
+    std::size_t size() const noexcept
+    {
+        return parent_.size();
+    }
+};
+
+class ll_concurrent_union_find
+{
+public:
+    using index_type = std::uint32_t;
+
+private:
+    std::vector<std::atomic<index_type>> parent_;
+
+    // murmur3 finaliser: a bijection, so priorities never tie
+    static constexpr index_type priority(index_type x) noexcept
+    {
+        x ^= x >> 16;
+        x *= 0x85EBCA6Bu;
+        x ^= x >> 13;
+        x *= 0xC2B2AE35u;
+        x ^= x >> 16;
+        return x;
+    }
+
+public:
+    explicit ll_concurrent_union_find(std::size_t n)
+        : parent_(n)
+    {
+        if (n > std::numeric_limits<index_type>::max())
+            throw std::length_error("ll_concurrent_union_find: too many elements");
+        for (std::size_t i = 0; i < n; ++i) parent_[i].store(static_cast<index_type>(i), std::memory_order_relaxed);
+    }
+
+    index_type find(index_type x) noexcept
+    {
+        for (;;)
+        {
+            index_type p = parent_[x].load(std::memory_order_acquire);
+            if (p == x) return x;
+            const index_type gp = parent_[p].load(std::memory_order_acquire);
+            if (gp == p) return p;
+            // x is not a root and never becomes one, and gp is an ancestor of
+            // x: a racing store can only undo another shortcut, never cut
+            // x out of its tree, so no CAS is needed
+            parent_[x].store(gp, std::memory_order_release);
+            x = gp;
+        }
+    }
+
+    // false if a and b were already in the same set
+    bool unite(index_type a, index_type b) noexcept
+    {
+        for (;;)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+            if (priority(a) > priority(b)) std::swap(a, b);
+            index_type expect = a;
+            if (parent_[a].compare_exchange_strong(expect, b, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return true;
+        }
+    }
+
+    // linearisable: a differing pair of roots counts only if a is still a root
+    bool same(index_type a, index_type b) noexcept
+    {
+        for (;;)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b) return true;
+            if (parent_[a].load(std::memory_order_acquire) == a) return false;
+        }
+    }
+
+    // quiescent only: counts roots
+    std::size_t sets() const noexcept
+    {
+        std::size_t roots = 0;
+        for (std::size_t i = 0; i < parent_.size(); ++i)
+            roots += parent_[i].load(std::memory_order_relaxed) == static_cast<index_type>(i);
+        return roots;
+    }
+    std::size_t size() const noexcept
+    {
+        return parent_.size();
+    }
+};
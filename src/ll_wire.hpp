@@ -0,0 +1,342 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+/*
+ *Zero-Copy Wire Messages
+ * Schema-by-template binary layout:
+ * - the schema is a list of field tag types, each carrying its wire type
+ * - fields are packed back to back: every offset is a compile-time constant
+ * - all scalars are little-endian on the wire (byteswapped only on BE hosts)
+ * - optional variable-length tail as the last field (u32 count + elements)
+ *
+ * Decoding never copies the message: a view is a pointer + length and each
+ * get<F>() is one unaligned load from a fixed offset. Encoding writes
+ * straight into the caller's buffer.
+ *
+ * Usage:
+ *   struct order_id : ll_wire_field<std::uint64_t> {};
+ *   struct price    : ll_wire_field<std::int64_t> {};
+ *   struct symbol   : ll_wire_field<ll_wire_chars<8>> {};
+ *   struct fills    : ll_wire_tail<std::uint32_t> {};
+ *   using new_order = ll_wire_message<order_id, price, symbol, fills>;
+ *
+ *   new_order::writer w(buf);  w.set<price>(10025);  w.set_tail<fills>(span);
+ *   new_order::view   v(buf, n);  v.get<price>();  v.tail<fills>()[0];
+ */
+
+// Wire types
+
+// fixed-width, space padded text (symbols, client ids)
+template <std::size_t N>
+struct ll_wire_chars
+{
+    std::array<char, N> data;
+
+    // trailing spaces / NULs are padding
+    std::string_view view() const noexcept
+    {
+        std::size_t n = N;
+        while (n && (data[n - 1] == ' ' || data[n - 1] == '\0')) --n;
+        return {data.data(), n};
+    }
+
+    static ll_wire_chars from(std::string_view s) noexcept
+    {
+        ll_wire_chars c;
+        c.data.fill(' ');
+        std::memcpy(c.data.data(), s.data(), s.size() < N ? s.size() : N);
+        return c;
+    }
+};
+
+template <typename T>
+struct ll_wire_field
+{
+    using type = T;
+    static constexpr bool is_tail = false;
+    static constexpr std::size_t wire_size = sizeof(T);
+};
+
+// variable-length tail: u32 element count in the fixed part, elements after it
+template <typename T>
+struct ll_wire_tail
+{
+    using type = T;
+    static constexpr bool is_tail = true;
+    static constexpr std::size_t wire_size = sizeof(std::uint32_t);
+};
+
+namespace ll_wire_detail
+{
+    template <typename T>
+    inline constexpr bool is_chars_v = false;
+    template <std::size_t N>
+    inline constexpr bool is_chars_v<ll_wire_chars<N>> = true;
+
+    template <typename T>
+    inline constexpr bool is_wire_type_v =
+        std::is_arithmetic_v<T> || std::is_enum_v<T> || is_chars_v<T>;
+
+    template <typename T>
+    constexpr T to_little(T v) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1 || is_chars_v<T>)
+        {
+            return v;
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            return static_cast<T>(std::byteswap(static_cast<std::underlying_type_t<T>>(v)));
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            using bits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+            return std::bit_cast<T>(std::byteswap(std::bit_cast<bits>(v)));
+        }
+        else
+        {
+            return std::byteswap(v);
+        }
+    }
+
+    template <typename T>
+    T load(const std::byte* p) noexcept
+    {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        return to_little(v);
+    }
+
+    template <typename T>
+    void store(std::byte* p, T v) noexcept
+    {
+        v = to_little(v);
+        std::memcpy(p, &v, sizeof(T));
+    }
+
+    template <typename F, typename... Fs>
+    constexpr std::size_t offset_of() noexcept
+    {
+        constexpr bool match[] = {std::is_same_v<F, Fs>...};
+        constexpr std::size_t size[] = {Fs::wire_size...};
+        std::size_t off = 0;
+        for (std::size_t i = 0; i < sizeof...(Fs); ++i)
+        {
+            if (match[i]) return off;
+            off += size[i];
+        }
+        return off;
+    }
+
+    template <typename F, typename... Fs>
+    inline constexpr bool contains_v = (std::is_same_v<F, Fs> || ...);
+
+    template <typename... Fs>
+    constexpr bool tail_is_last() noexcept
+    {
+        constexpr bool tails[] = {Fs::is_tail...};
+        for (std::size_t i = 0; i + 1 < sizeof...(Fs); ++i)
+            if (tails[i]) return false;
+        return true;
+    }
+}
+
+// read-only view over little-endian elements that may be unaligned
+template <typename T>
+class ll_wire_array
+{
+    const std::byte* p_;
+    std::size_t n_;
+
+public:
+    ll_wire_array(const std::byte* p, std::size_t n) noexcept : p_(p), n_(n) {}
+
+    std::size_t size() const noexcept
+    {
+        return n_;
+    }
+    bool empty() const noexcept
+    {
+        return n_ == 0;
+    }
+    T operator[](std::size_t i) const noexcept
+    {
+        return ll_wire_detail::load<T>(p_ + i * sizeof(T));
+    }
+    std::span<const std::byte> bytes() const noexcept
+    {
+        return {p_, n_ * sizeof(T)};
+    }
+};
+
+template <typename... Fields>
+class ll_wire_message
+{
+    static_assert(sizeof...(Fields) > 0, "ll_wire_message needs at least one field");
+    static_assert((ll_wire_detail::is_wire_type_v<typename Fields::type> && ...),
+                  "wire fields must be arithmetic, enum or ll_wire_chars");
+    static_assert(ll_wire_detail::tail_is_last<Fields...>(),
+                  "ll_wire_tail must be the last field");
+
+    static constexpr bool tails_[] = {Fields::is_tail...};
+
+    template <typename F>
+    static constexpr void check_field() noexcept
+    {
+        static_assert(ll_wire_detail::contains_v<F, Fields...>, "field is not part of this message");
+    }
+
+public:
+    // bytes before the tail (includes the tail's u32 count)
+    static constexpr std::size_t fixed_size = (std::size_t{0} + ... + Fields::wire_size);
+    static constexpr bool has_tail = tails_[sizeof...(Fields) - 1];
+
+    template <typename F>
+    static constexpr std::size_t offset_of = ll_wire_detail::offset_of<F, Fields...>();
+
+    // total encoded size for a given tail element count
+    template <typename Tail>
+    static constexpr std::size_t encoded_size(std::size_t tail_count) noexcept
+    {
+        static_assert(Tail::is_tail, "encoded_size<F>: F must be the ll_wire_tail field");
+        return fixed_size + tail_count * sizeof(typename Tail::type);
+    }
+
+// View: zero-copy decode
+    class view
+    {
+        const std::byte* p_;
+        std::size_t n_;
+
+    public:
+        // unchecked: caller guarantees n >= size of the encoded message
+        view(const std::byte* p, std::size_t n) noexcept : p_(p), n_(n) {}
+
+        template <typename F>
+        typename F::type get() const noexcept
+        {
+            check_field<F>();
+            static_assert(!F::is_tail, "use tail<F>() for the tail field");
+            return ll_wire_detail::load<typename F::type>(p_ + offset_of<F>);
+        }
+
+        template <typename F>
+        std::uint32_t tail_count() const noexcept
+        {
+            check_field<F>();
+            static_assert(F::is_tail, "tail_count<F>: F must be the ll_wire_tail field");
+            return ll_wire_detail::load<std::uint32_t>(p_ + offset_of<F>);
+        }
+
+        template <typename F>
+        auto tail() const noexcept
+        {
+            using T = typename F::type;
+            const std::size_t n = tail_count<F>();
+            if constexpr (std::is_same_v<T, char>) return std::string_view(reinterpret_cast<const char*>(p_ + fixed_size), n);
+            else return ll_wire_array<T>(p_ + fixed_size, n);
+        }
+
+        // encoded size of this message
+        std::size_t size() const noexcept
+        {
+            if constexpr (has_tail)
+            {
+                using tail_field = std::tuple_element_t<sizeof...(Fields) - 1, std::tuple<Fields...>>;
+                return encoded_size<tail_field>(tail_count<tail_field>());
+            }
+            else
+            {
+                return fixed_size;
+            }
+        }
+
+        const std::byte* data() const noexcept
+        {
+            return p_;
+        }
+        std::size_t capacity() const noexcept
+        {
+            return n_;
+        }
+    };
+
+    // bounds-checked decode: nullopt if the buffer cannot hold the message
+    static std::optional<view> try_view(std::span<const std::byte> buf) noexcept
+    {
+        if (buf.size() < fixed_size) return std::nullopt;
+        view v(buf.data(), buf.size());
+        if (v.size() > buf.size()) return std::nullopt;
+        return v;
+    }
+
+// Writer: encode in place
+    class writer
+    {
+        std::byte* p_;
+        std::size_t tail_bytes_;
+
+    public:
+        // caller guarantees the buffer can hold fixed_size + tail
+        explicit writer(std::byte* p) noexcept : p_(p), tail_bytes_(0)
+        {
+            // an unset tail encodes as empty
+            if constexpr (has_tail) ll_wire_detail::store(p_ + fixed_size - sizeof(std::uint32_t), std::uint32_t{0});
+        }
+
+        template <typename F>
+        writer& set(typename F::type v) noexcept
+        {
+            check_field<F>();
+            static_assert(!F::is_tail, "use set_tail<F>() for the tail field");
+            ll_wire_detail::store(p_ + offset_of<F>, v);
+            return *this;
+        }
+
+        template <typename F>
+        writer& set_tail(std::span<const typename F::type> elems) noexcept
+        {
+            check_field<F>();
+            static_assert(F::is_tail, "set_tail<F>: F must be the ll_wire_tail field");
+            using T = typename F::type;
+            ll_wire_detail::store(p_ + offset_of<F>, static_cast<std::uint32_t>(elems.size()));
+            std::byte* dst = p_ + fixed_size;
+            if constexpr (std::endian::native == std::endian::little || sizeof(T) == 1)
+            {
+                std::memcpy(dst, elems.data(), elems.size_bytes());
+            }
+            else
+            {
+                for (std::size_t i = 0; i < elems.size(); ++i) ll_wire_detail::store(dst + i * sizeof(T), elems[i]);
+            }
+            tail_bytes_ = elems.size_bytes();
+            return *this;
+        }
+
+        template <typename F>
+        writer& set_tail_text(std::string_view s) noexcept
+        {
+            static_assert(std::is_same_v<typename F::type, char>, "string tail needs ll_wire_tail<char>");
+            return set_tail<F>(std::span<const char>(s.data(), s.size()));
+        }
+
+        // bytes written so far (fixed part + tail)
+        std::size_t size() const noexcept
+        {
+            return fixed_size + tail_bytes_;
+        }
+        std::byte* data() const noexcept
+        {
+            return p_;
+        }
+    };
+};
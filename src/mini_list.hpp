@@ -34,7 +34,8 @@ public:
 
         iterator(node* p = nullptr) : ptr(p) {}
 
-        T& operator*{} const {return ptr->value;}
+        T& operator*() const {return ptr->value;}
+        T* operator->() const {return &ptr->value;}
         iterator& operator++() {ptr = ptr->next; return *this;}
         iterator& operator--() {ptr = ptr->prev; return *this;}
 
@@ -105,5 +106,21 @@ public:
         return ret;
     }
 
-    void push_back(const T& val) {insert(end(),val());}
+    // move the node at it before pos, relinking only
+    void splice(iterator pos, iterator it)
+    {
+        node* n = it.ptr;
+        node* p = pos.ptr;
+        if (n == p || n->next == p) return;
+
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+
+        n->prev = p->prev;
+        n->next = p;
+        p->prev->next = n;
+        p->prev = n;
+    }
+
+    void push_back(const T& val) {insert(end(),val);}
 };
\ No newline at end of file